@@ -0,0 +1,111 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        audioinput.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Audio sample sources for SoundAnalyzerBase. Exactly one backend is
+//    compiled into a given build (M5 mic, I2S digital mic, ADC analog mic,
+//    or the synthetic generator) and CreateAudioInput() hands it out once
+//    when the analyzer installs its hardware.
+//
+//    Read() blocks until the driver reports a completed DMA block, so the
+//    audio task sleeps while the peripheral fills the buffer and wakes as
+//    soon as a fresh block lands rather than polling on a timer. That keeps
+//    the analysis no more than one block behind the microphone.
+//
+//    Nothing here pulls in ESP-IDF headers; the driver-specific classes
+//    live in audioinput.cpp.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// IAudioInput
+//
+// One mono stream of signed 16-bit samples at SoundAnalyzerBase::SAMPLING_FREQUENCY.
+
+class IAudioInput
+{
+  public:
+    virtual ~IAudioInput() = default;
+
+    // Short backend name for logs
+    virtual const char* Name() const = 0;
+
+    // Install and start the driver. Must be called from the task that will
+    // call Read(), since some backends wake that task from their ISR.
+    virtual bool Begin(int inputPin) = 0;
+
+    // Stop DMA and uninstall the driver. Idempotent.
+    virtual void End() = 0;
+
+    // Block for up to timeoutMs until count samples are available and copy
+    // them to dest. Returns the number of samples written, which is 0 on
+    // timeout or error and may be short if the driver delivered a partial
+    // block.
+    virtual size_t Read(int16_t* dest, size_t count, uint32_t timeoutMs) = 0;
+};
+
+// CreateAudioInput
+//
+// Returns the backend this build was configured for, or nullptr if the
+// target has no usable audio input.
+
+std::unique_ptr<IAudioInput> CreateAudioInput();
+
+#if AUDIO_INPUT_SYNTHETIC
+
+// SyntheticAudioInput
+//
+// A DMA stand-in for exercising the sampler loop without a microphone: a
+// slow tone sweep with a decaying kick every beatMs, delivered one block at
+// a time at the same cadence real hardware would produce it. Selected by
+// CreateAudioInput() when AUDIO_INPUT_SYNTHETIC is set, and has no ESP-IDF
+// dependencies so it can also be driven directly from a host harness.
+
+class SyntheticAudioInput : public IAudioInput
+{
+  public:
+    explicit SyntheticAudioInput(uint32_t sampleRate, uint32_t beatMs = 500)
+      : _sampleRate(sampleRate), _beatMs(beatMs) {}
+
+    const char* Name() const override { return "Synthetic"; }
+    bool Begin(int inputPin) override;
+    void End() override { _running = false; }
+    size_t Read(int16_t* dest, size_t count, uint32_t timeoutMs) override;
+
+  private:
+    uint32_t _sampleRate;
+    uint32_t _beatMs;
+    bool     _running = false;
+    uint64_t _sampleIndex = 0;         // Total samples generated; doubles as the stream clock
+    uint32_t _startMs = 0;
+    float    _tonePhase = 0.0f;
+};
+
+#endif // AUDIO_INPUT_SYNTHETIC
@@ -47,6 +47,7 @@
 
 #include "globals.h"
 
+#include "audiosync.h"
 #include "itaskservice.h"   // includes iservice.h
 #include "soundanalyzer.h"
 
@@ -135,15 +136,27 @@ class AudioService : public ITaskService
     // no beats so effects can run safely.
     IAudioSource& Source() const;
 
+    // Networked audio counters, or nullptr when this build neither publishes
+    // nor subscribes (see audiosync.h).
+
+    const AudioSyncStats* SyncStats() const;
+
   protected:
     // ITaskService hooks
     TaskConfig GetTaskConfig() const override;
     bool OnBeforeStart() override;
     void Run() override;
+    void OnBeforeWaitForStop() override;
     void OnAfterStop() override;
 
   private:
     AudioConfig _config{};
+
+    #if AUDIO_SYNC_PUBLISH
+        AudioSyncPublisher _syncPublisher;
+    #elif AUDIO_SYNC_SUBSCRIBE
+        AudioSyncSubscriber _syncSubscriber;
+    #endif
 };
 
 #else // !ENABLE_AUDIO
@@ -176,6 +189,8 @@ class AudioService : public IService
 
     IAudioSource& Source() const;
 
+    const AudioSyncStats* SyncStats() const       { return nullptr; }
+
   private:
     AudioConfig _config{};
 };
@@ -0,0 +1,190 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        audiosync.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Networked audio feature broadcast. One device with a microphone (or a
+//    host process such as samples/audioserver) multicasts a compact snapshot
+//    of every analyzer pass over UDP; any number of subscriber devices feed
+//    those snapshots into SoundAnalyzerBase instead of sampling their own
+//    mic, so every prop in an installation sees the same beat at the same
+//    moment.
+//
+//    Both roles are driven from AudioService::Run() on the audio task, so
+//    neither costs an extra FreeRTOS task or stack. The role is chosen at
+//    build time with AUDIO_SYNC_PUBLISH or AUDIO_SYNC_SUBSCRIBE.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <array>
+#include <cstdint>
+
+#include "soundanalyzer.h"
+
+#define AUDIO_SYNC_MAGIC    (0x5541444E)                // ASCII "NDAU" as header
+#define AUDIO_SYNC_VERSION  1
+
+// AudioSyncPacket
+//
+// One analyzer pass on the wire. Times are publisher-relative ages rather
+// than absolute clocks so subscribers never need the two millis() counters
+// to agree; the subscriber aligns them itself (see AudioSyncSubscriber).
+
+struct AudioSyncPacket
+{
+    uint32_t    magic;             // AUDIO_SYNC_MAGIC
+    uint16_t    version;           // AUDIO_SYNC_VERSION
+    uint16_t    numBands;          // Must match NUM_BANDS on the receiver
+    uint32_t    sequence;          // Publisher pass counter; gaps mean lost packets
+    uint32_t    timestampMs;       // Publisher millis() at the end of the pass
+    float       vu;
+    float       vuRatio;
+    float       vuRatioFade;
+    uint32_t    beatSequence;      // Publisher's BeatInfo::sequence, 0 if no beat yet
+    uint32_t    beatAgeMs;         // How long before timestampMs that beat fired
+    float       msPerBeat;
+    float       beatConfidence;
+    float       beatStrength;
+    float       peaks[NUM_BANDS];
+} __attribute__((packed));
+
+static_assert(sizeof(AudioSyncPacket) == 48 + NUM_BANDS * sizeof(float), "AudioSyncPacket layout changed - update the host tools too");
+
+// AudioSyncStats
+//
+// Counters for /statistics. Written only by the audio task; readers on other
+// tasks may see a torn set of values but never a torn individual field.
+
+struct AudioSyncStats
+{
+    uint32_t    packets       = 0; // Sent (publisher) or applied (subscriber)
+    uint32_t    lost          = 0; // Sequence gaps seen by the subscriber
+    uint32_t    late          = 0; // Duplicates or out-of-order packets dropped
+    uint32_t    concealed     = 0; // Passes filled in from the last snapshot
+    int32_t     offsetMs      = 0; // Local minus publisher clock, minimum-delay estimate
+    uint32_t    jitterMs      = 0; // Smoothed arrival jitter
+    uint32_t    lastPacketMs  = 0; // Local millis() of the last good packet
+};
+
+#if AUDIO_SYNC_PUBLISH
+
+// AudioSyncPublisher
+//
+// Multicasts one AudioSyncPacket per analyzer pass. The socket is opened
+// lazily once WiFi is up and reopened if a send fails.
+
+class AudioSyncPublisher
+{
+  public:
+    AudioSyncPublisher() = default;
+    ~AudioSyncPublisher() { End(); }
+
+    AudioSyncPublisher(const AudioSyncPublisher&) = delete;
+    AudioSyncPublisher& operator=(const AudioSyncPublisher&) = delete;
+
+    void Publish(const SoundAnalyzerBase& analyzer);
+    void End();
+
+    const AudioSyncStats& Stats() const { return _stats; }
+
+  private:
+    bool Begin();
+
+    int             _socket = -1;
+    uint32_t        _sequence = 0;
+    uint32_t        _lastAttemptMs = 0;
+    AudioSyncStats  _stats{};
+};
+
+#endif // AUDIO_SYNC_PUBLISH
+
+#if AUDIO_SYNC_SUBSCRIBE
+
+// AudioSyncSubscriber
+//
+// Receives AudioSyncPackets and plays them into the analyzer.
+//
+// Clock alignment: the offset between the local and publisher clocks is
+// estimated as the smallest (arrival - timestampMs) seen recently, i.e. the
+// packet that took the fastest path. Each snapshot is then applied at
+// timestampMs + offset + AUDIO_SYNC_PLAYOUT_MS, which absorbs WiFi jitter
+// and keeps every subscriber on the same schedule.
+//
+// Loss concealment: when a pass comes due without a fresh snapshot, the
+// last one is replayed with decaying peaks; after AUDIO_PEAK_REMOTE_TIMEOUT
+// of silence the analyzer fades to zero.
+
+class AudioSyncSubscriber
+{
+  public:
+    AudioSyncSubscriber() = default;
+    ~AudioSyncSubscriber() { End(); }
+
+    AudioSyncSubscriber(const AudioSyncSubscriber&) = delete;
+    AudioSyncSubscriber& operator=(const AudioSyncSubscriber&) = delete;
+
+    // Wait up to maxWaitMs for the next snapshot to come due, then apply it
+    // (or a concealment frame) to the analyzer. Returns early as soon as a
+    // queued snapshot is due, so the audio task never sleeps past a beat.
+
+    void Poll(SoundAnalyzerBase& analyzer, uint32_t maxWaitMs);
+    void End();
+
+    const AudioSyncStats& Stats() const { return _stats; }
+
+  private:
+    static constexpr size_t   kQueueDepth        = 8;
+    static constexpr uint32_t kOffsetWindowMs    = 10000;   // Re-seed the min-delay estimate this often
+    static constexpr float    kConcealDecay      = 0.85f;   // Per-pass peak decay while concealing
+
+    bool Begin();
+    void Receive();
+    void Enqueue(const AudioSyncPacket& packet, uint32_t arrivalMs);
+    int32_t MsUntilDue(uint32_t now) const;
+    void Apply(SoundAnalyzerBase& analyzer, const AudioSyncPacket& packet, uint32_t now);
+    void Conceal(SoundAnalyzerBase& analyzer, uint32_t now);
+
+    int             _socket = -1;
+    uint32_t        _lastAttemptMs = 0;
+
+    std::array<AudioSyncPacket, kQueueDepth> _queue{};
+    size_t          _queueCount = 0;                        // Sorted by sequence, oldest first
+
+    bool            _haveOffset = false;
+    int32_t         _windowMinOffset = 0;
+    uint32_t        _windowStartMs = 0;
+    int32_t         _lastTransit = 0;
+
+    bool            _haveLast = false;
+    AudioSyncPacket _last{};
+    PeakData        _concealPeaks{};
+    uint32_t        _lastAppliedMs = 0;
+    uint32_t        _lastBeatSequence = 0;
+
+    AudioSyncStats  _stats{};
+};
+
+#endif // AUDIO_SYNC_SUBSCRIBE
@@ -28,8 +28,10 @@
 //    TCP socket (LEDViewer protocol) and/or the WebSocket frame channel
 //    so external tools and the local web UI can preview the strip.
 //    Gated by COLORDATA_SERVER_ENABLED. Inherits ITaskService for
-//    lifecycle. Implementation lives in network.cpp alongside the
-//    LEDViewer + frame-event-listener machinery.
+//    lifecycle. The TCP viewers are served by the SocketReactor, which
+//    the service attaches its LEDViewer to while it runs; its own task
+//    only feeds the WebSocket channel. Implementation lives in
+//    network.cpp alongside the frame-event-listener machinery.
 //
 // History:     May-04-2026         Davepl      Created
 //
@@ -39,19 +41,34 @@
 
 #if COLORDATA_SERVER_ENABLED
 
+#include <memory>
+#include <vector>
+
 #include "itaskservice.h"
+#include "previewencoder.h"
+
+class LEDViewer;
 
 class ColorStreamerService : public ITaskService
 {
   public:
-    ColorStreamerService() = default;
-    ~ColorStreamerService() override { Stop(); }
+    ColorStreamerService();
+    ~ColorStreamerService() override;
 
     const char* Name() const override { return "ColorStreamerService"; }
 
+    // Every preview client on either transport, with what it asked for and what it has been sent
+    std::vector<PreviewClientReport> GetPreviewClients() const;
+
   protected:
     TaskConfig GetTaskConfig() const override;
     void Run() override;
+    bool OnBeforeStart() override;
+    void OnBeforeWaitForStop() override { WakeTask(); }
+    void OnAfterStop() override;
+
+  private:
+    std::unique_ptr<LEDViewer> _viewer;
 };
 
 #endif // COLORDATA_SERVER_ENABLED
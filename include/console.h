@@ -29,11 +29,13 @@
 #pragma once
 #include "globals.h"
 #include <Arduino.h>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 #include "logger.h"
 
@@ -56,7 +58,7 @@ public:
 class ConsoleSession : public LogSink
 {
 public:
-    ConsoleSession(IConsoleSink* sink);
+    ConsoleSession(std::shared_ptr<IConsoleSink> sink);
 
     // IConsoleSink methods
     void WriteRaw(std::string_view data);
@@ -74,12 +76,18 @@ public:
     void SetShowColors(bool enable) { _showColors = enable; }
     bool ShowColors() const { return _showColors; }
 
+    // When set, a completed line is queued on the ConsoleManager rather than
+    // run by whoever fed the byte in; see ConsoleManager::RunQueuedCommands
+    void SetDeferCommands(bool enable) { _deferCommands = enable; }
+    bool DefersCommands() const { return _deferCommands; }
+
     std::string& StringBuffer() { return _buffer; }
 
 private:
-    IConsoleSink* _sink;
+    std::shared_ptr<IConsoleSink> _sink;
     bool _echo = true;
     bool _showColors = true;
+    bool _deferCommands = false;
     std::string _buffer;
 };
 
@@ -104,15 +112,24 @@ public:
     void Broadcast(std::string_view data);
     void Broadcast(LogLevel level, const char* tag, const char* message);
 
+    // Command lines from sessions that defer them wait here until the main
+    // loop calls RunQueuedCommands, so a slow command never runs on the task
+    // that is reading the socket
+    void QueueCommand(std::string line, std::shared_ptr<ConsoleSession> session);
+    void RunQueuedCommands();
+
     // Internal use by TelnetServer
-    void SetTelnetSink(IConsoleSink* sink);
+    void SetTelnetSink(std::shared_ptr<IConsoleSink> sink);
     void ClearTelnetSink();
 
 private:
     ConsoleManager();
 
+    static constexpr size_t kMaxQueuedCommands = 8;
+
     std::shared_ptr<ConsoleSession> _serialSession;
     std::shared_ptr<ConsoleSession> _telnetSession;
+    std::deque<std::pair<std::string, std::shared_ptr<ConsoleSession>>> _queuedCommands;
     ConsoleByteHandler _byteHandler = nullptr;
     std::recursive_mutex _mutex;
 };
@@ -24,10 +24,12 @@
 //
 // Description:
 //
-//    DebugConsole runs the BSD-socket telnet server that gives remote
-//    debug access to the chip. Inherits ITaskService for lifecycle.
-//    Implementation lives in telnetserver.cpp alongside the protocol
-//    handling helpers.
+//    DebugConsole is the telnet server that gives remote debug access to
+//    the chip. The socket reactor owns the listening and client sockets
+//    and calls in here as bytes arrive; this class handles the telnet
+//    protocol and feeds the console, whose commands then run on the main
+//    loop rather than on the reactor. Implementation lives in
+//    telnetserver.cpp alongside the protocol handling helpers.
 //
 // History:     May-04-2026         Davepl      Created
 //
@@ -38,35 +40,59 @@
 #if ENABLE_WIFI
 
 #include <atomic>
+#include <memory>
 
-#include "itaskservice.h"
+#include "iservice.h"
+#include "socketreactor.h"
 
-class DebugConsole : public ITaskService
+class TelnetSink;
+
+class DebugConsole : public IService, public ISocketProtocol
 {
   public:
     DebugConsole() = default;
-    ~DebugConsole() override { Stop(); }
+    ~DebugConsole() override;
 
-    const char* Name() const override { return "DebugConsole"; }
+    // IService
 
-  protected:
-    TaskConfig GetTaskConfig() const override;
-    void Run() override;
+    bool Start() override;
+    void Stop() override;
+    bool IsRunning() const override { return _running.load(); }
+    const char* Name() const override { return "DebugConsole"; }
 
-    // Close the listening (and any active client) socket from the Stop() thread
-    // so accept()/recv() return promptly and Run() can observe ShouldShutdown().
+    // ISocketProtocol. One client at a time, since the console has a single
+    // telnet session; a second connection waits in the backlog.
 
-    void OnBeforeWaitForStop() override;
+    const char* ProtocolName() const override { return "Telnet"; }
+    bool OnConnect(int fd, const sockaddr_in& peer) override;
+    bool OnReadable(int fd) override;
+    bool WantsWrite(int fd) const override;
+    bool OnWritable(int fd) override;
+    void OnDisconnect(int fd) override;
 
   private:
-    
-  // Both fds are set by Run() and may be cleared by OnBeforeWaitForStop()
-    // running on a different task. atomic<int> gives us a lock-free
-    // exchange so we never call close() twice on the same fd.  I can't 
-    // believe POSIX doesn't define an invalid handle constant, but here we are.
-
-    std::atomic<int> _listenFd{-1};
-    std::atomic<int> _clientFd{-1};
+
+    // State machine for Telnet protocol and CR handling.
+    // Survives across recv() boundaries.
+
+    enum class RecvState : uint8_t
+    {
+        Normal,     // Normal data byte
+        IAC,        // Saw 0xFF, waiting for verb
+        IACVerb,    // Saw IAC + verb, waiting for option byte
+        IACsb,      // Inside subnegotiation, waiting for IAC SE
+        IACInSB,    // Saw IAC inside subnegotiation
+        AfterCR,    // Saw \r, waiting to see if next is \0 or \n (RFC 854)
+    };
+
+    void ProcessByte(uint8_t byte);
+
+    SocketReactor*              _pReactor = nullptr;
+    std::atomic<bool>           _running{false};
+
+    // Only touched from reactor callbacks, which the reactor serializes
+    RecvState                   _state = RecvState::Normal;
+    std::shared_ptr<TelnetSink> _sink;
 };
 
 #endif // ENABLE_WIFI
@@ -37,6 +37,7 @@
 #include <vector>
 
 #include "interfaces.h"
+#include "powermodel.h"
 #include "types.h"
 
 #if ENABLE_WIFI
@@ -224,6 +225,7 @@ class DeviceConfig : public IJSONSerializable
     bool    rememberCurrentEffect = true;
     bool    remoteEffectButtonsResetInterval = true;
     int     powerLimit = POWER_LIMIT_DEFAULT;
+    PowerModelConfig powerModel = PowerModelConfig::Defaults();
     bool    showVUMeter = true;
     uint8_t brightness = BRIGHTNESS_MAX;
     CRGB    globalColor = CRGB::Red;
@@ -279,6 +281,7 @@ class DeviceConfig : public IJSONSerializable
     static constexpr const char * RemoteEffectButtonsResetIntervalTag = NAME_OF(remoteEffectButtonsResetInterval);
     static constexpr const char * PowerLimitTag = NAME_OF(powerLimit);
     static constexpr const char * PowerLimitDefaultTag = "powerLimitDefault";
+    static constexpr const char * PowerModelTag = NAME_OF(powerModel);
     static constexpr const char * BrightnessTag = NAME_OF(brightness);
     // No need to publish the show VU meter tag unless we're also publishing the setting
     #if SHOW_VU_METER
@@ -357,6 +360,10 @@ class DeviceConfig : public IJSONSerializable
     static SuccessResultWithMessage ValidatePowerLimit(const String& newPowerLimit);
     void SetPowerLimit(int newPowerLimit);
 
+    // The calibrated power model the brightness limiters estimate with; setting it also publishes it to PowerModel
+    const PowerModelConfig& GetPowerModel() const { return powerModel; }
+    void SetPowerModel(const PowerModelConfig& newPowerModel);
+
     const CRGB& GlobalColor() const { return globalColor; }
     void SetApplyGlobalColors();
     void ClearApplyGlobalColors();
@@ -461,6 +468,14 @@ class DeviceConfig : public IJSONSerializable
     SuccessResultWithMessage ApplyUnifiedDeviceSettings(const UnifiedSettingsRequest& request);
     void SerializeUnifiedSettings(JsonObject root) const;
     void SerializeUnifiedSettingsSchema(JsonObject root) const;
+
+    // The schema is a fixed list of top-level members that can also be
+    // serialized one at a time, which is how the web server streams it.
+
+    static constexpr size_t kUnifiedSettingsSchemaPartCount = 4;
+    static const char* UnifiedSettingsSchemaPartName(size_t part);
+    void SerializeUnifiedSettingsSchemaPart(size_t part, JsonVariant target) const;
+
     void SetAudioInputPin(int newAudioInputPin);
 
   private:
@@ -470,4 +485,8 @@ class DeviceConfig : public IJSONSerializable
     static const char* OutputDriverName(OutputDriver driver);
     static const char* WS281xColorOrderName(WS281xColorOrder colorOrder);
     static void AppendPins(JsonArray target, const std::array<int8_t, NUM_CHANNELS>& pins);
+    void SerializeSchemaTopology(JsonObject topology) const;
+    void SerializeSchemaOutputs(JsonObject outputs) const;
+    void SerializeSchemaDevice(JsonObject device) const;
+    static void SerializeSchemaSections(JsonArray sections);
 };
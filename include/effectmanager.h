@@ -43,6 +43,7 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 class GFXBase;
@@ -61,6 +62,38 @@ void InitEffectsManager();
 void SaveEffectManagerConfig();
 void RemoveEffectManagerConfig();
 
+// Journaled persistence. Small changes are appended to EFFECTS_JOURNAL_FILE
+// as one record each instead of rewriting all of EFFECTS_CONFIG_FILE; the
+// journal is replayed over the snapshot at boot and folded back into it
+// once it passes EFFECTS_JOURNAL_COMPACT_BYTES. Indexes are positions in
+// the effect list at the time of the change.
+
+void JournalEffectEnabled(size_t index, bool enabled);
+void JournalEffectMoved(size_t from, size_t to);
+void JournalEffectInterval(uint interval);
+void JournalEffectSettings(size_t index, const std::vector<std::pair<String, String>>& settings);
+
+// False while there are changes EFFECTS_CONFIG_FILE doesn't hold yet: records
+// in the journal, queued for it, or waiting on a snapshot
+bool IsEffectsConfigFileCurrent();
+
+// EffectsJournalStats
+//
+// Persistence counters for /statistics.
+
+struct EffectsJournalStats
+{
+    size_t   journalBytes    = 0;   // Current size of the journal on flash
+    size_t   lastChangeBytes = 0;   // Bytes appended to the journal for the most recent change
+    uint32_t changesWritten  = 0;   // Changes journaled since boot
+    size_t   snapshotBytes   = 0;   // Size of the last full snapshot written
+    uint32_t snapshots       = 0;   // Full snapshots (including compactions) written since boot
+    uint32_t replayedChanges = 0;   // Journal records applied at boot
+    uint32_t replayMs        = 0;   // Time spent replaying them
+};
+
+EffectsJournalStats GetEffectsJournalStats();
+
 // IFrameEventListener
 //
 // Abstract class that can be used to listen to frame-related events.
@@ -125,6 +158,12 @@ class  EffectManager : public IJSONSerializable
 
     std::vector<std::shared_ptr<GFXBase>> _gfx;
     std::shared_ptr<LEDStripEffect> _tempEffect;
+
+    // Geometry the effects were last initialized for, to tell which of their config inputs a change touched
+    size_t _initWidth = 0;
+    size_t _initHeight = 0;
+    bool   _initSerpentine = false;
+
     std::vector<std::reference_wrapper<IFrameEventListener>> _frameEventListeners;
     std::vector<std::reference_wrapper<IEffectEventListener>> _effectEventListeners;
     mutable std::mutex _listenerMutex;
@@ -132,6 +171,12 @@ class  EffectManager : public IJSONSerializable
     void construct(bool clearTempEffect);
     void DispatchBeatIfNeeded();
 
+    // Records the geometry of the first device and returns the LEDStripEffect::ConfigInputs that differ
+    // from what was recorded before
+    uint8_t NoteInitGeometry();
+
+    void AdvanceCurrentEffectIndex();
+
     // Implementation is in effects.cpp
     void LoadJSONEffects(const JsonArrayConst& effectsArray);
 
@@ -177,8 +222,25 @@ public:
     void AddEffectEventListener(IEffectEventListener& listener);
 
     void LoadDefaultEffects();
+
+    // ReinitializeEffects
+    //
+    // Called with the render lock held after a topology change.  Only the effect on screen is initialized
+    // again right away; the others that depend on what changed are flagged, and catch up through
+    // InitPendingEffect() or when they're next started.
+
     bool ReinitializeEffects();
 
+    // InitPendingEffect
+    //
+    // Initializes one flagged effect that isn't on screen, without holding the render lock while its Init()
+    // runs.  Returns false once there are none left.
+
+    bool InitPendingEffect();
+
+    size_t PendingInitCount() const;
+    size_t FailedInitCount() const;             // Effects whose last Init() failed; they are skipped until the next change
+
     // DeserializeFromJSON
     //
     // This function deserializes LED strip effects from a provided JSON object.
@@ -301,4 +363,7 @@ public:
     void Update();
 
     void ApplyFadeLogic();
+
+    // The share of an effect's frame time its Draw() may take, in microseconds
+    static uint32_t GetDrawBudgetMicros(const LEDStripEffect& effect);
 };
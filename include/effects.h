@@ -86,4 +86,7 @@ using FactoryId = uint64_t;
 #define PTY_PRECLEAR        "prc"
 #define PTY_IGNOREGLOBALCOLOR   "igc"
 
+#define PTY_JOURNALGEN      "jgn"
+
 #define EFFECTS_CONFIG_FILE "/effects.cfg"
+#define EFFECTS_JOURNAL_FILE "/effects.jnl"
@@ -120,7 +120,7 @@ class Boid
       return ::map((float)random(0, 255), 0.0f, 255.0f, -.5f, .5f);
     }
 
-    void run(Boid boids [], uint8_t boidCount) {
+    void run(Boid boids [], size_t boidCount) {
       flock(boids, boidCount);
       update();
       // wrapAroundBorders();
@@ -139,7 +139,7 @@ class Boid
     }
 
     // Method to update location
-    void update(Boid boids [], uint8_t boidCount) {
+    void update(Boid boids [], size_t boidCount) {
       // Update velocity
       flock(boids, boidCount);
       velocity += acceleration;
@@ -179,14 +179,72 @@ class Boid
     }
 
     // We accumulate a new acceleration each time based on three rules
-    void flock(Boid boids [], uint8_t boidCount) {
-      PVector sep = separate(boids, boidCount);   // Separation
-      PVector ali = align(boids, boidCount);      // Alignment
-      PVector coh = cohesion(boids, boidCount);   // Cohesion
+    void flock(const Boid boids [], size_t boidCount) {
+      FlockSums sums;
+      for (size_t i = 0; i < boidCount; i++)
+        accumulate(boids[i], sums);
+      applyFlockSums(sums);
+    }
+
+    // Running totals for the three flocking rules, gathered in one pass over
+    // the neighbours instead of one pass per rule
+    struct FlockSums {
+      PVector separation = PVector(0, 0);
+      PVector velocity = PVector(0, 0);
+      PVector location = PVector(0, 0);
+      int separationCount = 0;
+      int neighbourCount = 0;
+    };
+
+    // Add one other boid to the flocking sums. Distances stay squared:
+    // normalizing the offset and dividing by the distance again is the same
+    // as dividing by the squared distance, so no sqrt is needed.
+    void accumulate(const Boid& other, FlockSums& sums) const {
+      if (!other.enabled)
+        return;
+      PVector diff = location - other.location;
+      float d2 = diff.magSq();
+      if (d2 <= 0)
+        return;
+      if (d2 < desiredseparation * desiredseparation) {
+        sums.separation += diff / d2;
+        sums.separationCount++;
+      }
+      if (d2 < neighbordist * neighbordist) {
+        sums.velocity += other.velocity;
+        sums.location += other.location;
+        sums.neighbourCount++;
+      }
+    }
+
+    // Turn the sums into the weighted separation, alignment and cohesion
+    // forces that separate(), align() and cohesion() would have produced
+    void applyFlockSums(FlockSums& sums) {
+      PVector sep = PVector(0, 0);
+      if (sums.separationCount > 0)
+        sums.separation /= (float) sums.separationCount;
+      if (sums.separation.mag() > 0) {
+        sep = sums.separation;
+        sep.normalize();
+        sep *= maxspeed;
+        sep -= velocity;
+        sep.limit(maxforce);
+      }
+
+      PVector ali = PVector(0, 0);
+      PVector coh = PVector(0, 0);
+      if (sums.neighbourCount > 0) {
+        ali = sums.velocity / (float) sums.neighbourCount;
+        ali.normalize();
+        ali *= maxspeed;
+        ali -= velocity;
+        ali.limit(maxforce);
+
+        coh = seek(sums.location / (float) sums.neighbourCount);
+      }
+
       // Arbitrarily weight these forces
       sep *= 1.5;
-      ali *= 1.0;
-      coh *= 1.0;
       // Add the force vectors to acceleration
       applyForce(sep);
       applyForce(ali);
@@ -195,12 +253,12 @@ class Boid
 
     // Separation
     // Method checks for nearby boids and steers away
-    PVector separate(Boid boids [], uint8_t boidCount) {
+    PVector separate(const Boid boids [], size_t boidCount) {
       PVector steer = PVector(0, 0);
       int count = 0;
       // For every boid in the system, check if it's too close
-      for (int i = 0; i < boidCount; i++) {
-        Boid other = boids[i];
+      for (size_t i = 0; i < boidCount; i++) {
+        const Boid& other = boids[i];
         if (!other.enabled)
           continue;
         float d = location.dist(other.location);
@@ -232,11 +290,11 @@ class Boid
 
     // Alignment
     // For every nearby boid in the system, calculate the average velocity
-    PVector align(Boid boids [], uint8_t boidCount) {
+    PVector align(const Boid boids [], size_t boidCount) {
       PVector sum = PVector(0, 0);
       int count = 0;
-      for (int i = 0; i < boidCount; i++) {
-        Boid other = boids[i];
+      for (size_t i = 0; i < boidCount; i++) {
+        const Boid& other = boids[i];
         if (!other.enabled)
           continue;
         float d = location.dist(other.location);
@@ -260,11 +318,11 @@ class Boid
 
     // Cohesion
     // For the average location (i.e. center) of all nearby boids, calculate steering vector towards that location
-    PVector cohesion(Boid boids [], uint8_t boidCount) {
+    PVector cohesion(const Boid boids [], size_t boidCount) {
       PVector sum = PVector(0, 0);   // Start with empty vector to accumulate all locations
       int count = 0;
-      for (int i = 0; i < boidCount; i++) {
-        Boid other = boids[i];
+      for (size_t i = 0; i < boidCount; i++) {
+        const Boid& other = boids[i];
         if (!other.enabled)
           continue;
         float d = location.dist(other.location);
@@ -33,6 +33,11 @@
 //   that it calls to fetch the GIF data and to plot the pixels on the
 //   LED matrix.
 //
+//   With ENABLE_GIF_FRAME_CACHE, the first Start() of each GIF instead
+//   points those callbacks at a GIFFrameCache and decodes the whole file
+//   once, so every later frame is a run-length blit rather than an LZW
+//   decode.  GIFs that don't fit the cache fall back to live decoding.
+//
 // History:     Nov-21-2023         Davepl      Created
 //
 //---------------------------------------------------------------------------
@@ -44,10 +49,12 @@
 
 #include <ArduinoJson.h>
 #include <map>
+#include <set>
 #include <string.h>
 
 #include "effects.h"
 #include "GifDecoder.h"
+#include "gifframecache.h"
 #include "hub75gfx.h"
 #include "ledstripeffect.h"
 #include "systemcontainer.h"
@@ -119,6 +126,9 @@ struct GIFDecoderState
     uint16_t        _srcHeight = 0;
     uint16_t        _dstWidth  = 0;
     uint16_t        _dstHeight = 0;
+    // While a frame cache is being built, the callbacks plot into it instead of the matrix
+    GIFFrameCache * _capture   = nullptr;
+    bool            _captureFailed = false;
 };
 
 inline const std::map<GIFIdentifier, const GIFInfo>& AnimatedGIFs()
@@ -146,6 +156,29 @@ inline GIFDecoderState& SharedGIFDecoderState()
     return state;
 }
 
+// GIFFrameCaches
+//
+// Pre-decoded GIFs, kept across effect switches. The map is their only owner - effects just hold weak
+// references - so dropping an entry frees it, and the total is held to GIF_FRAME_CACHE_BYTES. Only one GIF
+// plays at a time, so when a new one won't fit beside the others they are dropped to make room.
+
+inline std::map<GIFIdentifier, std::shared_ptr<const GIFFrameCache>>& GIFFrameCaches()
+{
+    static std::map<GIFIdentifier, std::shared_ptr<const GIFFrameCache>> caches;
+    return caches;
+}
+
+// UncacheableGIFs
+//
+// GIFs that failed to cache even with the whole budget to themselves. They're decoded live from then on
+// rather than being decoded in full again on every Start().
+
+inline std::set<GIFIdentifier>& UncacheableGIFs()
+{
+    static std::set<GIFIdentifier> gifs;
+    return gifs;
+}
+
 inline allocated_unique_ptr<GifDecoder<MATRIX_WIDTH, MATRIX_HEIGHT, 16, true>>& SharedGIFDecoder()
 {
     static allocated_unique_ptr<GifDecoder<MATRIX_WIDTH, MATRIX_HEIGHT, 16, true>> decoder =
@@ -166,6 +199,11 @@ class PatternAnimatedGIF : public EffectWithId<PatternAnimatedGIF>
     bool _preClear           = false;
     bool _gifReadyToDraw     = false;
 
+    std::weak_ptr<const GIFFrameCache> _frameCache;
+    bool _useFrameCache      = false;
+    size_t _cachedFrame      = 0;
+    bool _rowContiguous      = false;
+
     // GIF decoder callbacks.  These are static because the decoder doesn't allow you to pass any context, so they
     // have to be global.  We use the global g_gifDecoderState to track state.  The GifDecoder code calls back to
     // these callbacks to do the actual work of plotting them on the LED matrix.
@@ -174,15 +212,26 @@ class PatternAnimatedGIF : public EffectWithId<PatternAnimatedGIF>
 
     static void screenClearCallback(void)
     {
+        if (SharedGIFDecoderState()._capture)
+        {
+            SharedGIFDecoderState()._capture->NoteClear();
+            return;
+        }
+
         auto& g = g_ptrSystem->GetEffectManager().g();
         g.Clear(SharedGIFDecoderState()._bkColor);
     }
 
-    // We decide when to update the screen, so this is a no-op
+    // We decide when to update the screen, so this is a no-op - except that it marks the end of
+    // each decoded image, which is where a frame cache being built closes off a frame
 
     static void updateScreenCallback(void)
     {
         debugV("UpdateScreenCallback from AnimatedGIF decoder.");
+
+        auto& state = SharedGIFDecoderState();
+        if (state._capture && !state._capture->EndFrame())
+            state._captureFailed = true;
     }
 
     // drawPixelCallback
@@ -191,11 +240,20 @@ class PatternAnimatedGIF : public EffectWithId<PatternAnimatedGIF>
 
     static void drawPixelCallback(int16_t x, int16_t y, uint8_t red, uint8_t green, uint8_t blue)
     {
+        auto& state = SharedGIFDecoderState();
+
+        if (state._capture)
+        {
+            // The cache holds the scaled image only; the offset is applied when it's played back
+            state._capture->Plot((int)(x * state._scaleX), (int)(y * state._scaleY), CRGB(red, green, blue));
+            return;
+        }
+
         auto& g = g_ptrSystem->GetEffectManager().g(0);
 
         // Apply scaling transformation
-        int16_t scaledX = (int16_t)(x * SharedGIFDecoderState()._scaleX) + SharedGIFDecoderState()._offsetX;
-        int16_t scaledY = (int16_t)(y * SharedGIFDecoderState()._scaleY) + SharedGIFDecoderState()._offsetY;
+        int16_t scaledX = (int16_t)(x * state._scaleX) + state._offsetX;
+        int16_t scaledY = (int16_t)(y * state._scaleY) + state._offsetY;
 
         if (false == g.isValidPixel(scaledX, scaledY))
         {
@@ -210,14 +268,104 @@ class PatternAnimatedGIF : public EffectWithId<PatternAnimatedGIF>
 
     // drawLineCallback
     //
-    // This is called by the GIF decoder to draw a line of pixels.
+    // This is called by the GIF decoder to draw a line of palette-indexed pixels, with the palette in RGB565 and
+    // skip being the transparent index.  Our decoder configuration plots pixel by pixel, but if a line does come
+    // through we expand it and send it down the same path.
 
     static void drawLineCallback(int16_t x, int16_t y, uint8_t *buf, int16_t w, uint16_t *palette, int16_t skip)
     {
-        // I don't think this is ever called, but if it is, we may need to implement it.  For now, it seems they just
-        // call drawPixelCallback for each pixel in the image.
+        for (int16_t i = 0; i < w; i++)
+        {
+            if (buf[i] == skip)
+                continue;
+
+            const CRGB color = GFXBase::from16Bit(palette[buf[i]]);
+            drawPixelCallback(x + i, y, color.r, color.g, color.b);
+        }
+    }
+
+    // BuildFrameCache
+    //
+    // Decodes every image in the GIF once, with the callbacks plotting into a GIFFrameCache at the scaled size.
+    // The image count comes from walking the file, since the decoder quietly loops back to the start at the end.
+    // Returns nullptr, leaving the decoder to be restarted for live playback, if the GIF won't cache in maxBytes.
+
+    static std::shared_ptr<const GIFFrameCache> BuildFrameCache(const GIFInfo& gif, size_t maxBytes)
+    {
+        const size_t frameCount = GIFFrameCache::CountFrames(gif.contents, gif.length);
+        if (frameCount == 0)
+            return nullptr;
+
+        auto& state = SharedGIFDecoderState();
+        auto cache = std::make_shared<GIFFrameCache>(state._dstWidth, state._dstHeight, maxBytes);
+
+        SharedGIFDecoder()->setScreenClearCallback( screenClearCallback );
+        SharedGIFDecoder()->setUpdateScreenCallback( updateScreenCallback );
+        SharedGIFDecoder()->setDrawPixelCallback( drawPixelCallback );
+        SharedGIFDecoder()->setDrawLineCallback( drawLineCallback );
+
+        state._capture = cache.get();
+        state._captureFailed = false;
+
+        bool ok = (ERROR_NONE == SharedGIFDecoder()->startDecoding((uint8_t *) gif.contents, gif.length));
+
+        // Each decoded image ends with updateScreenCallback closing one cache frame; the extra calls allowed here
+        // only cover a decoder that reports it has nothing new on a call
+
+        for (size_t calls = 0; ok && cache->FrameCount() < frameCount && calls < frameCount * 2; calls++)
+            ok = SharedGIFDecoder()->decodeFrame(false) >= 0 && !state._captureFailed;
+
+        state._capture = nullptr;
+
+        if (!ok || cache->FrameCount() != frameCount)
+        {
+            debugW("GIF frame cache not used: captured %zu of %zu frames", cache->FrameCount(), frameCount);
+            return nullptr;
+        }
+
+        cache->FinishCapture();
+        debugI("GIF frame cache: %zu frames at %dx%d in %zu bytes", frameCount, (int)state._dstWidth, (int)state._dstHeight, cache->Bytes());
+        return cache;
+    }
+
+    // FrameCacheFor
+    //
+    // The cached frames for a GIF, building them on first use. A new cache is first built in whatever budget
+    // the others leave; if it doesn't fit there they're dropped and it gets one try with the whole budget, and
+    // a GIF that fails that is remembered so it isn't decoded in full again on its next Start().
+
+    static std::weak_ptr<const GIFFrameCache> FrameCacheFor(GIFIdentifier gifIndex, const GIFInfo& gif)
+    {
+        auto& caches = GIFFrameCaches();
+        auto existing = caches.find(gifIndex);
+        if (existing != caches.end())
+            return existing->second;
 
-        throw new std::runtime_error("drawLineCallback not implemented for animated GIFs");
+        if (UncacheableGIFs().count(gifIndex))
+            return {};
+
+        size_t cachedBytes = 0;
+        for (const auto& entry : caches)
+            cachedBytes += entry.second->Bytes();
+
+        std::shared_ptr<const GIFFrameCache> cache;
+        if (cachedBytes < GIF_FRAME_CACHE_BYTES)
+            cache = BuildFrameCache(gif, GIF_FRAME_CACHE_BYTES - cachedBytes);
+
+        if (!cache && !caches.empty())
+        {
+            caches.clear();
+            cache = BuildFrameCache(gif, GIF_FRAME_CACHE_BYTES);
+        }
+
+        if (!cache)
+        {
+            UncacheableGIFs().insert(gifIndex);
+            return {};
+        }
+
+        caches.emplace(gifIndex, cache);
+        return cache;
     }
 
     // For slower animations that run at a lower framerate, we double the framerate by discarding every other frame,
@@ -320,6 +468,20 @@ public:
         SharedGIFDecoderState()._dstWidth  = dstWidth;
         SharedGIFDecoderState()._dstHeight = dstHeight;
 
+        #if ENABLE_GIF_FRAME_CACHE
+            _frameCache = FrameCacheFor(_gifIndex, gif->second);
+            if (auto cache = _frameCache.lock())
+            {
+                _useFrameCache  = true;
+                _cachedFrame    = 0;
+                _rowContiguous  = cache->IsRowContiguous(g(), offsetX, offsetY);
+                _gifReadyToDraw = true;
+                return;
+            }
+        #endif
+
+        _useFrameCache = false;
+
         // Set the GIF decoder callbacks to our static functions
 
         SharedGIFDecoder()->setScreenClearCallback( screenClearCallback );
@@ -352,8 +514,22 @@ public:
         if (_preClear)
             g().Clear(_bkColor);
 
-        if (_gifReadyToDraw)
+        if (_useFrameCache)
+        {
+            // Another GIF's Start() may have dropped our frames to make room; then there's nothing to draw
+            // until we're started again and rebuild them
+
+            if (auto cache = _frameCache.lock())
+            {
+                const auto& state = SharedGIFDecoderState();
+                cache->DrawFrame(_cachedFrame, g(), state._offsetX, state._offsetY, _bkColor, _rowContiguous);
+                _cachedFrame = (_cachedFrame + 1) % cache->FrameCount();
+            }
+        }
+        else if (_gifReadyToDraw)
+        {
             SharedGIFDecoder()->decodeFrame(false);
+        }
 
     }
 };
@@ -62,18 +62,15 @@
 #ifndef PatternCube_H
 #define PatternCube_H
 
-#include <algorithm>
-#include <cmath>
-#include <iterator>
-
-#include "Geometry.h"
+#include "mesh3d.h"
 
 // Description:
 // This file defines the PatternCube class, a subclass of LEDStripEffect.
 // The class implements a 3D rotating cube effect on an LED matrix. It
 // features customizable parameters for cube dimensions, rotation angles,
 // focal length of the camera, and positioning. The cube is constructed,
-// rotated, and projected onto a 2D plane for display.
+// rotated, and projected onto a 2D plane for display by Mesh3D, in fixed
+// point throughout.
 //
 // Key Features:
 // - 3D Cube rendering with adjustable size and rotation speed.
@@ -86,122 +83,15 @@
 class PatternCube : public EffectWithId<PatternCube>
 {
   private:
-    float focal = 30;   // Base focal of the camera (for 32px tile). We'll scale this dynamically to fit the display.
-    int cubeWidth = 28; // Cube size
-    float Angx = 20.0, AngxSpeed = 0.05; // rotation (angle+speed) around X-axis
-    float Angy = 10.0, AngySpeed = 0.05; // rotation (angle+speed) around Y-axis
-    float Ox = 15.5, Oy = 15.5;          // position (x,y) of the frame center
-    int zCamera = 110;                   // distance from cube to the eye of the camera
-
-    // Local vertices
-    Vertex local[8];
-    // Camera aligned vertices
-    Vertex aligned[8];
-    // On-screen projected vertices
-    Point screen[8];
-    // Faces
-    squareFace face[6];
-    // Edges
-    EdgePoint edge[12];
-    uint32_t nbEdges;
-    // ModelView matrix
-    float m00, m01, m02, m10, m11, m12, m20, m21, m22;
-
-    // constructs the cube
-    void make(int w)
-    {
-        nbEdges = 0;
+    static constexpr int kFocal = 30;       // Base focal of the camera (for 32px tile). We'll scale this dynamically to fit the display.
+    static constexpr int kCubeWidth = 28;   // Cube size
 
-        local[0].set(-w,  w,  w);
-        local[1].set( w,  w,  w);
-        local[2].set( w, -w,  w);
-        local[3].set(-w, -w,  w);
-        local[4].set(-w,  w, -w);
-        local[5].set( w,  w, -w);
-        local[6].set( w, -w, -w);
-        local[7].set(-w, -w, -w);
+    // Rotation angles around the X and Y axes in sin16() units; these are the 20 and 10 radians the
+    // float version started from
+    uint16_t Angx = 11999;
+    uint16_t Angy = 38769;
 
-        face[0].set(1, 0, 3, 2);
-        face[1].set(0, 4, 7, 3);
-        face[2].set(4, 0, 1, 5);
-        face[3].set(4, 5, 6, 7);
-        face[4].set(1, 2, 6, 5);
-        face[5].set(2, 3, 7, 6);
-
-        for (auto& f : face)
-        {
-            for (uint32_t i = 0; i < f.length; i++)
-            {
-                f.ed[i] = findEdge(f.sommets[i], f.sommets[i ? i - 1 : f.length - 1]);
-            }
-        }
-    }
-
-    // finds edges from faces
-    uint32_t findEdge(int a, int b)
-    {
-        for (uint32_t i = 0; i < nbEdges; i++)
-        {
-            if ((edge[i].x == a && edge[i].y == b) || (edge[i].x == b && edge[i].y == a))
-            {
-                return i;
-            }
-        }
-
-        edge[nbEdges++].set(a, b);
-        return nbEdges - 1;
-    }
-
-    // rotates according to angle x&y
-    // Rotate and project with effective center and focal length (allows dynamic scaling to tile size)
-    void rotate(float angx, float angy, float OxEff, float OyEff, float focalEff)
-    {
-        const float cx = cosf(angx);
-        const float sx = sinf(angx);
-        const float cy = cosf(angy);
-        const float sy = sinf(angy);
-
-        m00 = cy;
-        m01 = 0;
-        m02 = -sy;
-        m10 = sx * sy;
-        m11 = cx;
-        m12 = sx * cy;
-        m20 = cx * sy;
-        m21 = -sx;
-        m22 = cx * cy;
-
-        for (uint32_t i = 0; i < 8; i++)
-        {
-            aligned[i].x = m00 * local[i].x + m01 * local[i].y + m02 * local[i].z;
-            aligned[i].y = m10 * local[i].x + m11 * local[i].y + m12 * local[i].z;
-            aligned[i].z = m20 * local[i].x + m21 * local[i].y + m22 * local[i].z + zCamera;
-
-            screen[i].x = floorf(OxEff + focalEff * aligned[i].x / aligned[i].z);
-            screen[i].y = floorf(OyEff - focalEff * aligned[i].y / aligned[i].z);
-        }
-
-        for (auto &e : edge)
-        {
-            e.visible = false;
-        }
-
-        for (const auto &f : face)
-        {
-            const Point *pa = &screen[f.sommets[0]];
-            const Point *pb = &screen[f.sommets[1]];
-            const Point *pc = &screen[f.sommets[2]];
-
-            const bool back = ((pb->x - pa->x) * (pc->y - pa->y) - (pb->y - pa->y) * (pc->x - pa->x)) < 0;
-            if (!back)
-            {
-                for (uint32_t j = 0; j < 4; j++)
-                {
-                    edge[f.ed[j]].visible = true;
-                }
-            }
-        }
-    }
+    Mesh3D cube = Mesh3D::Cube(kCubeWidth);
 
     uint8_t hue = 0;
     int step = 0;
@@ -216,80 +106,34 @@ class PatternCube : public EffectWithId<PatternCube>
         return false;
     }
 
-    void construct()
-    {
-        make(cubeWidth);
-    }
-
   public:
-    PatternCube() : EffectWithId<PatternCube>("Cubes")
-    {
-      construct();
-    }
-
-    PatternCube(const JsonObjectConst& jsonObject) : EffectWithId<PatternCube>(jsonObject)
-    {
-      construct();
-    }
+    PatternCube() : EffectWithId<PatternCube>("Cubes") {}
+    PatternCube(const JsonObjectConst& jsonObject) : EffectWithId<PatternCube>(jsonObject) {}
 
     void Draw() override
     {
         g().Clear();
-        zCamera = (int)beatsin8(2, 100, 140);
-        AngxSpeed = beatsin8(3, 3, 10) / 100.0f;
-        AngySpeed = g().beatcos8(5, 3, 10) / 100.0f;
+        const int16_t zCamera = beatsin8(2, 100, 140);    // distance from cube to the eye of the camera
 
-        // Update values
-        Angx += AngxSpeed;
-        Angy += AngySpeed;
+        // Rotation speeds were hundredths of a radian per frame
+        Angx += beatsin8(3, 3, 10) * Mesh3D::kAnglePerRadian / 100;
+        Angy += g().beatcos8(5, 3, 10) * Mesh3D::kAnglePerRadian / 100;
 
-        if (Angx >= TWO_PI)
-        {
-            Angx -= TWO_PI;
-        }
-
-        if (Angy >= TWO_PI)
-        {
-            Angy -= TWO_PI;
-        }
-
-        // Determine tile size (the smaller of matrix width and height)
-        const int tileSize = (MATRIX_WIDTH < MATRIX_HEIGHT ? MATRIX_WIDTH : MATRIX_HEIGHT);
-        const float scale = (tileSize <= 0) ? 1.0f : (float)tileSize / 32.0f; // 32 was the original design tile
-
-        // Scale the projection center and focal to the current tile size
-        const float OxEff = ((Ox + 0.5f) * scale) - 0.5f; // keep subpixel bias consistent with original 15.5@32px
-        const float OyEff = ((Oy + 0.5f) * scale) - 0.5f;
-        const float focalEff = focal * scale;
+        // Determine tile size (the smaller of matrix width and height), and scale the projection center
+        // and focal to it from the original 32px design tile, whose center was 15.5
+        const int tileSize = std::max(std::min(MATRIX_WIDTH, MATRIX_HEIGHT), 1);
+        const int32_t center = tileSize * Mesh3D::kOne / 2 - Mesh3D::kOne / 2;
+        const int32_t focal = kFocal * tileSize * Mesh3D::kOne / 32;
 
-        rotate(Angx, Angy, OxEff, OyEff, focalEff);
+        cube.Project(Angx, Angy, zCamera, focal, center, center);
 
         // Draw as many cubes as will fit horizontally, stepping by the smaller dimension
-        for (uint32_t xOffset = 0; (int)xOffset < MATRIX_WIDTH; xOffset += tileSize)
+        for (int xOffset = 0; xOffset < MATRIX_WIDTH; xOffset += tileSize)
         {
-            CRGB color = g().ColorFromCurrentPalette(hue + 64 + xOffset);
-
-            // Backface - Drawn first to ensure they are behind frontfaces (Painter's Algorithm)
-            for (const auto &e : edge)
-            {
-                if (!e.visible)
-                {
-                    g().BresenhamLine(screen[e.x].x + xOffset, screen[e.x].y, screen[e.y].x + xOffset,
-                                       screen[e.y].y, color);
-                }
-            }
-
-            color = g().ColorFromCurrentPalette(hue + 128 + xOffset);
-
-            // Frontface - Drawn second to overlap backfaces correctly
-            for (const auto &e : edge)
-            {
-                if (e.visible)
-                {
-                    g().BresenhamLine(screen[e.x].x + xOffset, screen[e.x].y, screen[e.y].x + xOffset,
-                                       screen[e.y].y, color);
-                }
-            }
+            // Backface first, so the frontface is drawn over it (Painter's Algorithm)
+            cube.DrawEdges(g(), xOffset, 0,
+                           g().ColorFromCurrentPalette(hue + 64 + xOffset),
+                           g().ColorFromCurrentPalette(hue + 128 + xOffset));
 
             step++;
             if (step == 8)
@@ -64,12 +64,7 @@
 #ifndef PatternLife_H
 #define PatternLife_H
 
-#include <bitset>
-
-extern "C"
-{
-    #include "uzlib/src/uzlib.h"
-}
+#include "lifeboard.h"
 
 // Introduction:
 // -------------
@@ -110,32 +105,26 @@ extern "C"
 //
 // Performance Considerations:
 // ---------------------------
-// 1. Memory Efficiency: The implementation uses efficient data structures to store the state of each cell,
-//    minimizing memory usage.
-// 2. Speed Optimization: The update and render methods are optimized for speed to allow for a fluid
-//    visualization on the LED matrix.
+// 1. Memory Efficiency: The life state is a LifeBoard, one bit per cell per generation.  The hue and brightness
+//    each cell is drawn with live in a separate fade layer of a byte apiece.
+// 2. Speed Optimization: LifeBoard computes a generation 32 cells at a time, and hashes it as it goes for the
+//    loop checks, so the per-cell work left here is drawing and fading.
 //
 
-class Cell
-{
-public:
-  uint8_t alive : 1;
-  uint8_t prev  : 1;
-  uint8_t hue;
-  uint8_t brightness;
-};
-
-// We check for loops by keeping a number of hashes of previous frames.  A walker that goes up and across
-// the screen cycles every 2 times it crosses, so max dimension times 2 is a good place to start
+// We check for loops by keeping the hashes of a number of previous generations.  A walker that goes up and
+// across the screen cycles every 2 times it crosses, so max dimension times 2 is a good place to start
 
-constexpr auto CRC_LENGTH = (std::max(MATRIX_HEIGHT, MATRIX_WIDTH) * 4 + 1);
+constexpr auto LIFE_HASH_HISTORY = (std::max(MATRIX_HEIGHT, MATRIX_WIDTH) * 4);
 
 class PatternLife : public EffectWithId<PatternLife>
 {
 private:
-    allocated_unique_ptr<Cell [][MATRIX_HEIGHT]> world;
-    allocated_unique_ptr<uint32_t []> checksums;
-    int iChecksum = 0;
+    std::unique_ptr<LifeBoard> board;
+    allocated_unique_ptr<uint8_t []> hues;              // Fade layer, row by row like the board
+    allocated_unique_ptr<uint8_t []> brightness;
+    std::array<uint32_t, LIFE_HASH_HISTORY> hashes;     // Ring of the hashes of the last generations
+    size_t iHash = 0;
+    size_t cHashes = 0;
     uint32_t bStuckInLoop = 0;
     unsigned int density = 50;
     int cGeneration = 0;
@@ -146,11 +135,12 @@ private:
     {
         LEDStripEffect::Init(gfx);
 
-        // Note: placing the world in PSRAM may slow this effect down, but it's currently running
-        //       fast enough (30+ fps) that we can afford to use it
+        // The board is small enough to keep in internal RAM, where the generation step is fastest.  The fade
+        // layer is two bytes a cell and only touched once per cell per frame, so it can live in PSRAM.
 
-        world = make_unique_psram<Cell[][MATRIX_HEIGHT]>(MATRIX_WIDTH);
-        checksums = make_unique_psram<uint32_t[]>(CRC_LENGTH);
+        board = std::make_unique<LifeBoard>(MATRIX_WIDTH, MATRIX_HEIGHT);
+        hues = make_unique_psram<uint8_t[]>(MATRIX_WIDTH * MATRIX_HEIGHT);
+        brightness = make_unique_psram<uint8_t[]>(MATRIX_WIDTH * MATRIX_HEIGHT);
 
         return true;
     }
@@ -204,35 +194,53 @@ private:
             debugV("Randomized Seed: %lu", seed);
         }
 
+        // Filled column by column, which is the order the baked in seeds were found with
+
         srand(seed);
+        board->Clear();
         for (int i = 0; i < MATRIX_WIDTH; i++) {
             for (int j = 0; j < MATRIX_HEIGHT; j++) {
-                if ((rand() % 100) < density) {
-                    world[i][j].alive = 1;
-                    world[i][j].brightness = 128;
-                }
-                else {
-                    world[i][j].alive = 0;
-                    world[i][j].brightness = 0;
-                }
-                world[i][j].prev = world[i][j].alive;
-                world[i][j].hue = 0;
+                const bool alive = (rand() % 100) < density;
+                board->Set(i, j, alive);
+                brightness[j * MATRIX_WIDTH + i] = alive ? 128 : 0;
+                hues[j * MATRIX_WIDTH + i] = 0;
             }
         }
-
-        for (int i = 0; i < CRC_LENGTH; i++)
-            checksums[i] = 0xFFFFFFF;
     }
 
-    int neighbours(int x, int y) {
-        return (world[(x + 1) % MATRIX_WIDTH][y].prev) +
-            (world[x][(y + 1) % MATRIX_HEIGHT].prev) +
-            (world[(x + MATRIX_WIDTH - 1) % MATRIX_WIDTH][y].prev) +
-            (world[x][(y + MATRIX_HEIGHT - 1) % MATRIX_HEIGHT].prev) +
-            (world[(x + 1) % MATRIX_WIDTH][(y + 1) % MATRIX_HEIGHT].prev) +
-            (world[(x + MATRIX_WIDTH - 1) % MATRIX_WIDTH][(y + 1) % MATRIX_HEIGHT].prev) +
-            (world[(x + MATRIX_WIDTH - 1) % MATRIX_WIDTH][(y + MATRIX_HEIGHT - 1) % MATRIX_HEIGHT].prev) +
-            (world[(x + 1) % MATRIX_WIDTH][(y + MATRIX_HEIGHT - 1) % MATRIX_HEIGHT].prev);
+    // Fades the dead, lights up the newborn and blanks the newly dead, going by how the last step changed
+    // the board
+
+    void updateFadeLayer()
+    {
+        for (int y = 0; y < MATRIX_HEIGHT; y++)
+        {
+            const LifeBoard::Word* now = board->Row(y);
+            const LifeBoard::Word* before = board->PreviousRow(y);
+            uint8_t* rowHues = &hues[y * MATRIX_WIDTH];
+            uint8_t* rowBrightness = &brightness[y * MATRIX_WIDTH];
+
+            for (int x = 0; x < MATRIX_WIDTH; x++)
+            {
+                const int w = x / LifeBoard::kWordBits;
+                const LifeBoard::Word bit = LifeBoard::Word(1) << (x % LifeBoard::kWordBits);
+
+                if (before[w] & bit)
+                {
+                    if (!(now[w] & bit))
+                        rowBrightness[x] = 0;               // Cell dies
+                }
+                else if (now[w] & bit)
+                {
+                    rowHues[x] += 1;                        // A new cell is born
+                    rowBrightness[x] = 255;
+                }
+                else
+                {
+                    rowBrightness[x] = rowBrightness[x] * 3 / 4;
+                }
+            }
+        }
     }
 
 public:
@@ -243,8 +251,8 @@ public:
     void Reset()
     {
         randomFillWorld();
-        for (int i = 0; i < CRC_LENGTH; i++)
-            checksums[i] = 0xFFFFFFF;
+        iHash = 0;
+        cHashes = 0;
         cGeneration = 0;
         bStuckInLoop = 0;
     }
@@ -256,33 +264,26 @@ public:
 
         // Display current generation
 
-        for (int i = 0; i < MATRIX_WIDTH; i++) {
-            for (int j = 0; j < MATRIX_HEIGHT; j++) {
-                if (world[i][j].brightness > 0)
-                    g().leds[XY(i, j)] += g().ColorFromCurrentPalette(world[i][j].hue * 4, world[i][j].brightness);
+        for (int j = 0; j < MATRIX_HEIGHT; j++) {
+            for (int i = 0; i < MATRIX_WIDTH; i++) {
+                const uint8_t cellBrightness = brightness[j * MATRIX_WIDTH + i];
+                if (cellBrightness > 0)
+                    g().leds[XY(i, j)] += g().ColorFromCurrentPalette(hues[j * MATRIX_WIDTH + i] * 4, cellBrightness);
                 else
                     g().leds[XY(i, j)] = CRGB::Black;
             }
         }
 
-        // We maintain a scrolling window of the last N crcs and if the current crc makes it all
-        // the way down to the bottom half we assume we're stuck in a loop and restart.
-        // We have to first extract the alive bits alone because we don't want the hue and brightness
-        // data to mess with the CRC.
+        // We keep the hashes of the last N generations, and if the current one is among them we assume
+        // we're stuck in a loop and restart.  The board hashes itself as it steps, and only holds the
+        // alive bits, so there's nothing to gather up first.
 
-        bool alive[MATRIX_WIDTH][MATRIX_HEIGHT];
-        for (int i = 0; i < MATRIX_WIDTH; i++)
-            for (int j = 0; j < MATRIX_HEIGHT; j++)
-                alive[i][j] = world[i][j].alive;
+        const uint32_t hash = board->Hash();
+        const bool seenBefore = std::find(hashes.begin(), hashes.begin() + cHashes, hash) != hashes.begin() + cHashes;
 
-        auto crc = uzlib_crc32(alive, sizeof(alive), 0xffffffff);
-        for (int i = 0; i < CRC_LENGTH - 1; i++)
-            checksums[i] = checksums[i+1];
-        checksums[CRC_LENGTH - 1] = crc;
-
-
-        // Look for any occurrences of the current CRC in the first half of the window, which would mean
-        // a loop has occurred.  If
+        hashes[iHash] = hash;
+        iHash = (iHash + 1) % hashes.size();
+        cHashes = std::min(cHashes + 1, hashes.size());
 
         if (bStuckInLoop)
         {
@@ -297,58 +298,21 @@ public:
             }
             g().DimAll(255 - 255*elapsed/resetTime);
 
-            for (int x = 0; x < MATRIX_WIDTH; x++)
-                for (int y = 0; y < MATRIX_HEIGHT; y++)
-                        world[x][y].brightness *= 0.9;
+            for (int i = 0; i < MATRIX_WIDTH * MATRIX_HEIGHT; i++)
+                brightness[i] *= 0.9;
             if (elapsed > resetTime)
                 Reset();
         }
-        else
+        else if (seenBefore)
         {
-            for (int i = CRC_LENGTH - 2; i >= 0; i--)
-            {
-                if (checksums[i] == crc)
-                {
-                    bStuckInLoop = millis();
-                    debugV("Seed: %10lu, Generations: %5d, %s", seed, cGeneration, cGeneration > 3000 ? "Y" : "N");
-                }
-                if (checksums[i] == 0xFFFFFFF)
-                    break;
-            }
+            bStuckInLoop = millis();
+            debugV("Seed: %10lu, Generations: %5d, %s", seed, cGeneration, cGeneration > 3000 ? "Y" : "N");
         }
 
         // Birth and death cycle
-        for (int x = 0; x < MATRIX_WIDTH; x++) {
-            for (int y = 0; y < MATRIX_HEIGHT; y++) {
-                // Default is for cell to stay the same
-                if (world[x][y].brightness > 0 && world[x][y].prev == 0)
-                  world[x][y].brightness *= 0.75;
-
-                int count = neighbours(x, y);
-                if (count == 3 && world[x][y].prev == 0) {
-                    // A new cell is born
-                    world[x][y].alive = 1;
-                    world[x][y].hue += 1;
-                    world[x][y].brightness = 255;
-                } else if ((count < 2 || count > 3) && world[x][y].prev == 1) {
-                    // Cell dies
-                    world[x][y].alive = 0;
-                    world[x][y].brightness = 0;
-                }
-            }
-        }
-
-        // Copy next generation into place
-
-        int cCount = 0;
 
-        for (int x = 0; x < MATRIX_WIDTH; x++) {
-            for (int y = 0; y < MATRIX_HEIGHT; y++) {
-                if (world[x][y].prev != world[x][y].alive)
-                    cCount++;
-                world[x][y].prev = world[x][y].alive;
-            }
-        }
+        board->Step();
+        updateFadeLayer();
 
         cGeneration++;
     }
@@ -151,7 +151,6 @@ class PatternPongClock : public EffectWithId<PatternPongClock>
         // Render HH:MM using Adafruit_GFX font via GFXBase
         g().setFont(&Apple5x7);
         g().setTextWrap(false);
-        g().setTextColor(WHITE16);
 
         // The compiler warns that with a nul terminator, 4 bytes could be needed; allocate 4
         char buffer[4];
@@ -164,15 +163,13 @@ class PatternPongClock : public EffectWithId<PatternPongClock>
         g().getTextBounds(buffer, 0, 0, &bx, &by, &bw, &bh);
         int16_t hoursX = (MATRIX_WIDTH / 2) - 2 - bw;
         int16_t baselineY = bh+2; // draw so the text's top is near y=0
-        g().setCursor(hoursX, baselineY);
-        g().print(buffer);
+        g().DrawCachedText(buffer, hoursX, baselineY, WHITE16);
 
         // Minutes (right side)
         sprintf(buffer, "%02d", mins);
         g().getTextBounds(buffer, 0, 0, &bx, &by, &bw, &bh);
         int16_t minsX = (MATRIX_WIDTH / 2) + 2;
-        g().setCursor(minsX, baselineY);
-        g().print(buffer);
+        g().DrawCachedText(buffer, minsX, baselineY, WHITE16);
 
         // if restart flag is 1, set up a new game
         if (restart)
@@ -16,6 +16,7 @@ class PatternSMFlowFields : public EffectWithId<PatternSMFlowFields>
     const int COLS = MATRIX_WIDTH;
     const int ROWS = MATRIX_HEIGHT;
     static const int NUM_PARTICLES = 40;
+    static const int QUALITY_LEVELS = 4;            // Each level down draws a quarter fewer particles
     std::array<Boid, NUM_PARTICLES> boids;
 
     uint16_t x;
@@ -44,10 +45,18 @@ class PatternSMFlowFields : public EffectWithId<PatternSMFlowFields>
         }
     }
 
+    uint8_t QualityLevels() const override
+    {
+        return QUALITY_LEVELS;
+    }
+
     void Draw() override
     {
-        for (auto &boid : boids)
+        const int activeParticles = NUM_PARTICLES * (QualityLevel() + 1) / QUALITY_LEVELS;
+
+        for (int i = 0; i < activeParticles; i++)
         {
+            auto &boid = boids[i];
             int ioffset = scale * boid.location.x;
             int joffset = scale * boid.location.y;
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+
 #include "effectmanager.h"
 
 // Derived from https://wokwi.com/projects/289218075224441356
@@ -10,19 +12,55 @@ class PatternSMMetaBalls : public EffectWithId<PatternSMMetaBalls>
 {
   private:
 
-    uint8_t bx[5];
-    uint8_t by[5];
+    static constexpr int kBallCount = 5;
+    static constexpr int kStrength  = 220;                      // A ball's own pixel gets this much
+
+    // A ball adds kStrength / sqrt16(d2 + 1) to a pixel d2 away (squared), which falls to nothing once the
+    // root passes kStrength.  The table is cut off there or at the farthest a ball can be on this panel.
+    static constexpr int kSupport   = (kStrength + 1) * (kStrength + 1) - 1;
+    static constexpr int kMaxDist2  = (MATRIX_WIDTH - 1) * (MATRIX_WIDTH - 1) + (MATRIX_HEIGHT - 1) * (MATRIX_HEIGHT - 1);
+    static constexpr int kFalloffSize = std::min(kSupport, kMaxDist2 + 1);
+
+    uint8_t bx[kBallCount];
+    uint8_t by[kBallCount];
+
+    allocated_unique_ptr<uint8_t[]> _falloff;                   // Indexed by squared distance
+    uint8_t _rowSum[MATRIX_WIDTH];
+
+    void BuildFalloff()
+    {
+        _falloff = make_unique_psram<uint8_t[]>(kFalloffSize);
+        if (!_falloff)
+        {
+            debugE("Could not allocate falloff table for MetaBalls");
+            return;
+        }
+
+        for (int d2 = 0; d2 < kFalloffSize; d2++)
+            _falloff[d2] = kStrength / sqrt16(d2 + 1);
+    }
+
+    // AccumulateBall
+    //
+    // Adds one ball's field along row y.  Only the columns inside the ball's support are visited; with the
+    // saturating add, the order the balls are summed in makes no difference to the result.
 
-    uint8_t dist(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
+    void AccumulateBall(int ballX, int ballY, int y, int width)
     {
-        int a = y2 - y1;
-        int b = x2 - x1;
-        a *= a;
-        b *= b;
-        //    uint8_t dist = 220 / (sqrt16(a + b) + 1);
-        // Avoid a div/0 crash.
-        uint8_t dist = 220 / (sqrt16(a + b + 1));
-        return dist;
+        const int dy2 = (y - ballY) * (y - ballY);
+        if (dy2 >= kFalloffSize)
+            return;
+
+        const int reach = sqrt16(kFalloffSize - 1 - dy2);       // Farthest column offset still in the table
+        const int left  = std::max(0, ballX - reach);
+        const int right = std::min(width - 1, ballX + reach);
+
+        const uint8_t* falloff = &_falloff[dy2];
+        for (int x = left; x <= right; x++)
+        {
+            const int dx = x - ballX;
+            _rowSum[x] = qadd8(_rowSum[x], falloff[dx * dx]);
+        }
     }
 
   public:
@@ -32,27 +70,38 @@ class PatternSMMetaBalls : public EffectWithId<PatternSMMetaBalls>
 
     void Start() override
     {
+        if (!_falloff)
+            BuildFalloff();
+
         g().Clear();
     }
 
     void Draw() override
     {
-        for (uint8_t a = 0; a < 5; a++)
+        // Start() couldn't get the table; nothing to draw the field with
+        if (!_falloff)
+            return;
+
+        for (uint8_t a = 0; a < kBallCount; a++)
         {
             bx[a] = beatsin8(15 + a * 2, 0, MATRIX_WIDTH - 1, 0, a * 32);
             by[a] = beatsin8(18 + a * 2, 0, MATRIX_HEIGHT - 1, 0, a * 32);
         }
-        for (unsigned i = 0; i < MATRIX_WIDTH - 1; i++)
+
+        // The last row and column are left to the blur, as they always have been
+        constexpr int width  = MATRIX_WIDTH - 1;
+        constexpr int height = MATRIX_HEIGHT - 1;
+
+        for (int y = 0; y < height; y++)
         {
-            for (unsigned j = 0; j < MATRIX_HEIGHT - 1; j++)
+            std::fill_n(_rowSum, width, 0);
+            for (int a = 0; a < kBallCount; a++)
+                AccumulateBall(bx[a], by[a], y, width);
+
+            for (int x = 0; x < width; x++)
             {
-                uint8_t sum = dist(i, j, bx[0], by[0]);
-                for (uint8_t a = 1; a < 5; a++)
-                {
-                    sum = qadd8(sum, dist(i, j, bx[a], by[a]));
-                }
                 // HeatColors2_p peaks with blue instead of white and looks nicer for this effect
-                g().leds[XY(i, j)] = ColorFromPalette(HeatColors2_p, sum + 220, 254, LINEARBLEND);
+                g().leds[XY(x, y)] = ColorFromPalette(HeatColors2_p, _rowSum[x] + kStrength, 254, LINEARBLEND);
             }
         }
 
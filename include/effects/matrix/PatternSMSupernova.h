@@ -24,12 +24,19 @@ public:
         g().Clear();
     }
 
+    uint8_t QualityLevels() const override
+    {
+        return QUALITY_LEVELS;
+    }
+
     void Draw() override
     {
         step = -1;
         g().DimAll(200);
 
-        for (auto& debris_item : _debris_items) {
+        const size_t activeItems = ActiveDebrisItems();
+        for (size_t i = 0; i < activeItems; i++) {
+            auto& debris_item = _debris_items[i];
             if (!debris_item._is_shift && step) {
                 StarfieldEmit(debris_item);
                 step -= 1;
@@ -78,8 +85,22 @@ private:
     uint8_t hue, hue2, step;
 
     static constexpr int DEBRIS_ITEM_COUNT = 200;
+    static constexpr int QUALITY_LEVELS = 4;        // Each level down keeps a quarter fewer debris items in flight
     std::array<DebrisItem, DEBRIS_ITEM_COUNT> _debris_items;
 
+    size_t ActiveDebrisItems() const
+    {
+        return DEBRIS_ITEM_COUNT * (QualityLevel() + 1) / QUALITY_LEVELS;
+    }
+
+    // Items dropped by a lower level start over when a higher one brings them back, rather than
+    // resuming from wherever they were frozen
+    void OnQualityLevelChanged(uint8_t) override
+    {
+        std::for_each(_debris_items.begin() + ActiveDebrisItems(), _debris_items.end(),
+                      [](DebrisItem& debris_item) { debris_item.Clear(); });
+    }
+
     // Fast Babylonian Approximate square root.
     // It's called one time in the constructor, so no need for
     // crazy optimization here.
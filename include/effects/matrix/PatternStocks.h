@@ -39,7 +39,6 @@
 
 #include <Arduino.h>
 #include <string.h>
-#include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include <algorithm>
 #include <chrono>
@@ -52,6 +51,7 @@
 
 #include "formatsize.h"
 #include "gfxfont.h"                // Adafruit GFX font structs
+#include "httpjsonclient.h"
 #include "systemcontainer.h"
 
 extern const GFXfont Apple5x7 PROGMEM;
@@ -132,9 +132,7 @@ class AnimatedText
     void Draw(GFXBase *g)
     {
         g->setFont(pfont);
-        g->setTextColor(g->to16bit(color));
-        g->setCursor(currentX, currentY);
-        g->print(text);
+        g->DrawCachedText(text, currentX, currentY, g->to16bit(color));
     }
 };
 
@@ -250,13 +248,14 @@ private:
 
     using StockDataCallback = function<void(const StockData&)>;
 
-    HTTPClient http;
+    std::map<String, HttpValidators> quoteValidators;   // Per symbol; guarded by stockDataMutex and cleared with stockData
 
-    void AddRealtimeQuoteKeyHeader()
+    HttpHeaders RealtimeQuoteKeyHeaders() const
     {
         const char * realtimeQuoteKey = cszRealtimeQuoteKey;
         if (realtimeQuoteKey != nullptr && realtimeQuoteKey[0] != '\0')
-            http.addHeader("X-Stockserver-Realtime-Key", realtimeQuoteKey);
+            return { { "X-Stockserver-Realtime-Key", realtimeQuoteKey } };
+        return {};
     }
 
     void NormalizeStockServer()
@@ -429,39 +428,38 @@ private:
 
     void GetQuote(const String &symbol, StockDataCallback callback = nullptr)
     {
-        http.begin("http://" + stockServer + "/?ticker=" + symbol + "&v=2&points=64");
-        AddRealtimeQuoteKeyHeader();
+        // Only ask for a 304 when there's a cached quote for it to stand for;
+        // otherwise a symbol whose quote was dropped would stay blank
+        HttpValidators validators;
+        {
+            std::lock_guard dataGuard(stockDataMutex);
+            if (stockData.count(symbol))
+                validators = quoteValidators[symbol];
+        }
+
+        auto doc = CreateJsonDocument();
+        const auto result = FetchJson("http://" + stockServer + "/?ticker=" + symbol + "&v=2&points=64",
+                                      doc, nullptr, &validators, RealtimeQuoteKeyHeaders());
 
-        int httpCode = http.GET();
-        if (httpCode == HTTP_CODE_OK)
+        // Unchanged quotes keep what we already have in stockData
+        if (result == HttpFetchResult::NotModified)
+            return;
+
+        if (result == HttpFetchResult::Ok)
         {
             debugD("HTTP GET OK");
-            String payload = http.getString(); // Get the response payload
-            auto doc = CreateJsonDocument();
-            DeserializationError error = deserializeJson(doc, payload);
-            debugV("JSON: %s", payload.c_str());
-
-            if (!error)
             {
-                StockData stockData = ParseQuoteV2(doc);
-                if (callback)
-                    callback(stockData); // Successful retrieval and parsing
-            }
-            else
-            {
-                debugE("Failed to parse JSON: %s\n", error.c_str());
-                if (callback)
-                    callback(StockData()); // Parsing error
+                std::lock_guard dataGuard(stockDataMutex);
+                quoteValidators[symbol] = validators;
             }
+            StockData stockData = ParseQuoteV2(doc);
+            if (callback)
+                callback(stockData); // Successful retrieval and parsing
         }
-        else
+        else if (callback)
         {
-            debugE("[HTTP] GET failed, error: %s\n", http.errorToString(httpCode).c_str());
-            if (callback)
-                callback(StockData()); // HTTP request error
+            callback(StockData()); // HTTP request or parsing error
         }
-
-        http.end(); // Close the connection properly
     }
 
     // GetAllQuotes
@@ -844,6 +842,7 @@ public:
                 tickerSymbols = value;
                 iCurrentStock = -1;
                 stockData.clear();
+                quoteValidators.clear();
                 lastCount = SIZE_MAX;
             }
             g_ptrSystem->GetNetworkReader().FlagReader(readerIndex);
@@ -122,6 +122,8 @@ class PatternSubscribers : public EffectWithId<PatternSubscribers>
         guidUpdated = false;
 
         HTTPClient http;
+        http.setConnectTimeout(HTTP_FETCH_TIMEOUT_MS);
+        http.setTimeout(HTTP_FETCH_TIMEOUT_MS);
 
         http.begin("http://tools.tastethecode.com/api/youtube-sight/" + youtubeChannelGuid);
         int httpResponseCode = http.GET();
@@ -130,9 +132,12 @@ class PatternSubscribers : public EffectWithId<PatternSubscribers>
         {
             debugW("Error fetching subscribers for channel %s (GUID %s)", youtubeChannelName.c_str(), youtubeChannelGuid.c_str());
             http.end();
+            return;
         }
 
+        // The response is a short CSV line, not JSON, so it's still read whole
         String response = http.getString();
+        http.end();
         int commaIndex = -1;
         int startIndex;
 
@@ -239,7 +244,9 @@ class PatternSubscribers : public EffectWithId<PatternSubscribers>
         if (!LEDStripEffect::Init(gfx))
             return false;
 
-        readerIndex = g_ptrSystem->GetNetworkReader().RegisterReader([this] { SubscriberReader(); }, SUB_READER_INTERVAL, true);
+        // Init() runs again after topology changes; the reader only needs registering once
+        if (readerIndex == SIZE_MAX)
+            readerIndex = g_ptrSystem->GetNetworkReader().RegisterReader([this] { SubscriberReader(); }, SUB_READER_INTERVAL, true);
 
         return true;
     }
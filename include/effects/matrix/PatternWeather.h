@@ -41,7 +41,6 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
-#include <HTTPClient.h>
 #include <map>
 #include <mutex>
 #include <string.h>
@@ -50,6 +49,7 @@
 
 #include "effects.h"
 #include "array_utils.h"
+#include "httpjsonclient.h"
 #include "systemcontainer.h"
 #include "TJpg_Decoder.h"
 #include "types.h"
@@ -156,6 +156,10 @@ class PatternWeather : public EffectWithId<PatternWeather>
     system_clock::time_point latestUpdate = system_clock::from_time_t(0);
     mutable std::mutex weatherDataMutex;
 
+    // Only touched from the reader, so not guarded by weatherDataMutex
+    HttpValidators weatherValidators;
+    HttpValidators forecastValidators;
+
     static constexpr int WeatherFontHeight = 7;
     static constexpr int WeatherFontWidth  = 5;
 
@@ -235,7 +239,6 @@ class PatternWeather : public EffectWithId<PatternWeather>
      */
     bool updateCoordinates()
     {
-        HTTPClient http;
         String url;
 
         const String configLocation = g_ptrSystem->GetDeviceConfig().GetLocation();
@@ -255,25 +258,24 @@ class PatternWeather : public EffectWithId<PatternWeather>
             url = "http://api.openweathermap.org/geo/1.0/direct"
                 "?q=" + urlEncode(configLocation) + "," + urlEncode(configCountryCode) + "&limit=1&appid=" + urlEncode(g_ptrSystem->GetDeviceConfig().GetOpenWeatherAPIKey());
 
-        http.begin(url);
-        int httpResponseCode = http.GET();
+        // The zip endpoint returns one object, the direct one an array of them
+        auto filter = CreateJsonDocument();
+        JsonObject filterFields = configLocationIsZip ? filter.to<JsonObject>() : filter[0].to<JsonObject>();
+        filterFields["lat"] = true;
+        filterFields["lon"] = true;
 
-        if (httpResponseCode <= 0)
+        auto doc = CreateJsonDocument();
+        if (FetchJson(url, doc, &filter) != HttpFetchResult::Ok)
         {
             debugE("Error fetching coordinates for location: %s", configLocation.c_str());
-            http.end();
             return false;
         }
 
-        auto doc = CreateJsonDocument();
-        deserializeJson(doc, http.getString());
         JsonObject coordinates = configLocationIsZip ? doc.as<JsonObject>() : doc[0].as<JsonObject>();
 
         String newLatitude = coordinates["lat"].as<String>();
         String newLongitude = coordinates["lon"].as<String>();
 
-        http.end();
-
         {
             std::lock_guard guard(weatherDataMutex);
             strLatitude = newLatitude;
@@ -295,7 +297,6 @@ class PatternWeather : public EffectWithId<PatternWeather>
      */
     bool getTomorrowTemps()
     {
-        HTTPClient http;
         String latitude;
         String longitude;
 
@@ -307,14 +308,23 @@ class PatternWeather : public EffectWithId<PatternWeather>
 
         String url = "http://api.openweathermap.org/data/2.5/forecast"
             "?lat=" + latitude + "&lon=" + longitude + "&cnt=16&appid=" + urlEncode(g_ptrSystem->GetDeviceConfig().GetOpenWeatherAPIKey());
-        http.begin(url);
-        int httpResponseCode = http.GET();
 
-        if (httpResponseCode > 0)
+        // Keep only what we read from each forecast slot
+        auto filter = CreateJsonDocument();
+        JsonObject slotFilter = filter["list"][0].to<JsonObject>();
+        slotFilter["dt"] = true;
+        slotFilter["main"]["temp_max"] = true;
+        slotFilter["main"]["temp_min"] = true;
+        slotFilter["weather"][0]["icon"] = true;
+
+        auto doc = CreateJsonDocument();
+        const auto result = FetchJson(url, doc, &filter, &forecastValidators);
+
+        if (result == HttpFetchResult::NotModified)
+            return true;
+
+        if (result == HttpFetchResult::Ok)
         {
-            // Needs to be this large to process all the returned JSON
-            auto doc = CreateJsonDocument();
-            deserializeJson(doc, http.getString());
             JsonArray list = doc["list"];
 
             // Get tomorrow's date
@@ -374,13 +384,11 @@ class PatternWeather : public EffectWithId<PatternWeather>
 
             debugI("Got tomorrow's temps: Lo %d, Hi %d, Icon %s", (int)newLoTomorrow, (int)newHighTomorrow, newIconTomorrow.c_str());
 
-            http.end();
             return true;
         }
         else
         {
             debugE("Error fetching forecast data for location: %s in country: %s", strLocation.c_str(), strCountryCode.c_str());
-            http.end();
             return false;
         }
     }
@@ -395,7 +403,6 @@ class PatternWeather : public EffectWithId<PatternWeather>
      */
     bool getWeatherData()
     {
-        HTTPClient http;
         String latitude;
         String longitude;
 
@@ -407,12 +414,22 @@ class PatternWeather : public EffectWithId<PatternWeather>
 
         String url = "http://api.openweathermap.org/data/2.5/weather"
             "?lat=" + latitude + "&lon=" + longitude + "&appid=" + urlEncode(g_ptrSystem->GetDeviceConfig().GetOpenWeatherAPIKey());
-        http.begin(url);
-        int httpResponseCode = http.GET();
-        if (httpResponseCode > 0)
+
+        auto filter = CreateJsonDocument();
+        filter["main"]["temp"] = true;
+        filter["main"]["temp_max"] = true;
+        filter["main"]["temp_min"] = true;
+        filter["weather"][0]["icon"] = true;
+        filter["name"] = true;
+
+        auto jsonDoc = CreateJsonDocument();
+        const auto result = FetchJson(url, jsonDoc, &filter, &weatherValidators);
+
+        if (result == HttpFetchResult::NotModified)
+            return true;
+
+        if (result == HttpFetchResult::Ok)
         {
-            auto jsonDoc = CreateJsonDocument();
-            deserializeJson(jsonDoc, http.getString());
 
             // Once we have a non-zero temp we can start displaying things
             bool newDataReady = 0 < jsonDoc["main"]["temp"];
@@ -441,13 +458,11 @@ class PatternWeather : public EffectWithId<PatternWeather>
 
             debugI("Got today's temps: Now %d Lo %d, Hi %d, Icon %s", (int)newTemperature, (int)newLoToday, (int)newHighToday, newIconToday.c_str());
 
-            http.end();
             return true;
         }
         else
         {
             debugE("Error fetching Weather data for location: %s in country: %s", strLocation.c_str(), strCountryCode.c_str());
-            http.end();
             return false;
         }
     }
@@ -562,8 +577,9 @@ public:
         if (!LEDStripEffect::Init(gfx))
             return false;
 
-        // Register a Network Reader task with no interval.  Will manually flag in Draw()
-        readerIndex = g_ptrSystem->GetNetworkReader().RegisterReader([this] { UpdateWeather(); });
+        // Register a Network Reader task with no interval, once even if Init() runs again.  Will manually flag in Draw()
+        if (readerIndex == SIZE_MAX)
+            readerIndex = g_ptrSystem->GetNetworkReader().RegisterReader([this] { UpdateWeather(); });
 
         return true;
     }
@@ -657,9 +673,7 @@ public:
         // Print the town/city name
         int x = 0;
         int y = WeatherFontHeight + 1;
-        g().setCursor(x, y);
-        g().setTextColor(WHITE16);
-        g().print(g().FitTextToWidth(locationText, screenWidth - 2 * WeatherFontWidth));
+        g().DrawCachedText(locationText, x, y, WHITE16, screenWidth - 2 * WeatherFontWidth);
 
         // Display the temperature, right-justified
 
@@ -667,9 +681,7 @@ public:
         {
             String strTemp((int)displayTemperature);
             x = std::max(0, screenWidth - WeatherFontWidth * static_cast<int>(strTemp.length()));
-            g().setCursor(x, y);
-            g().setTextColor(g().to16bit(CRGB(192,192,192)));
-            g().print(strTemp);
+            g().DrawCachedText(strTemp, x, y, g().to16bit(CRGB(192,192,192)));
         }
 
         // Draw the separator lines
@@ -688,17 +700,14 @@ public:
         const char * pszTomorrow = pszDaysOfWeek[ (todayTime->tm_wday + 1) % 7 ];
 
         // Draw the day of the week and tomorrow's day as well
-        g().setTextColor(WHITE16);
-        g().setCursor(0, screenHeight);
-        g().print(pszToday);
-        g().setCursor(xHalf+2, screenHeight);
-        g().print(pszTomorrow);
+        g().DrawCachedText(pszToday, 0, screenHeight, WHITE16);
+        g().DrawCachedText(pszTomorrow, xHalf+2, screenHeight, WHITE16);
 
         // Draw the temperature in lighter white
 
         if (displayDataReady)
         {
-            g().setTextColor(g().to16bit(CRGB(192,192,192)));
+            const uint16_t lightWhite = g().to16bit(CRGB(192,192,192));
             String strHi((int) displayHighToday);
             String strLo((int) displayLoToday);
 
@@ -706,12 +715,10 @@ public:
 
             x = std::max(0, xHalf - WeatherFontWidth * static_cast<int>(strHi.length()));
             y = screenHeight - WeatherFontHeight;
-            g().setCursor(x,y);
-            g().print(strHi);
+            g().DrawCachedText(strHi, x, y, lightWhite);
             x = std::max(0, xHalf - WeatherFontWidth * static_cast<int>(strLo.length()));
             y+= WeatherFontHeight;
-            g().setCursor(x,y);
-            g().print(strLo);
+            g().DrawCachedText(strLo, x, y, lightWhite);
 
             // Draw tomorrow's HI and LO temperatures
 
@@ -719,12 +726,10 @@ public:
             strLo = String((int)displayLoTomorrow);
             x = std::max(0, screenWidth - WeatherFontWidth * static_cast<int>(strHi.length()));
             y = screenHeight - WeatherFontHeight;
-            g().setCursor(x,y);
-            g().print(strHi);
+            g().DrawCachedText(strHi, x, y, lightWhite);
             x = std::max(0, screenWidth - WeatherFontWidth * static_cast<int>(strLo.length()));
             y+= WeatherFontHeight;
-            g().setCursor(x,y);
-            g().print(strLo);
+            g().DrawCachedText(strLo, x, y, lightWhite);
         }
     }
 };
@@ -12,6 +12,7 @@
 //
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 
 #include "ledstripeffect.h"
@@ -26,13 +27,70 @@ enum PixelOrder
     RightLeft = 16
 };
 
+// FanGeometry
+//
+// The directional orders only depend on where a pixel sits within its fan, so rather than redo the ring
+// arithmetic for every pixel of every frame, each order is laid out once, at compile time, as the offset
+// from the start of the fan for every position in it.
+
+namespace FanGeometry
+{
+    constexpr int kFanSize   = FAN_SIZE;
+    constexpr int kFanPixels = NUM_FANS * kFanSize;
+
+    using OrderTable = std::array<int16_t, kFanSize>;
+
+    constexpr int RingPixelPosition(int pos, int ringSize)
+    {
+        return (pos & 1) ? ringSize - 1 - pos / 2 : pos / 2;
+    }
+
+    constexpr OrderTable MakeOrderTable(int offset)
+    {
+        OrderTable table{};
+        for (int fanPos = 0; fanPos < kFanSize; fanPos++)
+            table[fanPos] = (RingPixelPosition(fanPos, RING_SIZE_0) + offset) % kFanSize;
+        return table;
+    }
+
+    inline constexpr OrderTable kBottomUp  = MakeOrderTable(LED_FAN_OFFSET_BU);
+    inline constexpr OrderTable kTopDown   = MakeOrderTable(LED_FAN_OFFSET_TD);
+    inline constexpr OrderTable kLeftRight = MakeOrderTable(LED_FAN_OFFSET_LR);
+    inline constexpr OrderTable kRightLeft = MakeOrderTable(LED_FAN_OFFSET_RL);
+
+    // The table for one of the directional orders, or nullptr for Sequential and Reverse, which need none
+    constexpr const OrderTable* GetOrderTable(PixelOrder order)
+    {
+        switch (order)
+        {
+            case BottomUp:  return &kBottomUp;
+            case TopDown:   return &kTopDown;
+            case LeftRight: return &kLeftRight;
+            case RightLeft: return &kRightLeft;
+            default:        return nullptr;
+        }
+    }
+}
+
+// RotateForward
+//
+// Rotations of a whole turn or more are reduced to what's left over, and a zero rotation doesn't touch the buffer
+
 inline void RotateForward(int iStart, int length = FAN_SIZE, int count = 1)
 {
+    count %= length;
+    if (count == 0)
+        return;
+
     std::rotate(&FastLED.leds()[iStart], &FastLED.leds()[iStart + count], &FastLED.leds()[iStart + length]);
 }
 
 inline void RotateReverse(int iStart, int length = FAN_SIZE, int count = 1)
 {
+    count %= length;
+    if (count == 0)
+        return;
+
     std::rotate(&FastLED.leds()[iStart], &FastLED.leds()[iStart + length - count], &FastLED.leds()[iStart + length]);
 }
 
@@ -63,11 +121,7 @@ inline int16_t GetRingPixelPosition(float fPos, int16_t ringSize)
         return 0;
     }
 
-    int pos = fPos;
-    if (pos & 1)
-        return ringSize - 1 - pos / 2;
-
-    return pos / 2;
+    return FanGeometry::RingPixelPosition(fPos, ringSize);
 }
 
 // Returns the sequential strip position for fan index + direction.
@@ -76,41 +130,28 @@ inline int GetFanPixelOrder(int iPos, PixelOrder order = Sequential)
     if (iPos < 0)
         debugW("Calling GetFanPixelOrder with negative index: %d", iPos);
 
-    while (iPos < 0)
-        iPos += FAN_SIZE;
+    if (iPos < 0)
+    {
+        iPos %= FanGeometry::kFanSize;
+        if (iPos < 0)
+            iPos += FanGeometry::kFanSize;
+    }
 
-    if (iPos >= NUM_FANS * FAN_SIZE)
+    if (iPos >= FanGeometry::kFanPixels)
     {
         if (order == TopDown)
-            return NUM_LEDS - 1 - (iPos - NUM_FANS * FAN_SIZE);
+            return NUM_LEDS - 1 - (iPos - FanGeometry::kFanPixels);
 
         return iPos;
     }
 
-    int fanPos = iPos % FAN_SIZE;
-    int fanBase = iPos - fanPos;
-
-    switch (order)
-    {
-        case BottomUp:
-            return fanBase + ((GetRingPixelPosition(fanPos, RING_SIZE_0) + LED_FAN_OFFSET_BU) % FAN_SIZE);
-
-        case TopDown:
-            return fanBase + ((GetRingPixelPosition(fanPos, RING_SIZE_0) + LED_FAN_OFFSET_TD) % FAN_SIZE);
-
-        case LeftRight:
-            return fanBase + ((GetRingPixelPosition(fanPos, RING_SIZE_0) + LED_FAN_OFFSET_LR) % FAN_SIZE);
+    const int fanPos = iPos % FanGeometry::kFanSize;
 
-        case RightLeft:
-            return fanBase + ((GetRingPixelPosition(fanPos, RING_SIZE_0) + LED_FAN_OFFSET_RL) % FAN_SIZE);
+    if (order == Reverse)
+        return NUM_LEDS - 1 - fanPos;
 
-        case Reverse:
-            return NUM_LEDS - 1 - fanPos;
-
-        case Sequential:
-        default:
-            return fanBase + fanPos;
-    }
+    const auto* table = FanGeometry::GetOrderTable(order);
+    return table ? iPos - fanPos + (*table)[fanPos] : iPos;
 }
 
 // Clears pixels logically into a fan bank in a selected direction.
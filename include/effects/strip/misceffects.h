@@ -281,12 +281,21 @@ class ColorFillEffect : public EffectWithId<ColorFillEffect>
 
     void Draw() override
     {
+        const CRGB color = (!_ignoreGlobalColor && g_ptrSystem->GetDeviceConfig().ApplyGlobalColors())
+                         ? g_ptrSystem->GetDeviceConfig().GlobalColor()
+                         : _color;
+
         if (_everyNth != 1)
           fillSolidOnAllChannels(CRGB::Black);
-        if (!_ignoreGlobalColor && g_ptrSystem->GetDeviceConfig().ApplyGlobalColors())
-          fillSolidOnAllChannels(g_ptrSystem->GetDeviceConfig().GlobalColor(), 0, NUM_LEDS, _everyNth);
-        else
-          fillSolidOnAllChannels(_color, 0, NUM_LEDS, _everyNth);
+        fillSolidOnAllChannels(color, 0, NUM_LEDS, _everyNth);
+
+        // We know exactly what we drew, so spare the power limiter its scan of the buffer
+        if (_everyNth > 0)
+        {
+            for (auto& device : _GFX)
+                if (device->GetLEDCount() == NUM_LEDS)
+                    device->SetFrameChannelSums(ChannelSums::Solid(color, (NUM_LEDS + _everyNth - 1) / _everyNth, NUM_LEDS));
+        }
     }
 };
 
@@ -70,10 +70,12 @@
 #include <array>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include "Adafruit_GFX.h"
 #include "crgbw.h"
 #include "pixeltypes.h"
+#include "powermodel.h"
 
 // Calculates a weight for anti-aliasing in Wu's algorithm.
 constexpr static inline uint8_t WU_WEIGHT(uint8_t a, uint8_t b)
@@ -160,6 +162,32 @@ protected:
     static constexpr int _heatColorsPaletteIndex = 6;
     static constexpr int _randomPaletteIndex = 9;
 
+    ChannelSums _frameSums;
+    bool _hasFrameSums = false;
+
+    // PixelLayout
+    //
+    // How xy() arranges the matrix in leds[], worked out on first use and again after a topology
+    // change. When rows or columns turn out to be contiguous, the blur, stream and move helpers
+    // hand whole lines to PixelKernels instead of going through XY() a pixel at a time.
+
+    enum class PixelLayout : uint8_t
+    {
+        Unknown,
+        RowMajor,               // xy(x, y) == y * width + x
+        ColumnMajor,            // xy(x, y) == x * height + y
+        ColumnSerpentine,       // As ColumnMajor, with odd columns running backwards
+        Irregular
+    };
+
+    mutable PixelLayout _pixelLayout = PixelLayout::Unknown;
+    mutable std::vector<CRGB> _lineScratch;
+
+    PixelLayout GetPixelLayout() const;
+
+    // Scratch space for at least count pixels, kept between calls
+    CRGB* LineScratch(size_t count) const;
+
 public:
     static const uint16_t kMatrixWidth = MATRIX_WIDTH;                                  // known working for actual matrix effects: 32, 64, 96, 128
     static const uint16_t kMatrixHeight = MATRIX_HEIGHT;                                // known working for actual matrix effects: 16, 32, 48, 64
@@ -281,8 +309,37 @@ public:
     void DrawTextInBand(const String& text, int bandTop, int bandHeight, const CRGB& color);
     void DrawTextInBand(const String& text, int bandTop, int bandHeight, CRGB::HTMLColorCode color);
 
+    // Draws text with the cursor at (x, y) in the current font and size, as setCursor() and print() would,
+    // from a strip rasterized once and cached rather than from the font's glyphs every frame.  A maxWidth
+    // that isn't negative first fits the text to it, as FitTextToWidth() does.
+    void DrawCachedText(const String& text, int x, int y, const CRGB& color, int maxWidth = -1);
+    void DrawCachedText(const String& text, int x, int y, uint16_t color, int maxWidth = -1);
+
     virtual void Clear(CRGB color = CRGB::Black);
 
+    // Frame channel sums
+    //
+    // An effect that knows exactly what it drew this frame (a solid fill, say) can hand the
+    // channel totals for all of leds[] to SetFrameChannelSums(), and the power limiter will use
+    // them instead of scanning the buffer. The render loop drops them at the start of every
+    // frame and whenever something else draws over the effect, so they never go stale.
+
+    void SetFrameChannelSums(const ChannelSums& sums)
+    {
+        _frameSums = sums;
+        _hasFrameSums = true;
+    }
+
+    void InvalidateFrameChannelSums()
+    {
+        _hasFrameSums = false;
+    }
+
+    const ChannelSums* GetFrameChannelSums() const
+    {
+        return _hasFrameSums ? &_frameSums : nullptr;
+    }
+
     __attribute__((always_inline))
     virtual bool isValidPixel(uint x, uint y) const noexcept
     {
@@ -0,0 +1,113 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        gifframecache.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    A pre-decoded animated GIF, already scaled to the size it is shown
+//    at. PatternAnimatedGIF runs the LZW decoder once over the whole file,
+//    feeding every plotted pixel into a GIFFrameCache, and from then on
+//    plays the cached frames back instead of decoding them again.
+//
+//    Each frame is stored row by row as runs: a run either skips pixels
+//    the GIF left untouched (transparency, or outside the frame's image
+//    rectangle) or fills them with one entry of a palette. Palettes hold
+//    up to 256 colors and are shared by consecutive frames until a frame
+//    needs a color that no longer fits. Playback is a handful of
+//    fill_solid() calls per row on row-major panels.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <unordered_map>
+#include <vector>
+
+class GFXBase;
+
+class GIFFrameCache
+{
+  public:
+    GIFFrameCache(uint16_t width, uint16_t height, size_t maxBytes);
+
+    // Number of image descriptors in a GIF file, found by walking its block
+    // structure; 0 if the file is malformed
+    static size_t CountFrames(const uint8_t* data, size_t length);
+
+    // Capture, driven by the GIF decoder's callbacks. Coordinates are
+    // relative to the cache's own width and height.
+
+    void Plot(int x, int y, const CRGB& color);
+    void NoteClear();
+
+    // Encode the pixels plotted since the last EndFrame(). Returns false
+    // once the cache would grow past maxBytes, after which it is useless.
+    bool EndFrame();
+
+    // Drop the capture canvas once the last frame has been encoded
+    void FinishCapture();
+
+    // Playback
+
+    size_t FrameCount() const { return _frames.size(); }
+    size_t Bytes() const;
+    uint16_t Width() const { return _width; }
+    uint16_t Height() const { return _height; }
+
+    // True when each row of the cache rectangle at (offsetX, offsetY) is a
+    // contiguous, left-to-right run of g.leds, so rows can be blitted
+    bool IsRowContiguous(const GFXBase& g, int offsetX, int offsetY) const;
+
+    void DrawFrame(size_t index, GFXBase& g, int offsetX, int offsetY, const CRGB& bkColor, bool rowContiguous) const;
+
+  private:
+    struct Frame
+    {
+        uint32_t runOffset;
+        uint32_t paletteOffset;
+        bool     clearFirst;
+    };
+
+    // A run byte with this bit set skips its length; otherwise a palette
+    // index byte follows and the run is filled with that color
+    static constexpr uint8_t kSkipRun = 0x80;
+    static constexpr uint8_t kMaxRunLength = 0x7F;
+
+    void AppendRun(bool skip, uint8_t length, uint8_t paletteIndex);
+
+    uint16_t _width;
+    uint16_t _height;
+    size_t   _maxBytes;
+    bool     _overflowed = false;
+
+    std::vector<Frame, psram_allocator<Frame>>      _frames;
+    std::vector<uint8_t, psram_allocator<uint8_t>>  _runs;
+    std::vector<CRGB, psram_allocator<CRGB>>        _colors;
+
+    // Capture state, released by FinishCapture()
+    std::vector<CRGB, psram_allocator<CRGB>>        _canvas;
+    std::vector<uint8_t, psram_allocator<uint8_t>>  _plotted;
+    bool                                            _clearPending = false;
+    uint32_t                                        _paletteOffset = 0;
+    std::unordered_map<uint32_t, uint8_t>           _paletteLookup;
+};
@@ -160,7 +160,79 @@ extern std::recursive_mutex g_effect_manager_mutex;
 #define FASTLED_INTERNAL        1       // Silence FastLED build banners
 #define NTP_DELAY_SECONDS       (5*60)  // delay count for NTP update, in seconds
 #define NTP_DELAY_ERROR_SECONDS 30      // delay count for NTP updates if no time was set, in seconds
-#define NTP_PACKET_LENGTH       48      // ntp packet length
+#define NTP_POLL_MS             1000    // how often NTPTimeClient checks for a due sync or an overdue reply
+
+#ifndef HTTP_FETCH_TIMEOUT_MS
+#define HTTP_FETCH_TIMEOUT_MS   5000    // Connect and read timeout for each NetworkReader HTTP request
+#endif
+
+#ifndef NETWORK_READER_WORKERS
+#define NETWORK_READER_WORKERS  2       // How many NetworkReader jobs (HTTP fetches, NTP) may run at once
+#endif
+
+#ifndef SOCKET_REACTOR_IDLE_MS
+#define SOCKET_REACTOR_IDLE_MS  1000    // Longest the socket reactor sleeps with nothing scheduled (it still wakes on any socket event)
+#endif
+
+#ifndef SOCKET_REACTOR_POLL_MS
+#define SOCKET_REACTOR_POLL_MS  50      // Wait cap used only if the reactor's loopback wake socket can't be opened
+#endif
+
+#ifndef INCOMING_WIFI_MAX_CLIENTS
+#define INCOMING_WIFI_MAX_CLIENTS 2     // Senders that may stream color data to us at once
+#endif
+
+#ifndef COLORDATA_MAX_CLIENTS
+#define COLORDATA_MAX_CLIENTS   2       // Raw TCP LED viewers that may connect at once
+#endif
+
+#ifndef ENABLE_GIF_FRAME_CACHE
+    #if USE_PSRAM
+        #define ENABLE_GIF_FRAME_CACHE 1    // Pre-decode embedded animated GIFs into run-length frames held in PSRAM
+    #else
+        #define ENABLE_GIF_FRAME_CACHE 0
+    #endif
+#endif
+
+#ifndef GIF_FRAME_CACHE_BYTES
+#define GIF_FRAME_CACHE_BYTES   (256 * 1024)    // Most memory all cached GIFs may use together
+#endif
+
+#ifndef USE_SWAR_PIXEL_KERNELS
+#define USE_SWAR_PIXEL_KERNELS  1       // Fade, blur and stream spans a 32-bit word at a time instead of per pixel
+#endif
+
+#ifndef ENABLE_RENDER_BUDGET
+#define ENABLE_RENDER_BUDGET    1       // Time each effect's Draw() and scale the quality of effects that support it
+#endif
+
+#ifndef RENDER_BUDGET_PERCENT
+#define RENDER_BUDGET_PERCENT   75      // Share of an effect's frame time its Draw() may use; the rest is for output
+#endif
+
+#ifndef ENABLE_ASYNC_LOGGING
+#define ENABLE_ASYNC_LOGGING    1       // Hand log output to a writer task instead of writing it from the logging task
+#endif
+
+#ifndef LOG_RECORD_TEXT_BYTES
+#define LOG_RECORD_TEXT_BYTES   96      // Text carried by each queued log record; longer messages span several
+#endif
+
+#ifndef LOG_RING_RECORDS
+#define LOG_RING_RECORDS        32      // Queued log records per core, rounded up to a power of two
+#endif
+
+#ifndef TEXT_STRIP_CACHE_ENTRIES
+#define TEXT_STRIP_CACHE_ENTRIES 16     // Rasterized strings kept for GFXBase text drawing, least recently used dropped first
+#endif
+
+#ifndef ENABLE_WIRE_CAPTURE
+#define ENABLE_WIRE_CAPTURE     1       // Console commands to record what the socket server receives, for replay later
+#endif
+
+#ifndef WIRE_CAPTURE_BYTES
+#define WIRE_CAPTURE_BYTES      (512 * 1024)    // Ring a wire capture is recorded into; the oldest packets go when it's full
+#endif
 
 // C Helpers and Macros
 
@@ -208,6 +280,7 @@ extern std::recursive_mutex g_effect_manager_mutex;
 #define DEBUG_PRIORITY          (tskIDLE_PRIORITY+2)
 #define JSONWRITER_PRIORITY     (tskIDLE_PRIORITY+2)
 #define COLORDATA_PRIORITY      (tskIDLE_PRIORITY+2)
+#define LOGGER_PRIORITY         (tskIDLE_PRIORITY+2)
 
 // If you experiment and mess these up, my go-to solution is to put Drawing on Core 0, and everything else on Core 1.
 // My current core layout is as follows, and as of today it's solid as of (7/16/21).
@@ -233,6 +306,7 @@ extern std::recursive_mutex g_effect_manager_mutex;
 #define REMOTE_CORE             1
 #define JSONWRITER_CORE         0
 #define COLORDATA_CORE          0
+#define LOGGER_CORE             0
 
 #define FASTLED_INTERNAL            1   // Suppresses the compilation banner from FastLED
 #define __STDC_FORMAT_MACROS
@@ -467,6 +541,27 @@ extern std::recursive_mutex g_effect_manager_mutex;
     #ifndef ENABLE_AUDIO_SMOOTHING
         #define ENABLE_AUDIO_SMOOTHING 1
     #endif
+    #ifndef AUDIO_INPUT_SYNTHETIC
+        #define AUDIO_INPUT_SYNTHETIC 0                 // Replace the mic with a generated test signal (see audioinput.h)
+    #endif
+    #ifndef AUDIO_SYNC_PUBLISH
+        #define AUDIO_SYNC_PUBLISH 0                    // Multicast every audio pass so other devices can follow this mic
+    #endif
+    #ifndef AUDIO_SYNC_SUBSCRIBE
+        #define AUDIO_SYNC_SUBSCRIBE 0                  // Follow a publisher's audio instead of sampling a local mic
+    #endif
+    #ifndef AUDIO_SYNC_GROUP
+        #define AUDIO_SYNC_GROUP "239.78.68.65"         // Multicast group shared by publisher and subscribers
+    #endif
+    #ifndef AUDIO_SYNC_PLAYOUT_MS
+        #define AUDIO_SYNC_PLAYOUT_MS 30                // Subscriber jitter buffer depth; larger is smoother but later
+    #endif
+    #if AUDIO_SYNC_PUBLISH && AUDIO_SYNC_SUBSCRIBE
+        #error "AUDIO_SYNC_PUBLISH and AUDIO_SYNC_SUBSCRIBE are mutually exclusive"
+    #endif
+    #if (AUDIO_SYNC_PUBLISH || AUDIO_SYNC_SUBSCRIBE) && !ENABLE_WIFI
+        #error "AUDIO_SYNC_PUBLISH and AUDIO_SYNC_SUBSCRIBE require ENABLE_WIFI"
+    #endif
     #ifndef BARBEAT_ENHANCE
         #define BARBEAT_ENHANCE 0.3                     // How much the SpectrumAnalyzer "pulses" with the music
     #endif
@@ -560,6 +655,14 @@ extern std::recursive_mutex g_effect_manager_mutex;
 #define EFFECT_PERSISTENCE_CRITICAL 0
 #endif
 
+#ifndef EFFECTS_JOURNAL_COMPACT_BYTES
+#define EFFECTS_JOURNAL_COMPACT_BYTES 4096      // Rewrite effects.cfg and drop the journal once it grows past this
+#endif
+
+#ifndef JSON_STORAGE_MSGPACK
+#define JSON_STORAGE_MSGPACK 0                  // Store effects.cfg and device.cfg as MessagePack instead of text JSON
+#endif
+
 #ifndef MATRIX_REFRESH_RATE
 #define MATRIX_REFRESH_RATE 180
 #endif
@@ -568,6 +671,10 @@ extern std::recursive_mutex g_effect_manager_mutex;
 #define MATRIX_CALC_DIVIDER 3
 #endif
 
+#ifndef HUB75_SHADOW_FRAMEBUFFER
+#define HUB75_SHADOW_FRAMEBUFFER 1              // Draw into a persistent buffer copied to the panel at swap time, instead of copying the panel back every frame
+#endif
+
 // Power Limit
 //
 // The maximum amount of power, in milliwatts, that you want your project to use, if you want to limit that.
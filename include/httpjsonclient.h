@@ -0,0 +1,72 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        httpjsonclient.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    GET a JSON document for a NetworkReader job. The body is parsed straight
+//    off the socket (optionally through an ArduinoJson filter, so only the
+//    fields the effect reads are kept) instead of being buffered into a
+//    String first, every request is bounded by HTTP_FETCH_TIMEOUT_MS, and
+//    the caller can keep the server's validators so unchanged data comes
+//    back as a bodyless 304.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#if ENABLE_WIFI
+
+#include <ArduinoJson.h>
+#include <utility>
+#include <vector>
+
+// HttpValidators
+//
+// The ETag and Last-Modified the server sent for url. Hold on to one per
+// resource alongside the data parsed from it; FetchJson resets it if the
+// url changes.
+
+struct HttpValidators
+{
+    String url;
+    String etag;
+    String lastModified;
+};
+
+enum class HttpFetchResult
+{
+    Ok,             // doc holds the new body
+    NotModified,    // Server says the data hasn't changed; doc is untouched
+    Failed          // Connection, HTTP or parse error; already logged
+};
+
+using HttpHeaders = std::vector<std::pair<String, String>>;
+
+HttpFetchResult FetchJson(const String& url,
+                          JsonDocument& doc,
+                          const JsonDocument* pFilter = nullptr,
+                          HttpValidators* pValidators = nullptr,
+                          const HttpHeaders& headers = {});
+
+#endif // ENABLE_WIFI
@@ -45,6 +45,7 @@
 #include <memory>
 
 #include "gfxbase.h"
+#include "textstrip.h"
 #include "types.h"
 
 //
@@ -84,10 +85,10 @@ public:
 
     // EstimatePowerDraw
     //
-    // Estimate the total power load for the board and matrix by walking the pixels and adding our previously measured
-    // power draw per pixel based on what color and brightness each pixel is
+    // Estimate the total power load for the board and matrix at full brightness from the calibrated PowerModel,
+    // using the channel sums the effect reported for this frame when it did so. sumsOut receives the channel totals.
 
-    int EstimatePowerDraw();
+    int EstimatePowerDraw(ChannelSums* sumsOut = nullptr);
 
     __attribute__((always_inline)) uint16_t xy(uint16_t x, uint16_t y) const noexcept override
     {
@@ -136,5 +137,44 @@ public:
     static CRGB *GetMatrixBackBuffer();
     static bool WaitForMatrixSwap(uint32_t timeoutMs = 100);
     static void MatrixSwapBuffers(bool bSwapBackground);
+
+    // GetDrawingBuffer
+    //
+    // Where effects draw this frame: the shadow buffer with HUB75_SHADOW_FRAMEBUFFER, or else straight into
+    // the SmartMatrix back buffer
+
+    static CRGB *GetDrawingBuffer();
+
+private:
+
+    // DrawCaption
+    //
+    // Positions the caption and returns the first row of its band.  Without HUB75_SHADOW_FRAMEBUFFER it also
+    // renders it into the title layer's drawing buffer.
+
+    int DrawCaption();
+
+    // RasterizeCaption
+    //
+    // Renders the caption, shadow included, into a strip once per caption; scrolling it is then only a matter
+    // of where the strip is drawn
+
+    static std::shared_ptr<const TextStrip> RasterizeCaption(const String& caption, int top);
+
+    static std::shared_ptr<const TextStrip> captionStrip;
+    static String captionStripText;
+
+    #if HUB75_SHADOW_FRAMEBUFFER
+        // Effects draw into shadowBuffer, which therefore always holds last frame's pixels, and ComposeToBackBuffer()
+        // copies it into the SmartMatrix back buffer at swap time, blending in the caption band as it goes.  That
+        // replaces both copyRefreshToDrawing() and the separate title layer swap.
+
+        static std::unique_ptr<CRGB[]> shadowBuffer;
+        static int captionTop;
+        static int captionLeft;
+        static uint8_t captionBrightness;
+
+        static void ComposeToBackBuffer();
+    #endif
 };
 #endif
@@ -28,7 +28,7 @@
 //    that own a FreeRTOS task. It captures the standard launch / shutdown
 //    discipline (atomics for run state, signal-and-wait shutdown, force-
 //    delete fallback) in exactly one place so individual services like
-//    AudioService, JSONWriter, SocketServer, and RemoteControl don't each
+//    AudioService, JSONWriter, SocketReactor, and RemoteControl don't each
 //    reimplement it.
 //
 //    A service that wants its own task should:
@@ -37,7 +37,7 @@
 //      2. Implement GetTaskConfig() to specify the task's name, stack size,
 //         priority, and core. The shutdown timeout has a sensible default
 //         and only needs to be overridden when the task can block longer
-//         (e.g. SocketServer with its accept timeout).
+//         (e.g. SocketReactor, whose callbacks may be mid-send).
 //      3. Implement Run() — the task body. Run() should poll
 //         ShouldShutdown() between iterations and return when it sees true,
 //         which triggers the rest of the cleanup automatically.
@@ -0,0 +1,87 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        jsonchunkstream.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Chunked JSON responses for the web server. Instead of building a whole
+//    document in an AsyncJsonResponse, a handler takes a snapshot of what it
+//    needs (quickly, under whatever lock guards it) and hands a generator to
+//    JsonChunkStream. The generator is then called from the async TCP task,
+//    outside any lock, to produce the body one fragment at a time - one
+//    effect, one setting spec - as the socket drains. Peak heap is the
+//    snapshot plus a single fragment, however long the list gets.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#if ENABLE_WEBSERVER
+
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+#include <functional>
+#include <utility>
+
+// JsonChunkStream
+//
+// Adapts a fragment generator to an AwsResponseFiller. Fragments are
+// appended to a small pending buffer and copied out as the response asks
+// for bytes, so a fragment may span several TCP chunks.
+
+class JsonChunkStream
+{
+  public:
+    // Append fragment number `index` (0, 1, 2, ...) to out and return true,
+    // or return false without appending once the body is complete.
+
+    using Generator = std::function<bool(size_t index, String& out)>;
+
+    // Create a chunked application/json response driven by generator. The
+    // generator, and anything it captured, lives until the response is freed.
+
+    static AsyncWebServerResponse * BeginResponse(AsyncWebServerRequest * pRequest, Generator generator);
+
+    // Fragment helpers for generators. AppendElement and AppendMember add
+    // the comma too, unless first says nothing has been written yet, and
+    // append nothing at all when value overflowed or fails to serialize; a
+    // generator that keeps first across calls (a mutable lambda capture)
+    // then can't leave a dangling separator or key in the body.
+
+    static void AppendKey(String& out, const char* key);                // "key":
+    static bool AppendElement(String& out, bool& first, const JsonDocument& value);
+    static bool AppendMember(String& out, bool& first, const char* key, const JsonDocument& value);
+
+    explicit JsonChunkStream(Generator generator) : _generator(std::move(generator)) {}
+
+    size_t Fill(uint8_t * buffer, size_t maxLen);
+
+  private:
+    Generator _generator;
+    String    _pending;
+    size_t    _pendingOffset = 0;
+    size_t    _nextFragment = 0;
+    bool      _finished = false;
+};
+
+#endif // ENABLE_WEBSERVER
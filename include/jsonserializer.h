@@ -85,7 +85,9 @@ namespace ArduinoJson
 
 bool BoolFromText(const String& text);
 bool LoadJSONFile(const String & fileName, JsonDocument& jsonDoc);
-bool SaveToJSONFile(const String & fileName, IJSONSerializable& object);
+bool LoadAndMigrateJSONFile(const String & fileName, JsonDocument& jsonDoc);
+bool IsBinaryJSONFile(const String & fileName);
+bool SaveToJSONFile(const String & fileName, IJSONSerializable& object, size_t* pBytesWritten = nullptr);
 bool RemoveJSONFile(const String & fileName);
 std::mutex& JSONFilesystemWriteMutex();
 void WaitForRenderSwapBeforeFilesystemWrite();
@@ -35,9 +35,12 @@
 #include "effects.h"
 #include "hashing.h"
 #include "jsonserializer.h"
+#include "renderbudget.h"
 
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 class GFXBase;
@@ -87,6 +90,16 @@ class LEDStripEffect : public IJSONSerializable
 
     bool   _coreEffect = false;
 
+    RenderBudget _renderBudget;
+    uint8_t      _qualityLevel = UINT8_MAX;         // Top level until the render budget says otherwise
+
+    std::mutex        _initMutex;                   // Held while Init() runs, so two tasks can't init at once
+    std::atomic<bool> _initPending = false;
+    std::atomic<bool> _initFailed = false;          // The last Init() failed or ran out of memory; not to be started
+    uint32_t          _lastInitMicros = 0;
+
+    bool InitTimedLocked(std::vector<std::shared_ptr<GFXBase>>& gfx);
+
     // This "lazy loads" the SettingSpec instances for LEDStripEffect. Note that it adds the actual
     // instances to a static vector, meaning they are loaded once for all effects. The _settingSpecReferences
     // instance variable vector only contains reference_wrappers to the actual SettingSpecs to save
@@ -106,6 +119,9 @@ class LEDStripEffect : public IJSONSerializable
     // Returning nullptr indicates the effect has no SettingSpec instances to add to the base set.
     virtual EffectSettingSpecs* FillSettingSpecs() { return nullptr; }
 
+    // Called when the render budget moves the effect to another quality level; the next Draw() should use it
+    virtual void OnQualityLevelChanged(uint8_t level) {}
+
     static float fmap(const float x, const float in_min, const float in_max, const float out_min, const float out_max);
 
   public:
@@ -117,11 +133,49 @@ class LEDStripEffect : public IJSONSerializable
     virtual ~LEDStripEffect();
 
     // Init may be called more than once during the lifetime of an effect. In particular, live WS281x
-    // topology/output changes re-run Init() on every effect so it can refresh cached geometry, LED counts,
-    // and any size-dependent allocations. Implementations must therefore be re-entrant/idempotent and
-    // replace or rebuild any topology-dependent state instead of assuming one-time construction.
+    // topology changes re-run Init() on every effect whose ConfigDependencies() include what changed, so it
+    // can refresh cached geometry, LED counts, and any size-dependent allocations. Implementations must
+    // therefore be re-entrant/idempotent and replace or rebuild any topology-dependent state instead of
+    // assuming one-time construction. That Init() may run on another task while a different effect draws,
+    // so it must not draw itself; clearing the screen and the like belongs in Start().
     virtual bool Init(std::vector<std::shared_ptr<GFXBase>>& gfx);
 
+    // ConfigInputs
+    //
+    // Bit flags for the parts of the runtime configuration an effect's Init() depends on.  When any of them
+    // changes, the EffectManager initializes the effect again: at once if it's on screen, otherwise in the
+    // background, or at the latest when it's next started.
+
+    enum ConfigInputs : uint8_t
+    {
+        ConfigNone       = 0x00,
+        ConfigWidth      = 0x01,
+        ConfigHeight     = 0x02,
+        ConfigSerpentine = 0x04,
+        ConfigSize       = ConfigWidth | ConfigHeight,
+        ConfigTopology   = ConfigSize | ConfigSerpentine
+    };
+
+    // The base Init() caches the LED count, so by default every effect depends on the matrix size.  Effects
+    // that also cache anything laid out in wiring order should add ConfigSerpentine.
+    virtual uint8_t ConfigDependencies() const
+    {
+        return ConfigSize;
+    }
+
+    // Flags the effect for another Init() if it depends on any of the changed inputs; true if it does
+    bool MarkConfigChanged(uint8_t changedInputs);
+
+    bool IsInitPending() const              { return _initPending; }
+    bool InitFailed() const                 { return _initFailed; }
+    uint32_t LastInitMicros() const         { return _lastInitMicros; }
+
+    // Init() through these is timed and serialized: a second task to get here waits for the first to finish.
+    // InitTimed() always runs it, InitIfPending() only when a config change has flagged the effect.  Both
+    // return false when the effect isn't initialized, including an earlier Init() that failed.
+    bool InitTimed(std::vector<std::shared_ptr<GFXBase>>& gfx);
+    bool InitIfPending(std::vector<std::shared_ptr<GFXBase>>& gfx);
+
     virtual void Start() {}                                         // Optional method called when time to clean/init the effect
     virtual void Draw() = 0;                                        // Your effect must implement these
     virtual void OnBeat(const BeatInfo&) {}                         // Optional beat callback for audio-reactive effects
@@ -174,6 +228,24 @@ class LEDStripEffect : public IJSONSerializable
 
     virtual bool RequiresDoubleBuffering() const;
 
+    // QualityLevels
+    //
+    // Effects that can trade detail for speed - fewer particles, fewer noise octaves, a lower render resolution
+    // scaled up - return how many levels of it they have, and draw at QualityLevel(), from 0 (cheapest) to
+    // QualityLevels() - 1.  The EffectManager times every Draw() and steps the level down while the effect
+    // overruns its frame budget, and back up once there is room again.  One level means no scaling.
+
+    virtual uint8_t QualityLevels() const
+    {
+        return 1;
+    }
+
+    uint8_t QualityLevel() const;
+    void SetQualityLevel(uint8_t level);
+
+    RenderBudget& GetRenderBudget()             { return _renderBudget; }
+    const RenderBudget& GetRenderBudget() const { return _renderBudget; }
+
     // RandomRainbowColor
     //
     // Returns a random color of the rainbow
@@ -32,8 +32,16 @@
 //---------------------------------------------------------------------------
 
 #include "globals.h"
+#include <atomic>
+#include <mutex>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <vector>
+
+#include "effectmanager.h"
+#include "previewencoder.h"
+#include "socketreactor.h"
+
 #define COLOR_DATA_PACKET_HEADER 0x434C5244
 
 // Be careful of structure packing rules when adding elements to this structure
@@ -51,11 +59,21 @@ typedef struct
 
 // LEDViewer
 //
-// LEDViewer is a class that listens on a TCP port for a connection a client
-// and responds with the current state of the LED array.  This allows a client
-// to monitor the state of the LED array in real time.
+// LEDViewer listens on a TCP port for clients and sends each of them the
+// state of the LED array every time a new frame is drawn.  This allows a
+// client to monitor the state of the LED array in real time.
+//
+// The port is served by the SocketReactor. The renderer's frame event just
+// bumps a counter and wakes the reactor; the reactor then asks WantsWrite()
+// for each viewer that is behind, and the frame is captured once and sent
+// to every viewer whose socket can take it. A viewer that can't take a whole
+// frame simply misses it, so a stalled client never holds anything up.
+//
+// A viewer that sends a preview request (see previewencoder.h) gets its
+// frames scaled, encoded and rate limited to suit it instead of as raw
+// ColorDataPackets.
 
-class LEDViewer
+class LEDViewer : public ISocketProtocol, public IFrameEventListener
 {
 public:
     enum class SendResult
@@ -65,19 +83,67 @@ public:
         Failed
     };
 
+    explicit LEDViewer(int port);
+    ~LEDViewer();
+
+    // Serve the port on the reactor and start listening for frames. Detach()
+    // undoes both; no callbacks arrive once it returns.
+
+    bool Attach(SocketReactor& reactor);
+    void Detach();
+
+    // IFrameEventListener
+
+    void OnNewFrameAvailable() override;
+
+    // ISocketProtocol
+
+    const char* ProtocolName() const override { return "LEDViewer"; }
+    size_t MaxClients() const override { return COLORDATA_MAX_CLIENTS; }
+    bool OnConnect(int fd, const sockaddr_in& peer) override;
+    bool OnReadable(int fd) override;
+    bool WantsWrite(int fd) const override;
+    bool OnWritable(int fd) override;
+    void OnDisconnect(int fd) override;
+
+    static SendResult SendPacket(int socket, const void * pData, size_t cbSize);
+
+    // Lays the LEDs out row-major, x across and y down, whichever way they are wired
+    static void CopyRowMajor(const GFXBase& graphics, const CRGB* leds, size_t count, CRGB* frame);
+
+    void AppendPreviewClients(std::vector<PreviewClientReport>& reports) const;
+
 private:
 
-    int                         _port;
-    int                         _server_fd;
-    struct sockaddr_in          _address;
+    struct Viewer
+    {
+        int            fd;
+        uint32_t       frameSent;       // Value of _frameCounter when this viewer was last served
+        PreviewEncoder encoder;
+        bool           negotiated = false;
+        uint8_t        request[PreviewOptions::kRequestSize];
+        size_t         requestBytes = 0;
+    };
 
-public:
+    const Viewer* FindViewer(int fd) const;
+    void AcceptRequestBytes(Viewer& viewer, const uint8_t* data, size_t length);
+    bool CaptureFrame();
 
-    explicit LEDViewer(int port);
-    ~LEDViewer();
+    int                                   _port;
+    SocketReactor*                        _pReactor = nullptr;
+    bool                                  _attached = false;
+    std::atomic<uint32_t>                 _frameCounter{0};     // Bumped by the renderer for every frame
+    std::atomic<size_t>                   _viewerCount{0};
 
-    void release();
-    bool begin();
-    int CheckForConnection();
-    SendResult SendPacket(int socket, const void * pData, size_t cbSize);
+    // Only touched from reactor callbacks, which the reactor serializes; changes to the viewers and their
+    // stats are also made under _viewersMutex so AppendPreviewClients() can read them from elsewhere
+    mutable std::mutex                    _viewersMutex;
+    std::vector<Viewer>                   _viewers;
+    allocated_unique_ptr<ColorDataPacket> _packet;
+    size_t                                _packetSize = 0;
+    uint32_t                              _packetFrame = 0;
+    allocated_unique_ptr<CRGB []>         _frame;                // The same frame, row-major, for encoding
+    uint16_t                              _frameWidth = 0;
+    uint16_t                              _frameHeight = 0;
+    std::vector<uint8_t>                  _encoded;
 };
@@ -0,0 +1,89 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        lifeboard.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Bit-packed Game of Life board on a torus.
+//
+//    Each row is stored as packed 32-bit words, one bit per cell with the
+//    cell at x in bit (x % 32) of word (x / 32), and the bits past the
+//    width of the last word always clear. A generation is computed a word
+//    at a time: the eight neighbour masks of 32 cells are summed bit-sliced
+//    with a few ANDs and XORs instead of being counted one cell at a time.
+//
+//    The generation before the current one is kept, so a caller can see
+//    which cells were born or died, and the board is FNV-1a hashed row by
+//    row as each new generation is produced, for cheap cycle detection.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <memory>
+
+class LifeBoard
+{
+  public:
+    using Word = uint32_t;
+
+    static constexpr int kWordBits = 32;
+
+    LifeBoard(uint16_t width, uint16_t height);
+
+    uint16_t Width() const       { return _width; }
+    uint16_t Height() const      { return _height; }
+    uint16_t WordsPerRow() const { return _words; }
+
+    // Kills every cell in both the current and previous generation
+    void Clear();
+
+    bool IsAlive(uint16_t x, uint16_t y) const  { return (Row(y)[x / kWordBits] >> (x % kWordBits)) & 1; }
+    bool WasAlive(uint16_t x, uint16_t y) const { return (PreviousRow(y)[x / kWordBits] >> (x % kWordBits)) & 1; }
+
+    // Sets a cell in the current generation; it's also taken as the previous one, so a seeded cell isn't a birth
+    void Set(uint16_t x, uint16_t y, bool alive);
+
+    const Word* Row(uint16_t y) const         { return _current.get() + y * _words; }
+    const Word* PreviousRow(uint16_t y) const { return _previous.get() + y * _words; }
+
+    // Advances one generation; the current one becomes the previous one
+    void Step();
+
+    // FNV-1a hash of the current generation's rows
+    uint32_t Hash() const;
+
+  private:
+    void ShiftRow(const Word* row, Word* west, Word* east) const;
+
+    uint16_t                _width;
+    uint16_t                _height;
+    uint16_t                _words;
+    Word                    _lastWordMask;
+    std::unique_ptr<Word[]> _current;
+    std::unique_ptr<Word[]> _previous;
+    std::unique_ptr<Word[]> _west;                  // Each row of the current generation moved one cell east...
+    std::unique_ptr<Word[]> _east;                  // ...and one cell west, so bit x holds the neighbour on that side
+    mutable uint32_t        _hash = 0;
+    mutable bool            _hashValid = false;
+};
@@ -79,6 +79,13 @@ public:
     // Call once from setup() after Serial is initialized.
     static void InstallLogHook();
 
+    // Start the task that writes queued log output to the console sinks.  Until it runs - and always for
+    // Fatal messages - logging writes to the sinks directly from the calling task.
+    static void StartWriter();
+
+    // Log records dropped because the writer couldn't keep up
+    static uint32_t DroppedRecords();
+
 private:
     static LogLevel _level;
 };
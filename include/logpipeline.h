@@ -0,0 +1,187 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        logpipeline.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Lock-free hand-off of log output from the tasks that produce it to
+//    the one that writes it to the console sinks.
+//
+//    Producers post formatted text into one of several bounded rings of
+//    fixed-size records (one ring per core), splitting long messages
+//    across consecutive records. Posting never waits: when a ring is full
+//    the oldest record in it is dropped to make room, and if even that
+//    can't be done without waiting - the oldest record is still being
+//    written or read - the new one is dropped instead. Every drop is
+//    counted.
+//
+//    A single consumer drains the rings, merging them back into the order
+//    the records were posted in, reassembles split messages and hands
+//    each one to a sink.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "logger.h"
+
+struct LogRecord
+{
+    static constexpr uint8_t kRaw       = 0x01;     // Already formatted output, written without a level/tag prefix
+    static constexpr uint8_t kContinued = 0x02;     // Carries on the text of the record posted before it
+    static constexpr uint8_t kMore      = 0x04;     // The text carries on in the record posted after it
+
+    static constexpr size_t kTagBytes = 16;
+
+    uint32_t sequence;
+    uint32_t timestamp;
+    LogLevel level;
+    uint8_t  flags;
+    uint8_t  length;
+    char     tag[kTagBytes];
+    char     text[LOG_RECORD_TEXT_BYTES];
+};
+
+static_assert(LOG_RECORD_TEXT_BYTES <= 255, "Log record text length must fit in a byte");
+
+// LogRing
+//
+// Bounded multi-producer, multi-consumer queue of LogRecords after Dmitry Vyukov's design: each cell carries a
+// sequence number that says whether it is free for the producer at a given position or holds a record for the
+// consumer at it, and positions are claimed with a compare-and-swap.  Consumers other than the writer exist only
+// to drop the oldest record when the ring is full.
+
+class LogRing
+{
+  public:
+    explicit LogRing(size_t capacity);
+
+    // Claims the next cell and fills it with fill(LogRecord&); false if the ring is full
+    template <typename Fill>
+    bool TryPush(Fill&& fill)
+    {
+        size_t position = _pushPosition.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell& cell = _cells[position & _mask];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+            if (difference == 0)
+            {
+                if (_pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    fill(cell.record);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = _pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Takes the oldest record, copying it to out unless that's null; false if there is none ready
+    bool TryPop(LogRecord* out);
+
+  private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        LogRecord           record;
+    };
+
+    std::unique_ptr<Cell[]> _cells;
+    size_t                  _mask;
+    std::atomic<size_t>     _pushPosition { 0 };
+    std::atomic<size_t>     _popPosition { 0 };
+};
+
+// LogMessage
+//
+// One reassembled message as the sink sees it.  The text is NUL-terminated.
+
+struct LogMessage
+{
+    uint32_t         sequence;
+    uint32_t         timestamp;
+    LogLevel         level;
+    const char*      tag;
+    bool             raw;
+    std::string_view text;
+};
+
+class LogPipeline
+{
+  public:
+    using Sink = std::function<void(const LogMessage&)>;
+
+    LogPipeline(size_t rings, size_t recordsPerRing);
+
+    // Producer side, safe from any task.  ring is normally the posting core.
+    void Post(size_t ring, LogLevel level, const char* tag, bool raw, std::string_view text, uint32_t timestamp);
+
+    // Consumer side, from one task only.  Delivers what has been posted so far and returns how many records
+    // that took; a message whose later records haven't arrived yet waits for the next call.
+    size_t Drain(const Sink& sink);
+
+    uint32_t Posted() const    { return _posted.load(std::memory_order_relaxed); }      // Records, not messages
+    uint32_t Dropped() const   { return _dropped.load(std::memory_order_relaxed); }
+    uint32_t Delivered() const { return _delivered; }
+
+  private:
+    static constexpr int kPushAttempts = 3;
+
+    void PostRecord(LogRing& ring, const LogRecord& header, const char* text, size_t length);
+    void Accept(const LogRecord& record, const Sink& sink);
+    void FinishMessage(const Sink& sink);
+
+    std::vector<std::unique_ptr<LogRing>> _rings;
+    size_t                                _drainLimit;       // Records per Drain(), so producers can't keep it busy forever
+    std::atomic<uint32_t>                 _sequence { 0 };
+    std::atomic<uint32_t>                 _posted { 0 };
+    std::atomic<uint32_t>                 _dropped { 0 };
+
+    // Consumer state
+    std::vector<LogRecord> _heads;                  // Next record from each ring, when _hasHead says there is one
+    std::vector<bool>      _hasHead;
+    uint32_t               _delivered = 0;
+    uint32_t               _reportedDropped = 0;
+    bool                   _assembling = false;
+    LogRecord              _first;                  // First record of the message being assembled
+    uint32_t               _nextSequence = 0;
+    std::string            _text;
+};
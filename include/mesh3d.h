@@ -0,0 +1,149 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        mesh3d.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    A small fixed-point 3D engine for wireframe and flat shaded meshes.
+//
+//    A mesh is a list of integer vertices and convex faces, and the edges
+//    those faces share are worked out as faces are added. Project() turns
+//    it about the X and then the Y axis with sin16()/cos16(), pushes it
+//    away from the camera and projects it to Q16.16 screen positions,
+//    without any floating point. The projected vertices are kept until the
+//    view changes, so drawing the same mesh in several places costs one
+//    projection. Faces turned away from the camera are culled, and edges
+//    belong to the front when any face they border faces the camera.
+//
+//    The line and fill routines write straight to the LED buffer, clipped
+//    to the matrix, and are there for other effects to draw with as well.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <initializer_list>
+#include <vector>
+
+class GFXBase;
+
+class Mesh3D
+{
+  public:
+    static constexpr int     kFractionBits = 16;        // Screen positions, focal length and centers are Q16.16
+    static constexpr int32_t kOne          = 1 << kFractionBits;
+    static constexpr int     kMaxCorners   = 4;
+    static constexpr int16_t kMaxCoordinate = 8191;     // Keeps the transforms inside 32 bits
+    static constexpr int32_t kAnglePerRadian = 10430;   // sin16() angle units, 65536 to a full turn
+    static constexpr int32_t kScreenLimit = 8192 * kOne; // Furthest a projected vertex lands from the center
+
+    struct Vertex
+    {
+        int16_t x, y, z;
+    };
+
+    struct Edge
+    {
+        uint8_t a, b;
+    };
+
+    struct Face
+    {
+        uint8_t count;
+        uint8_t corners[kMaxCorners];
+        uint8_t edges[kMaxCorners];
+    };
+
+    struct ScreenPoint
+    {
+        int32_t xq, yq;             // Q16.16
+        int16_t x, y;               // Whole pixels, rounded down
+
+        void Set(int32_t xQ16, int32_t yQ16)
+        {
+            xq = xQ16;
+            yq = yQ16;
+            x = (int16_t)(xQ16 >> kFractionBits);
+            y = (int16_t)(yQ16 >> kFractionBits);
+        }
+    };
+
+    // A cube from -halfWidth to halfWidth on each axis
+    static Mesh3D Cube(int16_t halfWidth);
+
+    // Model.  Coordinates are clamped to +/- kMaxCoordinate.  Face corners go
+    // clockwise as seen from outside the mesh, with y pointing up; the camera
+    // looks down the z axis from the negative side.
+    uint8_t AddVertex(int16_t x, int16_t y, int16_t z);
+    void AddFace(std::initializer_list<uint8_t> corners);
+
+    // View.  Angles are in sin16() units, cameraZ in model units, and the
+    // focal length and projection center in Q16.16 pixels; the center must
+    // be within 8192 pixels of the matrix.
+    void Project(uint16_t angleX, uint16_t angleY, int16_t cameraZ, int32_t focalQ16, int32_t centerXQ16, int32_t centerYQ16);
+
+    size_t VertexCount() const                      { return _vertices.size(); }
+    size_t EdgeCount() const                        { return _edges.size(); }
+    size_t FaceCount() const                        { return _faces.size(); }
+    const Edge& GetEdge(size_t i) const             { return _edges[i]; }
+    const Face& GetFace(size_t i) const             { return _faces[i]; }
+    const ScreenPoint& GetScreen(size_t i) const    { return _screen[i]; }
+    bool IsFrontFace(size_t i) const                { return _frontFaces[i]; }
+    bool IsFrontEdge(size_t i) const                { return _frontEdges[i]; }
+
+    // Back edges first and then front ones, offset by (dx, dy) pixels
+    void DrawEdges(GFXBase& g, int dx, int dy, const CRGB& backColor, const CRGB& frontColor, bool antialias = false) const;
+
+    // Fills one face, whichever way it faces
+    void FillFace(GFXBase& g, size_t face, int dx, int dy, const CRGB& color) const;
+
+    // Raster primitives, clipped to the matrix
+
+    // Bresenham line, both ends included
+    static void DrawLine(GFXBase& g, int x0, int y0, int x1, int y1, const CRGB& color);
+
+    // Wu antialiased line between Q16.16 positions, blended over what's there
+    static void DrawLineAA(GFXBase& g, int32_t x0, int32_t y0, int32_t x1, int32_t y1, const CRGB& color);
+
+    // Scanline fill of a convex polygon, rows and columns both ends included
+    static void FillConvex(GFXBase& g, const ScreenPoint* points, size_t count, int dx, int dy, const CRGB& color);
+
+  private:
+    uint8_t FindOrAddEdge(uint8_t a, uint8_t b);
+
+    std::vector<Vertex>      _vertices;
+    std::vector<Edge>        _edges;
+    std::vector<Face>        _faces;
+    std::vector<ScreenPoint> _screen;
+    std::vector<bool>        _frontFaces;
+    std::vector<bool>        _frontEdges;
+
+    // The view _screen was projected for
+    bool     _projected = false;
+    uint16_t _angleX = 0;
+    uint16_t _angleY = 0;
+    int16_t  _cameraZ = 0;
+    int32_t  _focal = 0;
+    int32_t  _centerX = 0;
+    int32_t  _centerY = 0;
+};
@@ -36,6 +36,7 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -55,6 +56,7 @@ enum NetworkPort : int
 {
     ColorServer       = 12000,
     IncomingWiFi      = 49152,
+    AudioSync         = 49153,
     VICESocketServer  = 25232,
     Telnet            = 23,
     Webserver         = 80
@@ -130,13 +132,29 @@ namespace nd_network
     {
     public:
         struct ReaderEntry;
+        class Worker;
 
     private:
         std::vector<std::shared_ptr<ReaderEntry>> readers;
+        mutable std::mutex readersMutex;
+
+        // Readers run on these, never on the network handling task itself, so
+        // a slow server can't hold up WiFi reconnects or the other readers.
+        // The worker count is the number of requests that can be in flight.
+        std::vector<std::unique_ptr<Worker>> workers;
+
+        std::vector<std::shared_ptr<ReaderEntry>> SnapshotReaders() const;
+        void StartWorkers();
+        void WakeWorkers();
 
     public:
 
-        ~NetworkReader() override { Stop(); }
+        NetworkReader();
+        ~NetworkReader() override;
+
+        // Run flagged readers until none are left that aren't already running
+        // on another worker. Called by the workers.
+        void RunFlaggedReaders();
         const char* Name() const override { return "NetworkReader"; }
 
         // Add a reader to the collection. Returns the index of the added reader, for use with FlagReader().
@@ -154,6 +172,7 @@ namespace nd_network
         // ITaskService hooks
         TaskConfig GetTaskConfig() const override;
         void Run() override;
+        void OnAfterStop() override;
     };
 #endif
 
@@ -24,7 +24,7 @@
 //
 // Description:
 //
-//    Sets the system clock from the specified NTP Server
+//    Keeps the system clock in step with the configured NTP server
 //
 // History:     Jul-12-2018         Davepl      Created for BigBlueLCD
 //              Oct-09-2018         Davepl      Copied to LEDWifi project
@@ -34,13 +34,15 @@
 
 #if ENABLE_NTP
 
-#include <WiFiUdp.h>
+#include "sntpclient.h"
 
 // NTPTimeClient
 //
-// Basically, I took some really ancient NTP code that I had on hand that I knew
-// worked and wrapped it in a class.  As expected, it works, but it could likely
-// benefit from cleanup or even wholesale replacement.
+// Runs SntpClient rounds against the configured server without ever waiting
+// on the network: Poll() starts a round when one is due and the socket
+// reactor delivers the replies.  Once the clock has been set, corrections
+// are slewed in with adjtime() unless they're too large for that, so the
+// clock effects and anything timestamped don't see time jump.
 
 class NTPTimeClient
 {
@@ -49,7 +51,14 @@ class NTPTimeClient
     NTPTimeClient() = default;
 
     static bool HasClockBeenSet();
-    static bool UpdateClockFromWeb(WiFiUDP * pUDP);
+
+    // Called regularly by the NetworkReader; returns straight away whatever it finds to do
+    static void Poll();
+
+    // Has the next Poll() start a sync, however recently the last one was
+    static void RequestSync();
+
+    static SntpClient::Stats GetStats();
 };
 
 #endif // ENABLE_NTP
@@ -0,0 +1,63 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        pixelkernels.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Pixel kernels over contiguous spans of CRGB, used by the GFXBase fade,
+//    blur, stream and move helpers once they have worked out that a row or
+//    column is laid out contiguously in leds[].
+//
+//    Every kernel produces exactly what the per-pixel CRGB code it replaces
+//    would: nscale8() with FastLED's "fixed" rounding, and saturating +=.
+//    PixelKernels::Reference holds that per-pixel code; the default versions
+//    work on four bytes at a time in 32-bit words (two 16-bit lanes for the
+//    multiplies, bit tricks for the saturating adds) when
+//    USE_SWAR_PIXEL_KERNELS is set, and are the reference otherwise.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+namespace PixelKernels
+{
+    // pixels[i].nscale8(scale)
+    void ScaleSpan(CRGB* pixels, size_t count, uint8_t scale);
+
+    // dst[i] += src[i]
+    void AddSpan(CRGB* dst, const CRGB* src, size_t count);
+
+    // dst[i] += src[i]; dst[i].nscale8(scale) - one step of a Stream* tail
+    void AddThenScaleSpan(CRGB* dst, const CRGB* src, size_t count, uint8_t scale);
+
+    // blur1d() over the span, treating whatever lies outside it as black
+    void BlurSpan(CRGB* pixels, size_t count, fract8 amount);
+
+    namespace Reference
+    {
+        void ScaleSpan(CRGB* pixels, size_t count, uint8_t scale);
+        void AddSpan(CRGB* dst, const CRGB* src, size_t count);
+        void AddThenScaleSpan(CRGB* dst, const CRGB* src, size_t count, uint8_t scale);
+        void BlurSpan(CRGB* pixels, size_t count, fract8 amount);
+    }
+}
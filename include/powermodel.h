@@ -0,0 +1,204 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        powermodel.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Integer power model used by the HUB75 and WS281x brightness limiters.
+//
+//    Each channel's draw is described by a short curve of per-LED power at
+//    a few drive levels, which DeviceConfig persists so a panel or strip
+//    type can be calibrated. The curve is expanded into a per-level lookup
+//    table; when it is a straight line (the usual case, and the default)
+//    the estimate collapses to channel sums times a slope, so the per-frame
+//    work is one pass of SumChannels() - or nothing at all if the effect
+//    already told GFXBase what it drew.
+//
+//    PowerCalibration records what the model predicted next to what a
+//    meter says the device actually drew, and fits a new linear curve
+//    from those samples. The "power" console command drives it.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <ArduinoJson.h>
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// Per-LED white draw for SK6812-style strips; see WS281xGFX for the extraction
+
+#ifndef SK6812_WHITE_MW
+    #define SK6812_WHITE_MW (15 * 5)
+#endif
+
+// ChannelSums
+//
+// Per-channel totals over a run of pixels. count is the number of pixels
+// covered, lit or not, so the model can add their idle draw.
+
+struct ChannelSums
+{
+    uint32_t red   = 0;
+    uint32_t green = 0;
+    uint32_t blue  = 0;
+    uint32_t white = 0;
+    uint32_t count = 0;
+
+    ChannelSums& operator+=(const ChannelSums& other)
+    {
+        red   += other.red;
+        green += other.green;
+        blue  += other.blue;
+        white += other.white;
+        count += other.count;
+        return *this;
+    }
+
+    // litCount pixels of color among count pixels, the rest black
+    static ChannelSums Solid(const CRGB& color, uint32_t litCount, uint32_t count)
+    {
+        return ChannelSums{ color.r * litCount, color.g * litCount, color.b * litCount, 0, count };
+    }
+};
+
+// SumChannels
+//
+// Sum the red, green and blue channels of count pixels. Works a word at a
+// time with two 16-bit lanes per register, so it touches three loads per
+// four pixels instead of twelve.
+
+ChannelSums SumChannels(const CRGB* leds, size_t count);
+
+// PowerModelConfig
+//
+// The persisted form of the model. Curves give the extra draw of one LED
+// in microwatts, above its idle draw, at each of kCurveLevels; level 0 is
+// implicitly zero and levels in between are interpolated.
+
+struct PowerModelConfig
+{
+    static constexpr size_t kCurvePoints = 4;
+    static constexpr std::array<uint8_t, kCurvePoints> kCurveLevels = { 64, 128, 192, 255 };
+
+    using Curve = std::array<uint32_t, kCurvePoints>;
+
+    uint32_t baseMw = 0;            // Controller and panel load with every LED dark
+    uint32_t idleUwPerLed = 0;      // Draw of one LED that is wired but dark
+    Curve    red = {};
+    Curve    green = {};
+    Curve    blue = {};
+    Curve    white = {};
+
+    // The compiled-in defaults for this build's output driver
+    static PowerModelConfig Defaults();
+
+    // A straight-line curve through fullScaleUw at level 255
+    static Curve Linear(uint32_t fullScaleUw);
+
+    bool operator==(const PowerModelConfig& other) const;
+    bool operator!=(const PowerModelConfig& other) const { return !(*this == other); }
+
+    void SerializeToJSON(JsonObject object) const;
+    static std::optional<PowerModelConfig> FromJSON(JsonObjectConst object);
+};
+
+// PowerModel
+//
+// Immutable once built, and shared: the render loop grabs Current() once
+// a frame while a settings change Publish()es a replacement.
+
+class PowerModel
+{
+  public:
+    enum Channel : uint8_t { Red, Green, Blue, White, ChannelCount };
+
+    explicit PowerModel(const PowerModelConfig& config);
+
+    static std::shared_ptr<const PowerModel> Current();
+    static void Publish(const PowerModelConfig& config);
+
+    const PowerModelConfig& Config() const { return _config; }
+
+    // True when every curve is a straight line through zero, which lets
+    // EstimateMw() work from channel sums instead of individual pixels
+    bool IsLinear() const { return _linear; }
+
+    uint32_t BaseMw() const { return _config.baseMw; }
+
+    // Extra draw of one LED channel at a level, in microwatts
+    uint32_t LevelUw(Channel channel, uint8_t level) const { return _lut[channel][level]; }
+
+    // Draw of count LEDs whose channel totals are sums; linear models only
+    uint32_t SumsMw(const ChannelSums& sums) const;
+
+    // Draw of count pixels, excluding BaseMw(). known, when given, are the
+    // totals for exactly these pixels and let a linear model skip the scan.
+    // sumsOut receives the totals either way.
+    uint32_t EstimateMw(const CRGB* leds, size_t count, const ChannelSums* known, ChannelSums& sumsOut) const;
+
+  private:
+    PowerModelConfig                         _config;
+    bool                                     _linear = true;
+    std::array<uint32_t, ChannelCount>       _slopeQ16 = {};     // uW per level, 16.16
+    std::array<std::array<uint32_t, 256>, ChannelCount> _lut = {};
+};
+
+// PowerCalibration
+//
+// While active, the brightness limiters report every frame's channel sums
+// (already scaled by the brightness they chose) and predicted draw. Each
+// AddMeasurement() pairs a reading from an external meter with the mean of
+// the frames seen since the previous one, so hold a steady effect - Color
+// Fill in a few different colors works well - and give the meter a moment
+// to settle before reading it.
+
+class PowerCalibration
+{
+  public:
+    struct Sample
+    {
+        double   red, green, blue, white, count;
+        uint32_t predictedMw;
+        uint32_t measuredMw;
+    };
+
+    static void Start();
+    static void Stop();
+    static void Clear();
+    static bool IsActive();
+
+    static void NoteFrame(const ChannelSums& scaledSums, uint32_t predictedMw);
+
+    // Returns false if no frames have been seen since the last sample
+    static bool AddMeasurement(uint32_t measuredMw);
+
+    static std::vector<Sample> Samples();
+
+    // Least-squares fit of base load plus a linear slope per channel. The
+    // current idle draw is kept and the base load absorbs the rest of the
+    // intercept. rmsErrorMw receives the fit's residual.
+    static std::optional<PowerModelConfig> Fit(const PowerModelConfig& current, double& rmsErrorMw);
+};
@@ -0,0 +1,159 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        previewencoder.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Per-client encoding of the live preview sent over /ws/frames and the
+//    LEDViewer port, for clients that ask for something smaller than the
+//    raw LED buffer.
+//
+//    A client negotiates a scale, the richest encoding it can decode and a
+//    frame rate cap.  Each frame is box-filtered down by the scale, laid out
+//    row-major (x across, y down, whatever the wiring), and sent as the
+//    smallest of:
+//
+//      Raw         r, g, b for every pixel
+//      RunLength   [count - 1][r][g][b] for each run of up to 256 equal pixels
+//      Delta       [skip][count] then count literal r, g, b, repeated: skip
+//                  pixels are unchanged from the frame before, the next
+//                  count replace theirs.  Pixels after the last literal are
+//                  unchanged.
+//
+//    Delta is only ever against the last frame the client actually got, so
+//    a frame dropped because the client was backed up costs nothing but the
+//    frame.  Every packet starts with a 20 byte little endian header:
+//
+//      u32 magic "NDPV", u16 width, u16 height, u8 encoding, u8 scale,
+//      u16 reserved, u32 sequence, u32 payload bytes
+//
+//    A client on the LEDViewer port asks for this format by sending an 8
+//    byte request - "NDPR", u8 scale, u8 encoding, u16 max fps - and a web
+//    client by sending a JSON text message with the same fields; clients
+//    that never ask keep getting the raw format they always have.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <vector>
+
+struct PreviewOptions
+{
+    enum Encoding : uint8_t
+    {
+        Raw       = 0,
+        RunLength = 1,
+        Delta     = 2
+    };
+
+    static constexpr uint8_t kMaxScale        = 8;
+    static constexpr uint8_t kRequestMagic[4] = { 'N', 'D', 'P', 'R' };
+    static constexpr size_t  kRequestSize     = 8;
+
+    uint8_t  scale    = 1;              // Each side of the frame is divided by this
+    Encoding encoding = Raw;            // The richest encoding the client decodes; it also gets anything simpler
+    uint16_t maxFps   = 0;              // Zero for every frame drawn
+
+    // Clamps the fields to what the encoder supports
+    PreviewOptions Normalized() const;
+
+    // Reads an 8 byte LEDViewer request; false if it doesn't start with the request magic
+    static bool FromRequest(const uint8_t* request, PreviewOptions& options);
+
+    // "raw", "rle" or "delta"; false for anything else
+    static bool ParseEncoding(const char* name, Encoding& encoding);
+    static const char* EncodingName(Encoding encoding);
+};
+
+struct PreviewClientStats
+{
+    uint32_t framesSent    = 0;
+    uint32_t framesDropped = 0;         // Skipped because the client hadn't taken the ones before
+    uint64_t bytesSent     = 0;
+};
+
+// PreviewClientReport
+//
+// One preview client as reported by the stats and the console
+
+struct PreviewClientReport
+{
+    const char*        transport;
+    uint32_t           id;
+    bool               negotiated;      // False for clients still on the original raw format
+    PreviewOptions     options;
+    PreviewClientStats stats;
+};
+
+class PreviewEncoder
+{
+  public:
+    static constexpr uint8_t kMagic[4]   = { 'N', 'D', 'P', 'V' };
+    static constexpr size_t  kHeaderSize = 20;
+
+    PreviewEncoder() = default;
+    explicit PreviewEncoder(const PreviewOptions& options);
+
+    const PreviewOptions& Options() const        { return _options; }
+    const PreviewClientStats& Stats() const      { return _stats; }
+
+    // Changes the options; the next frame goes out whole
+    void SetOptions(const PreviewOptions& options);
+
+    // False while the frame rate cap says the client should wait
+    bool IsDue(uint32_t nowMillis) const;
+
+    // Encodes a row-major width x height frame into packet, replacing what was in it.  Nothing about the
+    // frame is kept as the base for the next delta until Commit() says the client has it.
+    void Encode(const CRGB* pixels, uint16_t width, uint16_t height, std::vector<uint8_t>& packet);
+
+    // The packet from the last Encode(), or some other packet of the given size, went to the client
+    void Commit(uint32_t nowMillis, size_t bytes);
+
+    // The client was too far behind to take this frame
+    void NoteDropped()                           { _stats.framesDropped++; _encoded = false; }
+
+  private:
+    using Frame = std::vector<CRGB, psram_allocator<CRGB>>;
+
+    void Downsample(const CRGB* pixels, uint16_t width, uint16_t height);
+    void EncodeRunLength(std::vector<uint8_t>& out) const;
+    void EncodeDelta(std::vector<uint8_t>& out) const;
+
+    PreviewOptions       _options;
+    PreviewClientStats   _stats;
+    Frame                _current;
+    Frame                _previous;
+    uint16_t             _width = 0;
+    uint16_t             _height = 0;
+    uint16_t             _previousWidth = 0;
+    uint16_t             _previousHeight = 0;
+    bool                 _havePrevious = false;
+    bool                 _encoded = false;              // _current holds a frame that hasn't been committed
+    bool                 _haveSent = false;
+    uint32_t             _lastSentMillis = 0;
+    uint32_t             _sequence = 0;
+    std::vector<uint8_t> _runLength;
+    std::vector<uint8_t> _delta;
+};
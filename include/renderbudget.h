@@ -0,0 +1,83 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        renderbudget.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Tracks how long an effect's Draw() takes against the time it has per
+//    frame, and picks the quality level it should draw at to stay inside
+//    that budget.
+//
+//    The controller works on a smoothed draw time. It drops a level once
+//    the average has been over budget for a few frames running, and climbs
+//    back a level only after a much longer run with plenty of headroom, so
+//    it settles rather than hunting between two levels. After each change
+//    it holds off for a while to let the average catch up with the new
+//    cost.
+//
+//    Time comes from a clock function, micros() by default, so the
+//    controller can be driven by a fake clock off the device.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+class RenderBudget
+{
+  public:
+    using MicrosClock = uint32_t (*)();
+
+    static constexpr uint8_t  kSmoothingShift    = 3;       // Average over roughly the last eight frames
+    static constexpr uint16_t kFramesBeforeDrop  = 8;       // Over budget this long before dropping a level
+    static constexpr uint16_t kFramesBeforeRaise = 90;      // Well under budget this long before raising one
+    static constexpr uint16_t kSettleFrames      = 16;      // No changes for this long after one
+    static constexpr uint8_t  kHeadroomPercent   = 60;      // "Well under" is below this share of the budget
+
+    explicit RenderBudget(MicrosClock clock = DefaultClock);
+
+    // Time one Draw(): call BeginDraw() before it and EndDraw() after, which
+    // returns the level the next frame should be drawn at
+    void BeginDraw();
+    uint8_t EndDraw(uint32_t budgetMicros, uint8_t levels);
+
+    // The control loop itself, for a draw that took drawMicros. A change in
+    // the number of levels restarts it at the top one.
+    uint8_t NoteFrame(uint32_t drawMicros, uint32_t budgetMicros, uint8_t levels);
+
+    uint8_t  Level() const         { return _level; }
+    uint32_t AverageMicros() const { return _averageMicros; }
+    uint32_t Misses() const        { return _misses; }          // Frames whose own draw time was over budget
+
+  private:
+    static uint32_t DefaultClock();
+
+    MicrosClock _clock;
+    uint32_t    _drawStart = 0;
+    uint32_t    _averageMicros = 0;
+    uint32_t    _misses = 0;
+    uint16_t    _overStreak = 0;
+    uint16_t    _underStreak = 0;
+    uint16_t    _settleFrames = 0;
+    uint8_t     _levels = 0;
+    uint8_t     _level = 0;
+};
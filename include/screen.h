@@ -100,6 +100,12 @@ class Screen : public GFXBase, public ITaskService
 
     virtual void EndFrame();
 
+    // Whether pixels drawn in one frame are still there in the next. Displays
+    // that clear their buffer in StartFrame() return false, which turns off
+    // mirror frame diffing for them.
+
+    virtual bool KeepsPreviousFrame() const { return true; }
+
     // Display capabilities and theme colors
     // Default: color display with a blue theme and white/yellow accents.
     virtual bool IsMonochrome() const { return false; }
@@ -134,6 +140,22 @@ class Screen : public GFXBase, public ITaskService
     // Render the current page into this screen.
     void Update(bool bRedraw);
 
+    // Mirror frame
+    //
+    // Draws a cols x rows grid of RGB565 cells (the LED mirror), each cell a
+    // scale x scale block with a 1px grid gap when scale > 1. The screen keeps
+    // the last frame it pushed and only redraws cells that changed, coalescing
+    // same-colored runs where there's no grid gap. Rows where most cells
+    // changed are simply redrawn whole. Call BeginMirrorFrame, DrawMirrorRow
+    // for each row, then EndMirrorFrame.
+
+    void BeginMirrorFrame(int cols, int rows, int xOffset, int yOffset, int scale);
+    void DrawMirrorRow(int row, const uint16_t* pixels);
+    void EndMirrorFrame();
+
+    // Forget the pushed frame, e.g. after the screen was cleared
+    void InvalidateMirrorFrame() { _mirrorValid = false; }
+
     // Flip to the next page and handle effect-rotation pause/resume semantics.
     // Safe to call from button handlers.
     static void FlipToNextPage();
@@ -145,6 +167,17 @@ class Screen : public GFXBase, public ITaskService
     void Run() override;
 
   private:
+    // Rows where at least this share of cells changed are redrawn whole
+    static constexpr int kMirrorFullRowPercent = 75;
+
+    std::vector<uint16_t> _mirrorShadow;     // RGB565 cells as last pushed to the display
+    int  _mirrorCols = 0;
+    int  _mirrorRows = 0;
+    int  _mirrorX = 0;
+    int  _mirrorY = 0;
+    int  _mirrorScale = 0;
+    bool _mirrorValid = false;
+
     // Cached screen refresh FPS (updated each loop iteration)
     float _screenFPS = 0.0f;
     uint32_t _lastScreenMillis = 0;
@@ -0,0 +1,130 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        sntpclient.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    The SNTP exchange behind NTPTimeClient, kept free of WiFi and RTOS
+//    calls so it can be run against a stand-in server on the host.
+//
+//    A sync is a round of a few request/reply samples sent one after the
+//    other over a non-blocking UDP socket someone else owns and watches.
+//    Nothing here ever waits: the owner calls OnReadable() when a reply is
+//    waiting - as soon as possible, since that moment is the sample's
+//    receive time - and Poll() now and then so unanswered requests time out.
+//
+//    Each sample gives the usual NTP clock offset and round trip delay:
+//
+//      offset = ((T2 - T1) + (T3 - T4)) / 2
+//      delay  = (T4 - T1) - (T3 - T2)
+//
+//    where T1 is when the request left, T2 and T3 when the server received
+//    it and replied, and T4 when the reply arrived.  At the end of a round
+//    the sample with the shortest delay wins, having had the least chance
+//    to be skewed by queueing, and the spread of the others around it is
+//    the jitter.  Small offsets are handed over to be slewed out, large
+//    ones (and the very first) to be stepped.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <functional>
+#include <mutex>
+#include <netinet/in.h>
+
+class SntpClient
+{
+  public:
+    static constexpr size_t   kPacketSize       = 48;
+    static constexpr size_t   kSamplesPerRound  = 4;
+    static constexpr uint32_t kReplyTimeoutMs   = 1000;
+    static constexpr int64_t  kStepMicros       = 128000;     // Offsets beyond this are stepped rather than slewed
+
+    // Microseconds since the Unix epoch by the clock being disciplined
+    using WallClock = std::function<int64_t()>;
+
+    // Moves the clock by offsetMicros, at once if step is set and gradually if not
+    using Correction = std::function<void(int64_t offsetMicros, bool step)>;
+
+    struct Stats
+    {
+        bool     synced = false;
+        int64_t  offsetMicros = 0;          // Server time minus ours, from the last round
+        uint32_t delayMicros = 0;
+        uint32_t jitterMicros = 0;
+        uint32_t lastSyncMs = 0;            // Caller's millis() when the last round was applied
+        uint32_t rounds = 0;                // Rounds that corrected the clock
+        uint32_t failedRounds = 0;          // Rounds that ended without a usable sample
+        uint32_t samples = 0;
+        uint32_t timeouts = 0;
+        uint32_t rejected = 0;              // Replies that were malformed, unsynchronized or not ours
+        uint32_t steps = 0;
+        uint32_t slews = 0;
+    };
+
+    SntpClient(WallClock clock, Correction correct);
+
+    // The non-blocking UDP socket to use, or -1 when there isn't one.  Losing it ends any round in progress.
+    void SetSocket(int fd);
+    int  Socket() const;
+
+    // Sends the first request of a new round; false if a round is already running or the send fails
+    bool StartRound(const sockaddr_in& server, uint32_t nowMs);
+
+    // Reads every datagram waiting on the socket; false if the socket has failed
+    bool OnReadable(uint32_t nowMs);
+
+    // Gives up on a request that has gone unanswered for too long
+    void Poll(uint32_t nowMs);
+
+    bool  IsBusy() const;
+    Stats GetStats() const;
+
+  private:
+    struct Sample
+    {
+        int64_t offsetMicros;
+        int64_t delayMicros;
+    };
+
+    bool SendRequest(uint32_t nowMs);
+    bool AcceptReply(const uint8_t* packet, size_t length, int64_t receivedMicros);
+    void NextSample(uint32_t nowMs);
+    void FinishRound(uint32_t nowMs);
+
+    mutable std::mutex _mutex;
+    WallClock          _clock;
+    Correction         _correct;
+    int                _fd = -1;
+    sockaddr_in        _server = {};
+    bool               _busy = false;
+    size_t             _attempts = 0;                       // Requests sent this round
+    uint64_t           _sentTimestamp = 0;                  // Transmit timestamp of the outstanding request, as sent
+    int64_t            _sentMicros = 0;
+    uint32_t           _sentMs = 0;
+    bool               _awaitingReply = false;
+    Sample             _samples[kSamplesPerRound];
+    size_t             _sampleCount = 0;
+    Stats              _stats;
+};
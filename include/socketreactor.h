@@ -0,0 +1,173 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        socketreactor.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    SocketReactor is the one task that owns the device's raw TCP servers:
+//    the incoming color data port (SocketServer), the LEDViewer preview
+//    port and the telnet DebugConsole. Each of those registers an
+//    ISocketProtocol against a port; the reactor opens the listening
+//    socket once WiFi is up, accepts clients, and sleeps in select() over
+//    every socket it holds, dispatching readable and writable events to
+//    the owning protocol as soon as they happen.
+//
+//    Other tasks that have something new to say (a rendered frame for the
+//    preview viewers, say) call Wake(), which pokes a loopback UDP socket
+//    that is part of the same select() set, so the reactor never has to
+//    poll on a timer to notice.
+//
+//    Sockets that aren't accepted from a listener, such as a UDP client
+//    socket, can be handed over with Watch() and are then served the same
+//    way.
+//
+//    All protocol callbacks run on the reactor task with the reactor's
+//    lock held, so once Unlisten() returns no further callbacks will be
+//    made for that protocol.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#if ENABLE_WIFI
+
+#include <atomic>
+#include <mutex>
+#include <netinet/in.h>
+#include <vector>
+
+#include "itaskservice.h"
+
+// ISocketProtocol
+//
+// Per-port handler driven by SocketReactor. Client sockets are already
+// non-blocking when they are handed over; handlers should read or write
+// what is available and return rather than wait for more.
+
+class ISocketProtocol
+{
+  public:
+    virtual ~ISocketProtocol() = default;
+
+    // Short name for log lines
+    virtual const char* ProtocolName() const = 0;
+
+    // How many clients may be connected at once. Further connections wait
+    // in the listen backlog until a slot frees up.
+    virtual size_t MaxClients() const { return 1; }
+
+    // Close a client that has been silent for this long; 0 disables
+    virtual uint32_t IdleTimeoutMs() const { return 0; }
+
+    // A client connected. Return false to refuse it.
+    virtual bool OnConnect(int fd, const sockaddr_in& peer) { return true; }
+
+    // Data (or EOF) is waiting on fd. Return false to close the client.
+    virtual bool OnReadable(int fd) = 0;
+
+    // Asked before every wait: should the reactor watch fd for writability?
+    virtual bool WantsWrite(int fd) const { return false; }
+
+    // fd can take more data. Return false to close the client.
+    virtual bool OnWritable(int fd) { return true; }
+
+    // The client is about to be closed, for whatever reason
+    virtual void OnDisconnect(int fd) {}
+};
+
+// SocketReactor
+
+class SocketReactor : public ITaskService
+{
+  public:
+    SocketReactor() = default;
+    ~SocketReactor() override { Stop(); }
+
+    const char* Name() const override { return "SocketReactor"; }
+
+    // Register protocol as the owner of port. The listening socket is
+    // opened by the reactor task whenever WiFi is connected, and reopened
+    // if it fails, so this may be called before the network is up.
+
+    bool Listen(uint16_t port, ISocketProtocol& protocol, int backlog = 4);
+
+    // Close the listener and every client that belongs to protocol. Safe
+    // to call from any task, including from inside one of its callbacks.
+
+    void Unlisten(ISocketProtocol& protocol);
+
+    // Serve a socket protocol opened itself - a UDP socket, say - as one of
+    // its clients: OnReadable() whenever data is waiting, and closed (with
+    // OnDisconnect()) by Unlisten(), a false return or the network going
+    // down, like any other. The reactor owns fd from here on.
+
+    bool Watch(int fd, ISocketProtocol& protocol);
+
+    // Interrupt the current wait so WantsWrite() is asked again. Cheap and
+    // coalescing; safe to call from any task at any rate.
+
+    void Wake();
+
+    size_t ClientCount(const ISocketProtocol& protocol) const;
+
+  protected:
+    TaskConfig GetTaskConfig() const override;
+    void Run() override;
+    void OnBeforeWaitForStop() override { Wake(); }
+    void OnAfterStop() override;
+
+  private:
+    struct Listener
+    {
+        uint16_t         port;
+        int              backlog;
+        ISocketProtocol* protocol;
+        int              fd = -1;
+        uint32_t         retryAtMs = 0;
+    };
+
+    struct Client
+    {
+        int              fd;
+        ISocketProtocol* protocol;
+        uint32_t         lastActivityMs;
+    };
+
+    bool OpenWakeSocket();
+    void DrainWakeSocket();
+    void OpenListeners(uint32_t now);
+    void AcceptClients(size_t listenerIndex, uint32_t now);
+    void CloseClient(size_t index);
+    void CloseAll();
+
+    mutable std::recursive_mutex _mutex;
+    std::vector<Listener>        _listeners;
+    std::vector<Client>          _clients;
+    bool                         _networkUp = false;
+
+    std::atomic<int>             _wakeFd{-1};
+    sockaddr_in                  _wakeAddress = {};
+    std::atomic<bool>            _wakePending{false};
+};
+
+#endif // ENABLE_WIFI
@@ -35,10 +35,15 @@
 #include <atomic>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <vector>
 
-#include "itaskservice.h"
+#include "iservice.h"
+#include "socketreactor.h"
+#include "wirecapture.h"
+#include "wirereplay.h"
 
 #define STANDARD_DATA_HEADER_SIZE   24                                             // Size of the header for expanded data
 #define COMPRESSED_HEADER_SIZE      16                                             // Size of the header for compressed data
@@ -101,63 +106,110 @@ static_assert( sizeof(SocketResponse) == 72, "SocketResponse struct size is not
 // SocketServer
 //
 // Handles incoming connections from the server and passes the data that comes
-// in. Inherits ITaskService so the accept/read loop, shutdown signaling, and
-// listening-socket teardown all share the standard service lifecycle.
+// in. The sockets themselves belong to the SocketReactor; this class is the
+// protocol handler it calls as packet bytes arrive, reassembling each
+// sender's packets in that sender's own buffer so several can stream at once.
 
-class SocketServer : public ITaskService
+class SocketServer : public IService, public ISocketProtocol
 {
 private:
 
+    // One sender's packet in progress
+
+    struct Connection
+    {
+        int                              fd;
+        allocated_unique_ptr<uint8_t []> pBuffer;
+        size_t                           cbReceived   = 0;
+        size_t                           cbNeeded     = STANDARD_DATA_HEADER_SIZE;
+        bool                             headerParsed = false;
+    };
+
     int                         _port;
     int                         _numLeds;
+    SocketReactor*              _pReactor = nullptr;
+    std::atomic<bool>           _running{false};
 
-    // Listening socket fd. atomic<int> because release() can be invoked from
-    // both the SocketServer task (Run/begin failure paths) and from the
-    // service-stop path (OnBeforeWaitForStop, called on the caller's thread).
-    // Using atomic exchange ensures only one of those callers actually
-    // close()s the descriptor; the other observes -1 and is a no-op.
-    
-    std::atomic<int>            _server_fd{-1};
-    struct sockaddr_in          _address;
-    allocated_unique_ptr<uint8_t []> _pBuffer;
+    // Only touched from reactor callbacks, which the reactor serializes
+    std::vector<Connection>     _connections;
+    std::atomic<size_t>         _cbReceived{0};
+    uint64_t                    _responseSequence = 0;
     allocated_unique_ptr<uint8_t []> _abOutputBuffer;
 
-public:
+    // Packets are handled one at a time, whether they come from a sender or a replay
+    std::mutex                  _ingestMutex;
+    allocated_unique_ptr<uint8_t []> _abReplayBuffer;
+
+    #if ENABLE_WIRE_CAPTURE
+        std::unique_ptr<WireCapture> _pCapture;             // Created on first use and kept, so it can be saved after stopping
+        std::atomic<bool>            _capturing{false};
+    #endif
 
-    size_t                      _cbReceived;
+    Connection* FindConnection(int fd);
+    void ResetConnection(Connection& connection);
+
+    // PacketSizeFromHeader
+    //
+    // Validates a complete standard header and returns the total size of the
+    // packet it announces, or 0 if the packet is malformed or unsupported.
+
+    size_t PacketSizeFromHeader(const uint8_t * pHeader) const;
+
+    bool ProcessPacket(allocated_unique_ptr<uint8_t []>& pBuffer, size_t cbPacket, bool& bSendResponsePacket);
+    void SendResponsePacket(int fd);
+
+public:
 
     SocketServer(int port, int numLeds);
     ~SocketServer() override { Stop(); }
 
-    // IService::Name
+    // IService
+
+    bool Start() override;
+    void Stop() override;
+    bool IsRunning() const override { return _running.load(); }
     const char* Name() const override { return "SocketServer"; }
 
-    void release();
-    bool begin();
-    void ResetReadBuffer();
     void SetLEDCount(size_t numLeds) { _numLeds = numLeds; }
     size_t GetLEDCount() const { return _numLeds; }
 
-  protected:
-    // ITaskService hooks
-    TaskConfig GetTaskConfig() const override;
-    void Run() override;
-    void OnBeforeWaitForStop() override;
-
-  public:
+    // Bytes currently held in partially received packets, across all senders
+    size_t GetBytesReceived() const { return _cbReceived.load(); }
 
-    // ReadUntilNBytesReceived
+    // ReplayPacket
     //
-    // Read from the socket until the buffer contains at least cbNeeded bytes
+    // Puts a packet through the same validation and handling as one that arrives from a sender, minus the
+    // response.  False if it was rejected.
 
-    bool ReadUntilNBytesReceived(size_t socket, size_t cbNeeded);
+    bool ReplayPacket(const uint8_t* pPacket, size_t cbPacket);
 
-    // ProcessIncomingConnectionsLoop
+    // ReplayCapture
     //
-    // Socket server main ProcessIncomingConnectionsLoop - accepts new connections and reads from them, dispatching
-    // data packets into our buffer and closing the socket if anything goes weird.
+    // Plays a whole capture file back through ReplayPacket() and reports how ingest kept up
+
+    WireReplay::Stats ReplayCapture(WireCaptureReader& capture, WireReplay::Timing timing);
+
+    #if ENABLE_WIRE_CAPTURE
+        // Starts recording every packet received into a fresh capture; the ring is only sized the first time
+        bool StartCapture(size_t capacityBytes = WIRE_CAPTURE_BYTES);
+        void StopCapture() { _capturing.store(false); }
+        bool IsCapturing() const { return _capturing.load(); }
+
+        // Null until a capture has been started
+        const WireCapture* GetCapture() const { return _pCapture.get(); }
+    #endif
+
+    // ISocketProtocol
+
+    const char* ProtocolName() const override { return "SocketServer"; }
+    size_t MaxClients() const override { return INCOMING_WIFI_MAX_CLIENTS; }
+
+    // A sender that stalls mid-packet, or goes quiet, is dropped after this
+    uint32_t IdleTimeoutMs() const override { return 3000; }
 
-    bool ProcessIncomingConnectionsLoop();
+    bool OnConnect(int fd, const sockaddr_in& peer) override;
+    bool OnReadable(int fd) override;
+    void OnDisconnect(int fd) override;
 
     // DecompressBuffer
     //
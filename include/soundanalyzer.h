@@ -42,6 +42,8 @@
 #include <memory>
 #include <mutex>
 
+#include "audioinput.h"
+
 #include <esp_idf_version.h>
 #define IS_IDF5 (ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0))
 
@@ -379,6 +381,11 @@ class SoundAnalyzerBase : public ISoundAnalyzer
 
     bool IsHardwareInstalled() const { return _hardwareInstalled; }
 
+    // True if the last RunSamplerPass() slept on the input driver for a
+    // fresh block, which already paces the audio loop to the sample rate.
+
+    bool LastPassWaitedOnInput() const { return _lastPassWaitedOnInput; }
+
     void RunSamplerPass() override;
     void SimulateBeatPass() override;
     void SetPeakDecayRates(float r1, float r2) override;
@@ -492,6 +499,12 @@ class SoundAnalyzerBase : public ISoundAnalyzer
     void UpdatePeakData();
     void SetPeakDataFromRemote(const PeakData &peaks);
 
+    // Record a beat that another device detected (see audiosync.h). The local
+    // sequence still advances by one per remote beat, so effects watching
+    // LastBeat().sequence behave exactly as they do with a local mic.
+
+    void SetBeatFromRemote(uint32_t timestampMs, float msPerBeat, float confidence, float strength);
+
     // Return pointer to last captured raw samples (int16).
     // Valid until the next FillBufferI2S() call.
     const int16_t *GetSampleBuffer() const
@@ -595,16 +608,19 @@ class SoundAnalyzerBase : public ISoundAnalyzer
     std::array<float, MAX_SAMPLES> _vImaginary{};
     allocated_unique_ptr<int16_t[]> ptrSampleBuffer; // sample buffer storage
 
-#if IS_IDF5
-    i2s_chan_handle_t _rx_handle = nullptr;
-    adc_continuous_handle_t _adc_handle = nullptr;
-#endif
+    // Hann weights, applied while the samples are converted into _vReal so
+    // the FFT never makes its own windowing pass.
+    std::array<float, MAX_SAMPLES> _window{};
+
+    // The one sample source chosen by InitAudioInput; null while uninstalled.
+    std::unique_ptr<IAudioInput> _input;
 
     // Tracked per-instance so AudioService::Stop can call TeardownAudioInput
     // without risk of double-uninstalling the I2S/ADC driver. Set true on
     // a successful InitAudioInput, cleared by TeardownAudioInput.
 
     bool _hardwareInstalled = false;
+    bool _lastPassWaitedOnInput = false;
 
     // The FFT object is now a member variable to avoid ctor/dtor overhead per frame.
     // Declaration order ensures _vReal and _vImaginary address are stable when _FFT is initialized.
@@ -624,18 +640,6 @@ class SoundAnalyzerBase : public ISoundAnalyzer
     //
     // Calculate a logarithmic scale for the bands like you would find on a graphic equalizer display
     virtual const PeakData & ProcessPeaksEnergy() = 0;
-
-    void InitM5();
-    void InitI2S_Modern();
-    void InitI2S_Legacy();
-    void InitADC_Modern();
-    void InitADC_Legacy();
-
-    size_t SampleM5();
-    size_t SampleI2S_Modern();
-    size_t SampleI2S_Legacy();
-    size_t SampleADC_Modern();
-    size_t SampleADC_Legacy();
 };
 
 // SoundAnalyzer
@@ -47,6 +47,7 @@ class LEDBufferManager;
 class TaskManager;
 class RemoteControl;
 class Screen;
+class SocketReactor;
 class SocketServer;
 class WebSocketServer;
 class CWebServer;
@@ -86,6 +87,10 @@ class SystemContainer
 
     #if ENABLE_WIFI
         allocated_unique_ptr<NetworkReader> _ptrNetworkReader;
+
+        // Declared ahead of the services that register with it, so it is
+        // destroyed after them
+        allocated_unique_ptr<SocketReactor> _ptrSocketReactor;
     #endif
 
     #if ENABLE_WIFI && ENABLE_WEBSERVER
@@ -132,6 +137,9 @@ class SystemContainer
     // Helper method that checks if a pointer is initialized.
     void CheckPointer(bool initialized, const char* name) const;
 
+    // The body of ApplyRuntimeConfiguration(), run with its locks held
+    SuccessResultWithMessage ApplyRuntimeConfigurationLocked();
+
   public:
     SystemContainer();
     ~SystemContainer();
@@ -172,6 +180,10 @@ class SystemContainer
         NetworkReader& SetupNetworkReader();
         bool HasNetworkReader() const { return !!_ptrNetworkReader; }
         NetworkReader& GetNetworkReader() const;
+
+        SocketReactor& SetupSocketReactor();
+        bool HasSocketReactor() const { return !!_ptrSocketReactor; }
+        SocketReactor& GetSocketReactor() const;
     #endif
 
     #if ENABLE_WIFI && ENABLE_WEBSERVER
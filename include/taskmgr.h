@@ -63,9 +63,11 @@ class LEDStripEffect;
 #define AUDIO_STACK_SIZE   4096
 #define JSON_STACK_SIZE    4096
 #define SOCKET_STACK_SIZE  4096
+#define SOCKET_REACTOR_STACK_SIZE 8192          // Runs telnet CLI commands and packet decompression for every port
 #define NET_STACK_SIZE     8192
+#define NET_READER_STACK_SIZE 8192              // Per NetworkReader worker; readers parse JSON on their own stack
 #define COLORDATA_STACK_SIZE 4096
-#define DEBUG_STACK_SIZE   8192                 // Needs a lot of stack for output if UpdateClockFromWeb is called from debugger
+#define DEBUG_STACK_SIZE   8192                 // Needs a lot of stack for output
 #define REMOTE_STACK_SIZE  4096
 #define SCREEN_STACK_SIZE  8192
 
@@ -110,8 +112,8 @@ class IdleTask
 // CPU the rest of the system *isn't* using, and the per-effect task launcher
 // (StartEffectThread) for effects that want to spin off their own background
 // thread. All project-level service threads (AudioService, AudioSerialBridge,
-// ColorStreamerService, DebugConsole, JSONWriter, NetworkReader,
-// RemoteControl, RenderService, Screen, SocketServer) live as Run() methods
+// ColorStreamerService, JSONWriter, NetworkReader, RemoteControl,
+// RenderService, Screen, SocketReactor) live as Run() methods
 // on their respective IService classes via ITaskService and are launched
 // through g_ptrSystem->Get*().Start() — TaskManager doesn't track them.
 
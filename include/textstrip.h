@@ -0,0 +1,116 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        textstrip.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    A string rasterized once into a strip of coverage bytes, so drawing
+//    it again - or scrolling it, which is only a change of position - is a
+//    blit rather than another walk through the font's glyph bitmaps.
+//
+//    Each byte of a strip is clear, edge or ink. Edge pixels are the
+//    outline or drop shadow baked in at rasterization time, and both edge
+//    and ink are given their colors when the strip is drawn, optionally
+//    blended over what is already there.
+//
+//    TextStrip::Cached() keeps the most recently used strips, keyed by
+//    string, font, text size, style and the width the string was fitted
+//    to, so effects that redraw the same few strings every frame only
+//    rasterize them when they change.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <memory>
+#include <vector>
+
+#include <Adafruit_GFX.h>
+
+class GFXBase;
+
+class TextStrip
+{
+  public:
+    enum class Style : uint8_t
+    {
+        Plain,
+        Outline,        // Edge pixels on all four sides of the ink
+        DropShadow      // Edge pixels one down and to the right of the ink
+    };
+
+    static constexpr uint8_t kClear = 0;
+    static constexpr uint8_t kEdge  = 1;
+    static constexpr uint8_t kInk   = 2;
+
+    // A blank strip whose top left sits at (originX, originY) relative to
+    // the position it is drawn at
+    TextStrip(uint16_t width, uint16_t height, int16_t originX = 0, int16_t originY = 0);
+
+    // Rasterize text the way Adafruit_GFX::print() would draw it with the
+    // cursor at the origin. If maxWidth is not negative, characters are
+    // dropped from the end until the ink fits in that many pixels.
+    static std::shared_ptr<const TextStrip> Rasterize(const String& text, const GFXfont* font, uint8_t sizeX, uint8_t sizeY, Style style, int maxWidth = -1);
+
+    // Rasterize(), through the cache
+    static std::shared_ptr<const TextStrip> Cached(const String& text, const GFXfont* font, uint8_t sizeX, uint8_t sizeY, Style style, int maxWidth = -1);
+
+    uint16_t Width() const   { return _width; }
+    uint16_t Height() const  { return _height; }
+    int16_t  OriginX() const { return _originX; }
+    int16_t  OriginY() const { return _originY; }
+
+    // Bounds of the ink alone, relative to the drawing position, as
+    // getTextBounds() would report them for the text the strip holds
+    int16_t  InkX() const      { return _inkX; }
+    int16_t  InkY() const      { return _inkY; }
+    uint16_t InkWidth() const  { return _inkWidth; }
+    uint16_t InkHeight() const { return _inkHeight; }
+
+    bool IsEmpty() const { return _inkWidth == 0; }
+
+    uint8_t At(int x, int y) const { return _pixels[size_t(y) * _width + x]; }
+    void Set(int x, int y, uint8_t value);
+    void SetInkBounds(int16_t x, int16_t y, uint16_t width, uint16_t height);
+
+    // Draw with the strip's origin offset from (x, y), clipped to the
+    // matrix. At full alpha the pixels are written as print() writes them.
+    void Draw(GFXBase& g, int x, int y, const CRGB& ink, const CRGB& edge = CRGB::Black, uint8_t alpha = 255) const;
+
+    // Blend row stripY of the strip into a row of pixels, the strip's left
+    // edge at column left, clipped to rowWidth
+    void DrawRow(int stripY, CRGB* row, int rowWidth, int left, const CRGB& ink, const CRGB& edge, uint8_t alpha) const;
+
+  private:
+    uint16_t _width;
+    uint16_t _height;
+    int16_t  _originX;
+    int16_t  _originY;
+
+    int16_t  _inkX = 0;
+    int16_t  _inkY = 0;
+    uint16_t _inkWidth = 0;
+    uint16_t _inkHeight = 0;
+
+    std::vector<uint8_t, psram_allocator<uint8_t>> _pixels;
+};
@@ -44,9 +44,15 @@ struct Values
     uint32_t FPS = 0;                                                       // Our global framerate
     bool UpdateStarted = false;                                             // Has an OTA update started?
     uint8_t Fader = 255;
+    uint32_t EffectDrawMicros = 0;                                          // Smoothed Draw() time of the current effect
+    uint8_t EffectQualityLevel = 0;                                         // Quality level the current effect draws at
+    uint32_t EffectBudgetMisses = 0;                                        // Frames the current effect overran its draw budget
+    uint32_t ReconfigureBlackoutMicros = 0;                                 // Time the last runtime reconfiguration held up drawing
 #if USE_HUB75
     int MatrixPowerMilliwatts = 0;                                         // Matrix power draw in mw
     uint8_t MatrixScaledBrightness = 255;                                  // 0-255 scaled brightness to stay in limit
+    uint32_t MatrixSwapWaitMicros = 0;                                     // Smoothed time spent waiting on SmartMatrix buffer swaps per frame
+    uint32_t MatrixSwapCopyMicros = 0;                                     // Smoothed time spent copying frame buffers per frame
 #endif
 };
 
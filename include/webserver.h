@@ -46,6 +46,8 @@
 #include <atomic>
 #include <ESPAsyncWebServer.h>
 #include <map>
+#include <utility>
+#include <vector>
 
 #include "deviceconfig.h"
 #include "iservice.h"
@@ -184,7 +186,7 @@ class CWebServer : public IService
     const std::vector<std::reference_wrapper<SettingSpec>> & LoadDeviceSettingSpecs();
     bool EnsureDeviceSettingSpecsJson();
     bool BuildSettingSpecsJson(String& json, const std::vector<std::reference_wrapper<SettingSpec>> & settingSpecs);
-    void SendSettingSpecsResponse(AsyncWebServerRequest * pRequest, const std::vector<std::reference_wrapper<SettingSpec>> & settingSpecs);
+    void SendSettingSpecsResponse(AsyncWebServerRequest * pRequest, std::vector<std::reference_wrapper<SettingSpec>> settingSpecs, std::shared_ptr<const void> owner = nullptr);
     SuccessResultWithMessage ValidateLegacyDeviceSettings(AsyncWebServerRequest * pRequest);
     SuccessResultWithMessage SetSettingsIfPresent(AsyncWebServerRequest * pRequest);
 
@@ -198,11 +200,12 @@ class CWebServer : public IService
     long GetEffectIndexFromParam(AsyncWebServerRequest * pRequest, bool post = false);
     bool CheckAndGetSettingsEffect(AsyncWebServerRequest * pRequest, std::shared_ptr<LEDStripEffect> & effect, bool post = false);
     void SendEffectSettingsResponse(AsyncWebServerRequest * pRequest, std::shared_ptr<LEDStripEffect> & effect);
-    bool ApplyEffectSettings(AsyncWebServerRequest * pRequest, std::shared_ptr<LEDStripEffect> & effect);
+    bool ApplyEffectSettings(AsyncWebServerRequest * pRequest, std::shared_ptr<LEDStripEffect> & effect, std::vector<std::pair<String, String>> * pApplied = nullptr);
 
     // Endpoint member functions
 
     void GetEffectListText(AsyncWebServerRequest * pRequest);
+    void GetEffectsConfig(AsyncWebServerRequest * pRequest);
     void GetSettingSpecs(AsyncWebServerRequest * pRequest);
     void GetSettings(AsyncWebServerRequest * pRequest);
     void SetSettings(AsyncWebServerRequest * pRequest);
@@ -35,10 +35,16 @@
 
 #if WEB_SOCKETS_ANY_ENABLED
 
+#include <algorithm>
 #include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
 
 #include "effectmanager.h"
 #include "iservice.h"
+#include "jsonserializer.h"
+#include "previewencoder.h"
 #include "webserver.h"
 
 // WebSocketServer
@@ -57,6 +63,16 @@
 //
 // Always Start CWebServer before WebSocketServer, and Stop in reverse
 // order; otherwise Start() refuses (Stop is harmless).
+//
+// A frame client can ask for a smaller preview by sending a JSON text
+// message such as {"scale":2,"encoding":"delta","maxFps":15}; from then on
+// it gets PreviewEncoder packets instead of the raw LEDs (see
+// previewencoder.h).  Requests arrive on the web server's task and are
+// only queued there; the frame sender applies them, so the socket library
+// is never called with a lock held that its own task might want.  The
+// same goes for connects and disconnects: the sender works from a copy of
+// the connected ids and only reaches clients through the library's id-based
+// calls, which look them up under its own lock.
 
 class WebSocketServer : public IEffectEventListener, public IService
 {
@@ -67,6 +83,79 @@ class WebSocketServer : public IEffectEventListener, public IService
     static constexpr size_t _maxColorNumberLen = sizeof(NAME_OF(16777215)) - 1; // (uint32_t)CRGB(255,255,255) == 16777215
     static constexpr size_t _maxCountLen = sizeof(NAME_OF(4294967295)) - 1;     // SIZE_MAX == 4294967295
 
+    struct PreviewClient
+    {
+        PreviewEncoder encoder;
+        bool           negotiated = false;
+    };
+
+    std::mutex                                       _previewMutex;     // Guards _previewClients and _previewPacket
+    std::map<uint32_t, PreviewClient>                _previewClients;
+    std::vector<uint8_t>                             _previewPacket;
+    std::mutex                                       _requestMutex;     // Guards _previewRequests and _frameClientIds
+    std::vector<std::pair<uint32_t, PreviewOptions>> _previewRequests;
+    std::vector<uint32_t>                            _frameClientIds;
+
+    // OnColorDataEvent
+    //
+    // Tracks which frame clients are connected and queues their preview
+    // requests for the frame sender to pick up
+
+    void OnColorDataEvent(AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len)
+    {
+        if (type == WS_EVT_CONNECT || type == WS_EVT_DISCONNECT)
+        {
+            std::lock_guard guard(_requestMutex);
+            _frameClientIds.erase(std::remove(_frameClientIds.begin(), _frameClientIds.end(), client->id()), _frameClientIds.end());
+            if (type == WS_EVT_CONNECT)
+                _frameClientIds.push_back(client->id());
+            return;
+        }
+
+        if (type != WS_EVT_DATA)
+            return;
+
+        const auto* info = static_cast<const AwsFrameInfo*>(arg);
+        if (!info->final || info->index != 0 || info->len != len || info->opcode != WS_TEXT)
+            return;
+
+        auto doc = CreateJsonDocument();
+        if (deserializeJson(doc, data, len) != DeserializationError::Ok)
+        {
+            debugW("Ignoring malformed preview request from frame client %u", client->id());
+            return;
+        }
+
+        PreviewOptions options;
+        if (!PreviewOptions::ParseEncoding(doc["encoding"] | "raw", options.encoding))
+        {
+            debugW("Ignoring preview request with unknown encoding from frame client %u", client->id());
+            return;
+        }
+        options.scale  = std::clamp(doc["scale"] | 1, 1, (int)PreviewOptions::kMaxScale);
+        options.maxFps = std::clamp(doc["maxFps"] | 0, 0, 1000);
+
+        std::lock_guard guard(_requestMutex);
+        _previewRequests.emplace_back(client->id(), options);
+    }
+
+    // Called with _previewMutex held
+    void ApplyPreviewRequests()
+    {
+        std::vector<std::pair<uint32_t, PreviewOptions>> requests;
+        {
+            std::lock_guard guard(_requestMutex);
+            requests.swap(_previewRequests);
+        }
+
+        for (const auto& [id, options] : requests)
+        {
+            auto& preview = _previewClients[id];
+            preview.encoder.SetOptions(options);
+            preview.negotiated = true;
+        }
+    }
+
 public:
 
     WebSocketServer(CWebServer& webServer) :
@@ -95,6 +184,10 @@ public:
         }
 
         #if COLORDATA_WEB_SOCKET_ENABLED
+            _colorDataSocket.onEvent([this](AsyncWebSocket*, AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len)
+            {
+                OnColorDataEvent(client, type, arg, data, len);
+            });
             _webServer.AddWebSocket(_colorDataSocket);
         #endif
         #if EFFECTS_WEB_SOCKET_ENABLED
@@ -122,6 +215,16 @@ public:
             _webServer.RemoveWebSocket(_effectChangeSocket);
         #endif
 
+        {
+            std::lock_guard guard(_previewMutex);
+            _previewClients.clear();
+        }
+        {
+            std::lock_guard guard(_requestMutex);
+            _previewRequests.clear();
+            _frameClientIds.clear();
+        }
+
         _running.store(false);
     }
 
@@ -139,13 +242,72 @@ public:
         return _colorDataSocket.count() > 0;
     }
 
-    // Send the color data for an array of leds of indicated length.
-    void SendColorData(CRGB* leds, size_t count)
+    // SendColorData
+    //
+    // Sends a frame to each frame client that is due one: the LEDs as wired to clients still on the raw
+    // format, and the row-major frame, encoded for the client, to those that asked for a preview.  A client
+    // whose queue is full misses this one and simply gets the latest when it catches up.  Clients are only
+    // addressed by id, so one that disconnects part way through is skipped rather than touched after the
+    // library has freed it.
+
+    void SendColorData(const CRGB* leds, size_t count, const CRGB* frame, uint16_t width, uint16_t height)
     {
-        if (!HaveColorDataClients() || leds == nullptr || count == 0 || !_colorDataSocket.availableForWriteAll())
+        if (!HaveColorDataClients() || leds == nullptr || count == 0)
             return;
 
-        _colorDataSocket.binaryAll((uint8_t *)leds, count * sizeof(CRGB));
+        std::vector<uint32_t> clientIds;
+        {
+            std::lock_guard guard(_requestMutex);
+            clientIds = _frameClientIds;
+        }
+
+        std::lock_guard guard(_previewMutex);
+        ApplyPreviewRequests();
+
+        const uint32_t now = millis();
+        for (uint32_t id : clientIds)
+        {
+            auto& preview = _previewClients[id];
+            if (!preview.encoder.IsDue(now))
+                continue;
+
+            if (!_colorDataSocket.availableForWrite(id))
+            {
+                preview.encoder.NoteDropped();
+                continue;
+            }
+
+            const uint8_t* packet = (const uint8_t*)leds;
+            size_t bytes = count * sizeof(CRGB);
+            if (preview.negotiated && frame != nullptr)
+            {
+                preview.encoder.Encode(frame, width, height, _previewPacket);
+                packet = _previewPacket.data();
+                bytes = _previewPacket.size();
+            }
+
+            if (_colorDataSocket.binary(id, packet, bytes))
+                preview.encoder.Commit(now, bytes);
+            else
+                preview.encoder.NoteDropped();
+        }
+
+        // Forget the clients that have gone
+        for (auto it = _previewClients.begin(); it != _previewClients.end(); )
+        {
+            if (_colorDataSocket.client(it->first) == nullptr)
+                it = _previewClients.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    void AppendPreviewClients(std::vector<PreviewClientReport>& reports)
+    {
+        std::lock_guard guard(_previewMutex);
+
+        for (const auto& [id, preview] : _previewClients)
+            reports.push_back({ "websocket", id, preview.negotiated, preview.encoder.Options(), preview.encoder.Stats() });
     }
 
     void OnCurrentEffectChanged(size_t currentEffectIndex) override
@@ -0,0 +1,116 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        wirecapture.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Records the packets the socket server receives, exactly as they came
+//    off the wire, so a session can be saved and played back later.
+//
+//    A capture file is an 8 byte header - "NDWC", a 16-bit version and two
+//    reserved bytes - followed by one record per packet: the microseconds
+//    since the packet before it and the packet's length, both 32-bit little
+//    endian, then the packet bytes.
+//
+//    WireCapture records into a fixed-size ring, PSRAM where there is some,
+//    and when the ring is full drops the oldest packets to make room, so it
+//    always holds the most recent stretch of traffic.  WireCaptureReader
+//    walks the records of a capture file held in memory.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <functional>
+#include <mutex>
+
+class WireCapture
+{
+  public:
+    static constexpr uint8_t  kMagic[4]    = { 'N', 'D', 'W', 'C' };
+    static constexpr uint16_t kVersion     = 1;
+    static constexpr size_t   kFileHeader  = 8;
+    static constexpr size_t   kRecordHeader = 8;
+
+    // Called with consecutive pieces of the capture file; returns false to stop
+    using Writer = std::function<bool(const uint8_t* data, size_t length)>;
+
+    explicit WireCapture(size_t capacityBytes);
+
+    // Adds a packet received at timestampMicros; false if it's bigger than the whole ring
+    bool Record(const uint8_t* packet, size_t length, uint32_t timestampMicros);
+
+    void Clear();
+
+    // Writes the capture out, oldest packet first, and returns the bytes written.  Record() waits for this
+    // to finish, so stop feeding the capture before saving it somewhere slow.
+    size_t Save(const Writer& write) const;
+
+    size_t   Capacity() const   { return _capacity; }
+    size_t   Records() const;
+    size_t   Bytes() const;                     // Size Save() would write
+    uint32_t Dropped() const;                   // Packets pushed out of a full ring, or too big for it
+
+  private:
+    void Put(const uint8_t* data, size_t length);
+    void Get(size_t position, uint8_t* data, size_t length) const;
+    void DropOldest();
+
+    mutable std::mutex               _mutex;
+    allocated_unique_ptr<uint8_t []> _ring;
+    size_t                           _capacity;
+    size_t                           _head = 0;             // Where the next record goes
+    size_t                           _tail = 0;             // Where the oldest record starts
+    size_t                           _used = 0;
+    size_t                           _records = 0;
+    uint32_t                         _dropped = 0;
+    uint32_t                         _lastTimestamp = 0;
+};
+
+struct WireCaptureRecord
+{
+    uint32_t       deltaMicros;                 // Since the packet before it; meaningless for the first one
+    const uint8_t* data;
+    size_t         length;
+};
+
+class WireCaptureReader
+{
+  public:
+    // The capture stays owned by the caller, and must outlive the reader
+    WireCaptureReader(const uint8_t* capture, size_t length);
+
+    // True if the capture starts with a header this version understands
+    bool IsValid() const { return _valid; }
+
+    // Moves to the next record; false at the end, or where the capture is cut short
+    bool Next(WireCaptureRecord& record);
+
+    void Rewind() { _position = WireCapture::kFileHeader; }
+
+  private:
+    const uint8_t* _capture;
+    size_t         _length;
+    size_t         _position;
+    bool           _valid;
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+//+--------------------------------------------------------------------------
+//
+// File:        wirereplay.h
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Plays a wire capture back into an ingest function - normally the
+//    socket server's own packet handling - and measures how it copes.
+//
+//    Packets go in either on the schedule they were captured with or back
+//    to back as fast as the ingest takes them.  On schedule, a packet that
+//    can't be handed over until well after it was due counts as late; the
+//    schedule is never stretched, so an ingest that can't keep up shows
+//    as a growing run of late packets rather than a slower replay.
+//
+//    Time comes from clock and wait functions, micros() and delays by
+//    default, so the replay can also run against a fake clock.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <functional>
+
+#include "wirecapture.h"
+
+class WireReplay
+{
+  public:
+    using MicrosClock = uint32_t (*)();
+    using MicrosWait  = void (*)(uint32_t micros);
+
+    // Hands one packet to the code under test; false if it rejected it
+    using Ingest = std::function<bool(const uint8_t* packet, size_t length)>;
+
+    // Optionally samples how many frames are queued after each packet
+    using DepthProbe = std::function<size_t()>;
+
+    static constexpr uint32_t kLateMicros = 10000;     // Handed over this long after it was due makes a packet late
+
+    enum class Timing
+    {
+        Original,
+        Fast
+    };
+
+    struct Stats
+    {
+        uint32_t packets = 0;
+        uint32_t failed = 0;
+        uint32_t late = 0;
+        uint32_t compressed = 0;
+        uint64_t bytes = 0;
+        uint64_t ingestMicros = 0;
+        uint64_t compressedMicros = 0;              // Share of ingestMicros spent on compressed packets
+        uint32_t maxIngestMicros = 0;
+        uint32_t maxLateMicros = 0;
+        uint32_t elapsedMicros = 0;
+        size_t   maxDepth = 0;
+        uint64_t depthTotal = 0;                    // Sum of the depth samples, one per packet
+
+        uint32_t PacketsPerSecond() const;
+        uint32_t AverageIngestMicros() const;
+        uint32_t AverageCompressedMicros() const;   // Ingest time per compressed packet, decompression included
+    };
+
+    explicit WireReplay(MicrosClock clock = DefaultClock, MicrosWait wait = DefaultWait);
+
+    Stats Run(WireCaptureReader& capture, Timing timing, const Ingest& ingest, const DepthProbe& depth = nullptr);
+
+  private:
+    static uint32_t DefaultClock();
+    static void DefaultWait(uint32_t micros);
+
+    MicrosClock _clock;
+    MicrosWait  _wait;
+};
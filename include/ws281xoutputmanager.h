@@ -59,6 +59,17 @@ class WS281xOutputManager : public IStripOutputManager
 
     size_t GetActiveChannelCount() const override { return _activeChannelCount; }
     size_t GetActiveLEDCount() const override { return _activeLEDCount; }
+
+    // Cost of the legacy RMT driver's buffer refills, which run in its ISR; all zero on IDF 5, where the
+    // driver does its own encoding
+    struct TranslatorStats
+    {
+        uint32_t refills;
+        uint32_t averageCycles;         // Smoothed over the last few refills
+        uint32_t maxCycles;             // Since the last ApplyConfig()
+    };
+
+    static TranslatorStats GetTranslatorStats();
 };
 
 #endif
@@ -25,6 +25,13 @@ import sys
 
 client = '192.168.8.47'        
 
+# Set multicast to True to publish AudioSync snapshots (see include/audiosync.h) instead of
+# connecting to one device. Every device built with AUDIO_SYNC_SUBSCRIBE=1 on the LAN follows along.
+
+multicast       = False
+multicast_group = '239.78.68.65'
+multicast_port  = 49153
+
 # Set up audio input stream. 512@24000 gives a nice framerate.  And 512
 # is what I run on the ESP32 if connected via hardware mic, so at least it matches
 
@@ -79,7 +86,11 @@ stream = p.open(format=pyaudio.paFloat32, channels=1, rate=sample_rate, input=Tr
 while True:
 
     # Connect to the socket we will be sending to if its not already connected
-    if sock == None:
+    if sock == None and multicast:
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+        sock.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_TTL, 1)
+        sequence = 0
+    elif sock == None:
         sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
         address = (client, 49152)
         sock.connect(address)
@@ -122,6 +133,18 @@ while True:
     print(bargraphs)
     sys.stdout.write('*')
 
+    # In multicast mode, compose an AudioSyncPacket instead. The host does no beat detection
+    # so the beat fields stay zero and subscribers pulse on the spectrum alone.
+
+    if multicast:
+        sequence += 1
+        vu = float(np.mean(scaled_values))
+        header = struct.pack('<IHHIIfffIIfff', 0x5541444E, 1, num_bands, sequence & 0xFFFFFFFF,
+                             int(time.monotonic() * 1000) & 0xFFFFFFFF, vu, 1.0, 1.0, 0, 0, 0.0, 0.0, 0.0)
+        sock.sendto(header + struct.pack('<' + 'f' * num_bands, *scaled_values), (multicast_group, multicast_port))
+        time.sleep(0.015)
+        continue
+
     # Compose and send the PEAKDATA packet to be sent to the ESP32 NightDriverStrip instance
 
     packed_data = struct.pack('f' * len(scaled_values), *scaled_values)
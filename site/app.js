@@ -97,6 +97,7 @@ $$$$$$$b   *u    ^$L            $$  $$$$$$$$$$$$u@       $$  d$$$$$$
       connected: false,
       frame: null,
       latestFrame: null,
+      rowMajor: false,
       dirty: false,
       animationFrameId: 0,
       receivedFrames: 0,
@@ -1612,12 +1613,16 @@ $$$$$$$b   *u    ^$L            $$  $$$$$$$$$$$$u@       $$  d$$$$$$
       els.previewStatus.textContent = "Preview connected";
       toast("Frame preview connected.", "success");
       refreshPreviewVisibility();
+      // Ask for delta-encoded frames; until the device has read this it keeps
+      // sending the raw LED buffer, which the message handler still takes.
+      socket.send(JSON.stringify({ scale: 1, encoding: "delta" }));
     };
     socket.onclose = function () {
       state.preview.connected = false;
       state.preview.socket = null;
       state.preview.frame = null;
       state.preview.latestFrame = null;
+      state.preview.rowMajor = false;
       state.preview.dirty = false;
       resetPreviewMetrics();
       stopPreviewRenderLoop();
@@ -1630,9 +1635,20 @@ $$$$$$$b   *u    ^$L            $$  $$$$$$$$$$$$u@       $$  d$$$$$$
     };
     socket.onmessage = function (event) {
       try {
-        state.preview.latestFrame = new Uint8Array(event.data);
+        const message = new Uint8Array(event.data);
+        if (isPreviewPacket(message)) {
+          const frame = decodePreviewPacket(message, state.preview.rowMajor ? state.preview.latestFrame : null);
+          if (!frame) {
+            return;
+          }
+          state.preview.latestFrame = frame;
+          state.preview.rowMajor = true;
+        } else {
+          state.preview.latestFrame = message;
+          state.preview.rowMajor = false;
+        }
         state.preview.receivedFrames += 1;
-        state.preview.receivedBytes += state.preview.latestFrame.length;
+        state.preview.receivedBytes += message.length;
         state.preview.dirty = true;
         updatePreviewMetrics();
         refreshPreviewVisibility();
@@ -1644,6 +1660,60 @@ $$$$$$$b   *u    ^$L            $$  $$$$$$$$$$$$u@       $$  d$$$$$$
     state.preview.socket = socket;
   }
 
+  // Preview packets (see include/previewencoder.h): a 20 byte little endian
+  // header - "NDPV", width, height, encoding, scale, reserved, sequence and
+  // payload length - then the payload, row-major RGB once decoded.
+  const PREVIEW_HEADER_SIZE = 20;
+
+  function isPreviewPacket(message) {
+    return message.length >= PREVIEW_HEADER_SIZE &&
+      message[0] === 0x4e && message[1] === 0x44 && message[2] === 0x50 && message[3] === 0x56;
+  }
+
+  function decodePreviewPacket(message, previous) {
+    const view = new DataView(message.buffer, message.byteOffset, message.byteLength);
+    const width = view.getUint16(4, true);
+    const height = view.getUint16(6, true);
+    const encoding = message[8];
+    const payloadLength = view.getUint32(16, true);
+    const payload = message.subarray(PREVIEW_HEADER_SIZE, PREVIEW_HEADER_SIZE + payloadLength);
+    const frame = new Uint8Array(width * height * 3);
+
+    if (encoding === 0) {
+      frame.set(payload.subarray(0, frame.length));
+    } else if (encoding === 1) {
+      let offset = 0;
+      for (let i = 0; i + 3 < payload.length; i += 4) {
+        for (let run = payload[i] + 1; run > 0 && offset < frame.length; run -= 1, offset += 3) {
+          frame[offset] = payload[i + 1];
+          frame[offset + 1] = payload[i + 2];
+          frame[offset + 2] = payload[i + 3];
+        }
+      }
+    } else if (encoding === 2) {
+      // Deltas patch the frame before; without a matching one there is nothing to patch
+      if (!previous || previous.length !== frame.length) {
+        return null;
+      }
+      frame.set(previous);
+      let offset = 0;
+      for (let i = 0; i + 1 < payload.length; ) {
+        offset += payload[i] * 3;
+        const literalBytes = payload[i + 1] * 3;
+        if (offset + literalBytes > frame.length || i + 2 + literalBytes > payload.length) {
+          return null;
+        }
+        frame.set(payload.subarray(i + 2, i + 2 + literalBytes), offset);
+        offset += literalBytes;
+        i += 2 + literalBytes;
+      }
+    } else {
+      return null;
+    }
+
+    return frame;
+  }
+
   function disconnectPreviewSocket() {
     state.preview.shouldReconnect = false;
     if (state.preview.reconnectTimer) {
@@ -1657,6 +1727,7 @@ $$$$$$$b   *u    ^$L            $$  $$$$$$$$$$$$u@       $$  d$$$$$$
     state.preview.connected = false;
     state.preview.frame = null;
     state.preview.latestFrame = null;
+    state.preview.rowMajor = false;
     state.preview.dirty = false;
     resetPreviewMetrics();
     stopPreviewRenderLoop();
@@ -1774,7 +1845,7 @@ $$$$$$$b   *u    ^$L            $$  $$$$$$$$$$$$u@       $$  d$$$$$$
     for (let y = 0; y < height; y += 1) {
       const top = y * metrics.pixelHeight;
       for (let x = 0; x < width; x += 1) {
-        const offset = getPreviewFrameOffset(x, y, width, height, serpentine);
+        const offset = state.preview.rowMajor ? (y * width + x) * 3 : getPreviewFrameOffset(x, y, width, height, serpentine);
         const red = frame[offset] || 0;
         const green = frame[offset + 1] || 0;
         const blue = frame[offset + 2] || 0;
@@ -0,0 +1,573 @@
+//+--------------------------------------------------------------------------
+//
+// File:        audioinput.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Driver backends behind IAudioInput. Each one is sized so a single DMA
+//    completion carries one analyzer block of MAX_SAMPLES, and each Read()
+//    sleeps on the driver's own completion signal:
+//
+//      I2S (IDF5 and legacy)   the driver's DMA-done queue, via a blocking read
+//      ADC continuous (IDF5)   on_conv_done ISR callback -> task notification
+//      ADC via I2S (legacy)    the driver's DMA-done queue, via a blocking read
+//      M5 mic                  M5Unified's recorder task; we wait for it to finish
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "audioinput.h"
+#include "soundanalyzer.h"
+
+#if ENABLE_AUDIO
+
+#if USE_M5
+    #include <M5Unified.h>
+#endif
+
+namespace
+{
+    constexpr uint32_t kSampleRate = SoundAnalyzerBase::SAMPLING_FREQUENCY;
+
+    [[maybe_unused]] bool CheckAudioErr(esp_err_t err, const char* what)
+    {
+        if (err == ESP_OK)
+            return true;
+
+        debugE("Audio: %s failed: %s", what, esp_err_to_name(err));
+        return false;
+    }
+
+    // Convert one 32-bit I2S slot (24 significant bits, left justified) to int16.
+    [[maybe_unused]] inline int16_t I2SWordToSample(int32_t word)
+    {
+        return (int16_t)std::clamp(word >> 15, (int32_t)INT16_MIN, (int32_t)INT16_MAX);
+    }
+
+#if USE_M5 && !AUDIO_INPUT_SYNTHETIC
+
+    // M5AudioInput
+    //
+    // M5Unified owns the I2S peripheral and fills our buffer from its own task,
+    // exposing no completion callback, so Read() queues the buffer and then
+    // sleeps a tick at a time until the recorder hands it back. Waiting here
+    // also stops the analyzer from reading a buffer the recorder is still
+    // writing into.
+
+    class M5AudioInput : public IAudioInput
+    {
+      public:
+        const char* Name() const override { return "M5 Mic"; }
+
+        bool Begin(int) override
+        {
+            debugI("Audio: Initializing M5Stack Microphone");
+            // Can't use speaker and mic at the same time, and speaker defaults on, so turn it off
+            M5.Speaker.setVolume(255);
+            M5.Speaker.end();
+            auto cfg = M5.Mic.config();
+            cfg.sample_rate = kSampleRate;
+            cfg.noise_filter_level = 0;
+            cfg.magnification = 8;
+            M5.Mic.config(cfg);
+            return M5.Mic.begin();
+        }
+
+        void End() override
+        {
+            M5.Mic.end();
+        }
+
+        size_t Read(int16_t* dest, size_t count, uint32_t timeoutMs) override
+        {
+            if (!M5.Mic.record(dest, count, kSampleRate, false))
+                return 0;
+
+            const uint32_t start = millis();
+            while (M5.Mic.isRecording())
+            {
+                if (millis() - start >= timeoutMs)
+                    return 0;
+                vTaskDelay(1);
+            }
+            return count;
+        }
+    };
+
+#elif (USE_I2S_AUDIO || ELECROW) && IS_IDF5 && !AUDIO_INPUT_SYNTHETIC
+
+    // I2SStdInput
+    //
+    // External digital mic (INMP441 etc.) on the IDF5 standard-mode driver.
+    // The DMA frame is one analyzer block, so i2s_channel_read() returns as
+    // soon as the interrupt posts that block to the driver's queue.
+
+    class I2SStdInput : public IAudioInput
+    {
+      public:
+        const char* Name() const override { return "I2S (IDF5)"; }
+
+        bool Begin(int inputPin) override
+        {
+            debugI("Audio: Initializing I2S Digital Mic (Modern) on BCLK:%d WS:%d DIN:%d", I2S_BCLK_PIN, I2S_WS_PIN, inputPin);
+
+            // Digital Microphones (INMP441, etc.) - Standard I2S Mode
+            i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_AUTO, I2S_ROLE_MASTER);
+            chan_cfg.dma_desc_num = kDmaBlocks;
+            chan_cfg.dma_frame_num = MAX_SAMPLES;
+            if (!CheckAudioErr(i2s_new_channel(&chan_cfg, NULL, &_rx), "i2s_new_channel"))
+                return false;
+
+            i2s_std_config_t std_cfg = {
+                .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(kSampleRate),
+                .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_32BIT, I2S_SLOT_MODE_STEREO),
+                .gpio_cfg = {
+                    .mclk = I2S_GPIO_UNUSED,
+                    .bclk = I2S_BCLK_PIN,
+                    .ws = I2S_WS_PIN,
+                    .dout = I2S_GPIO_UNUSED,
+                    .din = static_cast<gpio_num_t>(inputPin),
+                },
+            };
+
+            if (!CheckAudioErr(i2s_channel_init_std_mode(_rx, &std_cfg), "i2s_channel_init_std_mode")
+                || !CheckAudioErr(i2s_channel_enable(_rx), "i2s_channel_enable"))
+            {
+                End();
+                return false;
+            }
+            return true;
+        }
+
+        void End() override
+        {
+            if (!_rx)
+                return;
+
+            // Stop the hardware first to kill any active DMA transfers
+            const esp_err_t disableErr = i2s_channel_disable(_rx);
+            if (disableErr != ESP_OK)
+                debugW("Audio: i2s_channel_disable returned %d", (int)disableErr);
+            const esp_err_t delErr = i2s_del_channel(_rx);
+            if (delErr != ESP_OK)
+                debugW("Audio: i2s_del_channel returned %d", (int)delErr);
+            _rx = nullptr;
+        }
+
+        size_t Read(int16_t* dest, size_t count, uint32_t timeoutMs) override
+        {
+            count = std::min(count, (size_t)MAX_SAMPLES);
+            size_t bytesRead = 0;
+            if (i2s_channel_read(_rx, _raw.data(), count * kChannels * sizeof(int32_t), &bytesRead, pdMS_TO_TICKS(timeoutMs)) != ESP_OK)
+                return 0;
+
+            const size_t frames = bytesRead / (kChannels * sizeof(int32_t));
+            for (size_t i = 0; i < frames; i++)
+                dest[i] = I2SWordToSample(_raw[i * kChannels]);     // Left channel
+            return frames;
+        }
+
+      private:
+        static constexpr int kChannels  = 2;
+        static constexpr int kDmaBlocks = 3;
+
+        i2s_chan_handle_t _rx = nullptr;
+        std::array<int32_t, MAX_SAMPLES * kChannels> _raw{};
+    };
+
+#elif (USE_I2S_AUDIO || ELECROW) && !IS_IDF5 && !AUDIO_INPUT_SYNTHETIC
+
+    // I2SLegacyInput
+    //
+    // External digital mic on the IDF4 driver. dma_buf_len is one analyzer
+    // block, so i2s_read() wakes on the RX-done interrupt for that buffer.
+
+    class I2SLegacyInput : public IAudioInput
+    {
+      public:
+        const char* Name() const override { return "I2S (Legacy)"; }
+
+        bool Begin(int inputPin) override
+        {
+            debugI("Audio: Initializing I2S Digital Mic (Legacy) on BCLK:%d WS:%d DIN:%d", I2S_BCLK_PIN, I2S_WS_PIN, inputPin);
+            const i2s_config_t i2s_config = {.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX),
+                                             .sample_rate = kSampleRate,
+                                             .bits_per_sample = I2S_BITS_PER_SAMPLE_32BIT,
+                                             .channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT,
+                                             .communication_format = I2S_COMM_FORMAT_STAND_I2S,
+                                             .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
+                                             .dma_buf_count = 4,
+                                             .dma_buf_len = (int)MAX_SAMPLES,
+                                             .use_apll = false,
+                                             .tx_desc_auto_clear = false,
+                                             .fixed_mclk = 0};
+
+            pinMode(I2S_BCLK_PIN, OUTPUT);
+            pinMode(I2S_WS_PIN, OUTPUT);
+            pinMode(inputPin, INPUT);
+
+            const i2s_pin_config_t pin_config = {.bck_io_num = I2S_BCLK_PIN,
+                                                 .ws_io_num = I2S_WS_PIN,
+                                                 .data_out_num = I2S_PIN_NO_CHANGE,
+                                                 .data_in_num = inputPin};
+
+            if (!CheckAudioErr(i2s_driver_install(I2S_NUM_0, &i2s_config, 0, NULL), "i2s_driver_install"))
+                return false;
+            _installed = true;
+
+            if (!CheckAudioErr(i2s_set_pin(I2S_NUM_0, &pin_config), "i2s_set_pin")
+                || !CheckAudioErr(i2s_zero_dma_buffer(I2S_NUM_0), "i2s_zero_dma_buffer")
+                || !CheckAudioErr(i2s_start(I2S_NUM_0), "i2s_start"))
+            {
+                End();
+                return false;
+            }
+            return true;
+        }
+
+        void End() override
+        {
+            if (!_installed)
+                return;
+
+            // i2s_stop terminates DMA before the driver goes away
+            i2s_stop(I2S_NUM_0);
+            i2s_driver_uninstall(I2S_NUM_0);
+            _installed = false;
+            _chanIndex = -1;
+        }
+
+        size_t Read(int16_t* dest, size_t count, uint32_t timeoutMs) override
+        {
+            count = std::min(count, (size_t)MAX_SAMPLES);
+            const size_t bytesExpected = count * kChannels * sizeof(int32_t);
+            size_t bytesRead = 0;
+
+            if (i2s_read(I2S_NUM_0, _raw.data(), bytesExpected, &bytesRead, pdMS_TO_TICKS(timeoutMs)) != ESP_OK || bytesRead != bytesExpected)
+            {
+                debugW("Only read %u of %u bytes from I2S\n", bytesRead, bytesExpected);
+                return 0;
+            }
+
+            // Mics differ on which slot they drive; pick the louder one once
+            if (_chanIndex < 0)
+            {
+                long long sumAbs[2] = {0, 0};
+                for (size_t i = 0; i < count; ++i)
+                {
+                    sumAbs[0] += llabs((long long)_raw[i * kChannels + 0]);
+                    sumAbs[1] += llabs((long long)_raw[i * kChannels + 1]);
+                }
+                _chanIndex = (sumAbs[1] > sumAbs[0]) ? 1 : 0;
+            }
+
+            for (size_t i = 0; i < count; i++)
+                dest[i] = I2SWordToSample(_raw[i * kChannels + _chanIndex]);
+            return count;
+        }
+
+      private:
+        static constexpr int kChannels = 2;    // RIGHT + LEFT
+
+        bool _installed = false;
+        int  _chanIndex = -1;
+        std::array<int32_t, MAX_SAMPLES * kChannels> _raw{};
+    };
+
+#elif !USE_M5 && !USE_I2S_AUDIO && IS_IDF5 && !AUDIO_INPUT_SYNTHETIC
+
+    // AdcContinuousInput
+    //
+    // Analog mic on the IDF5 continuous ADC driver. The conversion frame is
+    // one analyzer block; on_conv_done gives the reading task a notification
+    // from the ISR, and Read() sleeps in ulTaskNotifyTake until it arrives.
+
+    class AdcContinuousInput : public IAudioInput
+    {
+      public:
+        const char* Name() const override { return "ADC (IDF5)"; }
+
+        bool Begin(int) override
+        {
+            debugI("Audio: Initializing ADC Analog Mic (Modern) on Channel 0");
+            _waiter = xTaskGetCurrentTaskHandle();
+
+            adc_continuous_handle_cfg_t adc_config = {
+                .max_store_buf_size = 1024,
+                .conv_frame_size = MAX_SAMPLES * sizeof(uint16_t),
+            };
+            if (!CheckAudioErr(adc_continuous_new_handle(&adc_config, &_handle), "adc_continuous_new_handle"))
+                return false;
+
+            adc_continuous_config_t dig_cfg = {
+                .sample_freq_hz = kSampleRate,
+                .conv_mode = ADC_CONV_SINGLE_UNIT_1, // Using ADC1
+                .format = ADC_DIGI_OUTPUT_FORMAT_TYPE2,
+            };
+
+            // Configure pattern: channel, attenuation, etc.
+            adc_digi_pattern_config_t adc_pattern[1] = {0};
+            adc_pattern[0].atten = ADC_ATTEN_DB_12; // 12dB (formerly 11dB) for full range ~3.3V
+            adc_pattern[0].channel = ADC_CHANNEL_0; // FIXED for now, ideally map from AUDIO_INPUT_PIN
+            adc_pattern[0].unit = ADC_UNIT_1;
+            adc_pattern[0].bit_width = ADC_BITWIDTH_12;
+
+            dig_cfg.adc_pattern = adc_pattern;
+            dig_cfg.pattern_num = 1;
+
+            adc_continuous_evt_cbs_t cbs = {};
+            cbs.on_conv_done = OnConvDone;
+
+            if (!CheckAudioErr(adc_continuous_config(_handle, &dig_cfg), "adc_continuous_config")
+                || !CheckAudioErr(adc_continuous_register_event_callbacks(_handle, &cbs, this), "adc_continuous_register_event_callbacks")
+                || !CheckAudioErr(adc_continuous_start(_handle), "adc_continuous_start"))
+            {
+                adc_continuous_deinit(_handle);
+                _handle = nullptr;
+                return false;
+            }
+            return true;
+        }
+
+        void End() override
+        {
+            if (!_handle)
+                return;
+
+            const esp_err_t stopErr = adc_continuous_stop(_handle);
+            if (stopErr != ESP_OK)
+                debugW("Audio: adc_continuous_stop returned %d", (int)stopErr);
+            const esp_err_t deinitErr = adc_continuous_deinit(_handle);
+            if (deinitErr != ESP_OK)
+                debugW("Audio: adc_continuous_deinit returned %d", (int)deinitErr);
+            _handle = nullptr;
+        }
+
+        size_t Read(int16_t* dest, size_t count, uint32_t timeoutMs) override
+        {
+            auto raw = reinterpret_cast<uint8_t *>(dest);
+            const size_t bytesWanted = count * sizeof(uint16_t);
+            const uint32_t start = millis();
+            size_t bytesHave = 0;
+
+            while (bytesHave < bytesWanted)
+            {
+                uint32_t got = 0;
+                const esp_err_t err = adc_continuous_read(_handle, raw + bytesHave, bytesWanted - bytesHave, &got, 0);
+                if (err == ESP_OK)
+                {
+                    bytesHave += got;
+                    continue;
+                }
+                if (err != ESP_ERR_TIMEOUT)
+                    break;
+
+                // Nothing buffered yet: sleep until the ISR says a frame is done
+                const uint32_t elapsed = millis() - start;
+                if (elapsed >= timeoutMs || ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs - elapsed)) == 0)
+                    break;
+            }
+
+            const size_t samples = bytesHave / sizeof(uint16_t);
+            for (size_t i = 0; i < samples; i++)
+            {
+                const uint16_t data = (uint16_t)dest[i] & 0xFFF;   // Keep 12 bits
+                dest[i] = (int16_t)((data - 2048) * 16);
+            }
+            return samples;
+        }
+
+      private:
+        static bool IRAM_ATTR OnConvDone(adc_continuous_handle_t, const adc_continuous_evt_data_t *, void *ctx)
+        {
+            BaseType_t woken = pdFALSE;
+            vTaskNotifyGiveFromISR(static_cast<AdcContinuousInput *>(ctx)->_waiter, &woken);
+            return woken == pdTRUE;
+        }
+
+        adc_continuous_handle_t _handle = nullptr;
+        TaskHandle_t _waiter = nullptr;
+    };
+
+#elif !USE_M5 && !USE_I2S_AUDIO && !IS_IDF5 && defined(SOC_I2S_SUPPORTS_ADC) && !AUDIO_INPUT_SYNTHETIC
+
+    // AdcLegacyInput
+    //
+    // Analog mic through the ESP32's I2S built-in ADC mode on IDF4. As with
+    // the legacy I2S mic, each DMA buffer is one analyzer block.
+
+    class AdcLegacyInput : public IAudioInput
+    {
+      public:
+        const char* Name() const override { return "ADC (Legacy)"; }
+
+        bool Begin(int) override
+        {
+            debugI("Audio: Initializing I2S ADC Analog Mic (Legacy) on Channel 0");
+            static_assert(SOC_I2S_SUPPORTS_ADC, "This ESP32 model does not support ADC built-in mode");
+
+            const i2s_config_t i2s_config = {
+                .mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN),
+                .sample_rate = kSampleRate,
+                .bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT,
+                .channel_format = I2S_CHANNEL_FMT_ONLY_LEFT,
+                .communication_format = I2S_COMM_FORMAT_STAND_I2S,
+                .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
+                .dma_buf_count = 2,
+                .dma_buf_len = MAX_SAMPLES,
+                .use_apll = false,
+                .tx_desc_auto_clear = false,
+                .fixed_mclk = 0
+            };
+
+            if (!CheckAudioErr(adc1_config_width(ADC_WIDTH_BIT_12), "adc1_config_width")
+                || !CheckAudioErr(adc1_config_channel_atten(ADC1_CHANNEL_0, ADC_ATTEN_DB_0), "adc1_config_channel_atten")
+                || !CheckAudioErr(i2s_driver_install(I2S_NUM_0, &i2s_config, 0, NULL), "i2s_driver_install"))
+                return false;
+            _installed = true;
+
+            if (!CheckAudioErr(i2s_set_adc_mode(ADC_UNIT_1, ADC1_CHANNEL_0), "i2s_set_adc_mode"))
+            {
+                End();
+                return false;
+            }
+            return true;
+        }
+
+        void End() override
+        {
+            if (!_installed)
+                return;
+
+            i2s_stop(I2S_NUM_0);
+            i2s_driver_uninstall(I2S_NUM_0);
+            _installed = false;
+        }
+
+        size_t Read(int16_t* dest, size_t count, uint32_t timeoutMs) override
+        {
+            const size_t bytesExpected = count * sizeof(int16_t);
+            size_t bytesRead = 0;
+            if (i2s_read(I2S_NUM_0, dest, bytesExpected, &bytesRead, pdMS_TO_TICKS(timeoutMs)) != ESP_OK || bytesRead != bytesExpected)
+            {
+                debugW("Could only read %u bytes of %u from I2S ADC\n", bytesRead, bytesExpected);
+                return 0;
+            }
+            return count;
+        }
+
+      private:
+        bool _installed = false;
+    };
+
+#endif
+}
+
+#if AUDIO_INPUT_SYNTHETIC
+
+// SyntheticAudioInput::Begin
+//
+// Resets the stream clock; the input pin is ignored.
+
+bool SyntheticAudioInput::Begin(int)
+{
+    debugI("Audio: Using synthetic input (%u Hz, beat every %u ms)", (unsigned)_sampleRate, (unsigned)_beatMs);
+    _running = true;
+    _sampleIndex = 0;
+    _tonePhase = 0.0f;
+    _startMs = millis();
+    return true;
+}
+
+// SyntheticAudioInput::Read
+//
+// Sleeps until the wall clock reaches the end of the requested block, just
+// as a DMA read would, then synthesizes it. A 200 Hz to 2 kHz sweep every
+// four seconds gives the spectrum something to track, and a decaying 60 Hz
+// burst at the top of each beat gives the beat detector something to find.
+
+size_t SyntheticAudioInput::Read(int16_t* dest, size_t count, uint32_t timeoutMs)
+{
+    if (!_running)
+        return 0;
+
+    const uint32_t dueMs = _startMs + (uint32_t)((_sampleIndex + count) * 1000 / _sampleRate);
+    const int32_t waitMs = (int32_t)(dueMs - millis());
+    if (waitMs > (int32_t)timeoutMs)
+    {
+        delay(timeoutMs);
+        return 0;
+    }
+    if (waitMs > 0)
+        delay(waitMs);
+
+    constexpr float kTwoPi = 6.2831853f;
+    constexpr float kSweepSeconds = 4.0f;
+    const uint32_t beatSamples = std::max<uint32_t>(1, _sampleRate * _beatMs / 1000);
+
+    for (size_t i = 0; i < count; i++, _sampleIndex++)
+    {
+        const float t = (float)(_sampleIndex % (uint64_t)(_sampleRate * kSweepSeconds)) / _sampleRate;
+        const float toneHz = 200.0f + 1800.0f * (t / kSweepSeconds);
+        _tonePhase += kTwoPi * toneHz / _sampleRate;
+        if (_tonePhase > kTwoPi)
+            _tonePhase -= kTwoPi;
+
+        const float beatT = (float)(_sampleIndex % beatSamples) / _sampleRate;
+        const float kick = expf(-beatT * 25.0f) * sinf(kTwoPi * 60.0f * beatT);
+
+        dest[i] = (int16_t)(3000.0f * sinf(_tonePhase) + 20000.0f * kick);
+    }
+    return count;
+}
+
+#endif // AUDIO_INPUT_SYNTHETIC
+
+// CreateAudioInput
+//
+// The single place the backend is picked; everything after this talks to
+// IAudioInput.
+
+std::unique_ptr<IAudioInput> CreateAudioInput()
+{
+#if AUDIO_INPUT_SYNTHETIC
+    return std::make_unique<SyntheticAudioInput>(kSampleRate);
+#elif USE_M5
+    return std::make_unique<M5AudioInput>();
+#elif (USE_I2S_AUDIO || ELECROW) && IS_IDF5
+    return std::make_unique<I2SStdInput>();
+#elif (USE_I2S_AUDIO || ELECROW)
+    return std::make_unique<I2SLegacyInput>();
+#elif IS_IDF5
+    return std::make_unique<AdcContinuousInput>();
+#elif defined(SOC_I2S_SUPPORTS_ADC)
+    return std::make_unique<AdcLegacyInput>();
+#else
+    return nullptr;
+#endif
+}
+
+#endif // ENABLE_AUDIO
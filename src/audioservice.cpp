@@ -213,6 +213,17 @@ IAudioSource& AudioService::Source() const
     return GetNullSource();
 }
 
+const AudioSyncStats* AudioService::SyncStats() const
+{
+    #if AUDIO_SYNC_PUBLISH
+        return &_syncPublisher.Stats();
+    #elif AUDIO_SYNC_SUBSCRIBE
+        return &_syncSubscriber.Stats();
+    #else
+        return nullptr;
+    #endif
+}
+
 // ---- ITaskService hooks ----
 
 ITaskService::TaskConfig AudioService::GetTaskConfig() const
@@ -222,7 +233,7 @@ ITaskService::TaskConfig AudioService::GetTaskConfig() const
         AUDIO_STACK_SIZE,
         AUDIO_PRIORITY,
         AUDIO_CORE,
-        750    // Stop timeout: I2S read uses a 100ms timeout, plus loop work.
+        750    // Stop timeout: input reads time out after 100ms, plus loop work.
     };
 }
 
@@ -245,12 +256,26 @@ bool AudioService::OnBeforeStart()
     return true;
 }
 
+// OnBeforeWaitForStop - nudge the task out of an input read that sleeps on
+// its task notification (the IDF5 ADC backend) so Stop() doesn't wait out
+// the read timeout.
+void AudioService::OnBeforeWaitForStop()
+{
+    WakeTask();
+}
+
 // OnAfterStop - release the audio hardware and zero analyzer telemetry so
 // direct readers of g_Analyzer see safe defaults during a reconfigure.
 // Idempotent in both calls (TeardownAudioInput's _hardwareInstalled guard
 // and Reset's unconditional zero-out).
 void AudioService::OnAfterStop()
 {
+    #if AUDIO_SYNC_PUBLISH
+        _syncPublisher.End();
+    #elif AUDIO_SYNC_SUBSCRIBE
+        _syncSubscriber.End();
+    #endif
+
     g_Analyzer.TeardownAudioInput();
     g_Analyzer.Reset();
 }
@@ -265,14 +290,17 @@ void AudioService::Run()
 
     // M5 boards sample through M5.Mic/M5Unified, not the generic AUDIO_INPUT_PIN
     // path. Only configure the input pin for the external mic configurations
-    // that actually consume it.
-    #if !USE_M5
+    // that actually consume it. Subscribers take their audio from the network
+    // and never install the sampling hardware at all.
+    #if !USE_M5 && !AUDIO_SYNC_SUBSCRIBE
     const auto audioInputPin = g_ptrSystem->GetConfiguredAudioInputPin();
     if (audioInputPin >= 0)
         pinMode(audioInputPin, INPUT);
     #endif
 
+    #if !AUDIO_SYNC_SUBSCRIBE
     g_Analyzer.InitAudioInput();
+    #endif
 
     auto lastVU = 0.0f;
     auto frameDurationSeconds = 0.016;
@@ -282,8 +310,19 @@ void AudioService::Run()
     while (!ShouldShutdown())
     {
         auto lastFrame = millis();
+        const auto targetDelay = PERIOD_FROM_FREQ(kMaxFPS) * MILLIS_PER_SECOND / MICROS_PER_SECOND;
+
+        #if AUDIO_SYNC_SUBSCRIBE
+            // Blocks on the socket until the next snapshot is due, so this
+            // also takes the place of the frame delay below.
+            if (g_Analyzer.GetSimulateBeat())
+                g_Analyzer.SimulateBeatPass();
+            else
+                _syncSubscriber.Poll(g_Analyzer, (uint32_t)targetDelay);
+        #else
+            g_Analyzer.RunSamplerPass();
+        #endif
 
-        g_Analyzer.RunSamplerPass();
         g_Analyzer.UpdatePeakData();
         g_Analyzer.DecayPeaks();
 
@@ -303,10 +342,21 @@ void AudioService::Run()
               / std::max(g_Analyzer.PeakVU() - g_Analyzer.MinVU(), (float) MIN_VU)
               * 2.0f);
 
-        // Yield to share the CPU. We always wait at least kMinFrameDelay so
-        // we don't bogart the core even when sampling is fast.
-        const auto targetDelay = PERIOD_FROM_FREQ(kMaxFPS) * MILLIS_PER_SECOND / MICROS_PER_SECOND;
-        delay(std::max(1.0, targetDelay - (millis() - lastFrame)));
+        #if AUDIO_SYNC_PUBLISH
+            _syncPublisher.Publish(g_Analyzer);
+        #endif
+
+        // Yield to share the CPU. A pass that slept on the input driver has
+        // already given the core away until the next DMA block, so it loops
+        // straight back to wait for the one after; otherwise we wait at least
+        // a millisecond so we don't bogart the core.
+        #if AUDIO_SYNC_SUBSCRIBE
+            if (g_Analyzer.GetSimulateBeat())
+                delay(std::max(1.0, targetDelay - (millis() - lastFrame)));
+        #else
+            if (!g_Analyzer.LastPassWaitedOnInput())
+                delay(std::max(1.0, targetDelay - (millis() - lastFrame)));
+        #endif
 
         const auto duration = millis() - lastFrame;
         frameDurationSeconds = duration / 1000.0;
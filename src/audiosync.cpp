@@ -0,0 +1,442 @@
+//+--------------------------------------------------------------------------
+//
+// File:        audiosync.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    UDP multicast publisher and subscriber for analyzer snapshots. See
+//    audiosync.h for the protocol and the timing model.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#if ENABLE_AUDIO && (AUDIO_SYNC_PUBLISH || AUDIO_SYNC_SUBSCRIBE)
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "audiosync.h"
+#include "nd_network.h"
+
+namespace
+{
+    constexpr uint32_t kReopenIntervalMs = 1000;    // How often to retry the socket while WiFi is down
+
+    sockaddr_in GroupAddress()
+    {
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family      = AF_INET;
+        address.sin_port        = htons(NetworkPort::AudioSync);
+        address.sin_addr.s_addr = inet_addr(AUDIO_SYNC_GROUP);
+        return address;
+    }
+}
+
+#if AUDIO_SYNC_PUBLISH
+
+bool AudioSyncPublisher::Begin()
+{
+    const uint32_t now = millis();
+    if (now - _lastAttemptMs < kReopenIntervalMs || !nd_network::IsWiFiConnected())
+        return false;
+    _lastAttemptMs = now;
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+    {
+        debugE("AudioSync: socket error %d", errno);
+        return false;
+    }
+
+    // Keep the stream on the local segment and off our own receive path. A
+    // non-blocking socket means a congested radio drops a snapshot rather
+    // than stalling the audio task.
+
+    uint8_t ttl  = 1;
+    uint8_t loop = 0;
+    setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+    setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    nd_network::SetSocketBlockingEnabled(fd, false);
+
+    _socket = fd;
+    debugI("AudioSync: publishing to %s:%d", AUDIO_SYNC_GROUP, (int)NetworkPort::AudioSync);
+    return true;
+}
+
+void AudioSyncPublisher::End()
+{
+    if (_socket >= 0)
+    {
+        close(_socket);
+        _socket = -1;
+    }
+}
+
+// Publish
+//
+// Snapshot the analyzer state after a pass and multicast it. Beat timing is
+// sent as an age so receivers don't need a shared clock.
+
+void AudioSyncPublisher::Publish(const SoundAnalyzerBase& analyzer)
+{
+    if (_socket < 0 && !Begin())
+        return;
+
+    const uint32_t now  = millis();
+    const BeatInfo beat = analyzer.LastBeat();
+
+    AudioSyncPacket packet{};
+    packet.magic          = AUDIO_SYNC_MAGIC;
+    packet.version        = AUDIO_SYNC_VERSION;
+    packet.numBands       = NUM_BANDS;
+    packet.sequence       = ++_sequence;
+    packet.timestampMs    = now;
+    packet.vu             = analyzer.VU();
+    packet.vuRatio        = analyzer.VURatio();
+    packet.vuRatioFade    = analyzer.VURatioFade();
+    packet.beatSequence   = beat.sequence;
+    packet.beatAgeMs      = beat.sequence ? now - beat.timestampMs : 0;
+    packet.msPerBeat      = beat.msPerBeat;
+    packet.beatConfidence = beat.confidence;
+    packet.beatStrength   = beat.strength;
+
+    const PeakData& peaks = analyzer.Peaks();
+    for (int i = 0; i < NUM_BANDS; i++)
+        packet.peaks[i] = peaks[i];
+
+    const sockaddr_in group = GroupAddress();
+    if (sendto(_socket, &packet, sizeof(packet), 0, (const sockaddr *)&group, sizeof(group)) != sizeof(packet))
+    {
+        // lwIP reports a full transmit queue as ENOMEM; that's a dropped
+        // snapshot, not a broken socket.
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOMEM)
+        {
+            debugW("AudioSync: send failed (%d), reopening", errno);
+            End();
+        }
+        return;
+    }
+
+    _stats.packets++;
+    _stats.lastPacketMs = now;
+}
+
+#endif // AUDIO_SYNC_PUBLISH
+
+#if AUDIO_SYNC_SUBSCRIBE
+
+bool AudioSyncSubscriber::Begin()
+{
+    const uint32_t now = millis();
+    if (now - _lastAttemptMs < kReopenIntervalMs || !nd_network::IsWiFiConnected())
+        return false;
+    _lastAttemptMs = now;
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+    {
+        debugE("AudioSync: socket error %d", errno);
+        return false;
+    }
+
+    int opt = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family      = AF_INET;
+    address.sin_port        = htons(NetworkPort::AudioSync);
+    address.sin_addr.s_addr = INADDR_ANY;
+
+    if (bind(fd, (sockaddr *)&address, sizeof(address)) < 0)
+    {
+        debugE("AudioSync: bind failed on port %d: %s (%d)", (int)NetworkPort::AudioSync, strerror(errno), errno);
+        close(fd);
+        return false;
+    }
+
+    ip_mreq membership;
+    memset(&membership, 0, sizeof(membership));
+    membership.imr_multiaddr.s_addr = inet_addr(AUDIO_SYNC_GROUP);
+    membership.imr_interface.s_addr = INADDR_ANY;
+
+    if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0)
+    {
+        debugE("AudioSync: could not join %s: %s (%d)", AUDIO_SYNC_GROUP, strerror(errno), errno);
+        close(fd);
+        return false;
+    }
+
+    nd_network::SetSocketBlockingEnabled(fd, false);
+
+    _socket = fd;
+    debugI("AudioSync: subscribed to %s:%d", AUDIO_SYNC_GROUP, (int)NetworkPort::AudioSync);
+    return true;
+}
+
+void AudioSyncSubscriber::End()
+{
+    if (_socket >= 0)
+    {
+        close(_socket);
+        _socket = -1;
+    }
+    _queueCount = 0;
+    _haveOffset = false;
+}
+
+// Receive
+//
+// Drain every datagram waiting on the socket into the playout queue.
+
+void AudioSyncSubscriber::Receive()
+{
+    AudioSyncPacket packet;
+
+    while (_socket >= 0)
+    {
+        const int cbRead = recv(_socket, &packet, sizeof(packet), 0);
+        if (cbRead < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                debugW("AudioSync: receive failed (%d), reopening", errno);
+                End();
+            }
+            return;
+        }
+
+        if (cbRead != sizeof(packet)
+            || packet.magic != AUDIO_SYNC_MAGIC
+            || packet.version != AUDIO_SYNC_VERSION
+            || packet.numBands != NUM_BANDS)
+        {
+            debugV("AudioSync: ignoring %d byte datagram (bands=%u)", cbRead, (unsigned)packet.numBands);
+            continue;
+        }
+
+        Enqueue(packet, millis());
+    }
+}
+
+// Enqueue
+//
+// Update the clock offset and jitter estimates from one arrival, then insert
+// the packet into the sequence-ordered playout queue.
+
+void AudioSyncSubscriber::Enqueue(const AudioSyncPacket& packet, uint32_t arrivalMs)
+{
+    const int32_t transit = (int32_t)(arrivalMs - packet.timestampMs);
+
+    // A publisher reboot (or a new publisher) shows up as a wild jump in
+    // transit time; start the alignment over rather than wait it out.
+
+    if (_haveOffset && std::abs(transit - _stats.offsetMs) > 2000)
+    {
+        debugI("AudioSync: publisher clock jumped, resynchronizing");
+        _haveOffset = false;
+        _queueCount = 0;
+        _haveLast = false;
+        _lastBeatSequence = 0;
+    }
+
+    if (!_haveOffset)
+    {
+        _haveOffset      = true;
+        _stats.offsetMs  = transit;
+        _windowMinOffset = transit;
+        _windowStartMs   = arrivalMs;
+        _lastTransit     = transit;
+    }
+    else
+    {
+        // A faster path than we've seen lowers the offset right away; a
+        // slower one only takes effect when the window rolls over, so a
+        // single delayed packet can't drag the schedule later.
+
+        _windowMinOffset = std::min(_windowMinOffset, transit);
+        if (transit < _stats.offsetMs)
+            _stats.offsetMs = transit;
+        if (arrivalMs - _windowStartMs >= kOffsetWindowMs)
+        {
+            _stats.offsetMs  = _windowMinOffset;
+            _windowMinOffset = transit;
+            _windowStartMs   = arrivalMs;
+        }
+
+        const uint32_t delta = (uint32_t)std::abs(transit - _lastTransit);
+        _stats.jitterMs += ((int32_t)delta - (int32_t)_stats.jitterMs) / 16;
+        _lastTransit = transit;
+    }
+
+    // Anything at or behind what we've already played or queued is stale.
+
+    const uint32_t newest = _queueCount ? _queue[_queueCount - 1].sequence : (_haveLast ? _last.sequence : 0);
+    if ((_haveLast || _queueCount) && (int32_t)(packet.sequence - newest) <= 0)
+    {
+        _stats.late++;
+        return;
+    }
+
+    if ((_haveLast || _queueCount) && packet.sequence - newest > 1)
+        _stats.lost += packet.sequence - newest - 1;
+
+    if (_queueCount == kQueueDepth)
+    {
+        std::move(_queue.begin() + 1, _queue.end(), _queue.begin());
+        _queueCount--;
+        _stats.late++;
+    }
+
+    _queue[_queueCount++] = packet;
+    _stats.lastPacketMs = arrivalMs;
+}
+
+// MsUntilDue
+//
+// Milliseconds until the oldest queued snapshot should be applied; zero or
+// negative means it is due now.
+
+int32_t AudioSyncSubscriber::MsUntilDue(uint32_t now) const
+{
+    const uint32_t due = _queue[0].timestampMs + _stats.offsetMs + AUDIO_SYNC_PLAYOUT_MS;
+    return (int32_t)(due - now);
+}
+
+void AudioSyncSubscriber::Apply(SoundAnalyzerBase& analyzer, const AudioSyncPacket& packet, uint32_t now)
+{
+    PeakData peaks;
+    for (int i = 0; i < NUM_BANDS; i++)
+        peaks[i] = packet.peaks[i];
+    analyzer.SetPeakDataFromRemote(peaks);
+
+    // The first packet after (re)joining only establishes the beat baseline;
+    // replaying a beat that fired before we were listening would double-pulse.
+
+    if (_haveLast && packet.beatSequence != 0 && packet.beatSequence != _lastBeatSequence)
+        analyzer.SetBeatFromRemote(now - packet.beatAgeMs, packet.msPerBeat, packet.beatConfidence, packet.beatStrength);
+
+    _lastBeatSequence = packet.beatSequence;
+    _last = packet;
+    _haveLast = true;
+    _concealPeaks = peaks;
+    _lastAppliedMs = now;
+    _stats.packets++;
+}
+
+// Conceal
+//
+// No fresh snapshot arrived in time: hold the last one with decaying peaks,
+// and go quiet for good once the publisher has been silent for the remote
+// timeout.
+
+void AudioSyncSubscriber::Conceal(SoundAnalyzerBase& analyzer, uint32_t now)
+{
+    if (!_haveLast)
+        return;
+
+    if (now - _stats.lastPacketMs > AUDIO_PEAK_REMOTE_TIMEOUT)
+    {
+        _concealPeaks.fill(0.0f);
+        analyzer.SetPeakDataFromRemote(_concealPeaks);
+        _haveLast = false;
+        debugI("AudioSync: publisher silent, fading out");
+        return;
+    }
+
+    for (auto& peak : _concealPeaks)
+        peak *= kConcealDecay;
+
+    analyzer.SetPeakDataFromRemote(_concealPeaks);
+    _stats.concealed++;
+}
+
+// Poll
+//
+// Called in place of RunSamplerPass() by the audio task. Sleeps in select()
+// on the socket so the task wakes the moment a datagram lands, rather than
+// after a fixed delay.
+
+void AudioSyncSubscriber::Poll(SoundAnalyzerBase& analyzer, uint32_t maxWaitMs)
+{
+    constexpr uint32_t kConcealAfterMs = 40;
+
+    if (_socket < 0 && !Begin())
+    {
+        delay(maxWaitMs);
+        Conceal(analyzer, millis());
+        return;
+    }
+
+    const uint32_t start = millis();
+
+    while (_socket >= 0)
+    {
+        Receive();
+
+        const uint32_t now = millis();
+        if (_queueCount && MsUntilDue(now) <= 0)
+        {
+            // Apply the newest snapshot that's due. Older due ones are
+            // superseded; beat sequence numbers are cumulative so skipping
+            // them never loses a beat.
+
+            size_t iDue = 0;
+            while (iDue + 1 < _queueCount && (int32_t)(_queue[iDue + 1].timestampMs + _stats.offsetMs + AUDIO_SYNC_PLAYOUT_MS - now) <= 0)
+                iDue++;
+
+            Apply(analyzer, _queue[iDue], now);
+            std::move(_queue.begin() + iDue + 1, _queue.begin() + _queueCount, _queue.begin());
+            _queueCount -= iDue + 1;
+            return;
+        }
+
+        const int32_t remaining = (int32_t)(start + maxWaitMs - now);
+        if (remaining <= 0)
+            break;
+
+        const int32_t waitMs = _queueCount ? std::min(remaining, MsUntilDue(now)) : remaining;
+
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(_socket, &readSet);
+        timeval timeout = { waitMs / 1000, (waitMs % 1000) * 1000 };
+        select(_socket + 1, &readSet, nullptr, nullptr, &timeout);
+    }
+
+    const uint32_t now = millis();
+    if (now - _lastAppliedMs >= kConcealAfterMs)
+        Conceal(analyzer, now);
+}
+
+#endif // AUDIO_SYNC_SUBSCRIBE
+
+#endif // ENABLE_AUDIO && (AUDIO_SYNC_PUBLISH || AUDIO_SYNC_SUBSCRIBE)
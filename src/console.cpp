@@ -28,6 +28,8 @@
 
 #include "globals.h"
 
+#include <algorithm>
+
 #include "console.h"
 #include "debug_cli.h"
 #include "logger.h"
@@ -36,7 +38,7 @@
 // ConsoleSession
 //
 
-ConsoleSession::ConsoleSession(IConsoleSink* sink) : _sink(sink) {}
+ConsoleSession::ConsoleSession(std::shared_ptr<IConsoleSink> sink) : _sink(std::move(sink)) {}
 
 void ConsoleSession::WriteRaw(std::string_view data)
 {
@@ -128,11 +130,9 @@ void ConsoleSession::Write(LogLevel level, const char* tag, const char* message)
 // ConsoleManager
 //
 
-static SerialConsoleSink g_SerialSink;
-
 ConsoleManager::ConsoleManager()
 {
-    _serialSession = std::make_shared<ConsoleSession>(&g_SerialSink);
+    _serialSession = std::make_shared<ConsoleSession>(std::make_shared<SerialConsoleSink>());
 }
 
 void ConsoleManager::FeedSerialByte(uint8_t byte)
@@ -191,18 +191,55 @@ void ConsoleManager::Broadcast(LogLevel level, const char* tag, const char* mess
     }
 }
 
-void ConsoleManager::SetTelnetSink(IConsoleSink* sink)
+void ConsoleManager::QueueCommand(std::string line, std::shared_ptr<ConsoleSession> session)
+{
+    if (!session) return;
+    {
+        std::lock_guard guard(_mutex);
+        if (_queuedCommands.size() < kMaxQueuedCommands)
+        {
+            _queuedCommands.emplace_back(std::move(line), std::move(session));
+            return;
+        }
+    }
+    session->WriteText("Console busy, command dropped\n");
+}
+
+// RunQueuedCommands
+//
+// Called from the main loop, which also runs the serial console's commands.
+// The lock is only held to pop each entry, so sessions can keep queueing
+// (and the telnet client can disconnect) while a command is running.
+
+void ConsoleManager::RunQueuedCommands()
+{
+    while (true)
+    {
+        std::pair<std::string, std::shared_ptr<ConsoleSession>> entry;
+        {
+            std::lock_guard guard(_mutex);
+            if (_queuedCommands.empty())
+                return;
+            entry = std::move(_queuedCommands.front());
+            _queuedCommands.pop_front();
+        }
+        DebugCLI::RunCommand(entry.first, entry.second);
+    }
+}
+
+void ConsoleManager::SetTelnetSink(std::shared_ptr<IConsoleSink> sink)
 {
     std::shared_ptr<ConsoleSession> session;
     {
         std::lock_guard guard(_mutex);
-        _telnetSession = std::make_shared<ConsoleSession>(sink);
+        _telnetSession = std::make_shared<ConsoleSession>(std::move(sink));
         session = _telnetSession;
     }
     if (session) {
         session->SetEcho(true);
         session->SetShowColors(false);      // Default off for clean 'nc', real Telnet can call 'color on'
-        DebugCLI::RunCommand("", session); // Force an initial prompt
+        session->SetDeferCommands(true);    // Bytes arrive on the socket reactor, which mustn't run commands
+        QueueCommand("", session);          // Force an initial prompt
     }
 }
 
@@ -211,6 +248,10 @@ void ConsoleManager::ClearTelnetSink()
     std::lock_guard guard(_mutex);
     if (_telnetSession)
     {
+        // Lines the client typed but never saw run go with it
+        _queuedCommands.erase(std::remove_if(_queuedCommands.begin(), _queuedCommands.end(),
+                                             [&](const auto& entry) { return entry.second == _telnetSession; }),
+                              _queuedCommands.end());
         _telnetSession.reset();
     }
 }
@@ -50,6 +50,7 @@
 #include "gfxbase.h"
 #include "ledstripeffect.h"
 #include "nd_network.h"
+#include "powermodel.h"
 #include "soundanalyzer.h"
 #include "systemcontainer.h"
 
@@ -604,6 +605,97 @@ static void DoCat(const cli_argv &argv)
     file.close();
 }
 
+static void PrintPowerModel(const PowerModelConfig& config)
+{
+    auto printCurve = [](const char* name, const PowerModelConfig::Curve& curve)
+    {
+        cli_printf("  %-5s uW/LED at 64/128/192/255: %lu %lu %lu %lu\n", name,
+                   (unsigned long)curve[0], (unsigned long)curve[1], (unsigned long)curve[2], (unsigned long)curve[3]);
+    };
+
+    cli_printf("  Base: %lu mW, idle: %lu uW/LED\n", (unsigned long)config.baseMw, (unsigned long)config.idleUwPerLed);
+    printCurve("red", config.red);
+    printCurve("green", config.green);
+    printCurve("blue", config.blue);
+    printCurve("white", config.white);
+}
+
+// DoPowerCommand
+//
+// Shows the power model and drives calibration: start it, hold a steady effect, read the supply
+// current off a meter and enter "power cal <mW>" for each of a few different colors, then
+// "power fit" to see the fitted model and "power fit apply" to save it.
+
+static void DoPowerCommand(const cli_argv &argv)
+{
+    auto& deviceConfig = g_ptrSystem->GetDeviceConfig();
+
+    if (argv.size() < 2)
+    {
+        const auto model = PowerModel::Current();
+        cli_printf("Power model (%s):\n", model->IsLinear() ? "linear" : "curved");
+        PrintPowerModel(model->Config());
+        cli_printf("Calibration: %s, %zu samples\n", PowerCalibration::IsActive() ? "ON" : "OFF", PowerCalibration::Samples().size());
+        return;
+    }
+
+    if (StringCompareInsensitive(argv[1], "cal") && argv.size() > 2)
+    {
+        if (StringCompareInsensitive(argv[2], "start"))
+            PowerCalibration::Start();
+        else if (StringCompareInsensitive(argv[2], "stop"))
+            PowerCalibration::Stop();
+        else if (StringCompareInsensitive(argv[2], "clear"))
+            PowerCalibration::Clear();
+        else if (StringCompareInsensitive(argv[2], "list"))
+        {
+            for (const auto& sample : PowerCalibration::Samples())
+                cli_printf("  R:%.0f G:%.0f B:%.0f W:%.0f  predicted %lu mW, measured %lu mW\n",
+                           sample.red, sample.green, sample.blue, sample.white,
+                           (unsigned long)sample.predictedMw, (unsigned long)sample.measuredMw);
+        }
+        else if (isdigit(argv[2][0]))
+        {
+            if (!PowerCalibration::IsActive())
+                cli_printf("Calibration is not running; use 'power cal start' first\n");
+            else if (!PowerCalibration::AddMeasurement(atoi(std::string(argv[2]).c_str())))
+                cli_printf("No frames drawn since the last sample\n");
+        }
+        cli_printf("Calibration: %s, %zu samples\n", PowerCalibration::IsActive() ? "ON" : "OFF", PowerCalibration::Samples().size());
+        return;
+    }
+
+    if (StringCompareInsensitive(argv[1], "fit"))
+    {
+        double rmsErrorMw = 0;
+        auto fitted = PowerCalibration::Fit(deviceConfig.GetPowerModel(), rmsErrorMw);
+        if (!fitted)
+        {
+            cli_printf("Not enough distinct samples to fit; measure a few different colors, not just greys\n");
+            return;
+        }
+
+        cli_printf("Fitted model (RMS error %.0f mW):\n", rmsErrorMw);
+        PrintPowerModel(*fitted);
+
+        if (argv.size() > 2 && StringCompareInsensitive(argv[2], "apply"))
+        {
+            deviceConfig.SetPowerModel(*fitted);
+            cli_printf("Saved\n");
+        }
+        return;
+    }
+
+    if (StringCompareInsensitive(argv[1], "reset"))
+    {
+        deviceConfig.SetPowerModel(PowerModelConfig::Defaults());
+        cli_printf("Power model reset to defaults\n");
+        return;
+    }
+
+    cli_printf("Usage: power [cal start|stop|clear|list|<mW>] [fit [apply]] [reset]\n");
+}
+
 void DoUptime(const cli_argv &)
 {
     struct timeval timeval = { 0 };
@@ -738,6 +830,7 @@ static const command core_commands[] = {
         cli_printf("Brightness: %d\n", val);
     }},
     {"uptime", "Show system uptime", "Showing uptime...", DoUptime},
+    {"power", "[cal ...|fit [apply]|reset] Show or calibrate the power model", nullptr, DoPowerCommand},
     {"color", "[on|off] | [r g b | hex] Set or show colors", "Global Color:",
      [](const cli_argv &argv) {
          if (argv.size() > 1)
@@ -869,7 +962,10 @@ void ProcessCLIByte(uint8_t byte, std::shared_ptr<ConsoleSession> session)
         // CR triggers command dispatch. Echo the newline so the terminal
         // moves to the next line before command output appears.
         session->WriteRaw("\r\n");
-        RunCommand(cmd, session);
+        if (session->DefersCommands())
+            ConsoleManager::Instance().QueueCommand(cmd, session);
+        else
+            RunCommand(cmd, session);
         cmd.clear();
         break;
     }
@@ -167,7 +167,7 @@ DeviceConfig::DeviceConfig()
 
     auto jsonDoc = CreateJsonDocument();
 
-    if (LoadJSONFile(DEVICE_CONFIG_FILE, jsonDoc))
+    if (LoadAndMigrateJSONFile(DEVICE_CONFIG_FILE, jsonDoc))
     {
         debugI("Loading DeviceConfig from JSON");
 
@@ -207,6 +207,7 @@ bool DeviceConfig::SerializeToJSON(JsonObject& jsonObject, bool includeSensitive
     jsonDoc[RemoteEffectButtonsResetIntervalTag] = remoteEffectButtonsResetInterval;
     jsonDoc[PowerLimitTag] = powerLimit;
     jsonDoc[PowerLimitDefaultTag] = POWER_LIMIT_DEFAULT;
+    powerModel.SerializeToJSON(jsonDoc[PowerModelTag].to<JsonObject>());
     // Only serialize showVUMeter if the VU meter is enabled in the build
     #if SHOW_VU_METER
     jsonDoc[ShowVUMeterTag] = showVUMeter;
@@ -281,6 +282,14 @@ bool DeviceConfig::DeserializeFromJSON(const JsonObjectConst& jsonObject, bool s
             }
         }
     }
+    if (jsonObject[PowerModelTag].is<JsonObjectConst>())
+    {
+        if (auto savedPowerModel = PowerModelConfig::FromJSON(jsonObject[PowerModelTag].as<JsonObjectConst>()))
+            powerModel = *savedPowerModel;
+        else
+            debugW("Ignoring invalid saved powerModel; using compiled defaults");
+    }
+    PowerModel::Publish(powerModel);
     SetIfPresentIn(jsonObject, brightness, BrightnessTag);
     // Persisted config predates the newer brightness guardrails in some installs, so treat an invalid
     // saved brightness as "unset" and fall back to the normal 100% default instead of booting dark.
@@ -478,6 +487,12 @@ void DeviceConfig::SetPowerLimit(int newPowerLimit)
         SetAndSave(powerLimit, newPowerLimit);
 }
 
+void DeviceConfig::SetPowerModel(const PowerModelConfig& newPowerModel)
+{
+    SetAndSave(powerModel, newPowerModel);
+    PowerModel::Publish(powerModel);
+}
+
 void DeviceConfig::SetApplyGlobalColors()
 {
     SetAndSave(applyGlobalColors, true);
@@ -191,9 +191,32 @@ void DeviceConfig::SerializeUnifiedSettings(JsonObject root) const
     AppendPins(apa102["clockPins"].to<JsonArray>(), GetAPA102ClockPins());
 }
 
+const char* DeviceConfig::UnifiedSettingsSchemaPartName(size_t part)
+{
+    static constexpr const char* kPartNames[kUnifiedSettingsSchemaPartCount] = { "topology", "outputs", "device", "sections" };
+    return part < kUnifiedSettingsSchemaPartCount ? kPartNames[part] : nullptr;
+}
+
 void DeviceConfig::SerializeUnifiedSettingsSchema(JsonObject root) const
 {
-    auto topology = root["topology"].to<JsonObject>();
+    for (size_t part = 0; part < kUnifiedSettingsSchemaPartCount; ++part)
+        SerializeUnifiedSettingsSchemaPart(part, root[UnifiedSettingsSchemaPartName(part)]);
+}
+
+void DeviceConfig::SerializeUnifiedSettingsSchemaPart(size_t part, JsonVariant target) const
+{
+    switch (part)
+    {
+        case 0:  SerializeSchemaTopology(target.to<JsonObject>()); break;
+        case 1:  SerializeSchemaOutputs(target.to<JsonObject>());  break;
+        case 2:  SerializeSchemaDevice(target.to<JsonObject>());   break;
+        case 3:  SerializeSchemaSections(target.to<JsonArray>());  break;
+        default: break;
+    }
+}
+
+void DeviceConfig::SerializeSchemaTopology(JsonObject topology) const
+{
     topology["compiledMaxWidth"] =
         GetCompiledOutputDriver() == OutputDriver::HUB75
             ? GetCompiledMatrixWidth()
@@ -207,8 +230,10 @@ void DeviceConfig::SerializeUnifiedSettingsSchema(JsonObject root) const
     topology["compiledMaxLEDs"] = GetCompiledLEDCount();
     topology["liveApply"] = SupportsLiveTopology();
     topology["rejectMessage"] = DeviceConfigInternal::RecompileNeededMessage();
+}
 
-    auto outputs = root["outputs"].to<JsonObject>();
+void DeviceConfig::SerializeSchemaOutputs(JsonObject outputs) const
+{
     outputs["compiledDriver"] = GetCompiledDriverName();
     outputs["liveApply"] = SupportsLiveOutputReconfigure();
     outputs["rejectMessage"] = DeviceConfigInternal::RecompileNeededMessage();
@@ -251,8 +276,10 @@ void DeviceConfig::SerializeUnifiedSettingsSchema(JsonObject root) const
     apa102AllowedColorOrders.add("BGR");
     AppendPins(apa102["compiledDataPins"].to<JsonArray>(), GetCompiledWS281xPins());
     AppendPins(apa102["compiledClockPins"].to<JsonArray>(), GetCompiledAPA102ClockPins());
+}
 
-    auto device = root["device"].to<JsonObject>();
+void DeviceConfig::SerializeSchemaDevice(JsonObject device) const
+{
     auto remote = device["remote"].to<JsonObject>();
     remote["enabled"] =
     #if ENABLE_REMOTE
@@ -276,7 +303,10 @@ void DeviceConfig::SerializeUnifiedSettingsSchema(JsonObject root) const
     audio["requiresReboot"] = !SupportsLiveAudioInputReconfigure();
     audio["supportsPinOverride"] = SupportsConfigurableAudioInputPin();
     audio["rejectMessage"] = DeviceConfigInternal::RecompileNeededMessage();
+}
 
+void DeviceConfig::SerializeSchemaSections(JsonArray sections)
+{
     struct SectionInfo
     {
         const char* id;
@@ -295,7 +325,6 @@ void DeviceConfig::SerializeUnifiedSettingsSchema(JsonObject root) const
         { "system",     "System",            "Identification, power limits, and other system-wide options." },
     };
 
-    auto sections = root["sections"].to<JsonArray>();
     for (const auto& info : kSections)
     {
         auto entry = sections.add<JsonObject>();
@@ -190,7 +190,13 @@ uint16_t LocalDraw()
                     #if ENABLE_AUDIO
                         static auto spectrum = std::static_pointer_cast<SpectrumAnalyzerEffect>(GetSpectrumAnalyzer(0));
                         if (effectManager.IsVUVisible())
+                        {
                             spectrum->DrawVUMeter(g_ptrSystem->GetEffectManager().GetBaseGraphics(), 0, g_Analyzer.IsRemoteAudioActive() ? & vuPaletteBlue : &vuPaletteGreen);
+
+                            // The meter draws over whatever channel sums the effect reported
+                            for (auto& device : effectManager.GetBaseGraphics())
+                                device->InvalidateFrameChannelSums();
+                        }
                     #endif
                 #endif
 
@@ -398,6 +404,10 @@ void IRAM_ATTR RenderService::Run()
 
             graphics.PrepareFrame();
 
+            // Channel sums are only good for the frame whose effect reported them
+            for (auto& device : g_ptrSystem->GetDevices())
+                device->InvalidateFrameChannelSums();
+
             if (nd_network::IsWiFiConnected())
                 wifiPixelsDrawn = WiFiDraw();
 
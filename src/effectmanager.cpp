@@ -56,6 +56,7 @@ extern allocated_unique_ptr<EffectFactories> g_ptrEffectFactories;
 extern std::map<int, JSONEffectFactory> g_JsonStarryNightEffectFactories;
 DRAM_ATTR size_t g_EffectsManagerJSONBufferSize = 0;
 extern DRAM_ATTR size_t l_EffectsManagerJSONWriterIndex;
+extern DRAM_ATTR size_t l_EffectsJournalWriterIndex;
 extern DRAM_ATTR size_t l_CurrentEffectWriterIndex;
 extern DRAM_ATTR bool l_EffectManagerInitializing;
 
@@ -79,15 +80,9 @@ extern DRAM_ATTR bool l_EffectManagerInitializing;
 void LoadEffectFactories();
 std::optional<JsonObjectConst> LoadEffectsJSONFile(JsonDocument& jsonDoc);
 void WriteCurrentEffectIndexFile();
-
-namespace
-{
-    void WriteEffectManagerConfigFile()
-    {
-        if (!SaveToJSONFile(EFFECTS_CONFIG_FILE, g_ptrSystem->GetEffectManager()) && EFFECT_PERSISTENCE_CRITICAL)
-            throw std::runtime_error("Effects serialization failed");
-    }
-}
+void WriteEffectManagerConfigFile();
+void WriteEffectsJournalFile();
+void ReplayEffectsJournal(const JsonObjectConst& snapshot);
 
 // InitEffectsManager
 //
@@ -99,6 +94,9 @@ void InitEffectsManager()
 
     LoadEffectFactories();
 
+    // The journal writer is registered first so a pass that has both flagged
+    // appends the journal before the snapshot supersedes it.
+    l_EffectsJournalWriterIndex = g_ptrSystem->GetJSONWriter().RegisterWriter(WriteEffectsJournalFile);
     l_EffectsManagerJSONWriterIndex = g_ptrSystem->GetJSONWriter().RegisterWriter([]()
     {
         WriteEffectManagerConfigFile();
@@ -117,6 +115,8 @@ void InitEffectsManager()
             g_ptrSystem->GetEffectManager().DeserializeFromJSON(jsonObject.value());
         else
             g_ptrSystem->SetupEffectManager(jsonObject.value(), g_ptrSystem->GetDevices());
+
+        ReplayEffectsJournal(jsonObject.value());
     }
     else
     {
@@ -161,7 +161,7 @@ EffectManager::EffectManager(const std::shared_ptr<LEDStripEffect>& effect, std:
 {
     debugV("EffectManager Splash Effect Constructor");
 
-    if (effect->Init(_gfx))
+    if (effect->InitTimed(_gfx))
         _tempEffect = effect;
 
     construct(false);
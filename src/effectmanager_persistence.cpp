@@ -13,8 +13,10 @@
 #include <algorithm>
 #include <FS.h>
 #include <limits>
+#include <mutex>
 #include <set>
 #include <SPIFFS.h>
+#include <utility>
 
 #include "deviceconfig.h"
 #include "effectfactories.h"
@@ -30,6 +32,7 @@
 
 extern allocated_unique_ptr<EffectFactories> g_ptrEffectFactories;
 DRAM_ATTR size_t l_EffectsManagerJSONWriterIndex = SIZE_MAX;
+DRAM_ATTR size_t l_EffectsJournalWriterIndex = SIZE_MAX;
 DRAM_ATTR size_t l_CurrentEffectWriterIndex = SIZE_MAX;
 DRAM_ATTR bool l_EffectManagerInitializing = false;
 
@@ -37,10 +40,80 @@ DRAM_ATTR bool l_EffectManagerInitializing = false;
     #define NO_EFFECT_PERSISTENCE 0
 #endif
 
+// Journal state. Records are queued here by the Journal* calls (usually with
+// g_effect_manager_mutex held, so the lock order is effect manager first,
+// then journal) and appended to flash by the JSON writer task.
+
+namespace
+{
+    std::mutex          l_journalMutex;
+    std::vector<String> l_pendingJournalRecords;
+    bool                l_snapshotPending = false;      // A full snapshot is flagged; it will cover any change made before it runs
+    uint32_t            l_journalGeneration = 0;        // Generation of the snapshot on flash; the journal header must match it
+    EffectsJournalStats l_journalStats;
+
+    // QueueJournalRecord
+    //
+    // Serialize one change as a JSON line and hand it to the writer. While a
+    // snapshot is pending the record is pointless (the snapshot is taken
+    // later and includes the change), so we just make sure it's flagged.
+
+    void QueueJournalRecord(JsonDocument& record)
+    {
+        if (l_EffectManagerInitializing || NO_EFFECT_PERSISTENCE)
+            return;
+
+        std::lock_guard journalGuard(l_journalMutex);
+
+        if (l_snapshotPending)
+        {
+            g_ptrSystem->GetJSONWriter().FlagWriter(l_EffectsManagerJSONWriterIndex);
+            return;
+        }
+
+        String line;
+        serializeJson(record, line);
+        line += '\n';
+        l_pendingJournalRecords.push_back(std::move(line));
+
+        g_ptrSystem->GetJSONWriter().FlagWriter(l_EffectsJournalWriterIndex);
+    }
+
+    // EffectManagerSnapshot
+    //
+    // What actually gets written to EFFECTS_CONFIG_FILE: the effect manager's
+    // own JSON plus the generation stamp that ties it to a journal. Queued
+    // journal records are discarded under the same locks the serialization
+    // runs under, so every change lands either in the snapshot or in the
+    // journal that follows it, never in both or neither.
+
+    class EffectManagerSnapshot : public IJSONSerializable
+    {
+      public:
+        uint32_t generation = 0;
+
+        bool SerializeToJSON(JsonObject& jsonObject) override
+        {
+            std::lock_guard effectGuard(g_effect_manager_mutex);
+
+            if (!g_ptrSystem->GetEffectManager().SerializeToJSON(jsonObject))
+                return false;
+
+            std::lock_guard journalGuard(l_journalMutex);
+            generation = l_journalGeneration + 1;
+            jsonObject[PTY_JOURNALGEN] = generation;
+            l_pendingJournalRecords.clear();
+            l_snapshotPending = false;
+
+            return true;
+        }
+    };
+}
+
 std::optional<JsonObjectConst> LoadEffectsJSONFile(JsonDocument& jsonDoc)
 {
     // If ordered to do so, we ignore whatever is persisted
-    if (NO_EFFECT_PERSISTENCE || !LoadJSONFile(EFFECTS_CONFIG_FILE, jsonDoc))
+    if (NO_EFFECT_PERSISTENCE || !LoadAndMigrateJSONFile(EFFECTS_CONFIG_FILE, jsonDoc))
         return {};
 
     auto jsonObject = jsonDoc.as<JsonObjectConst>();
@@ -105,6 +178,10 @@ void SaveEffectManagerConfig()
         return;
 
     debugV("Saving effect manager config...");
+    {
+        std::lock_guard journalGuard(l_journalMutex);
+        l_snapshotPending = true;
+    }
     g_ptrSystem->GetJSONWriter().FlagWriter(l_EffectsManagerJSONWriterIndex);
 }
 
@@ -113,9 +190,260 @@ void RemoveEffectManagerConfig()
     WaitForRenderSwapBeforeFilesystemWrite();
     std::lock_guard filesystemGuard(JSONFilesystemWriteMutex());
     SPIFFS.remove(EFFECTS_CONFIG_FILE);
+    SPIFFS.remove(EFFECTS_JOURNAL_FILE);
     SPIFFS.remove(CURRENT_EFFECT_CONFIG_FILE);
 }
 
+void JournalEffectEnabled(size_t index, bool enabled)
+{
+    JsonDocument record;
+    record["op"] = "en";
+    record["i"] = index;
+    record["v"] = enabled ? 1 : 0;
+    QueueJournalRecord(record);
+}
+
+void JournalEffectMoved(size_t from, size_t to)
+{
+    JsonDocument record;
+    record["op"] = "mv";
+    record["f"] = from;
+    record["t"] = to;
+    QueueJournalRecord(record);
+}
+
+void JournalEffectInterval(uint interval)
+{
+    JsonDocument record;
+    record["op"] = "ivl";
+    record["v"] = interval;
+    QueueJournalRecord(record);
+}
+
+void JournalEffectSettings(size_t index, const std::vector<std::pair<String, String>>& settings)
+{
+    if (settings.empty())
+        return;
+
+    JsonDocument record;
+    record["op"] = "set";
+    record["i"] = index;
+    auto settingsObject = record["s"].to<JsonObject>();
+    for (const auto& [name, value] : settings)
+        settingsObject[name] = value;
+    QueueJournalRecord(record);
+}
+
+bool IsEffectsConfigFileCurrent()
+{
+    std::lock_guard journalGuard(l_journalMutex);
+    return !l_snapshotPending && l_pendingJournalRecords.empty() && l_journalStats.journalBytes == 0;
+}
+
+EffectsJournalStats GetEffectsJournalStats()
+{
+    std::lock_guard journalGuard(l_journalMutex);
+    return l_journalStats;
+}
+
+// WriteEffectManagerConfigFile
+//
+// Writes a full snapshot and retires the journal it supersedes. The old
+// journal is only removed after the new snapshot is safely in place; if we
+// reset in between, its header generation no longer matches and boot
+// ignores it.
+
+void WriteEffectManagerConfigFile()
+{
+    EffectManagerSnapshot snapshot;
+    size_t bytesWritten = 0;
+
+    if (!SaveToJSONFile(EFFECTS_CONFIG_FILE, snapshot, &bytesWritten))
+    {
+        // Records queued since the failed attempt were dropped, so keep
+        // the journal closed until a snapshot makes it to flash.
+        {
+            std::lock_guard journalGuard(l_journalMutex);
+            l_snapshotPending = true;
+        }
+
+        if (EFFECT_PERSISTENCE_CRITICAL)
+            throw std::runtime_error("Effects serialization failed");
+        return;
+    }
+
+    {
+        WaitForRenderSwapBeforeFilesystemWrite();
+        std::lock_guard filesystemGuard(JSONFilesystemWriteMutex());
+        SPIFFS.remove(EFFECTS_JOURNAL_FILE);
+    }
+
+    std::lock_guard journalGuard(l_journalMutex);
+    l_journalGeneration = snapshot.generation;
+    l_journalStats.journalBytes = 0;
+    l_journalStats.snapshotBytes = bytesWritten;
+    l_journalStats.snapshots++;
+}
+
+// WriteEffectsJournalFile
+//
+// Appends queued records to the journal, starting it with a header line if
+// it's new. Once the journal outgrows EFFECTS_JOURNAL_COMPACT_BYTES it is
+// folded into a fresh snapshot, which keeps boot replay short.
+
+void WriteEffectsJournalFile()
+{
+    std::vector<String> records;
+    uint32_t generation;
+    {
+        std::lock_guard journalGuard(l_journalMutex);
+        records.swap(l_pendingJournalRecords);
+        generation = l_journalGeneration;
+    }
+
+    if (records.empty())
+        return;
+
+    size_t bytesWritten = 0;
+    size_t journalBytes = 0;
+    {
+        WaitForRenderSwapBeforeFilesystemWrite();
+        std::lock_guard filesystemGuard(JSONFilesystemWriteMutex());
+
+        File file = SPIFFS.open(EFFECTS_JOURNAL_FILE, FILE_APPEND);
+        if (!file)
+        {
+            debugE("Unable to open file %s for appending!", EFFECTS_JOURNAL_FILE);
+            return;
+        }
+
+        if (file.size() == 0)
+            bytesWritten += file.printf("{\"gen\":%u}\n", (unsigned)generation);
+
+        for (const auto& record : records)
+            bytesWritten += file.print(record);
+
+        file.flush();
+        journalBytes = file.size();
+        file.close();
+    }
+
+    debugV("Appended %zu bytes to %s", bytesWritten, EFFECTS_JOURNAL_FILE);
+
+    {
+        std::lock_guard journalGuard(l_journalMutex);
+        l_journalStats.journalBytes = journalBytes;
+        l_journalStats.lastChangeBytes = records.back().length();
+        l_journalStats.changesWritten += records.size();
+    }
+
+    if (journalBytes > EFFECTS_JOURNAL_COMPACT_BYTES)
+    {
+        debugI("Compacting %s (%zu bytes)", EFFECTS_JOURNAL_FILE, journalBytes);
+        SaveEffectManagerConfig();
+    }
+}
+
+// ReplayEffectsJournal
+//
+// Applies the journal on top of the snapshot just loaded. Called while the
+// effect manager is still initializing, so none of the changes are saved
+// or journaled again. A journal written against a different snapshot is
+// discarded; a torn last record (reset mid-append) ends the replay, and the
+// journal is then compacted so new records don't land after it.
+
+void ReplayEffectsJournal(const JsonObjectConst& snapshot)
+{
+    const uint32_t generation = snapshot[PTY_JOURNALGEN] | 0u;
+    {
+        std::lock_guard journalGuard(l_journalMutex);
+        l_journalGeneration = generation;
+    }
+
+    if (NO_EFFECT_PERSISTENCE)
+        return;
+
+    File file = SPIFFS.open(EFFECTS_JOURNAL_FILE);
+    if (!file)
+        return;
+
+    const size_t journalBytes = file.size();
+    const auto startMs = millis();
+    auto& effectManager = g_ptrSystem->GetEffectManager();
+    uint32_t replayed = 0;
+    bool headerMatched = false;
+    bool torn = false;
+    JsonDocument record;
+
+    while (file.available())
+    {
+        String line = file.readStringUntil('\n');
+        if (deserializeJson(record, line) != DeserializationError::Ok)
+        {
+            torn = true;
+            break;
+        }
+
+        if (!headerMatched)
+        {
+            if ((record["gen"] | UINT32_MAX) != generation)
+                break;
+            headerMatched = true;
+            continue;
+        }
+
+        const String op = record["op"] | "";
+        const size_t index = record["i"] | SIZE_MAX;
+
+        if (op == "en")
+        {
+            if (record["v"].as<int>())
+                effectManager.EnableEffect(index, true);
+            else
+                effectManager.DisableEffect(index, true);
+        }
+        else if (op == "mv")
+            effectManager.MoveEffect(record["f"] | SIZE_MAX, record["t"] | SIZE_MAX);
+        else if (op == "ivl")
+            effectManager.SetInterval(record["v"] | DEFAULT_EFFECT_INTERVAL, true);
+        else if (op == "set")
+        {
+            if (auto effect = effectManager.EffectAt(index))
+            {
+                for (JsonPairConst setting : record["s"].as<JsonObjectConst>())
+                    effect->SetSetting(setting.key().c_str(), setting.value().as<String>());
+            }
+        }
+
+        replayed++;
+    }
+
+    file.close();
+
+    if (!headerMatched)
+    {
+        debugW("Discarding %s, it doesn't belong to the current %s", EFFECTS_JOURNAL_FILE, EFFECTS_CONFIG_FILE);
+        WaitForRenderSwapBeforeFilesystemWrite();
+        std::lock_guard filesystemGuard(JSONFilesystemWriteMutex());
+        SPIFFS.remove(EFFECTS_JOURNAL_FILE);
+        return;
+    }
+
+    std::lock_guard journalGuard(l_journalMutex);
+    l_journalStats.journalBytes = journalBytes;
+    l_journalStats.replayedChanges = replayed;
+    l_journalStats.replayMs = millis() - startMs;
+
+    debugI("Replayed %u effect changes from %s in %ums", replayed, EFFECTS_JOURNAL_FILE, (unsigned)l_journalStats.replayMs);
+
+    if (torn)
+    {
+        debugW("Last record in %s was incomplete, compacting", EFFECTS_JOURNAL_FILE);
+        l_snapshotPending = true;
+        g_ptrSystem->GetJSONWriter().FlagWriter(l_EffectsManagerJSONWriterIndex);
+    }
+}
+
 void WriteCurrentEffectIndexFile()
 {
     // Capture the current effect index without holding g_render_mutex to avoid nested lock order issues.
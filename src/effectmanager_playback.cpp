@@ -32,7 +32,6 @@
 #endif
 
 extern allocated_unique_ptr<EffectFactories> g_ptrEffectFactories;
-void SaveEffectManagerConfig();
 
 void EffectManager::SetCurrentEffectIndex(size_t i)
 {
@@ -72,7 +71,7 @@ void EffectManager::SetInterval(uint interval, bool skipSave)
     _effectInterval = interval;
 
     if (!skipSave)
-        SaveEffectManagerConfig();
+        JournalEffectInterval(interval);
 
     {
         std::lock_guard listenerGuard(_listenerMutex);
@@ -45,7 +45,7 @@ std::shared_ptr<LEDStripEffect> GetSpectrumAnalyzer(CRGB color)
     CHSV hueColor = rgb2hsv_approximate(color);
     CRGB color2 = CRGB(CHSV(hueColor.hue + 64, 255, 255));
     auto object = make_shared_psram<SpectrumAnalyzerEffect>("Spectrum Clr", 24, CRGBPalette16(color, color2), true);
-    if (object->Init(g_ptrSystem->GetDevices()))
+    if (object->InitTimed(g_ptrSystem->GetDevices()))
         return object;
     throw std::runtime_error("Could not initialize new spectrum analyzer, one color version!");
 }
@@ -74,6 +74,29 @@ void EffectManager::StartEffect()
 
     auto effect = _tempEffect ? _tempEffect : _vEffects[_iCurrentEffect];
 
+    // An effect flagged by a topology change and not yet caught up in the background is initialized now.
+    // One whose Init() failed isn't started half set up; the next effect in the rotation that is
+    // initialized is started in its place, and Update() won't draw it should none be.
+    size_t skipped = 0;
+    while (!effect->InitIfPending(_gfx))
+    {
+        debugE("Skipping effect %s, its Init() failed", effect->FriendlyName().c_str());
+
+        if (effect == _tempEffect)
+            _tempEffect.reset();
+        else if (++skipped >= _vEffects.size())
+            break;
+        else
+            AdvanceCurrentEffectIndex();
+
+        if (_vEffects.empty())
+        {
+            _effectStartTime = millis();
+            return;
+        }
+        effect = _tempEffect ? _tempEffect : _vEffects[_iCurrentEffect];
+    }
+
     #if USE_HUB75
         auto& matrix = static_cast<HUB75GFX&>(*_gfx[0]);
         matrix.SetCaption(effect->FriendlyName(), CAPTION_TIME);
@@ -146,11 +169,8 @@ bool EffectManager::Init()
     for (const auto & _vEffect : _vEffects)
     {
         debugV("About to init effect %s", _vEffect->FriendlyName().c_str());
-        if (false == _vEffect->Init(_gfx))
-        {
-            debugW("Could not initialize effect: %s\n", _vEffect->FriendlyName().c_str());
+        if (false == _vEffect->InitTimed(_gfx))
             return false;
-        }
         debugV("Loaded Effect: %s", _vEffect->FriendlyName().c_str());
     }
     if (_vEffects.empty())
@@ -158,33 +178,113 @@ bool EffectManager::Init()
     else
         debugV("First Effect: %s", GetCurrentEffectName().c_str());
 
+    NoteInitGeometry();
+
     if (g_ptrSystem->GetDeviceConfig().ApplyGlobalColors())
         ApplyGlobalPaletteColors();
 
     return true;
 }
 
+uint8_t EffectManager::NoteInitGeometry()
+{
+    const auto& device = *_gfx[0];
+    uint8_t changed = LEDStripEffect::ConfigNone;
+
+    if (device.GetMatrixWidth() != _initWidth)
+        changed |= LEDStripEffect::ConfigWidth;
+    if (device.GetMatrixHeight() != _initHeight)
+        changed |= LEDStripEffect::ConfigHeight;
+    if (device.IsSerpentine() != _initSerpentine)
+        changed |= LEDStripEffect::ConfigSerpentine;
+
+    _initWidth = device.GetMatrixWidth();
+    _initHeight = device.GetMatrixHeight();
+    _initSerpentine = device.IsSerpentine();
+
+    return changed;
+}
+
 bool EffectManager::ReinitializeEffects()
 {
     std::scoped_lock guard(g_render_mutex, g_effect_manager_mutex);
 
-    if (!Init())
-        return false;
+    const uint8_t changed = NoteInitGeometry();
+    if (changed == LEDStripEffect::ConfigNone)
+        return true;
 
+    size_t flagged = 0;
+    for (const auto& effect : _vEffects)
+        flagged += effect->MarkConfigChanged(changed) ? 1 : 0;
     if (_tempEffect)
+        flagged += _tempEffect->MarkConfigChanged(changed) ? 1 : 0;
+
+    debugI("Topology change flagged %zu effects for reinitialization", flagged);
+
+    if (g_ptrSystem->GetDeviceConfig().ApplyGlobalColors())
+        ApplyGlobalPaletteColors();
+
+    if (!_tempEffect && _vEffects.empty())
+        return true;
+
+    // Only the effect on screen is brought up to date now; the rest catch up in InitPendingEffect() or
+    // when they are started, whichever comes first
+    auto effect = _tempEffect ? _tempEffect : _vEffects[_iCurrentEffect];
+    const bool result = effect->InitIfPending(_gfx);
+
+    StartEffect();
+    return result;
+}
+
+bool EffectManager::InitPendingEffect()
+{
+    std::shared_ptr<LEDStripEffect> effect;
+    std::vector<std::shared_ptr<GFXBase>> gfx;
+
     {
-        debugV("About to re-init temp effect %s", _tempEffect->FriendlyName().c_str());
-        if (!_tempEffect->Init(_gfx))
+        std::lock_guard effectGuard(g_effect_manager_mutex);
+
+        const auto current = _tempEffect ? _tempEffect : (_vEffects.empty() ? nullptr : _vEffects[_iCurrentEffect]);
+        for (const auto& candidate : _vEffects)
         {
-            debugW("Could not re-initialize temporary effect: %s\n", _tempEffect->FriendlyName().c_str());
-            return false;
+            if (candidate != current && candidate->IsInitPending())
+            {
+                effect = candidate;
+                break;
+            }
         }
+
+        if (!effect)
+            return false;
+
+        gfx = _gfx;
     }
 
-    StartEffect();
+    // Should the effect be started in the meantime, StartEffect() waits in InitIfPending() for this to finish
+    effect->InitIfPending(gfx);
     return true;
 }
 
+size_t EffectManager::PendingInitCount() const
+{
+    std::lock_guard effectGuard(g_effect_manager_mutex);
+
+    size_t count = _tempEffect && _tempEffect->IsInitPending() ? 1 : 0;
+    for (const auto& effect : _vEffects)
+        count += effect->IsInitPending() ? 1 : 0;
+    return count;
+}
+
+size_t EffectManager::FailedInitCount() const
+{
+    std::lock_guard effectGuard(g_effect_manager_mutex);
+
+    size_t count = _tempEffect && _tempEffect->InitFailed() ? 1 : 0;
+    for (const auto& effect : _vEffects)
+        count += effect->InitFailed() ? 1 : 0;
+    return count;
+}
+
 bool EffectManager::ShowVU(bool bShow)
 {
     std::scoped_lock guard(g_render_mutex, g_effect_manager_mutex);
@@ -311,7 +411,7 @@ void EffectManager::EnableEffect(size_t i, bool skipSave)
         effect->SetEnabled(true);
 
         if (!skipSave)
-            SaveEffectManagerConfig();
+            JournalEffectEnabled(i, true);
 
         {
             std::lock_guard listenerGuard(_listenerMutex);
@@ -340,7 +440,7 @@ void EffectManager::DisableEffect(size_t i, bool skipSave)
             ApplyGlobalColor(CRGB::Black);
 
         if (!skipSave)
-            SaveEffectManagerConfig();
+            JournalEffectEnabled(i, false);
 
         {
             std::lock_guard listenerGuard(_listenerMutex);
@@ -382,7 +482,7 @@ void EffectManager::MoveEffect(size_t from, size_t to)
         SaveCurrentEffectIndex();
     }
 
-    SaveEffectManagerConfig();
+    JournalEffectMoved(from, to);
 
     {
         std::lock_guard listenerGuard(_listenerMutex);
@@ -396,7 +496,7 @@ bool EffectManager::AppendEffect(std::shared_ptr<LEDStripEffect>& effect)
 {
     std::scoped_lock guard(g_render_mutex, g_effect_manager_mutex);
 
-    if (!effect->Init(_gfx))
+    if (!effect->InitTimed(_gfx))
         return false;
 
     _vEffects.push_back(effect);
@@ -519,6 +619,21 @@ void EffectManager::CheckEffectTimerExpired()
     }
 }
 
+// Step _iCurrentEffect on to the next effect in the rotation, which skips disabled effects unless all of
+// them are or PlayAll is on. Called with the locks held and at least one effect in the list.
+
+void EffectManager::AdvanceCurrentEffectIndex()
+{
+    auto enabled = AreEffectsEnabled();
+
+    do
+    {
+        _iCurrentEffect++;
+        _iCurrentEffect %= EffectCount();
+        _effectStartTime = millis();
+    } while (enabled && false == _bPlayAll && false == IsEffectEnabled(_iCurrentEffect));
+}
+
 // Update to the next effect and abort the current effect.
 
 void EffectManager::NextEffect(bool skipSave)
@@ -532,15 +647,7 @@ void EffectManager::NextEffect(bool skipSave)
         return;
     }
 
-    auto enabled = AreEffectsEnabled();
-
-    do
-    {
-        _iCurrentEffect++;
-        _iCurrentEffect %= EffectCount();
-        _effectStartTime = millis();
-    } while (enabled && false == _bPlayAll && false == IsEffectEnabled(_iCurrentEffect));
-
+    AdvanceCurrentEffectIndex();
     StartEffect();
     if (!skipSave)
         SaveCurrentEffectIndex();
@@ -604,14 +711,45 @@ void EffectManager::Update()
     CheckEffectTimerExpired();
     DispatchBeatIfNeeded();
 
-    if (_tempEffect)
-        _tempEffect->Draw();
-    else
-        _vEffects[_iCurrentEffect]->Draw();
+    auto& effect = _tempEffect ? *_tempEffect : *_vEffects[_iCurrentEffect];
+
+    // Only left current when StartEffect() found nothing that would initialize
+    if (effect.InitFailed())
+    {
+        ApplyFadeLogic();
+        return;
+    }
+
+    #if ENABLE_RENDER_BUDGET
+        auto& budget = effect.GetRenderBudget();
+        budget.BeginDraw();
+        effect.Draw();
+        effect.SetQualityLevel(budget.EndDraw(GetDrawBudgetMicros(effect), effect.QualityLevels()));
+
+        g_Values.EffectDrawMicros   = budget.AverageMicros();
+        g_Values.EffectQualityLevel = effect.QualityLevel();
+        g_Values.EffectBudgetMisses = budget.Misses();
+    #else
+        effect.Draw();
+    #endif
 
     ApplyFadeLogic();
 }
 
+// EffectManager::GetDrawBudgetMicros
+//
+// The share of an effect's frame time its Draw() may take; 0, meaning no budget, for effects that ask for
+// an unlimited frame rate
+
+uint32_t EffectManager::GetDrawBudgetMicros(const LEDStripEffect& effect)
+{
+    const size_t fps = effect.DesiredFramesPerSecond();
+    if (fps == 0)
+        return 0;
+
+    return MICROS_PER_SECOND / fps * RENDER_BUDGET_PERCENT / 100;
+}
+
 void EffectManager::ApplyFadeLogic()
 {
     if (EffectCount() < 2)
@@ -42,7 +42,9 @@
 #include "effectmanager.h"
 #include "effects/matrix/Boid.h"
 #include "gfxbase.h"
+#include "pixelkernels.h"
 #include "systemcontainer.h"
+#include "textstrip.h"
 
 // 32 Entries in the 5-bit gamma table
 const uint8_t GFXBase::gamma5[32] =
@@ -147,27 +149,23 @@ String GFXBase::FitTextToWidth(const String& text, int maxWidth)
 }
 
 // Draws the specified text centered within the given rectangle, using the current font 
-// and text color.
+// and text color.  The fitted text is rasterized once and cached, so redrawing the same
+// string frame after frame neither refits nor re-renders it.
 
 void GFXBase::DrawTextInRect(const String& text, int x, int y, int width, int height, uint16_t color)
 {
     if (text.isEmpty() || width <= 0 || height <= 0)
         return;
 
-    const String fitted = FitTextToWidth(text, width);
-    if (fitted.isEmpty())
+    const auto strip = TextStrip::Cached(text, gfxFont, textsize_x, textsize_y, TextStrip::Style::Plain, width);
+    if (strip->IsEmpty())
         return;
 
-    int16_t x1, y1;
-    uint16_t textWidth, textHeight;
-    getTextBounds(fitted, 0, 0, &x1, &y1, &textWidth, &textHeight);
-
-    const int drawX = x + std::max(0, (width - static_cast<int>(textWidth)) / 2 - x1);
-    const int drawY = y + (height - static_cast<int>(textHeight)) / 2 - y1;
+    const int drawX = x + std::max(0, (width - static_cast<int>(strip->InkWidth())) / 2 - strip->InkX());
+    const int drawY = y + (height - static_cast<int>(strip->InkHeight())) / 2 - strip->InkY();
 
     setTextColor(color);
-    setCursor(drawX, drawY);
-    print(fitted);
+    strip->Draw(*this, drawX, drawY, from16Bit(color));
 }
 
 void GFXBase::DrawTextInRect(const String& text, int x, int y, int width, int height, const CRGB& color)
@@ -195,6 +193,19 @@ void GFXBase::DrawTextInBand(const String& text, int bandTop, int bandHeight, CR
     DrawTextInBand(text, bandTop, bandHeight, to16bit(color));
 }
 
+void GFXBase::DrawCachedText(const String& text, int x, int y, const CRGB& color, int maxWidth)
+{
+    if (text.isEmpty())
+        return;
+
+    TextStrip::Cached(text, gfxFont, textsize_x, textsize_y, TextStrip::Style::Plain, maxWidth)->Draw(*this, x, y, color);
+}
+
+void GFXBase::DrawCachedText(const String& text, int x, int y, uint16_t color, int maxWidth)
+{
+    DrawCachedText(text, x, y, from16Bit(color), maxWidth);
+}
+
 void GFXBase::Clear(CRGB color)
 {
     const size_t count = _width * _height;
@@ -543,8 +554,109 @@ CRGBW GFXBase::MaximumWhiteForKelvin(uint16_t kelvin, uint8_t brightness)
     return split;
 }
 
+namespace
+{
+    // BlurLine
+    //
+    // blurRows/blurColumns on one contiguous line, given as the span holding logical pixels
+    // [first, count) in either direction. The pixel before first isn't blurred, but still picks
+    // up its share of pixel first; edge is where it lives, or nullptr when first is 0.
+
+    void BlurLine(CRGB* span, size_t spanCount, const CRGB& firstPixel, CRGB* edge, fract8 blur_amount)
+    {
+        if (edge)
+        {
+            CRGB part = firstPixel;
+            part.nscale8(blur_amount >> 1);
+            *edge += part;
+        }
+        PixelKernels::BlurSpan(span, spanCount, blur_amount);
+    }
+
+    // BlurAcrossLines
+    //
+    // The same blur run across parallel lines rather than along them: lines [first, lineCount),
+    // each lineLength pixels and stride apart, are treated as the pixels of one blur1d. This is
+    // how columns blur on a row-major panel, and rows on a column-major one.
+
+    void BlurAcrossLines(CRGB* leds, size_t stride, size_t lineLength, size_t first, size_t lineCount, fract8 blur_amount, CRGB* scratch)
+    {
+        const uint8_t keep = 255 - blur_amount;
+        const uint8_t seep = blur_amount >> 1;
+        CRGB* carry = scratch;
+        CRGB* part = scratch + lineLength;
+
+        for (size_t i = first; i < lineCount; i++)
+        {
+            CRGB* line = leds + i * stride;
+
+            std::copy_n(line, lineLength, part);
+            PixelKernels::ScaleSpan(part, lineLength, seep);
+            PixelKernels::ScaleSpan(line, lineLength, keep);
+            if (i > first)
+                PixelKernels::AddSpan(line, carry, lineLength);
+            if (i)
+                PixelKernels::AddSpan(line - stride, part, lineLength);
+            std::swap(carry, part);
+        }
+    }
+}
+
+GFXBase::PixelLayout GFXBase::GetPixelLayout() const
+{
+    if (_pixelLayout != PixelLayout::Unknown)
+        return _pixelLayout;
+
+    auto matches = [&](auto index)
+    {
+        for (size_t x = 0; x < _width; x++)
+            for (size_t y = 0; y < _height; y++)
+                if (xy(x, y) != index(x, y))
+                    return false;
+        return true;
+    };
+
+    PixelLayout layout = PixelLayout::Irregular;
+    if (matches([&](size_t x, size_t y) { return y * _width + x; }))
+        layout = PixelLayout::RowMajor;
+    else if (matches([&](size_t x, size_t y) { return x * _height + y; }))
+        layout = PixelLayout::ColumnMajor;
+    else if (matches([&](size_t x, size_t y) { return x * _height + ((x & 0x01) ? _height - 1 - y : y); }))
+        layout = PixelLayout::ColumnSerpentine;
+
+    _pixelLayout = layout;
+    return layout;
+}
+
+CRGB* GFXBase::LineScratch(size_t count) const
+{
+    if (_lineScratch.size() < count)
+        _lineScratch.resize(count);
+    return _lineScratch.data();
+}
+
 void GFXBase::blurRows(CRGB *leds, uint16_t width, uint16_t height, uint16_t first, fract8 blur_amount)
 {
+    const PixelLayout layout = (width <= _width && height <= _height) ? GetPixelLayout() : PixelLayout::Irregular;
+
+    if (layout == PixelLayout::RowMajor)
+    {
+        if (first >= width)
+            return;
+        for (uint16_t row = 0; row < height; row++)
+        {
+            CRGB* line = leds + row * _width;
+            BlurLine(line + first, width - first, line[first], first ? line + first - 1 : nullptr, blur_amount);
+        }
+        return;
+    }
+
+    if (layout == PixelLayout::ColumnMajor)
+    {
+        BlurAcrossLines(leds, _height, height, first, width, blur_amount, LineScratch(2 * height));
+        return;
+    }
+
     // blur rows same as columns, for irregular matrix
     uint8_t keep = 255 - blur_amount;
     uint8_t seep = blur_amount >> 1;
@@ -570,6 +682,33 @@ void GFXBase::blurRows(CRGB *leds, uint16_t width, uint16_t height, uint16_t fir
 
 void GFXBase::blurColumns(CRGB *leds, uint16_t width, uint16_t height, uint16_t first, fract8 blur_amount)
 {
+    const PixelLayout layout = (width <= _width && height <= _height) ? GetPixelLayout() : PixelLayout::Irregular;
+
+    if (layout == PixelLayout::RowMajor)
+    {
+        BlurAcrossLines(leds, _width, width, first, height, blur_amount, LineScratch(2 * width));
+        return;
+    }
+
+    if (layout == PixelLayout::ColumnMajor || layout == PixelLayout::ColumnSerpentine)
+    {
+        if (first >= height)
+            return;
+        for (uint16_t col = 0; col < width; ++col)
+        {
+            CRGB* line = leds + col * _height;
+
+            // Odd serpentine columns hold y at _height - 1 - y, so the span runs the other way; the
+            // blur itself is symmetric, so only the edge pixel needs to know
+
+            if (layout == PixelLayout::ColumnSerpentine && (col & 0x01))
+                BlurLine(line + _height - height, height - first, line[_height - 1 - first], first ? line + _height - first : nullptr, blur_amount);
+            else
+                BlurLine(line + first, height - first, line[first], first ? line + first - 1 : nullptr, blur_amount);
+        }
+        return;
+    }
+
     // blur columns
     uint8_t keep = 255 - blur_amount;
     uint8_t seep = blur_amount >> 1;
@@ -640,6 +779,7 @@ void GFXBase::ConfigureTopology(size_t width, size_t height, bool serpentine)
     _height     = height;
     _ledcount   = width * height;
     _serpentine = serpentine;
+    _pixelLayout = PixelLayout::Unknown;
 
     WIDTH  = width;
     HEIGHT = height;
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <gfxfont.h>
 #include <memory>
 #include <stdexcept>
@@ -20,6 +21,7 @@
 #include "effectmanager.h"
 #include "effects/matrix/Boid.h"
 #include "gfxbase.h"
+#include "pixelkernels.h"
 #include "systemcontainer.h"
 
 void GFXBase::MoveOscillators()
@@ -89,6 +91,20 @@ void GFXBase::MoveOutwardsX(int startY, int endY)
 
 void GFXBase::MoveX(uint8_t delta) const
 {
+    if (delta < _width && GetPixelLayout() == PixelLayout::RowMajor)
+    {
+        for (size_t y = 0; y < _height; y++)
+        {
+            CRGB* row = leds + y * _width;
+            memmove(row, row + delta, (_width - delta) * sizeof(CRGB));
+
+            // Like the loop below, the wrapped pixels are read after the move
+            for (size_t x = _width - delta; x < _width; x++)
+                row[x] = row[x + delta - _width];
+        }
+        return;
+    }
+
     for (int y = 0; y < (int)_height; y++)
     {
         for (int x = 0; x < (int)_width - delta; x++)
@@ -100,6 +116,21 @@ void GFXBase::MoveX(uint8_t delta) const
 
 void GFXBase::MoveY(uint8_t delta) const
 {
+    if (GetPixelLayout() == PixelLayout::RowMajor)
+    {
+        // Each step below shifts up one row and refills the bottom from the original top row
+        const size_t steps = std::min<size_t>(delta, _height);
+        if (steps == 0)
+            return;
+
+        CRGB* topRow = LineScratch(_width);
+        std::copy_n(leds, _width, topRow);
+        memmove(leds, leds + steps * _width, (_height - steps) * _width * sizeof(CRGB));
+        for (size_t y = _height - steps; y < _height; y++)
+            std::copy_n(topRow, _width, leds + y * _width);
+        return;
+    }
+
     CRGB tmp = 0;
     for (int x = 0; x < (int)_width; x++)
     {
@@ -121,6 +152,21 @@ void GFXBase::MoveY(uint8_t delta) const
 
 void GFXBase::Caleidoscope1() const
 {
+    if (GetPixelLayout() == PixelLayout::RowMajor)
+    {
+        // Mirror the left half of each top row onto its right half, then the top rows onto the bottom
+        for (size_t y = 0; y < (_height + 1) / 2; y++)
+        {
+            CRGB* row = leds + y * _width;
+            std::reverse_copy(row, row + _width / 2, row + (_width + 1) / 2);
+
+            CRGB* mirrorRow = leds + (_height - 1 - y) * _width;
+            if (mirrorRow != row)
+                std::copy_n(row, _width, mirrorRow);
+        }
+        return;
+    }
+
     for (int x = 0; x < ((_width + 1) / 2); x++)
     {
         for (int y = 0; y < ((_height + 1) / 2); y++)
@@ -327,6 +373,16 @@ void GFXBase::Expand(int centerX, int centerY, int radius, uint8_t dimm)
 
 void GFXBase::StreamRight(uint8_t scale, int fromX, int toX, int fromY, int toY)
 {
+    // Each column takes from the one before it, so on a column-major matrix a column is one span
+    if (fromX >= 0 && toX <= (int)_width && fromY >= 0 && fromY <= toY && toY <= (int)_height
+        && GetPixelLayout() == PixelLayout::ColumnMajor)
+    {
+        for (int x = fromX + 1; x < toX; x++)
+            PixelKernels::AddThenScaleSpan(leds + x * _height + fromY, leds + (x - 1) * _height + fromY, toY - fromY, scale);
+        PixelKernels::ScaleSpan(leds + fromY, toY - fromY, scale);
+        return;
+    }
+
     for (int x = fromX + 1; x < toX; x++)
     {
         for (int y = fromY; y < toY; y++)
@@ -343,6 +399,15 @@ void GFXBase::StreamRight(uint8_t scale, int fromX, int toX, int fromY, int toY)
 
 void GFXBase::StreamLeft(uint8_t scale, int fromX, int toX, int fromY, int toY)
 {
+    if (toX >= 0 && fromX < (int)_width && fromY >= 0 && fromY <= toY && toY <= (int)_height
+        && GetPixelLayout() == PixelLayout::ColumnMajor)
+    {
+        for (int x = toX; x < fromX; x++)
+            PixelKernels::AddThenScaleSpan(leds + x * _height + fromY, leds + (x + 1) * _height + fromY, toY - fromY, scale);
+        PixelKernels::ScaleSpan(leds + fromY, toY - fromY, scale);
+        return;
+    }
+
     for (int x = toX; x < fromX; x++)
     {
         for (int y = fromY; y < toY; y++)
@@ -359,6 +424,15 @@ void GFXBase::StreamLeft(uint8_t scale, int fromX, int toX, int fromY, int toY)
 
 void GFXBase::StreamDown(uint8_t scale)
 {
+    // Each row takes from the one above it, so on a row-major matrix a row is one span
+    if (GetPixelLayout() == PixelLayout::RowMajor)
+    {
+        for (size_t y = 1; y < _height; y++)
+            PixelKernels::AddThenScaleSpan(leds + y * _width, leds + (y - 1) * _width, _width, scale);
+        PixelKernels::ScaleSpan(leds, _width, scale);
+        return;
+    }
+
     for (int x = 0; x < _width; x++)
     {
         for (int y = 1; y < _height; y++)
@@ -375,6 +449,14 @@ void GFXBase::StreamDown(uint8_t scale)
 
 void GFXBase::StreamUp(uint8_t scale)
 {
+    if (_height > 0 && GetPixelLayout() == PixelLayout::RowMajor)
+    {
+        for (int y = (int)_height - 2; y >= 0; y--)
+            PixelKernels::AddThenScaleSpan(leds + y * _width, leds + (y + 1) * _width, _width, scale);
+        PixelKernels::ScaleSpan(leds + (_height - 1) * _width, _width, scale);
+        return;
+    }
+
     for (int x = 0; x < _width; x++)
     {
         for (int y = (int)_height - 2; y >= 0; y--)
@@ -512,8 +594,7 @@ void GFXBase::drawLine(int x0, int y0, int x1, int y1, CRGB color)
 
 void GFXBase::DimAll(uint8_t value)
 {
-    for (int i = 0; i < (int)_ledcount; i++)
-        fadePixelToBlackBy(i, 255 - value);
+    PixelKernels::ScaleSpan(leds, _ledcount, value);
 }
 
 CRGB GFXBase::ColorFromCurrentPalette(uint8_t index, uint8_t brightness, TBlendType blendType) const
@@ -0,0 +1,320 @@
+//+--------------------------------------------------------------------------
+//
+// File:        gifframecache.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Pre-decoded GIF frame storage and playback; see gifframecache.h.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+#include "gfxbase.h"
+#include "gifframecache.h"
+
+namespace
+{
+    constexpr uint8_t kExtensionIntroducer = 0x21;
+    constexpr uint8_t kImageSeparator      = 0x2C;
+    constexpr uint8_t kTrailer             = 0x3B;
+    constexpr size_t  kMaxPaletteSize      = 256;
+
+    uint32_t ColorKey(const CRGB& color)
+    {
+        return (uint32_t(color.r) << 16) | (uint32_t(color.g) << 8) | color.b;
+    }
+
+    // Size in bytes of the color table a packed field announces, if any
+    size_t ColorTableBytes(uint8_t packed)
+    {
+        return (packed & 0x80) ? 3 * (size_t(1) << ((packed & 0x07) + 1)) : 0;
+    }
+
+    // Step past a chain of data sub-blocks, including its zero terminator
+    bool SkipSubBlocks(const uint8_t* data, size_t length, size_t& pos)
+    {
+        while (pos < length)
+        {
+            const uint8_t blockSize = data[pos++];
+            if (blockSize == 0)
+                return true;
+            pos += blockSize;
+        }
+        return false;
+    }
+}
+
+GIFFrameCache::GIFFrameCache(uint16_t width, uint16_t height, size_t maxBytes)
+    : _width(width),
+      _height(height),
+      _maxBytes(maxBytes),
+      _canvas(size_t(width) * height),
+      _plotted(size_t(width) * height, 0)
+{
+}
+
+// CountFrames
+//
+// Header and logical screen descriptor, an optional global color table,
+// then a sequence of extensions and images up to the trailer.
+
+size_t GIFFrameCache::CountFrames(const uint8_t* data, size_t length)
+{
+    constexpr size_t kHeaderBytes = 13;
+    constexpr size_t kImageDescriptorBytes = 9;
+
+    if (length < kHeaderBytes || memcmp(data, "GIF", 3) != 0)
+        return 0;
+
+    size_t pos = kHeaderBytes + ColorTableBytes(data[10]);
+    size_t frames = 0;
+
+    while (pos < length)
+    {
+        switch (data[pos++])
+        {
+            case kTrailer:
+                return frames;
+
+            case kExtensionIntroducer:
+                pos++;                                  // Extension label
+                if (!SkipSubBlocks(data, length, pos))
+                    return 0;
+                break;
+
+            case kImageSeparator:
+                if (pos + kImageDescriptorBytes >= length)
+                    return 0;
+                pos += kImageDescriptorBytes + ColorTableBytes(data[pos + 8]);
+                pos++;                                  // LZW minimum code size
+                if (!SkipSubBlocks(data, length, pos))
+                    return 0;
+                frames++;
+                break;
+
+            default:
+                // Some encoders leave junk after the last image; anything
+                // before it still plays
+                return frames;
+        }
+    }
+
+    return frames;
+}
+
+void GIFFrameCache::Plot(int x, int y, const CRGB& color)
+{
+    if (x < 0 || y < 0 || x >= _width || y >= _height || _canvas.empty())
+        return;
+
+    const size_t index = size_t(y) * _width + x;
+    _canvas[index] = color;
+    _plotted[index] = 1;
+}
+
+// NoteClear
+//
+// The decoder cleared the screen, so whatever was plotted so far this
+// frame is gone and playback must clear too before drawing it
+
+void GIFFrameCache::NoteClear()
+{
+    std::fill(_plotted.begin(), _plotted.end(), 0);
+    _clearPending = true;
+}
+
+void GIFFrameCache::AppendRun(bool skip, uint8_t length, uint8_t paletteIndex)
+{
+    if (skip)
+    {
+        _runs.push_back(kSkipRun | length);
+    }
+    else
+    {
+        _runs.push_back(length);
+        _runs.push_back(paletteIndex);
+    }
+}
+
+// EndFrame
+//
+// Starts a new palette when this frame's new colors won't fit in the
+// current one, then writes the frame out as skip and fill runs, row by row.
+
+bool GIFFrameCache::EndFrame()
+{
+    if (_overflowed || _canvas.empty())
+        return false;
+
+    const size_t pixelCount = _canvas.size();
+
+    size_t newColors = 0;
+    {
+        std::unordered_set<uint32_t> unseen;
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            const uint32_t key = ColorKey(_canvas[i]);
+            if (_plotted[i] && _paletteLookup.count(key) == 0 && unseen.insert(key).second)
+                newColors++;
+        }
+    }
+
+    if (newColors > kMaxPaletteSize)
+    {
+        _overflowed = true;
+        return false;
+    }
+
+    if (_paletteLookup.size() + newColors > kMaxPaletteSize)
+    {
+        _paletteLookup.clear();
+        _paletteOffset = _colors.size();
+    }
+
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        if (!_plotted[i])
+            continue;
+
+        const uint32_t key = ColorKey(_canvas[i]);
+        if (_paletteLookup.emplace(key, static_cast<uint8_t>(_colors.size() - _paletteOffset)).second)
+            _colors.push_back(_canvas[i]);
+    }
+
+    _frames.push_back({ static_cast<uint32_t>(_runs.size()), _paletteOffset, _clearPending });
+
+    for (uint16_t y = 0; y < _height; ++y)
+    {
+        const size_t rowStart = size_t(y) * _width;
+        uint16_t x = 0;
+
+        while (x < _width)
+        {
+            const size_t first = rowStart + x;
+            const bool skip = !_plotted[first];
+            const uint32_t key = ColorKey(_canvas[first]);
+
+            uint8_t length = 1;
+            while (x + length < _width && length < kMaxRunLength)
+            {
+                const size_t next = first + length;
+                if (skip ? _plotted[next] != 0 : (!_plotted[next] || ColorKey(_canvas[next]) != key))
+                    break;
+                length++;
+            }
+
+            AppendRun(skip, length, skip ? 0 : _paletteLookup[key]);
+            x += length;
+        }
+    }
+
+    std::fill(_plotted.begin(), _plotted.end(), 0);
+    _clearPending = false;
+
+    if (Bytes() > _maxBytes)
+        _overflowed = true;
+
+    return !_overflowed;
+}
+
+void GIFFrameCache::FinishCapture()
+{
+    decltype(_canvas)().swap(_canvas);
+    decltype(_plotted)().swap(_plotted);
+    decltype(_paletteLookup)().swap(_paletteLookup);
+
+    _frames.shrink_to_fit();
+    _runs.shrink_to_fit();
+    _colors.shrink_to_fit();
+}
+
+size_t GIFFrameCache::Bytes() const
+{
+    return _runs.size() + _colors.size() * sizeof(CRGB) + _frames.size() * sizeof(Frame);
+}
+
+bool GIFFrameCache::IsRowContiguous(const GFXBase& g, int offsetX, int offsetY) const
+{
+    if (offsetX < 0 || offsetY < 0 || offsetX + _width > int(g.GetMatrixWidth()) || offsetY + _height > int(g.GetMatrixHeight()))
+        return false;
+
+    for (uint16_t y = 0; y < _height; ++y)
+    {
+        const size_t rowStart = g.xy(offsetX, offsetY + y);
+        for (uint16_t x = 1; x < _width; ++x)
+            if (g.xy(offsetX + x, offsetY + y) != rowStart + x)
+                return false;
+    }
+    return true;
+}
+
+// DrawFrame
+//
+// Replays one frame the way the decoder drew it: clear if it cleared, then
+// fill the plotted runs and leave skipped pixels holding the previous frame.
+
+void GIFFrameCache::DrawFrame(size_t index, GFXBase& g, int offsetX, int offsetY, const CRGB& bkColor, bool rowContiguous) const
+{
+    if (index >= _frames.size())
+        return;
+
+    const Frame& frame = _frames[index];
+    if (frame.clearFirst)
+        g.Clear(bkColor);
+
+    const CRGB* palette = _colors.data() + frame.paletteOffset;
+    const uint8_t* run = _runs.data() + frame.runOffset;
+
+    for (uint16_t y = 0; y < _height; ++y)
+    {
+        CRGB* row = rowContiguous ? g.leds + g.xy(offsetX, offsetY + y) : nullptr;
+        uint16_t x = 0;
+
+        while (x < _width)
+        {
+            const uint8_t code = *run++;
+            const uint8_t length = code & kMaxRunLength;
+
+            if (code & kSkipRun)
+            {
+                x += length;
+                continue;
+            }
+
+            const CRGB color = palette[*run++];
+            if (row)
+            {
+                fill_solid(row + x, length, color);
+            }
+            else
+            {
+                for (uint8_t i = 0; i < length; ++i)
+                    g.leds[g.xy(offsetX + x + i, offsetY + y)] = color;
+            }
+            x += length;
+        }
+    }
+}
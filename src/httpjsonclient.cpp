@@ -0,0 +1,111 @@
+//+--------------------------------------------------------------------------
+//
+// File:        httpjsonclient.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Streaming, conditional JSON GET; see httpjsonclient.h.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#if ENABLE_WIFI
+
+#include <HTTPClient.h>
+#include <iterator>
+
+#include "httpjsonclient.h"
+
+// FetchJson
+//
+// HTTP/1.0 is requested so the server can't answer with a chunked body,
+// which deserializeJson can't read from the raw stream.
+
+HttpFetchResult FetchJson(const String& url, JsonDocument& doc, const JsonDocument* pFilter, HttpValidators* pValidators, const HttpHeaders& headers)
+{
+    static const char* kCollectedHeaders[] = { "ETag", "Last-Modified" };
+
+    HTTPClient http;
+    http.setConnectTimeout(HTTP_FETCH_TIMEOUT_MS);
+    http.setTimeout(HTTP_FETCH_TIMEOUT_MS);
+    http.useHTTP10(true);
+
+    if (!http.begin(url))
+    {
+        debugE("Unable to start request for %s", url.c_str());
+        return HttpFetchResult::Failed;
+    }
+
+    for (const auto& [name, value] : headers)
+        http.addHeader(name, value);
+
+    if (pValidators)
+    {
+        if (pValidators->url != url)
+            *pValidators = HttpValidators{ url };
+
+        if (!pValidators->etag.isEmpty())
+            http.addHeader("If-None-Match", pValidators->etag);
+        if (!pValidators->lastModified.isEmpty())
+            http.addHeader("If-Modified-Since", pValidators->lastModified);
+
+        http.collectHeaders(kCollectedHeaders, std::size(kCollectedHeaders));
+    }
+
+    const int httpCode = http.GET();
+
+    if (httpCode == HTTP_CODE_NOT_MODIFIED)
+    {
+        debugV("Not modified: %s", url.c_str());
+        http.end();
+        return HttpFetchResult::NotModified;
+    }
+
+    if (httpCode != HTTP_CODE_OK)
+    {
+        debugW("GET %s failed: %s", url.c_str(), httpCode < 0 ? http.errorToString(httpCode).c_str() : String(httpCode).c_str());
+        http.end();
+        return HttpFetchResult::Failed;
+    }
+
+    DeserializationError error = pFilter
+        ? deserializeJson(doc, http.getStream(), DeserializationOption::Filter(*pFilter))
+        : deserializeJson(doc, http.getStream());
+
+    if (error)
+    {
+        debugW("Failed to parse JSON from %s: %s", url.c_str(), error.c_str());
+        http.end();
+        return HttpFetchResult::Failed;
+    }
+
+    if (pValidators)
+    {
+        pValidators->etag = http.header("ETag");
+        pValidators->lastModified = http.header("Last-Modified");
+    }
+
+    http.end();
+    return HttpFetchResult::Ok;
+}
+
+#endif // ENABLE_WIFI
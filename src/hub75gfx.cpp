@@ -38,6 +38,7 @@
 #include "effectmanager.h"
 #include "hub75gfx.h"
 #include "ledstripeffect.h"
+#include "powermodel.h"
 #include "soundanalyzer.h"
 #include "systemcontainer.h"
 #include "values.h"
@@ -48,8 +49,51 @@ SMLayerBackground<HUB75GFX::SM_RGB, HUB75GFX::kBackgroundLayerOptions> HUB75GFX:
 SMLayerBackground<HUB75GFX::SM_RGB, HUB75GFX::kBackgroundLayerOptions> HUB75GFX::titleLayer(kMatrixWidth, kMatrixHeight);
 SmartMatrixHub75Calc<COLOR_DEPTH, HUB75GFX::kMatrixWidth, HUB75GFX::kMatrixHeight, HUB75GFX::kPanelType, HUB75GFX::kMatrixOptions> HUB75GFX::matrix;
 
+std::shared_ptr<const TextStrip> HUB75GFX::captionStrip;
+String HUB75GFX::captionStripText;
+
+#if HUB75_SHADOW_FRAMEBUFFER
+    std::unique_ptr<CRGB[]> HUB75GFX::shadowBuffer;
+    int HUB75GFX::captionTop = 0;
+    int HUB75GFX::captionLeft = 0;
+    uint8_t HUB75GFX::captionBrightness = 0;
+#endif
+
 namespace
 {
+    const rgb24 kCaptionChromaKey = rgb24(255, 0, 255);
+    constexpr int kCaptionCharWidth = 6;
+    constexpr int kCaptionCharHeight = 10;
+    constexpr int kCaptionBandHeight = kCaptionCharHeight + 1;
+    const CRGB kCaptionTextColor = CRGB(255, 255, 255);
+    const CRGB kCaptionShadowColor = CRGB(0, 0, 0);
+
+    bool IsCaptionChromaKey(const HUB75GFX::SM_RGB& pixel)
+    {
+        return pixel.red == kCaptionChromaKey.red && pixel.green == kCaptionChromaKey.green && pixel.blue == kCaptionChromaKey.blue;
+    }
+
+    // Swap timings are smoothed over roughly the last sixteen frames
+    void NoteSwapTiming(uint32_t waitMicros, uint32_t copyMicros)
+    {
+        g_Values.MatrixSwapWaitMicros = (g_Values.MatrixSwapWaitMicros * 15 + waitMicros) / 16;
+        g_Values.MatrixSwapCopyMicros = (g_Values.MatrixSwapCopyMicros * 15 + copyMicros) / 16;
+    }
+
+    void DrawStatusOverlay()
+    {
+        #if SHOW_FPS_ON_MATRIX
+            // Display status on bottom of matrix in format FPS: 00 CPU0: 000 CPU1: 000 Aud: 00
+            auto& backgroundLayer = HUB75GFX::backgroundLayer;
+            backgroundLayer.setFont(font3x5);
+            auto& taskManager = g_ptrSystem->GetTaskManager();
+            String output = "LED: " + String(g_Values.FPS) + " AUD: " + String(g_Analyzer.AudioFPS());
+            backgroundLayer.drawString(2, MATRIX_HEIGHT  - 12, rgb24(255, 255, 255), rgb24(0, 0, 0), output.c_str());
+            output = "CP0: " + String((int)taskManager.GetCPUUsagePercent(0)) + " CP1: " + String((int)taskManager.GetCPUUsagePercent(1));
+            backgroundLayer.drawString(2, MATRIX_HEIGHT  - 6, rgb24(255, 255, 255), rgb24(0, 0, 0), output.c_str());
+        #endif
+    }
+
     template <typename Layer>
     bool WaitForLayerSwap(Layer& layer, const char* layerName, uint32_t timeoutMs)
     {
@@ -94,8 +138,16 @@ void HUB75GFX::InitializeHardware(std::vector<std::shared_ptr<GFXBase>>& devices
     titleLayer.enableColorCorrection(false);
     backgroundLayer.enableColorCorrection(true);
 
+    #if HUB75_SHADOW_FRAMEBUFFER
+        // Effects hit this on every pixel they touch, so it comes from the default heap, not PSRAM.  The title
+        // layer is never shown; its drawing buffer is only where the caption gets rendered for compositing.
+        shadowBuffer = std::make_unique<CRGB[]>(NUM_LEDS);
+        titleLayer.enableChromaKey(false);
+        titleLayer.setBrightness(0);
+    #endif
+
     // Starting an effect might need to draw, so we need to set the leds up before doing so
-    static_cast<HUB75GFX&>(*devices[0]).setLeds(GetMatrixBackBuffer());
+    static_cast<HUB75GFX&>(*devices[0]).setLeds(GetDrawingBuffer());
 }
 
 void HUB75GFX::SetBrightness(byte amount)
@@ -105,24 +157,22 @@ void HUB75GFX::SetBrightness(byte amount)
 
 // EstimatePowerDraw
 //
-// Estimate the total power load for the board and matrix by walking the pixels and adding our previously measured
-// power draw per pixel based on what color and brightness each pixel is
+// Estimate the total power load for the board and matrix from the calibrated power model. The default model is
+// linear, so this is one pass of SumChannels() over the back buffer - or none, if the effect reported its sums.
 
-int HUB75GFX::EstimatePowerDraw()
+int HUB75GFX::EstimatePowerDraw(ChannelSums* sumsOut)
 {
-    constexpr auto kBaseLoad       = 1500;          // Experimentally derived values
-    constexpr auto mwPerPixelRed   = 4.10f;
-    constexpr auto mwPerPixelGreen = 0.82f;
-    constexpr auto mwPerPixelBlue  = 1.75f;
+    const auto model = PowerModel::Current();
 
-    float totalPower = kBaseLoad;
-    for (int i = 0; i < NUM_LEDS; i++)
-    {
-        const auto pixel = leds[i];
-        totalPower += pixel.r * mwPerPixelRed   / 255.0f;
-        totalPower += pixel.g * mwPerPixelGreen / 255.0f;
-        totalPower += pixel.b * mwPerPixelBlue  / 255.0f;
-    }
+    const ChannelSums* known = GetFrameChannelSums();
+    if (known && known->count != NUM_LEDS)
+        known = nullptr;
+
+    ChannelSums sums;
+    const uint32_t totalPower = model->BaseMw() + model->EstimateMw(leds, NUM_LEDS, known, sums);
+
+    if (sumsOut)
+        *sumsOut = sums;
     return (int) totalPower;
 }
 
@@ -148,6 +198,14 @@ void HUB75GFX::Clear(CRGB color)
     //     before them on the next buffer swap.  So we clear the backbuffer and then the leds, which point to
     //     the current front buffer.  TLDR:  We clear both the front and back buffers to avoid flicker between effects.
 
+    //     With a shadow framebuffer, effects never see the back buffer and it is rebuilt from leds at every swap,
+    //     so leds is the only buffer to clear.
+
+    #if HUB75_SHADOW_FRAMEBUFFER
+        fill_solid(leds, _ledcount, color);
+        return;
+    #endif
+
     if (color.g == color.r && color.r == color.b)
     {
         memset((void *) leds, color.r, sizeof(CRGB) * _ledcount);
@@ -276,7 +334,7 @@ void HUB75GFX::PrepareFrame()
         matrix.setRefreshRate(MATRIX_REFRESH_RATE);
 
         auto& pMatrix = static_cast<HUB75GFX&>(graphics);
-        pMatrix.setLeds(GetMatrixBackBuffer());
+        pMatrix.setLeds(GetDrawingBuffer());
 
         // We set ourselves to the lower of the fader value or the brightness value,
         // so that we can fade between effects without having to change the brightness
@@ -285,68 +343,131 @@ void HUB75GFX::PrepareFrame()
         auto& effectManager = g_ptrSystem->GetEffectManager();
         if (effectManager.HasCurrentEffect() && effectManager.GetCurrentEffect().ShouldShowTitle() && pMatrix.GetCaptionTransparency() > 0.00)
         {
-            titleLayer.setFont(font3x5);
             uint8_t brite = (uint8_t)(pMatrix.GetCaptionTransparency() * 255.0);
             debugV("Caption: %d", brite);
 
-            rgb24 chromaKeyColor = rgb24(255, 0, 255);
-            rgb24 shadowColor = rgb24(0, 0, 0);
-            rgb24 titleColor = rgb24(255, 255, 255);
+            int y = pMatrix.DrawCaption();
+
+            #if HUB75_SHADOW_FRAMEBUFFER
+                // Blended into the panel's buffer at swap time rather than shown as a layer of its own
+                captionTop = y;
+                captionBrightness = brite;
+            #else
+                // We enable the chromakey overlay just for the strip of screen where it appears.  This support is only
+                // present in the private fork of SmartMatrix that is linked to the mesmerizer project.
+
+                if (WaitForLayerSwap(titleLayer, "title", 100))
+                    titleLayer.swapBuffers(false);
+                titleLayer.enableChromaKey(true, y, y + kCaptionCharHeight);
+                titleLayer.setBrightness(brite); // 255 would obscure it entirely
+            #endif
+        }
+        else
+        {
+            #if HUB75_SHADOW_FRAMEBUFFER
+                captionBrightness = 0;
+            #else
+                titleLayer.enableChromaKey(false);
+                titleLayer.setBrightness(0);
+            #endif
+        }
+    }
+}
 
-            titleLayer.setChromaKeyColor(chromaKeyColor);
-            titleLayer.setFont(font6x10);
+int HUB75GFX::DrawCaption()
+{
+    titleLayer.setChromaKeyColor(kCaptionChromaKey);
 
-            const size_t kCharWidth = 6;
-            const size_t kCharHeight = 10;
+    const auto caption = GetCaption();
 
-            const auto caption = pMatrix.GetCaption();
+    int y = MATRIX_HEIGHT - 2 - kCaptionCharHeight;
+    int w = caption.length() * kCaptionCharWidth;
 
-            int y = MATRIX_HEIGHT - 2 - kCharHeight;
-            int w = caption.length() * kCharWidth;
+    unsigned long elapsed = millis() - captionStartTime;
 
-            unsigned long elapsed = millis() - captionStartTime;
+    int x;
+    if (w > MATRIX_WIDTH)
+    {
+        // Scroll if too wide to fit
+        float progress = (float)elapsed / totalCaptionDuration;
+        x = MATRIX_WIDTH - (int)(progress * (w + MATRIX_WIDTH));
+    }
 
-            int x;
-            if (w > MATRIX_WIDTH)
-            {
-                // Scroll if too wide to fit
-                float progress = (float)elapsed / totalCaptionDuration;
-                x = MATRIX_WIDTH - (int)(progress * (w + MATRIX_WIDTH));
-            }
+    else
+    {
+        // Center if it fits
+        x = (MATRIX_WIDTH / 2) - (w / 2) + 1;
+    }
 
-            else
-            {
-                // Center if it fits
-                x = (MATRIX_WIDTH / 2) - (w / 2) + 1;
-            }
+    if (!captionStrip || caption != captionStripText)
+    {
+        captionStrip = RasterizeCaption(caption, y);
+        captionStripText = caption;
+    }
 
-            // Generic fill that's way faster than the rectangle base impl
-            for (int i = y * _width; i < (y + 1 + kCharHeight) * _width; ++i)
-                titleLayer.backBuffer()[i] = chromaKeyColor;
+    #if HUB75_SHADOW_FRAMEBUFFER
+        // ComposeToBackBuffer() blends the strip in at swap time
+        captionLeft = x + captionStrip->OriginX();
+    #else
+        // Generic fill that's way faster than the rectangle base impl
+        auto band = titleLayer.backBuffer() + y * _width;
+        std::fill(band, band + kCaptionBandHeight * _width, kCaptionChromaKey);
 
-            auto szCaption = caption.c_str();
-            titleLayer.drawString(x - 1, y, shadowColor, szCaption);
-            titleLayer.drawString(x + 1, y, shadowColor, szCaption);
-            titleLayer.drawString(x, y - 1, shadowColor, szCaption);
-            titleLayer.drawString(x, y + 1, shadowColor, szCaption);
-            titleLayer.drawString(x, y, titleColor, szCaption);
+        for (int row = 0; row < kCaptionBandHeight; ++row)
+            captionStrip->DrawRow(row, (CRGB *)(band + row * _width), _width, x + captionStrip->OriginX(), kCaptionTextColor, kCaptionShadowColor, 255);
+    #endif
 
-            // We enable the chromakey overlay just for the strip of screen where it appears.  This support is only
-            // present in the private fork of SmartMatrix that is linked to the mesmerizer project.
+    return y;
+}
 
-            if (WaitForLayerSwap(titleLayer, "title", 100))
-                titleLayer.swapBuffers(false);
-            titleLayer.enableChromaKey(true, y, y + kCharHeight);
-            titleLayer.setBrightness(brite); // 255 would obscure it entirely
-        }
-        else
-        {
-            titleLayer.enableChromaKey(false);
-            titleLayer.setBrightness(0);
-        }
+// RasterizeCaption
+//
+// SmartMatrix only draws its bitmap fonts into a layer, so the caption is captured a matrix-width slice at a time:
+// each slice fills the caption band of the title layer's drawing buffer with the chroma key, draws the shadowed
+// caption shifted left by the slice's offset, and reads back which pixels became shadow and which became text.
+// The strip starts a column left of the text to hold its shadow.
 
+std::shared_ptr<const TextStrip> HUB75GFX::RasterizeCaption(const String& caption, int top)
+{
+    const rgb24 shadowColor = rgb24(0, 0, 0);
+    const rgb24 titleColor = rgb24(255, 255, 255);
+
+    const int textWidth = caption.length() * kCaptionCharWidth;
+    auto strip = std::make_shared<TextStrip>(textWidth + 2, kCaptionBandHeight, -1, 0);
+    strip->SetInkBounds(0, 0, textWidth, kCaptionCharHeight);
+
+    titleLayer.setFont(font6x10);
+
+    auto band = titleLayer.backBuffer() + top * MATRIX_WIDTH;
+    auto szCaption = caption.c_str();
+
+    for (int sliceLeft = 0; sliceLeft < strip->Width(); sliceLeft += MATRIX_WIDTH)
+    {
+        std::fill(band, band + kCaptionBandHeight * MATRIX_WIDTH, kCaptionChromaKey);
 
+        const int x = 1 - sliceLeft;
+        titleLayer.drawString(x - 1, top, shadowColor, szCaption);
+        titleLayer.drawString(x + 1, top, shadowColor, szCaption);
+        titleLayer.drawString(x, top - 1, shadowColor, szCaption);
+        titleLayer.drawString(x, top + 1, shadowColor, szCaption);
+        titleLayer.drawString(x, top, titleColor, szCaption);
+
+        const int sliceWidth = std::min<int>(MATRIX_WIDTH, strip->Width() - sliceLeft);
+        for (int row = 0; row < kCaptionBandHeight; ++row)
+        {
+            for (int column = 0; column < sliceWidth; ++column)
+            {
+                const SM_RGB& pixel = band[row * MATRIX_WIDTH + column];
+                if (IsCaptionChromaKey(pixel))
+                    continue;
+
+                const bool isShadow = pixel.red == shadowColor.red && pixel.green == shadowColor.green && pixel.blue == shadowColor.blue;
+                strip->Set(sliceLeft + column, row, isShadow ? TextStrip::kEdge : TextStrip::kInk);
+            }
+        }
     }
+
+    return strip;
 }
 
 // PostProcessFrame
@@ -362,7 +483,8 @@ void HUB75GFX::PostProcessFrame(uint16_t localPixelsDrawn, uint16_t wifiPixelsDr
     auto& pMatrix = static_cast<HUB75GFX&>(g_ptrSystem->GetEffectManager().g());
 
     constexpr auto kCaptionPower = 500;                                                 // A guess as the power the caption will consume
-    g_Values.MatrixPowerMilliwatts = pMatrix.EstimatePowerDraw();                             // What our drawn pixels will consume
+    ChannelSums frameSums;
+    g_Values.MatrixPowerMilliwatts = pMatrix.EstimatePowerDraw(&frameSums);                   // What our drawn pixels will consume
 
     if (pMatrix.GetCaptionTransparency() > 0)
         g_Values.MatrixPowerMilliwatts += kCaptionPower;
@@ -389,15 +511,14 @@ void HUB75GFX::PostProcessFrame(uint16_t localPixelsDrawn, uint16_t wifiPixelsDr
     debugV("MW: %lu, Setting Scaled Brightness to: %lu", (unsigned long)g_Values.MatrixPowerMilliwatts, (unsigned long)targetBrightness);
     pMatrix.SetBrightness(targetBrightness);
 
-    #if SHOW_FPS_ON_MATRIX
-        // Display status on bottom of matrix in format FPS: 00 CPU0: 000 CPU1: 000 Aud: 00
-        backgroundLayer.setFont(font3x5);
-        auto& taskManager = g_ptrSystem->GetTaskManager();
-        String output = "LED: " + String(g_Values.FPS) + " AUD: " + String(g_Analyzer.AudioFPS());
-        backgroundLayer.drawString(2, MATRIX_HEIGHT  - 12, rgb24(255, 255, 255), rgb24(0, 0, 0), output.c_str());
-        output = "CP0: " + String((int)taskManager.GetCPUUsagePercent(0)) + " CP1: " + String((int)taskManager.GetCPUUsagePercent(1));
-        backgroundLayer.drawString(2, MATRIX_HEIGHT  - 6, rgb24(255, 255, 255), rgb24(0, 0, 0), output.c_str());
-    #endif
+    if (PowerCalibration::IsActive())
+    {
+        // Report what the panel is actually being driven with, not the full-brightness frame
+        frameSums.red   = frameSums.red   * targetBrightness / 255;
+        frameSums.green = frameSums.green * targetBrightness / 255;
+        frameSums.blue  = frameSums.blue  * targetBrightness / 255;
+        PowerCalibration::NoteFrame(frameSums, g_Values.MatrixPowerMilliwatts * targetBrightness / 255);
+    }
 
     auto& effectManager = g_ptrSystem->GetEffectManager();
     const bool effectRequiresDoubleBuffering = effectManager.HasCurrentEffect() && effectManager.GetCurrentEffect().RequiresDoubleBuffering();
@@ -414,6 +535,43 @@ CRGB *HUB75GFX::GetMatrixBackBuffer()
     return (CRGB *)backgroundLayer.backBuffer();
 }
 
+CRGB *HUB75GFX::GetDrawingBuffer()
+{
+    #if HUB75_SHADOW_FRAMEBUFFER
+        for (auto& device : g_ptrSystem->GetDevices())
+            device->UpdatePaletteCycle();
+
+        return shadowBuffer.get();
+    #else
+        return GetMatrixBackBuffer();
+    #endif
+}
+
+#if HUB75_SHADOW_FRAMEBUFFER
+
+// ComposeToBackBuffer
+//
+// The panel and shadow buffers share a layout, so this is a straight copy, after which the caption strip is
+// blended into its band at the caption's brightness, the way the chroma-keyed title layer used to overlay it.
+
+void HUB75GFX::ComposeToBackBuffer()
+{
+    CRGB* dest = (CRGB *)backgroundLayer.backBuffer();
+    memcpy(dest, shadowBuffer.get(), sizeof(CRGB) * NUM_LEDS);
+
+    if (captionBrightness == 0 || !captionStrip)
+        return;
+
+    const int firstRow = std::max(captionTop, 0);
+    const int lastRow = std::min(captionTop + kCaptionBandHeight, (int)MATRIX_HEIGHT);
+
+    for (int y = firstRow; y < lastRow; ++y)
+        captionStrip->DrawRow(y - captionTop, dest + y * MATRIX_WIDTH, MATRIX_WIDTH, captionLeft,
+                              kCaptionTextColor, kCaptionShadowColor, captionBrightness);
+}
+
+#endif
+
 void HUB75GFX::MatrixSwapBuffers(bool bSwapBackground)
 {
     // If an effect redraws itself entirely ever frame, it can skip saving the most recent buffer, so
@@ -422,13 +580,45 @@ void HUB75GFX::MatrixSwapBuffers(bool bSwapBackground)
     matrix.setRefreshRate(MATRIX_REFRESH_RATE);
     matrix.setMaxCalculationCpuPercentage(95);
 
+    const uint32_t waitStart = micros();
+
     if (!WaitForMatrixSwap())
         return;
 
-    backgroundLayer.swapBuffers(false);
+    #if HUB75_SHADOW_FRAMEBUFFER
+
+        // The shadow buffer already holds this frame's history, so whatever bSwapBackground asks for, it's one
+        // wait for the back buffer to come free and one pass to fill it
 
-    if (bSwapBackground && WaitForMatrixSwap())
-        backgroundLayer.copyRefreshToDrawing();
+        const uint32_t copyStart = micros();
+        ComposeToBackBuffer();
+        DrawStatusOverlay();
+        backgroundLayer.swapBuffers(false);
+        NoteSwapTiming(copyStart - waitStart, micros() - copyStart);
+
+    #else
+
+        DrawStatusOverlay();
+        backgroundLayer.swapBuffers(false);
+
+        uint32_t waitMicros = micros() - waitStart;
+        uint32_t copyMicros = 0;
+
+        if (bSwapBackground)
+        {
+            const uint32_t secondWaitStart = micros();
+            if (WaitForMatrixSwap())
+            {
+                const uint32_t copyStart = micros();
+                backgroundLayer.copyRefreshToDrawing();
+                copyMicros = micros() - copyStart;
+                waitMicros += copyStart - secondWaitStart;
+            }
+        }
+
+        NoteSwapTiming(waitMicros, copyMicros);
+
+    #endif
 }
 
 bool HUB75GFX::WaitForMatrixSwap(uint32_t timeoutMs)
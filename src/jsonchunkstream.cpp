@@ -0,0 +1,135 @@
+//+--------------------------------------------------------------------------
+//
+// File:        jsonchunkstream.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Chunked JSON response writer; see jsonchunkstream.h.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#if ENABLE_WEBSERVER
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "jsonchunkstream.h"
+
+// BeginResponse
+//
+// The filler lambda owns the stream through a shared_ptr, so the snapshot
+// captured by the generator is released when AsyncWebServer frees the
+// response - at the end of the body or when the client goes away.
+
+AsyncWebServerResponse * JsonChunkStream::BeginResponse(AsyncWebServerRequest * pRequest, Generator generator)
+{
+    auto stream = std::make_shared<JsonChunkStream>(std::move(generator));
+
+    return pRequest->beginChunkedResponse("application/json", [stream](uint8_t * buffer, size_t maxLen, size_t) -> size_t
+    {
+        return stream->Fill(buffer, maxLen);
+    });
+}
+
+void JsonChunkStream::AppendKey(String& out, const char* key)
+{
+    out += '"';
+    out += key;
+    out += "\":";
+}
+
+namespace
+{
+    // serializeJson replaces a String's contents, which would take the framing
+    // already in out with it, so values are serialized on their own first -
+    // which is also what lets a failed one be left out cleanly
+
+    bool SerializeFragment(const JsonDocument& value, String& serialized)
+    {
+        return !value.overflowed() && serializeJson(value, serialized) != 0;
+    }
+}
+
+bool JsonChunkStream::AppendElement(String& out, bool& first, const JsonDocument& value)
+{
+    String serialized;
+    if (!SerializeFragment(value, serialized))
+        return false;
+
+    if (!first)
+        out += ',';
+    first = false;
+    out += serialized;
+    return true;
+}
+
+bool JsonChunkStream::AppendMember(String& out, bool& first, const char* key, const JsonDocument& value)
+{
+    String serialized;
+    if (!SerializeFragment(value, serialized))
+        return false;
+
+    if (!first)
+        out += ',';
+    first = false;
+    AppendKey(out, key);
+    out += serialized;
+    return true;
+}
+
+// Fill
+//
+// Copy up to maxLen bytes of body into buffer, pulling new fragments from
+// the generator whenever the pending one runs out. Returning 0 ends the
+// chunked response.
+
+size_t JsonChunkStream::Fill(uint8_t * buffer, size_t maxLen)
+{
+    size_t written = 0;
+
+    while (written < maxLen)
+    {
+        if (_pendingOffset >= _pending.length())
+        {
+            if (_finished)
+                break;
+
+            // Reuse the pending buffer's allocation for the next fragment
+            _pending.remove(0);
+            _pendingOffset = 0;
+            if (!_generator(_nextFragment++, _pending))
+                _finished = true;
+            continue;
+        }
+
+        const size_t count = std::min(maxLen - written, (size_t)_pending.length() - _pendingOffset);
+        memcpy(buffer + written, _pending.c_str() + _pendingOffset, count);
+        _pendingOffset += count;
+        written += count;
+    }
+
+    return written;
+}
+
+#endif // ENABLE_WEBSERVER
@@ -29,6 +29,7 @@
 
 #include "globals.h"
 
+#include <cstring>
 #include <esp_heap_caps.h>
 #include <FS.h>
 #include <functional>
@@ -301,85 +302,243 @@ bool BoolFromText(const String& text)
     return text == "true" || strtol(text.c_str(), nullptr, 10);
 }
 
-bool LoadJSONFile(const String & fileName, JsonDocument& jsonDoc)
+namespace
 {
-    bool jsonReadSuccessful = false;
+    // Binary storage header. A MessagePack file starts with these three
+    // bytes and a format version; anything else is read as text JSON, which
+    // is how files written by older builds are picked up and migrated.
 
-    File file = SPIFFS.open(fileName);
+    constexpr uint8_t kBinaryStorageMagic[] = { 'N', 'D', 'B' };
+    constexpr uint8_t kBinaryStorageVersion = 1;
+    constexpr size_t  kBinaryStorageHeaderSize = sizeof(kBinaryStorageMagic) + 1;
 
-    if (file)
+    enum class StorageFormat
     {
-        if (file.size() > 0)
+        Json,
+        MsgPack,
+        Unsupported
+    };
+
+    constexpr StorageFormat kConfiguredStorageFormat = JSON_STORAGE_MSGPACK ? StorageFormat::MsgPack : StorageFormat::Json;
+
+    // ReadStorageHeader
+    //
+    // Identify the format of an open file and leave it positioned at the
+    // start of the payload.
+
+    StorageFormat ReadStorageHeader(File& file)
+    {
+        uint8_t header[kBinaryStorageHeaderSize];
+
+        if (file.read(header, sizeof(header)) == sizeof(header)
+            && memcmp(header, kBinaryStorageMagic, sizeof(kBinaryStorageMagic)) == 0)
         {
-            debugI("Attempting to read JSON file %s", fileName.c_str());
+            return header[sizeof(kBinaryStorageMagic)] == kBinaryStorageVersion ? StorageFormat::MsgPack : StorageFormat::Unsupported;
+        }
 
-            DeserializationError error = deserializeJson(jsonDoc, file);
+        file.seek(0);
+        return StorageFormat::Json;
+    }
 
-            if (error == DeserializationError::NoMemory)
-            {
-                debugW("Out of memory reading JSON from file %s", fileName.c_str());
-            }
-            else if (error == DeserializationError::Ok)
-            {
-                jsonReadSuccessful = true;
-            }
-            else
-            {
-                debugW("Error with code %d occurred while deserializing JSON from file %s", to_value(error.code()), fileName.c_str());
-            }
+    // TempFileName
+    //
+    // SaveToJSONFile writes here first and renames over the real file, so a
+    // reset mid-write leaves either the old file or the complete new one.
+
+    String TempFileName(const String & fileName)
+    {
+        return fileName + ".tmp";
+    }
+
+    // WriteDocumentToFile
+    //
+    // Writes jsonDoc in the configured storage format, crash-safely: the
+    // document goes to a temp file that is only renamed over fileName once
+    // it has been written in full. SPIFFS can't rename onto an existing name,
+    // so the old file is removed just before the rename; LoadAndMigrateJSONFile
+    // finishes the job if we reset in between.
+
+    bool WriteDocumentToFile(const String & fileName, const JsonDocument& jsonDoc, size_t* pBytesWritten)
+    {
+        WaitForRenderSwapBeforeFilesystemWrite();
+        std::lock_guard filesystemGuard(JSONFilesystemWriteMutex());
+
+        const String tempFileName = TempFileName(fileName);
+        SPIFFS.remove(tempFileName);
+
+        File file = SPIFFS.open(tempFileName, FILE_WRITE);
+
+        if (!file)
+        {
+            debugE("Unable to open file %s to write JSON!", tempFileName.c_str());
+            return false;
         }
 
+        size_t expectedBytes;
+        size_t bytesWritten;
+
+        if (kConfiguredStorageFormat == StorageFormat::MsgPack)
+        {
+            expectedBytes = kBinaryStorageHeaderSize + measureMsgPack(jsonDoc);
+            bytesWritten = file.write(kBinaryStorageMagic, sizeof(kBinaryStorageMagic));
+            bytesWritten += file.write(kBinaryStorageVersion);
+            bytesWritten += serializeMsgPack(jsonDoc, file);
+        }
+        else
+        {
+            expectedBytes = measureJson(jsonDoc);
+            bytesWritten = serializeJson(jsonDoc, file);
+        }
+
+        file.flush();
         file.close();
-    }
 
-    return jsonReadSuccessful;
+        debugI("Number of bytes written to JSON file %s: %zu", fileName.c_str(), (size_t)bytesWritten);
+
+        if (bytesWritten == 0 || bytesWritten != expectedBytes)
+        {
+            debugE("Unable to write JSON to file %s!", fileName.c_str());
+            SPIFFS.remove(tempFileName);
+            return false;
+        }
+
+        SPIFFS.remove(fileName);
+        if (!SPIFFS.rename(tempFileName, fileName))
+        {
+            debugE("Unable to rename %s to %s!", tempFileName.c_str(), fileName.c_str());
+            return false;
+        }
+
+        if (pBytesWritten)
+            *pBytesWritten = bytesWritten;
+
+        return true;
+    }
 }
 
-bool SaveToJSONFile(const String & fileName, IJSONSerializable& object)
+namespace
 {
-    auto jsonDoc = CreateInternalJsonDocument();
-    auto jsonObject = jsonDoc.to<JsonObject>();
+    // ReadDocumentFromFile
+    //
+    // Reads fileName in whichever storage format it's in, and reports which
+    // that was. Never writes to flash.
 
-    if (!object.SerializeToJSON(jsonObject))
+    bool ReadDocumentFromFile(const String & fileName, JsonDocument& jsonDoc, StorageFormat& format)
     {
-        debugE("Could not serialize object to JSON, skipping write to %s!", fileName.c_str());
-        return false;
+        bool jsonReadSuccessful = false;
+        format = StorageFormat::Unsupported;
+
+        File file = SPIFFS.open(fileName);
+
+        if (file)
+        {
+            if (file.size() > 0)
+            {
+                debugI("Attempting to read JSON file %s", fileName.c_str());
+
+                format = ReadStorageHeader(file);
+
+                DeserializationError error = DeserializationError::InvalidInput;
+                if (format == StorageFormat::MsgPack)
+                    error = deserializeMsgPack(jsonDoc, file);
+                else if (format == StorageFormat::Json)
+                    error = deserializeJson(jsonDoc, file);
+                else
+                    debugW("File %s was stored in an unsupported format version", fileName.c_str());
+
+                if (error == DeserializationError::NoMemory)
+                {
+                    debugW("Out of memory reading JSON from file %s", fileName.c_str());
+                }
+                else if (error == DeserializationError::Ok)
+                {
+                    jsonReadSuccessful = true;
+                }
+                else
+                {
+                    debugW("Error with code %d occurred while deserializing JSON from file %s", to_value(error.code()), fileName.c_str());
+                }
+            }
+
+            file.close();
+        }
+
+        return jsonReadSuccessful;
     }
+}
 
-    if (jsonDoc.overflowed())
+bool LoadJSONFile(const String & fileName, JsonDocument& jsonDoc)
+{
+    StorageFormat format;
+    return ReadDocumentFromFile(fileName, jsonDoc, format);
+}
+
+// LoadAndMigrateJSONFile
+//
+// LoadJSONFile for the boot-time loaders, which are the only readers allowed
+// to write: it finishes an interrupted save, and rewrites a file found in the
+// other storage format (typically text JSON from before binary storage was
+// enabled) in the configured one.
+
+bool LoadAndMigrateJSONFile(const String & fileName, JsonDocument& jsonDoc)
+{
+    // A reset between removing the old file and renaming the new one into
+    // place leaves only the finished temp file; promote it.
+    const String tempFileName = TempFileName(fileName);
+    if (!SPIFFS.exists(fileName) && SPIFFS.exists(tempFileName))
     {
-        debugE("JSON document overflowed while preparing %s, skipping write!", fileName.c_str());
-        return false;
+        debugW("Recovering %s from %s", fileName.c_str(), tempFileName.c_str());
+        std::lock_guard filesystemGuard(JSONFilesystemWriteMutex());
+        SPIFFS.rename(tempFileName, fileName);
     }
 
-    WaitForRenderSwapBeforeFilesystemWrite();
-    std::lock_guard filesystemGuard(JSONFilesystemWriteMutex());
+    StorageFormat format;
+    if (!ReadDocumentFromFile(fileName, jsonDoc, format))
+        return false;
 
-    SPIFFS.remove(fileName);
+    if (format != kConfiguredStorageFormat)
+    {
+        debugI("Migrating %s to %s storage", fileName.c_str(), JSON_STORAGE_MSGPACK ? "MessagePack" : "JSON");
+        WriteDocumentToFile(fileName, jsonDoc, nullptr);
+    }
 
-    File file = SPIFFS.open(fileName, FILE_WRITE);
+    return true;
+}
 
+bool IsBinaryJSONFile(const String & fileName)
+{
+    File file = SPIFFS.open(fileName);
     if (!file)
-    {
-        debugE("Unable to open file %s to write JSON!", fileName.c_str());
         return false;
-    }
-
-    size_t bytesWritten = serializeJson(jsonDoc, file);
 
-    file.flush();
+    const bool binary = ReadStorageHeader(file) != StorageFormat::Json;
     file.close();
+    return binary;
+}
 
-    debugI("Number of bytes written to JSON file %s: %zu", fileName.c_str(), (size_t)bytesWritten);
+// SaveToJSONFile
+//
+// Serializes object and writes it in the configured storage format; see
+// WriteDocumentToFile for how a reset mid-write is survived.
 
-    if (bytesWritten == 0)
+bool SaveToJSONFile(const String & fileName, IJSONSerializable& object, size_t* pBytesWritten)
+{
+    auto jsonDoc = CreateInternalJsonDocument();
+    auto jsonObject = jsonDoc.to<JsonObject>();
+
+    if (!object.SerializeToJSON(jsonObject))
     {
-        debugE("Unable to write JSON to file %s!", fileName.c_str());
-        SPIFFS.remove(fileName);
+        debugE("Could not serialize object to JSON, skipping write to %s!", fileName.c_str());
         return false;
     }
 
-    return true;
+    if (jsonDoc.overflowed())
+    {
+        debugE("JSON document overflowed while preparing %s, skipping write!", fileName.c_str());
+        return false;
+    }
+
+    return WriteDocumentToFile(fileName, jsonDoc, pBytesWritten);
 }
 
 bool RemoveJSONFile(const String & fileName)
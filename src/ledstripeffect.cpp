@@ -35,10 +35,12 @@
 #include <cstdlib>
 #include <cstring>
 #include <iterator>
+#include <new>
 #include <stdexcept>
 
 #include "gfxbase.h"
 #include "jsonserializer.h"
+#include "pixelkernels.h"
 #include "random_utils.h"
 
 #if HEXAGON
@@ -348,8 +350,7 @@ void LEDStripEffect::fadePixelToBlackOnAllChannelsBy(int pixel, uint8_t fadeValu
 void LEDStripEffect::fadeAllChannelsToBlackBy(uint8_t fadeValue) const
 {
     for (auto& device : _GFX)
-        for (size_t i = 0; i < _cLEDs; ++i)
-            GFXBase::FadePixelInPlace(device->leds[i], fadeValue);
+        PixelKernels::ScaleSpan(device->leds, _cLEDs, 255 - fadeValue);
 }
 
 void LEDStripEffect::setAllOnAllChannels(uint8_t r, uint8_t g, uint8_t b) const
@@ -430,6 +431,72 @@ bool LEDStripEffect::IsCoreEffect() const { return _coreEffect; }
 
 bool LEDStripEffect::RequiresDoubleBuffering() const { return true; }
 
+uint8_t LEDStripEffect::QualityLevel() const
+{
+    return std::min<uint8_t>(_qualityLevel, QualityLevels() - 1);
+}
+
+void LEDStripEffect::SetQualityLevel(uint8_t level)
+{
+    level = std::min<uint8_t>(level, QualityLevels() - 1);
+    if (level == QualityLevel())
+        return;
+
+    _qualityLevel = level;
+    OnQualityLevelChanged(level);
+}
+
+bool LEDStripEffect::MarkConfigChanged(uint8_t changedInputs)
+{
+    if (!(ConfigDependencies() & changedInputs))
+        return false;
+
+    _initPending = true;
+    return true;
+}
+
+bool LEDStripEffect::InitTimed(std::vector<std::shared_ptr<GFXBase>>& gfx)
+{
+    std::lock_guard initGuard(_initMutex);
+    return InitTimedLocked(gfx);
+}
+
+bool LEDStripEffect::InitIfPending(std::vector<std::shared_ptr<GFXBase>>& gfx)
+{
+    std::lock_guard initGuard(_initMutex);
+    return _initPending ? InitTimedLocked(gfx) : !_initFailed;
+}
+
+// InitTimedLocked
+//
+// The pending flag is cleared before Init() rather than after, so a change flagged while it runs isn't lost.
+// A failed Init() isn't retried until the next change; it has been reported by then.  Many Init()s allocate
+// through make_unique_psram, which throws when memory runs out; this can run from loop() or the render task,
+// so that is caught here and treated as any other failure rather than left to abort the device.
+
+bool LEDStripEffect::InitTimedLocked(std::vector<std::shared_ptr<GFXBase>>& gfx)
+{
+    _initPending = false;
+
+    const uint32_t start = micros();
+    bool result = false;
+    try
+    {
+        result = Init(gfx);
+    }
+    catch (const std::bad_alloc&)
+    {
+        debugE("Out of memory initializing effect: %s", _friendlyName.c_str());
+    }
+    _lastInitMicros = micros() - start;
+    _initFailed = !result;
+
+    if (!result)
+        debugW("Could not initialize effect: %s", _friendlyName.c_str());
+
+    return result;
+}
+
 // Lazily loads the SettingsSpecs for this effect if they haven't been loaded yet, and
 // returns a vector with reference_wrappers to them.
 const std::vector<std::reference_wrapper<SettingSpec>>& LEDStripEffect::GetSettingSpecs()
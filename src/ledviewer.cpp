@@ -23,108 +23,273 @@
 //
 // Description:
 //
-//    LED viewer socket server implementation.
+//    LED viewer preview protocol, served by the SocketReactor.
 //
 
 #include "globals.h"
 #include "ledviewer.h"
 #include "nd_network.h"
+#include "systemcontainer.h"
 
+#if COLORDATA_WEB_SOCKET_ENABLED
+#include "websocketserver.h"
+#endif
+
+#include <algorithm>
 #include <arpa/inet.h>
 #include <cstring>
 #include <sys/socket.h>
-#include <sys/time.h>
 #include <unistd.h>
 
 LEDViewer::LEDViewer(int port) :
-    _port(port),
-    _server_fd(-1)
+    _port(port)
 {
-    memset(&_address, 0, sizeof(_address));
 }
 
 LEDViewer::~LEDViewer()
 {
-    release();
+    Detach();
 }
 
-void LEDViewer::release()
+bool LEDViewer::Attach(SocketReactor& reactor)
 {
-    if (_server_fd >= 0)
+    if (_attached)
+        return true;
+
+    _pReactor = &reactor;
+    g_ptrSystem->GetEffectManager().AddFrameEventListener(*this);
+
+    if (!reactor.Listen(_port, *this, 6))
     {
-        close(_server_fd);
-        _server_fd = -1;
+        g_ptrSystem->GetEffectManager().RemoveFrameEventListener(*this);
+        return false;
     }
+
+    _attached = true;
+    return true;
+}
+
+void LEDViewer::Detach()
+{
+    if (!_attached)
+        return;
+
+    _attached = false;
+    _pReactor->Unlisten(*this);
+    g_ptrSystem->GetEffectManager().RemoveFrameEventListener(*this);
 }
 
-bool LEDViewer::begin()
+// OnNewFrameAvailable
+//
+// Called on the render task, so it does no more than note the frame and,
+// if anyone is watching, nudge the reactor.
+
+void LEDViewer::OnNewFrameAvailable()
 {
-    // Creating socket file descriptor
+    _frameCounter.fetch_add(1);
+
+    if (_viewerCount.load() > 0)
+        _pReactor->Wake();
+}
 
-    if ((_server_fd = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+const LEDViewer::Viewer* LEDViewer::FindViewer(int fd) const
+{
+    auto it = std::find_if(_viewers.begin(), _viewers.end(), [fd](const Viewer& viewer) { return viewer.fd == fd; });
+    return it == _viewers.end() ? nullptr : &(*it);
+}
+
+bool LEDViewer::OnConnect(int fd, const sockaddr_in& peer)
+{
+    if (!_packet)
     {
-        debugE("Color data socket error\n");
-        release();
-        return false;
+        _packet = make_unique_psram<ColorDataPacket>();
+        _frame = make_unique_psram<CRGB[]>(NUM_LEDS);
+        if (!_packet || !_frame)
+        {
+            _packet.reset();
+            debugE("Unable to allocate color data packet");
+            return false;
+        }
     }
-    nd_network::SetSocketBlockingEnabled(_server_fd, false);
 
-    // When an error occurs and we close and reopen the port, we need to specify reuse flags
-    // or it might be too soon to use the port again, since close doesn't actually close it
-    // until the socket is no longer in use.
+    // Start the viewer off with the next frame drawn
+    std::lock_guard guard(_viewersMutex);
+    _viewers.push_back(Viewer{ fd, _frameCounter.load() });
+    _viewerCount.store(_viewers.size());
+    return true;
+}
 
-    int opt = 1;
-    if (setsockopt(_server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)))
+void LEDViewer::OnDisconnect(int fd)
+{
+    std::lock_guard guard(_viewersMutex);
+    _viewers.erase(std::remove_if(_viewers.begin(), _viewers.end(), [fd](const Viewer& viewer) { return viewer.fd == fd; }), _viewers.end());
+    _viewerCount.store(_viewers.size());
+}
+
+// AcceptRequestBytes
+//
+// Gathers a viewer's preview request, which may arrive in pieces.  Anything that doesn't line up with the
+// request magic is skipped, so a viewer that sends something else just keeps getting raw frames.
+
+void LEDViewer::AcceptRequestBytes(Viewer& viewer, const uint8_t* data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
     {
-        perror("setsockopt colordata");
-        release();
-        return false;
+        const uint8_t value = data[i];
+        if (viewer.requestBytes < sizeof(PreviewOptions::kRequestMagic) && value != PreviewOptions::kRequestMagic[viewer.requestBytes])
+        {
+            viewer.requestBytes = 0;
+            if (value != PreviewOptions::kRequestMagic[0])
+                continue;
+        }
+
+        viewer.request[viewer.requestBytes++] = value;
+        if (viewer.requestBytes < sizeof(viewer.request))
+            continue;
+
+        viewer.requestBytes = 0;
+
+        PreviewOptions options;
+        if (PreviewOptions::FromRequest(viewer.request, options))
+        {
+            std::lock_guard guard(_viewersMutex);
+            viewer.encoder.SetOptions(options);
+            viewer.negotiated = true;
+        }
     }
+}
+
+// OnReadable
+//
+// The only thing a viewer sends is a preview request, if even that; otherwise
+// all we expect to read is the end of the stream when it goes away.
 
-    memset(&_address, 0, sizeof(_address));
-    _address.sin_family = AF_INET;
-    _address.sin_addr.s_addr = INADDR_ANY;
-    _address.sin_port = htons(_port);
+bool LEDViewer::OnReadable(int fd)
+{
+    auto it = std::find_if(_viewers.begin(), _viewers.end(), [fd](const Viewer& viewer) { return viewer.fd == fd; });
 
-    if (bind(_server_fd, (struct sockaddr *)&_address, sizeof(_address)) < 0)       // Bind socket to port
+    uint8_t buffer[64];
+    while (true)
     {
-        perror("bind failed for color data\n");
-        release();
+        const auto cbRead = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (cbRead > 0)
+        {
+            if (it != _viewers.end())
+                AcceptRequestBytes(*it, buffer, cbRead);
+            continue;
+        }
+        if (cbRead < 0 && errno == EINTR)
+            continue;
+
+        return cbRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+}
+
+bool LEDViewer::WantsWrite(int fd) const
+{
+    const Viewer* pViewer = FindViewer(fd);
+    if (pViewer == nullptr || pViewer->frameSent == _frameCounter.load() || !pViewer->encoder.IsDue(millis()))
+        return false;
+
+    // Prefer the websocket preview transport used by the local UI. The raw TCP
+    // preview port remains available for external tools, but we do not drive
+    // both transports for the same frames.
+#if COLORDATA_WEB_SOCKET_ENABLED
+    if (g_ptrSystem->HasWebSocketServer() && g_ptrSystem->GetWebSocketServer().HaveColorDataClients())
+        return false;
+#endif
+
+    return true;
+}
+
+// CaptureFrame
+//
+// Copies the current LEDs into the shared packet, and row-major into the
+// frame the preview encoders work from, once per frame however many viewers
+// it goes to.
+
+bool LEDViewer::CaptureFrame()
+{
+    const uint32_t frame = _frameCounter.load();
+    if (_packetSize != 0 && _packetFrame == frame)
+        return true;
+
+    auto& graphics = g_ptrSystem->GetEffectManager().g();
+    if (graphics.leds == nullptr)
         return false;
+
+    const auto activeLEDCount = graphics.GetLEDCount();
+
+    _packet->header = COLOR_DATA_PACKET_HEADER;
+    _packet->width  = graphics.GetMatrixWidth();
+    _packet->height = graphics.GetMatrixHeight();
+    memcpy(_packet->colors, graphics.leds, sizeof(CRGB) * activeLEDCount);
+
+    _frameWidth  = graphics.GetMatrixWidth();
+    _frameHeight = graphics.GetMatrixHeight();
+    CopyRowMajor(graphics, _packet->colors, activeLEDCount, _frame.get());
+
+    _packetSize = sizeof(_packet->header) + sizeof(_packet->width) + sizeof(_packet->height) + sizeof(CRGB) * activeLEDCount;
+    _packetFrame = frame;
+    return true;
+}
+
+bool LEDViewer::OnWritable(int fd)
+{
+    auto it = std::find_if(_viewers.begin(), _viewers.end(), [fd](const Viewer& viewer) { return viewer.fd == fd; });
+    if (it == _viewers.end() || it->frameSent == _frameCounter.load() || !CaptureFrame())
+        return true;
+
+    // Either way this frame has been dealt with; if it would have blocked,
+    // the viewer just skips it and gets the next one
+    it->frameSent = _packetFrame;
+
+    const void* packet = _packet.get();
+    size_t packetSize = _packetSize;
+    if (it->negotiated)
+    {
+        it->encoder.Encode(_frame.get(), _frameWidth, _frameHeight, _encoded);
+        packet = _encoded.data();
+        packetSize = _encoded.size();
     }
-    if (listen(_server_fd, 6) < 0)                                                  // Start listening for connections
+
+    debugV("Sending color data packet");
+    const auto result = SendPacket(fd, packet, packetSize);
+    if (result == SendResult::Failed)
     {
-        perror("listen failed for color data\n");
-        release();
+        debugW("Error on color data socket, so closing");
         return false;
     }
+
+    std::lock_guard guard(_viewersMutex);
+    if (result == SendResult::Sent)
+        it->encoder.Commit(millis(), packetSize);
+    else
+        it->encoder.NoteDropped();
     return true;
 }
 
-int LEDViewer::CheckForConnection()
+void LEDViewer::CopyRowMajor(const GFXBase& graphics, const CRGB* leds, size_t count, CRGB* frame)
 {
-    int new_socket = -1;
-    // Accept a new incoming connection
-    int addrlen = sizeof(_address);
-    if ((new_socket = accept(_server_fd, (struct sockaddr *)&_address, (socklen_t*)&addrlen)) < 0)
-    {
-        if (errno == EAGAIN || errno == EWOULDBLOCK)
-            return -1;
-        debugE("Error accepting color data connection: %s", strerror(errno));
-        return -1;
-    }
+    const auto width  = graphics.GetMatrixWidth();
+    const auto height = graphics.GetMatrixHeight();
 
-    // Preview transport is strictly best-effort; keep the client socket non-blocking so
-    // a stalled viewer never back-pressures drawing or the WiFi servicing tasks.
-    if (!nd_network::SetSocketBlockingEnabled(new_socket, false))
+    for (size_t y = 0; y < height; y++)
     {
-        debugE("Unable to make color data client socket non-blocking!");
-        close(new_socket);
-        return -1;
+        for (size_t x = 0; x < width; x++)
+        {
+            const size_t index = graphics.xy(x, y);
+            *frame++ = index < count ? leds[index] : CRGB::Black;
+        }
     }
+}
+
+void LEDViewer::AppendPreviewClients(std::vector<PreviewClientReport>& reports) const
+{
+    std::lock_guard guard(_viewersMutex);
 
-    Serial.println("Accepted new ColorData Client!");
-    return new_socket;
+    for (const auto& viewer : _viewers)
+        reports.push_back({ "tcp", (uint32_t)viewer.fd, viewer.negotiated, viewer.encoder.Options(), viewer.encoder.Stats() });
 }
 
 LEDViewer::SendResult LEDViewer::SendPacket(int socket, const void * pData, size_t cbSize)
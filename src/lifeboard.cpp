@@ -0,0 +1,167 @@
+//+--------------------------------------------------------------------------
+//
+// File:        lifeboard.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Bit-packed Game of Life board; see lifeboard.h.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "hashing.h"
+#include "lifeboard.h"
+
+namespace
+{
+    // AddNeighbour
+    //
+    // Adds one neighbour mask to 32 bit-sliced counters at once.  Only counts of 0 to 3 matter to the rules, so
+    // the counter is two bits plus a sticky "four or more" bit rather than a full four-bit sum.
+
+    inline void AddNeighbour(LifeBoard::Word neighbour, LifeBoard::Word& ones, LifeBoard::Word& twos, LifeBoard::Word& many)
+    {
+        const LifeBoard::Word carry = ones & neighbour;
+        ones ^= neighbour;
+        many |= twos & carry;
+        twos ^= carry;
+    }
+}
+
+LifeBoard::LifeBoard(uint16_t width, uint16_t height)
+    : _width(std::max<uint16_t>(width, 1)),
+      _height(std::max<uint16_t>(height, 1)),
+      _words((_width + kWordBits - 1) / kWordBits),
+      _lastWordMask(_width % kWordBits ? (Word(1) << (_width % kWordBits)) - 1 : ~Word(0))
+{
+    const size_t words = (size_t)_words * _height;
+
+    _current  = std::make_unique<Word[]>(words);
+    _previous = std::make_unique<Word[]>(words);
+    _west     = std::make_unique<Word[]>(words);
+    _east     = std::make_unique<Word[]>(words);
+
+    Clear();
+}
+
+void LifeBoard::Clear()
+{
+    const size_t bytes = (size_t)_words * _height * sizeof(Word);
+
+    memset(_current.get(), 0, bytes);
+    memset(_previous.get(), 0, bytes);
+    _hashValid = false;
+}
+
+void LifeBoard::Set(uint16_t x, uint16_t y, bool alive)
+{
+    const size_t index = (size_t)y * _words + x / kWordBits;
+    const Word bit = Word(1) << (x % kWordBits);
+
+    if (alive)
+        _current[index] |= bit;
+    else
+        _current[index] &= ~bit;
+
+    _previous[index] = _current[index];
+    _hashValid = false;
+}
+
+// ShiftRow
+//
+// Moves a row one cell each way with wraparound: the cell that falls off one end of the row comes back in at the
+// other, which for a width that isn't a multiple of 32 is somewhere inside the last word.
+
+void LifeBoard::ShiftRow(const Word* row, Word* west, Word* east) const
+{
+    const int last = _words - 1;
+    const int lastBit = (_width - 1) % kWordBits;
+
+    for (int w = 0; w <= last; w++)
+    {
+        const Word fromWest = w > 0    ? row[w - 1] >> (kWordBits - 1) : (row[last] >> lastBit) & 1;
+        const Word fromEast = w < last ? row[w + 1] << (kWordBits - 1) : (row[0] & 1) << lastBit;
+
+        west[w] = (row[w] << 1) | fromWest;
+        east[w] = (row[w] >> 1) | fromEast;
+    }
+
+    west[last] &= _lastWordMask;
+    east[last] &= _lastWordMask;
+}
+
+// Step
+//
+// A cell is alive in the next generation when it has three neighbours, or two and is alive already.  The new
+// generation is written over the old previous one, and each row is folded into the hash as soon as it's done.
+
+void LifeBoard::Step()
+{
+    for (int y = 0; y < _height; y++)
+        ShiftRow(Row(y), _west.get() + y * _words, _east.get() + y * _words);
+
+    Word* next = _previous.get();
+    uint32_t hash = fnv1a::traits<uint32_t>::offset;
+
+    for (int y = 0; y < _height; y++)
+    {
+        const size_t above = (size_t)(y > 0 ? y - 1 : _height - 1) * _words;
+        const size_t here  = (size_t)y * _words;
+        const size_t below = (size_t)(y + 1 < _height ? y + 1 : 0) * _words;
+
+        for (int w = 0; w < _words; w++)
+        {
+            Word ones = 0, twos = 0, many = 0;
+
+            AddNeighbour(_west[above + w],    ones, twos, many);
+            AddNeighbour(_current[above + w], ones, twos, many);
+            AddNeighbour(_east[above + w],    ones, twos, many);
+            AddNeighbour(_west[here + w],     ones, twos, many);
+            AddNeighbour(_east[here + w],     ones, twos, many);
+            AddNeighbour(_west[below + w],    ones, twos, many);
+            AddNeighbour(_current[below + w], ones, twos, many);
+            AddNeighbour(_east[below + w],    ones, twos, many);
+
+            next[here + w] = ~many & twos & (ones | _current[here + w]);
+        }
+
+        hash = fnv1a::hash_bytes<uint32_t>(next + here, _words * sizeof(Word), hash);
+    }
+
+    std::swap(_current, _previous);
+    _hash = hash;
+    _hashValid = true;
+}
+
+uint32_t LifeBoard::Hash() const
+{
+    if (!_hashValid)
+    {
+        _hash = fnv1a::hash_bytes<uint32_t>(_current.get(), (size_t)_words * _height * sizeof(Word));
+        _hashValid = true;
+    }
+    return _hash;
+}
@@ -24,15 +24,68 @@
 //
 //    Core logging infrastructure: LogSink chain, Logger, and debugX macros.
 //
+//    With ENABLE_ASYNC_LOGGING, a task that logs only formats its message
+//    and posts it to a LogPipeline; the low priority writer task started by
+//    Logger::StartWriter() is the one that waits on the serial port and
+//    telnet client.
+//
 //---------------------------------------------------------------------------
 
+#include <atomic>
+#include <cstring>
 #include <esp_log.h>
 #include <string_view>
 #include "console.h"
 #include "logger.h"
+#include "logpipeline.h"
 
 LogLevel Logger::_level = LogLevel::Info;
 
+namespace
+{
+    constexpr auto kLogWriterIntervalMs = 10;
+    constexpr auto kLogWriterStackSize = 4096;
+
+    std::atomic<bool> g_LogWriterRunning { false };
+
+    LogPipeline& Pipeline()
+    {
+        static LogPipeline pipeline(portNUM_PROCESSORS, LOG_RING_RECORDS);
+        return pipeline;
+    }
+
+    void DeliverMessage(const LogMessage& message)
+    {
+        if (message.raw)
+            ConsoleManager::Instance().Broadcast(message.text);
+        else
+            ConsoleManager::Instance().Broadcast(message.level, message.tag, message.text.data());
+    }
+
+    void LogWriterTask(void*)
+    {
+        for (;;)
+        {
+            Pipeline().Drain(DeliverMessage);
+            vTaskDelay(pdMS_TO_TICKS(kLogWriterIntervalMs));
+        }
+    }
+
+    // Posts the message for the writer task if it's running, and says whether it did
+    bool PostToWriter(LogLevel level, const char* tag, bool raw, std::string_view text)
+    {
+        #if ENABLE_ASYNC_LOGGING
+            if (!g_LogWriterRunning.load(std::memory_order_acquire) || level == LogLevel::Fatal)
+                return false;
+
+            Pipeline().Post(xPortGetCoreID(), level, tag, raw, text, millis());
+            return true;
+        #else
+            return false;
+        #endif
+    }
+}
+
 // Mapping LogLevel to esp_log_level_t
 static esp_log_level_t ToEspLevel(LogLevel level)
 {
@@ -110,7 +163,8 @@ void Logger::Logv(LogLevel level, const char* tag, const char* fmt, va_list args
         }
     }
 
-    ConsoleManager::Instance().Broadcast(level, tag, buf);
+    if (!PostToWriter(level, tag, false, std::string_view(buf, strlen(buf))))
+        ConsoleManager::Instance().Broadcast(level, tag, buf);
 
     if (must_free)
         free(buf);
@@ -161,7 +215,9 @@ static int LogHookVprintf(const char* fmt, va_list args)
     if (len >= 2 && buf[len-1] == '\n' && buf[len-2] == '\n')
         len--;
 
-    ConsoleManager::Instance().Broadcast(std::string_view(buf, static_cast<size_t>(len)));
+    const std::string_view text(buf, static_cast<size_t>(len));
+    if (!PostToWriter(LogLevel::Info, "", true, text))
+        ConsoleManager::Instance().Broadcast(text);
 
     if (must_free)
         free(buf);
@@ -174,3 +230,24 @@ void Logger::InstallLogHook()
     esp_log_set_vprintf(LogHookVprintf);
 }
 
+void Logger::StartWriter()
+{
+    #if ENABLE_ASYNC_LOGGING
+        if (g_LogWriterRunning.load())
+            return;
+
+        Pipeline();     // Construct it before anyone can post to it
+        if (xTaskCreatePinnedToCore(LogWriterTask, "LogWriter", kLogWriterStackSize, nullptr, LOGGER_PRIORITY, nullptr, LOGGER_CORE) == pdPASS)
+            g_LogWriterRunning.store(true, std::memory_order_release);
+    #endif
+}
+
+uint32_t Logger::DroppedRecords()
+{
+    #if ENABLE_ASYNC_LOGGING
+        return Pipeline().Dropped();
+    #else
+        return 0;
+    #endif
+}
+
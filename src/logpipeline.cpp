@@ -0,0 +1,237 @@
+//+--------------------------------------------------------------------------
+//
+// File:        logpipeline.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Log record rings and the pipeline that drains them; see logpipeline.h.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+#include "logpipeline.h"
+
+namespace
+{
+    size_t RoundUpToPowerOfTwo(size_t value)
+    {
+        size_t result = 2;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+
+    // Sequence numbers wrap, so "earlier" is a signed difference
+    bool IsEarlier(uint32_t a, uint32_t b)
+    {
+        return (int32_t)(a - b) < 0;
+    }
+}
+
+LogRing::LogRing(size_t capacity)
+{
+    capacity = RoundUpToPowerOfTwo(capacity);
+    _cells = std::make_unique<Cell[]>(capacity);
+    _mask = capacity - 1;
+
+    for (size_t i = 0; i < capacity; ++i)
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+bool LogRing::TryPop(LogRecord* out)
+{
+    size_t position = _popPosition.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Cell& cell = _cells[position & _mask];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+
+        if (difference == 0)
+        {
+            if (_popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                if (out)
+                    *out = cell.record;
+                cell.sequence.store(position + _mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            position = _popPosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+LogPipeline::LogPipeline(size_t rings, size_t recordsPerRing)
+    : _drainLimit(std::max<size_t>(rings, 1) * RoundUpToPowerOfTwo(recordsPerRing) * 2),
+      _heads(std::max<size_t>(rings, 1)),
+      _hasHead(std::max<size_t>(rings, 1), false)
+{
+    for (size_t i = 0; i < _heads.size(); ++i)
+        _rings.push_back(std::make_unique<LogRing>(recordsPerRing));
+}
+
+// Post
+//
+// Sequence numbers for all of a message's records are reserved in one go, so they are consecutive even when
+// other tasks post in between, which is how the consumer knows what belongs together.
+
+void LogPipeline::Post(size_t ring, LogLevel level, const char* tag, bool raw, std::string_view text, uint32_t timestamp)
+{
+    const size_t records = std::max<size_t>(1, (text.size() + LOG_RECORD_TEXT_BYTES - 1) / LOG_RECORD_TEXT_BYTES);
+
+    LogRecord header;
+    header.sequence = _sequence.fetch_add(records, std::memory_order_relaxed);
+    header.timestamp = timestamp;
+    header.level = level;
+    strncpy(header.tag, tag ? tag : "", LogRecord::kTagBytes - 1);
+    header.tag[LogRecord::kTagBytes - 1] = '\0';
+
+    LogRing& target = *_rings[ring % _rings.size()];
+
+    for (size_t i = 0; i < records; ++i)
+    {
+        const size_t offset = i * LOG_RECORD_TEXT_BYTES;
+        header.flags = (raw ? LogRecord::kRaw : 0)
+                     | (i > 0 ? LogRecord::kContinued : 0)
+                     | (i + 1 < records ? LogRecord::kMore : 0);
+
+        PostRecord(target, header, text.data() + offset, std::min<size_t>(LOG_RECORD_TEXT_BYTES, text.size() - offset));
+        header.sequence++;
+    }
+}
+
+// PostRecord
+//
+// A full ring gives up its oldest record.  That can fail when the oldest cell is still being filled or read by a
+// task we may have preempted, and waiting on a lower priority task from here could wait forever, so after a
+// few tries the new record is the one dropped.
+
+void LogPipeline::PostRecord(LogRing& ring, const LogRecord& header, const char* text, size_t length)
+{
+    _posted.fetch_add(1, std::memory_order_relaxed);
+
+    auto fill = [&](LogRecord& record)
+    {
+        memcpy(&record, &header, offsetof(LogRecord, text));
+        memcpy(record.text, text, length);
+        record.length = (uint8_t)length;
+    };
+
+    for (int attempt = 0; attempt < kPushAttempts; ++attempt)
+    {
+        if (ring.TryPush(fill))
+            return;
+
+        if (ring.TryPop(nullptr))
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    _dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Drain
+//
+// Keeps the next record of every ring in hand and always delivers the earliest of them, which puts records
+// from different rings back in posting order.
+
+size_t LogPipeline::Drain(const Sink& sink)
+{
+    size_t records = 0;
+
+    while (records < _drainLimit)
+    {
+        int earliest = -1;
+        for (size_t i = 0; i < _rings.size(); ++i)
+        {
+            if (!_hasHead[i])
+                _hasHead[i] = _rings[i]->TryPop(&_heads[i]);
+
+            if (_hasHead[i] && (earliest < 0 || IsEarlier(_heads[i].sequence, _heads[earliest].sequence)))
+                earliest = i;
+        }
+
+        if (earliest < 0)
+            break;
+
+        _hasHead[earliest] = false;
+        Accept(_heads[earliest], sink);
+        records++;
+    }
+
+    // Nothing more arrived for a message that was still coming in, so the rest of it was dropped
+    if (records == 0 && _assembling)
+        FinishMessage(sink);
+
+    const uint32_t dropped = Dropped();
+    if (dropped != _reportedDropped)
+    {
+        char notice[64];
+        const int length = snprintf(notice, sizeof(notice), "%lu log records dropped\n", (unsigned long)(dropped - _reportedDropped));
+        _reportedDropped = dropped;
+        sink({ 0, 0, LogLevel::Warn, "LOG", false, std::string_view(notice, std::max(length, 0)) });
+    }
+
+    return records;
+}
+
+void LogPipeline::Accept(const LogRecord& record, const Sink& sink)
+{
+    _delivered++;
+
+    // A message whose next record never came is sent as far as it got
+    if (_assembling && (!(record.flags & LogRecord::kContinued) || record.sequence != _nextSequence))
+        FinishMessage(sink);
+
+    if (!_assembling)
+    {
+        _first = record;
+        _text.assign(record.text, record.length);
+        _assembling = true;
+    }
+    else
+    {
+        _text.append(record.text, record.length);
+    }
+
+    _nextSequence = record.sequence + 1;
+
+    if (!(record.flags & LogRecord::kMore))
+        FinishMessage(sink);
+}
+
+void LogPipeline::FinishMessage(const Sink& sink)
+{
+    _assembling = false;
+    sink({ _first.sequence, _first.timestamp, _first.level, _first.tag, (_first.flags & LogRecord::kRaw) != 0, _text });
+}
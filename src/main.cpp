@@ -202,6 +202,7 @@
 #include "remotecontrol.h"
 #include "renderservice.h"
 #include "screen.h"
+#include "socketreactor.h"
 #include "socketserver.h"
 #include "soundanalyzer.h"
 #include "systemcontainer.h"
@@ -345,6 +346,9 @@ void setup()
     // and Serial.flush() are applied on every log line.
     Logger::InstallLogHook();
 
+    // From here on, logging tasks queue their output and a low priority task writes it out
+    Logger::StartWriter();
+
     // Initialize SPIFFS for file access to non-volatile storage
     if (!SPIFFS.begin(true))
         Serial.println("WARNING: SPIFFS could not be initialized!");
@@ -505,8 +509,8 @@ void setup()
         auto & networkReader = g_ptrSystem->SetupNetworkReader();
 
         #if ENABLE_NTP
-            // Register a network reader to update the device clock at regular intervals
-            networkReader.RegisterReader(nd_network::UpdateNTPTime, (NTP_DELAY_ERROR_SECONDS) * 1000UL);
+            // Register a network reader to keep the device clock in step; most polls find nothing to do
+            networkReader.RegisterReader(nd_network::UpdateNTPTime, NTP_POLL_MS);
         #endif
     #endif
 
@@ -719,6 +723,10 @@ void setup()
         // Start its task here, after WiFi credentials are loaded.
         if (g_ptrSystem->HasNetworkReader())
             g_ptrSystem->GetNetworkReader().Start();
+
+        // One task serves the color data, LED viewer and telnet ports; the
+        // services below just register their ports with it
+        g_ptrSystem->SetupSocketReactor().Start();
     #endif
     #if COLORDATA_SERVER_ENABLED
         g_ptrSystem->SetupColorStreamerService().Start();
@@ -765,6 +773,10 @@ void loop()
             }
         }
 
+        // Telnet lines are edited on the socket reactor but run here, alongside serial ones,
+        // so a slow command doesn't stall the reactor's other sockets
+        ConsoleManager::Instance().RunQueuedCommands();
+
         #if ENABLE_OTA
             try
             {
@@ -777,6 +789,11 @@ void loop()
             }
         #endif
 
+        // Effects flagged by a topology change are initialized here one per pass, away from the render task,
+        // so the change itself only has to wait on the effect that's on screen
+        if (g_ptrSystem->HasEffectManager())
+            g_ptrSystem->GetEffectManager().InitPendingEffect();
+
         EVERY_N_SECONDS(5)
         {
             String strOutput;
@@ -794,6 +811,7 @@ void loop()
 
             #if USE_HUB75
                 strOutput += str_sprintf("Refresh: %d Hz, Power: %d mW, Brite: %3.0lf%%, ", HUB75GFX::matrix.getRefreshRate(), g_Values.MatrixPowerMilliwatts, g_Values.MatrixScaledBrightness / 2.55);
+                strOutput += str_sprintf("Swap: %lu+%lu us, ", (unsigned long)g_Values.MatrixSwapWaitMicros, (unsigned long)g_Values.MatrixSwapCopyMicros);
             #endif
 
             #if ENABLE_AUDIO
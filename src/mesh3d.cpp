@@ -0,0 +1,386 @@
+//+--------------------------------------------------------------------------
+//
+// File:        mesh3d.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Fixed-point mesh projection and rasterization; see mesh3d.h.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <utility>
+
+#include "gfxbase.h"
+#include "mesh3d.h"
+
+namespace
+{
+    inline bool OnMatrix(const GFXBase& g, int x, int y)
+    {
+        return (unsigned)x < g.GetMatrixWidth() && (unsigned)y < g.GetMatrixHeight();
+    }
+
+    inline void BlendPixel(GFXBase& g, int x, int y, const CRGB& color, uint8_t coverage)
+    {
+        if (coverage && OnMatrix(g, x, y))
+        {
+            CRGB& pixel = g.leds[XY(x, y)];
+            pixel = blend(pixel, color, coverage);
+        }
+    }
+}
+
+Mesh3D Mesh3D::Cube(int16_t halfWidth)
+{
+    const int16_t w = halfWidth;
+    Mesh3D cube;
+
+    cube.AddVertex(-w,  w,  w);
+    cube.AddVertex( w,  w,  w);
+    cube.AddVertex( w, -w,  w);
+    cube.AddVertex(-w, -w,  w);
+    cube.AddVertex(-w,  w, -w);
+    cube.AddVertex( w,  w, -w);
+    cube.AddVertex( w, -w, -w);
+    cube.AddVertex(-w, -w, -w);
+
+    cube.AddFace({ 1, 0, 3, 2 });
+    cube.AddFace({ 0, 4, 7, 3 });
+    cube.AddFace({ 4, 0, 1, 5 });
+    cube.AddFace({ 4, 5, 6, 7 });
+    cube.AddFace({ 1, 2, 6, 5 });
+    cube.AddFace({ 2, 3, 7, 6 });
+
+    return cube;
+}
+
+uint8_t Mesh3D::AddVertex(int16_t x, int16_t y, int16_t z)
+{
+    auto clamp = [](int16_t v) { return std::clamp<int16_t>(v, -kMaxCoordinate, kMaxCoordinate); };
+
+    _vertices.push_back({ clamp(x), clamp(y), clamp(z) });
+    _screen.emplace_back();
+    _projected = false;
+    return (uint8_t)(_vertices.size() - 1);
+}
+
+void Mesh3D::AddFace(std::initializer_list<uint8_t> corners)
+{
+    Face face = {};
+    for (uint8_t corner : corners)
+    {
+        if (face.count == kMaxCorners)
+            break;
+        face.corners[face.count++] = corner;
+    }
+
+    for (uint8_t i = 0; i < face.count; i++)
+        face.edges[i] = FindOrAddEdge(face.corners[i], face.corners[i ? i - 1 : face.count - 1]);
+
+    _faces.push_back(face);
+    _frontFaces.push_back(false);
+    _projected = false;
+}
+
+uint8_t Mesh3D::FindOrAddEdge(uint8_t a, uint8_t b)
+{
+    for (size_t i = 0; i < _edges.size(); i++)
+    {
+        if ((_edges[i].a == a && _edges[i].b == b) || (_edges[i].a == b && _edges[i].b == a))
+            return (uint8_t)i;
+    }
+
+    _edges.push_back({ a, b });
+    _frontEdges.push_back(false);
+    return (uint8_t)(_edges.size() - 1);
+}
+
+// Project
+//
+// The rotation matrix is Q1.15 straight from sin16()/cos16(), so a rotated coordinate is a model coordinate in
+// Q15.  Each vertex then takes one division for its perspective scale, in 64 bits because the Q16 focal length
+// shifted up by 15 doesn't fit in 32.  Vertices closer than one unit to the camera, or behind it, are held at
+// that distance, and screen positions are kept within kScreenLimit pixels of the center.
+
+void Mesh3D::Project(uint16_t angleX, uint16_t angleY, int16_t cameraZ, int32_t focalQ16, int32_t centerXQ16, int32_t centerYQ16)
+{
+    if (_projected && angleX == _angleX && angleY == _angleY && cameraZ == _cameraZ
+        && focalQ16 == _focal && centerXQ16 == _centerX && centerYQ16 == _centerY)
+    {
+        return;
+    }
+
+    _projected = true;
+    _angleX = angleX;
+    _angleY = angleY;
+    _cameraZ = cameraZ;
+    _focal = focalQ16;
+    _centerX = centerXQ16;
+    _centerY = centerYQ16;
+
+    const int32_t sx = sin16(angleX);
+    const int32_t cx = cos16(angleX);
+    const int32_t sy = sin16(angleY);
+    const int32_t cy = cos16(angleY);
+
+    const int32_t m00 = cy;
+    const int32_t m02 = -sy;
+    const int32_t m10 = (sx * sy) >> 15;
+    const int32_t m11 = cx;
+    const int32_t m12 = (sx * cy) >> 15;
+    const int32_t m20 = (cx * sy) >> 15;
+    const int32_t m21 = -sx;
+    const int32_t m22 = (cx * cy) >> 15;
+
+    const int32_t cameraQ15 = (int32_t)cameraZ << 15;
+
+    for (size_t i = 0; i < _vertices.size(); i++)
+    {
+        const Vertex& v = _vertices[i];
+
+        const int32_t ax = m00 * v.x + m02 * v.z;
+        const int32_t ay = m10 * v.x + m11 * v.y + m12 * v.z;
+        const int32_t az = std::max<int32_t>(m20 * v.x + m21 * v.y + m22 * v.z + cameraQ15, 1 << 15);
+
+        const int64_t scale = ((int64_t)focalQ16 << 15) / az;       // Q16 pixels per model unit
+
+        _screen[i].Set(centerXQ16 + (int32_t)std::clamp<int64_t>((ax * scale) >> 15, -kScreenLimit, kScreenLimit),
+                       centerYQ16 - (int32_t)std::clamp<int64_t>((ay * scale) >> 15, -kScreenLimit, kScreenLimit));
+    }
+
+    // A face is at the back when its first three corners turn the other way on screen
+
+    std::fill(_frontEdges.begin(), _frontEdges.end(), false);
+
+    for (size_t f = 0; f < _faces.size(); f++)
+    {
+        const Face& face = _faces[f];
+        if (face.count < 3)
+        {
+            _frontFaces[f] = false;
+            continue;
+        }
+
+        const ScreenPoint& pa = _screen[face.corners[0]];
+        const ScreenPoint& pb = _screen[face.corners[1]];
+        const ScreenPoint& pc = _screen[face.corners[2]];
+
+        const int32_t cross = (pb.x - pa.x) * (pc.y - pa.y) - (pb.y - pa.y) * (pc.x - pa.x);
+
+        _frontFaces[f] = cross >= 0;
+        if (_frontFaces[f])
+        {
+            for (uint8_t j = 0; j < face.count; j++)
+                _frontEdges[face.edges[j]] = true;
+        }
+    }
+}
+
+void Mesh3D::DrawEdges(GFXBase& g, int dx, int dy, const CRGB& backColor, const CRGB& frontColor, bool antialias) const
+{
+    // Back edges go first so the front ones are drawn over them
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        const bool front = pass == 1;
+        const CRGB& color = front ? frontColor : backColor;
+
+        for (size_t e = 0; e < _edges.size(); e++)
+        {
+            if (_frontEdges[e] != front)
+                continue;
+
+            const ScreenPoint& a = _screen[_edges[e].a];
+            const ScreenPoint& b = _screen[_edges[e].b];
+
+            if (antialias)
+                DrawLineAA(g, a.xq + dx * kOne, a.yq + dy * kOne, b.xq + dx * kOne, b.yq + dy * kOne, color);
+            else
+                DrawLine(g, a.x + dx, a.y + dy, b.x + dx, b.y + dy, color);
+        }
+    }
+}
+
+void Mesh3D::FillFace(GFXBase& g, size_t face, int dx, int dy, const CRGB& color) const
+{
+    const Face& f = _faces[face];
+    ScreenPoint corners[kMaxCorners];
+
+    for (uint8_t i = 0; i < f.count; i++)
+        corners[i] = _screen[f.corners[i]];
+
+    FillConvex(g, corners, f.count, dx, dy, color);
+}
+
+// DrawLine
+//
+// The same walk as GFXBase::BresenhamLine, but pixels off the matrix are skipped rather than wrapped through
+// XY(), and a line that lies wholly off one side isn't walked at all
+
+void Mesh3D::DrawLine(GFXBase& g, int x0, int y0, int x1, int y1, const CRGB& color)
+{
+    const int width = g.GetMatrixWidth();
+    const int height = g.GetMatrixHeight();
+
+    if ((x0 < 0 && x1 < 0) || (x0 >= width && x1 >= width) || (y0 < 0 && y1 < 0) || (y0 >= height && y1 >= height))
+        return;
+
+    const int dx = abs(x1 - x0);
+    const int dy = abs(y1 - y0);
+    const int sx = x0 < x1 ? 1 : -1;
+    const int sy = y0 < y1 ? 1 : -1;
+    int err = dx - dy;
+
+    for (;;)
+    {
+        if ((unsigned)x0 < (unsigned)width && (unsigned)y0 < (unsigned)height)
+            g.leds[XY(x0, y0)] = color;
+
+        if (x0 == x1 && y0 == y1)
+            break;
+
+        const int e2 = 2 * err;
+        if (e2 > -dy)
+        {
+            err -= dy;
+            x0 += sx;
+        }
+        if (e2 < dx)
+        {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+// DrawLineAA
+//
+// Wu's algorithm in Q16.16: one step per column along the major axis, splitting each step's coverage between
+// the two pixels the line passes between.  Pixel centers are at the half, as ScreenPoint's whole pixels assume.
+
+void Mesh3D::DrawLineAA(GFXBase& g, int32_t x0, int32_t y0, int32_t x1, int32_t y1, const CRGB& color)
+{
+    const bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep)
+    {
+        std::swap(x0, y0);
+        std::swap(x1, y1);
+    }
+    if (x0 > x1)
+    {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+    }
+
+    x0 -= kOne / 2;
+    x1 -= kOne / 2;
+    y0 -= kOne / 2;
+    y1 -= kOne / 2;
+
+    const int32_t dx = x1 - x0;
+    const int32_t gradient = dx ? (int32_t)(((int64_t)(y1 - y0) << kFractionBits) / dx) : 0;
+
+    // Only the columns (or rows, for a steep line) on the matrix are walked
+    const int columns = steep ? g.GetMatrixHeight() : g.GetMatrixWidth();
+    const int first = std::max((x0 + kOne / 2) >> kFractionBits, 0);
+    const int last = std::min((x1 + kOne / 2) >> kFractionBits, columns - 1);
+
+    int32_t y = y0 + (int32_t)(((int64_t)(((int32_t)first << kFractionBits) - x0) * gradient) >> kFractionBits);
+
+    for (int x = first; x <= last; x++, y += gradient)
+    {
+        const int row = y >> kFractionBits;
+        const uint8_t below = (y >> (kFractionBits - 8)) & 0xFF;
+
+        if (steep)
+        {
+            BlendPixel(g, row, x, color, 255 - below);
+            BlendPixel(g, row + 1, x, color, below);
+        }
+        else
+        {
+            BlendPixel(g, x, row, color, 255 - below);
+            BlendPixel(g, x, row + 1, color, below);
+        }
+    }
+}
+
+// FillConvex
+//
+// Each row is filled between the leftmost and rightmost points where it crosses the outline.  A convex
+// outline crosses any row in one span, so there's no need to sort or pair up the crossings.
+
+void Mesh3D::FillConvex(GFXBase& g, const ScreenPoint* points, size_t count, int dx, int dy, const CRGB& color)
+{
+    if (count == 0)
+        return;
+
+    const int width = g.GetMatrixWidth();
+    const int height = g.GetMatrixHeight();
+
+    int top = INT_MAX, bottom = INT_MIN;
+    for (size_t i = 0; i < count; i++)
+    {
+        top = std::min<int>(top, points[i].y);
+        bottom = std::max<int>(bottom, points[i].y);
+    }
+
+    const int firstRow = std::max(top + dy, 0);
+    const int lastRow = std::min(bottom + dy, height - 1);
+
+    for (int y = firstRow; y <= lastRow; y++)
+    {
+        const int py = y - dy;
+        int left = INT_MAX, right = INT_MIN;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const ScreenPoint& p = points[i];
+            const ScreenPoint& q = points[(i + 1) % count];
+
+            if (py < std::min(p.y, q.y) || py > std::max(p.y, q.y))
+                continue;
+
+            if (p.y == q.y)
+            {
+                left = std::min<int>(left, std::min(p.x, q.x));
+                right = std::max<int>(right, std::max(p.x, q.x));
+            }
+            else
+            {
+                const int x = p.x + (py - p.y) * (q.x - p.x) / (q.y - p.y);
+                left = std::min(left, x);
+                right = std::max(right, x);
+            }
+        }
+
+        left = std::max(left + dx, 0);
+        right = std::min(right + dx, width - 1);
+
+        for (int x = left; x <= right; x++)
+            g.leds[XY(x, y)] = color;
+    }
+}
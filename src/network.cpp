@@ -41,6 +41,7 @@
     #include <limits>
     #include <mutex>
     #include <nvs.h>
+    #include <SPIFFS.h>
     #include <WiFi.h>
 #elif ENABLE_ESPNOW
     #include <WiFi.h>
@@ -90,8 +91,6 @@ namespace nd_network
     static std::atomic<int> l_LastWiFiDisconnectReason{0};
 
 #if ENABLE_WIFI
-    static DRAM_ATTR WiFiUDP l_Udp;
-
     // Writer function and flag combo
     struct NetworkReader::ReaderEntry
     {
@@ -100,6 +99,7 @@ namespace nd_network
         std::atomic_ulong     lastReadMs;
         std::atomic_bool      flag = false;
         std::atomic_bool      canceled = false;
+        std::atomic_bool      running = false;     // Claimed by a worker; keeps a reader from running twice at once
 
         ReaderEntry(std::function<void()> r, unsigned long interval)
             : reader(std::move(r)), lastReadMs(0), readInterval(interval) {}
@@ -364,13 +364,7 @@ namespace nd_network
             SetupOTA(String(WiFi.getHostname()));
         #endif
         #if ENABLE_NTP
-            static bool bUdpInitialized = false;
-            if (!bUdpInitialized)
-            {
-                l_Udp.begin(1234);     // Use a fixed local port for NTP responses
-                bUdpInitialized = true;
-            }
-            NTPTimeClient::UpdateClockFromWeb(&l_Udp);
+            NTPTimeClient::RequestSync();
         #endif
 
         EnsureNetworkServicesStarted();
@@ -381,16 +375,9 @@ namespace nd_network
     #if ENABLE_NTP
         void UpdateNTPTime()
         {
-            static unsigned long lastUpdate = 0;
+            // NTPTimeClient works out for itself whether a sync is due, and never waits on the server
             if (IsWiFiConnected())
-            {
-                // If we've already retrieved the time successfully, we'll only actually update every NTP_DELAY_SECONDS seconds
-                if (!NTPTimeClient::HasClockBeenSet() || (millis() - lastUpdate) > ((NTP_DELAY_SECONDS) * 1000))
-                {
-                    if (NTPTimeClient::UpdateClockFromWeb(&l_Udp))
-                        lastUpdate = millis();
-                }
-            }
+                NTPTimeClient::Poll();
         }
     #endif
 
@@ -492,37 +479,179 @@ namespace nd_network
         return success;
     }
 
+    // NetworkReader::Worker
+    //
+    // One of the tasks that actually runs readers. It sleeps until the
+    // network handling task wakes it, then keeps claiming flagged readers
+    // until there are none left.
+
+    class NetworkReader::Worker : public ITaskService
+    {
+      public:
+        Worker(NetworkReader& owner, int index) : _owner(owner)
+        {
+            snprintf(_taskName, sizeof(_taskName), "NetReader%d", index);
+        }
+
+        ~Worker() override { Stop(); }
+
+        const char* Name() const override { return _taskName; }
+
+        void Wake() const { WakeTask(); }
+
+      protected:
+        TaskConfig GetTaskConfig() const override
+        {
+            return TaskConfig {
+                _taskName,
+                NET_READER_STACK_SIZE,
+                NET_PRIORITY,
+                NET_CORE,
+                HTTP_FETCH_TIMEOUT_MS * 2 + 1000   // A reader may be part-way through a connect and a read
+            };
+        }
+
+        void Run() override
+        {
+            while (!ShouldShutdown())
+            {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+                if (ShouldShutdown())
+                    break;
+
+                _owner.RunFlaggedReaders();
+            }
+        }
+
+        void OnBeforeWaitForStop() override { WakeTask(); }
+
+      private:
+        NetworkReader& _owner;
+        char _taskName[16];
+    };
+
     // NetworkReader Implementation
 
+    NetworkReader::NetworkReader() = default;
+
+    NetworkReader::~NetworkReader()
+    {
+        Stop();
+    }
+
     size_t NetworkReader::RegisterReader(const std::function<void()> &reader, unsigned long interval, bool flag)
     {
         auto entry = make_shared_internal<ReaderEntry>(reader, interval);
-        readers.push_back(entry);
         if (interval) entry->lastReadMs.store(millis());
-        if (flag) FlagReader(readers.size() - 1);
-        return readers.size() - 1;
+
+        size_t index;
+        {
+            std::lock_guard guard(readersMutex);
+            readers.push_back(entry);
+            index = readers.size() - 1;
+        }
+
+        if (flag) FlagReader(index);
+        return index;
     }
 
     void NetworkReader::FlagReader(size_t index)
     {
-        if (index < readers.size())
+        std::shared_ptr<ReaderEntry> entry;
         {
-            readers[index]->flag.store(true);
-            WakeTask();
+            std::lock_guard guard(readersMutex);
+            if (index >= readers.size())
+                return;
+            entry = readers[index];
         }
+
+        entry->flag.store(true);
+        WakeTask();
     }
 
     void NetworkReader::CancelReader(size_t index)
     {
-        if (index < readers.size())
+        std::shared_ptr<ReaderEntry> entry;
+        {
+            std::lock_guard guard(readersMutex);
+            if (index >= readers.size())
+                return;
+            entry = readers[index];
+        }
+
+        entry->canceled.store(true);
+        entry->readInterval.store(0);
+        entry->flag.store(false);
+    }
+
+    std::vector<std::shared_ptr<NetworkReader::ReaderEntry>> NetworkReader::SnapshotReaders() const
+    {
+        std::lock_guard guard(readersMutex);
+        return readers;
+    }
+
+    void NetworkReader::StartWorkers()
+    {
+        if (!workers.empty())
+            return;
+
+        for (int i = 0; i < NETWORK_READER_WORKERS; i++)
+        {
+            workers.push_back(std::make_unique<Worker>(*this, i));
+            workers.back()->Start();
+        }
+    }
+
+    void NetworkReader::WakeWorkers()
+    {
+        for (auto& worker : workers)
+            worker->Wake();
+    }
+
+    void NetworkReader::RunFlaggedReaders()
+    {
+        bool ranReader = true;
+
+        while (ranReader && !ShouldShutdown())
         {
-            auto &entry = *readers[index];
-            entry.canceled.store(true);
-            entry.readInterval.store(0);
-            entry.flag.store(false);
+            ranReader = false;
+
+            for (auto &entryPtr : SnapshotReaders())
+            {
+                auto &entry = *entryPtr;
+                if (entry.canceled.load() || !entry.flag.load())
+                    continue;
+
+                // Another worker may have claimed it since we looked
+                if (entry.running.exchange(true))
+                    continue;
+
+                if (entry.flag.exchange(false) && entry.reader)
+                {
+                    entry.reader();
+                    entry.lastReadMs.store(millis());
+                    ranReader = true;
+                }
+
+                entry.running.store(false);
+            }
         }
     }
 
+    // NetworkReader::OnAfterStop
+    //
+    // The workers outlive the network handling task by a little, since a
+    // reader may be in the middle of a request; they're stopped here, after
+    // it has exited, so nothing can wake them any more.
+
+    void NetworkReader::OnAfterStop()
+    {
+        for (auto& worker : workers)
+            worker->Stop();
+        workers.clear();
+    }
+
     // NetworkReader ITaskService hooks
     //
     // Start/Stop/IsRunning are inherited final from ITaskService; this class
@@ -557,6 +686,8 @@ namespace nd_network
         unsigned long lastWebSocketCleanup = 0;
         if (!MDNS.begin("esp32")) Serial.println("Error starting mDNS");
 
+        StartWorkers();
+
         TickType_t notifyWait = 0;
         while (!ShouldShutdown())
         {
@@ -613,12 +744,18 @@ namespace nd_network
 
             unsigned long now = millis();
             unsigned long nextEventMs = kReaderDispatchGapMs;
+            bool anyFlagged = false;
 
-            for (auto &entryPtr : readers)
+            // Work out which readers are due and hand them to the workers. The
+            // readers themselves never run on this task.
+            for (auto &entryPtr : SnapshotReaders())
             {
                 auto &entry = *entryPtr;
                 if (entry.canceled.load()) continue;
 
+                // Its interval restarts when the current run finishes
+                if (entry.running.load()) continue;
+
                 unsigned long interval = entry.readInterval.load();
                 if (interval)
                 {
@@ -630,13 +767,12 @@ namespace nd_network
                     if (remaining < nextEventMs) nextEventMs = remaining;
                 }
 
-                if (entry.flag.exchange(false))
-                {
-                    if (entry.reader)
-                        entry.reader();
-                    entry.lastReadMs.store(millis());
-                }
+                anyFlagged = anyFlagged || entry.flag.load();
             }
+
+            if (anyFlagged)
+                WakeWorkers();
+
             notifyWait = pdMS_TO_TICKS(nextEventMs);
         }
 
@@ -675,21 +811,217 @@ namespace nd_network
         #endif
 
         #if INCOMING_WIFI_ENABLED
-        DebugCLI::cli_printf("Socket Buffer _cbReceived: %zu", g_ptrSystem->GetSocketServer()._cbReceived);
+        DebugCLI::cli_printf("Socket Buffer _cbReceived: %zu", g_ptrSystem->GetSocketServer().GetBytesReceived());
         #endif
     }
 
+    #if ENABLE_NTP
+
+    // DoClockCommand
+    //
+    // Asks for a sync on the next NTP poll and shows how the last one went
+
+    void DoClockCommand(const DebugCLI::cli_argv &)
+    {
+        NTPTimeClient::RequestSync();
+
+        const auto stats = NTPTimeClient::GetStats();
+        if (!stats.synced)
+        {
+            DebugCLI::cli_printf("Not synced yet; %lu rounds failed, %lu timeouts\n",
+                (unsigned long)stats.failedRounds, (unsigned long)stats.timeouts);
+            return;
+        }
+
+        DebugCLI::cli_printf("Offset %+lld us, delay %lu us, jitter %lu us, synced %lu s ago\n",
+            (long long)stats.offsetMicros, (unsigned long)stats.delayMicros, (unsigned long)stats.jitterMicros,
+            (unsigned long)((millis() - stats.lastSyncMs) / 1000));
+        DebugCLI::cli_printf("Rounds %lu (%lu failed): %lu steps, %lu slews; %lu samples, %lu timeouts, %lu rejected\n",
+            (unsigned long)stats.rounds, (unsigned long)stats.failedRounds, (unsigned long)stats.steps,
+            (unsigned long)stats.slews, (unsigned long)stats.samples, (unsigned long)stats.timeouts,
+            (unsigned long)stats.rejected);
+    }
+
+    #endif
+
+    #if COLORDATA_SERVER_ENABLED
+
+    // DoPreviewCommand
+    //
+    // Lists the live preview clients on both transports, with what each asked for and what it has been sent
+
+    void DoPreviewCommand(const DebugCLI::cli_argv &)
+    {
+        const auto clients = g_ptrSystem->HasColorStreamerService()
+            ? g_ptrSystem->GetColorStreamerService().GetPreviewClients()
+            : std::vector<PreviewClientReport>();
+
+        if (clients.empty())
+        {
+            DebugCLI::cli_printf("No preview clients\n");
+            return;
+        }
+
+        for (const auto& client : clients)
+        {
+            DebugCLI::cli_printf("%-9s %5lu  %-6s scale %u  max %u fps  sent %lu frames, %llu bytes  dropped %lu\n",
+                client.transport, (unsigned long)client.id,
+                client.negotiated ? PreviewOptions::EncodingName(client.options.encoding) : "legacy",
+                client.options.scale, client.options.maxFps,
+                (unsigned long)client.stats.framesSent, (unsigned long long)client.stats.bytesSent,
+                (unsigned long)client.stats.framesDropped);
+        }
+    }
+
+    #endif
+
+    #if INCOMING_WIFI_ENABLED && ENABLE_WIRE_CAPTURE
+
+    std::string CaptureFileName(std::string_view name)
+    {
+        std::string fileName(name);
+        if (fileName.empty() || fileName[0] != '/')
+            fileName.insert(0, "/");
+        return fileName;
+    }
+
+    // DoCaptureCommand
+    //
+    // "capture start" records what arrives on the socket until "capture stop"; "capture save <file>" writes what
+    // was recorded to SPIFFS for "replay", or to be copied off and replayed on the bench.  Saving stops the
+    // capture first, since Save() holds the ring's lock through the flash write and would otherwise stall the
+    // socket server's Record() calls for as long as that takes.
+
+    void DoCaptureCommand(const DebugCLI::cli_argv &argv)
+    {
+        auto& socketServer = g_ptrSystem->GetSocketServer();
+
+        if (argv.size() > 1 && DebugCLI::StringCompareInsensitive(argv[1], "start"))
+        {
+            if (!socketServer.StartCapture())
+                DebugCLI::cli_printf("Could not start capture\n");
+            return;
+        }
+
+        if (argv.size() > 1 && DebugCLI::StringCompareInsensitive(argv[1], "stop"))
+            socketServer.StopCapture();
+
+        const auto* pCapture = socketServer.GetCapture();
+        if (pCapture == nullptr)
+        {
+            DebugCLI::cli_printf("Usage: capture start|stop|status|save <file>\n");
+            return;
+        }
+
+        if (argv.size() > 2 && DebugCLI::StringCompareInsensitive(argv[1], "save"))
+        {
+            if (socketServer.IsCapturing())
+            {
+                socketServer.StopCapture();
+                DebugCLI::cli_printf("Capture stopped\n");
+            }
+
+            const std::string fileName = CaptureFileName(argv[2]);
+            File file = SPIFFS.open(fileName.c_str(), FILE_WRITE);
+            if (!file)
+            {
+                DebugCLI::cli_printf("Could not create %s\n", fileName.c_str());
+                return;
+            }
+
+            const size_t expected = pCapture->Bytes();
+            const size_t written = pCapture->Save([&file](const uint8_t* data, size_t length) { return file.write(data, length) == length; });
+            file.close();
+
+            if (written != expected)
+                DebugCLI::cli_printf("Only wrote %zu of %zu bytes to %s\n", written, expected, fileName.c_str());
+            return;
+        }
+
+        DebugCLI::cli_printf("Capture %s: %zu packets, %zu of %zu bytes, %lu dropped\n",
+            socketServer.IsCapturing() ? "running" : "stopped", pCapture->Records(), pCapture->Bytes(),
+            pCapture->Capacity(), (unsigned long)pCapture->Dropped());
+    }
+
+    // DoReplayCommand
+    //
+    // Plays a saved capture back through the socket server's packet handling, on its original schedule or with
+    // "fast" as quickly as it will go, and reports how ingest kept up.
+
+    void DoReplayCommand(const DebugCLI::cli_argv &argv)
+    {
+        if (argv.size() < 2)
+        {
+            DebugCLI::cli_printf("Usage: replay <file> [fast]\n");
+            return;
+        }
+
+        const std::string fileName = CaptureFileName(argv[1]);
+        File file = SPIFFS.open(fileName.c_str());
+        if (!file || file.isDirectory())
+        {
+            DebugCLI::cli_printf("Could not open %s\n", fileName.c_str());
+            return;
+        }
+
+        const size_t length = file.size();
+        auto pCapture = make_unique_psram<uint8_t[]>(length);
+        const bool loaded = pCapture && file.read(pCapture.get(), length) == length;
+        file.close();
+
+        if (!loaded)
+        {
+            DebugCLI::cli_printf("Could not load %s\n", fileName.c_str());
+            return;
+        }
+
+        WireCaptureReader reader(pCapture.get(), length);
+        if (!reader.IsValid())
+        {
+            DebugCLI::cli_printf("%s is not a wire capture\n", fileName.c_str());
+            return;
+        }
+
+        const bool fast = argv.size() > 2 && DebugCLI::StringCompareInsensitive(argv[2], "fast");
+        const auto stats = g_ptrSystem->GetSocketServer().ReplayCapture(reader, fast ? WireReplay::Timing::Fast : WireReplay::Timing::Original);
+
+        DebugCLI::cli_printf("Replayed %lu packets (%llu bytes) in %lu ms: %lu packets/s, %lu rejected\n",
+            (unsigned long)stats.packets, (unsigned long long)stats.bytes, (unsigned long)(stats.elapsedMicros / 1000),
+            (unsigned long)stats.PacketsPerSecond(), (unsigned long)stats.failed);
+        DebugCLI::cli_printf("Ingest: avg %lu us, max %lu us; %lu compressed at avg %lu us\n",
+            (unsigned long)stats.AverageIngestMicros(), (unsigned long)stats.maxIngestMicros,
+            (unsigned long)stats.compressed, (unsigned long)stats.AverageCompressedMicros());
+        DebugCLI::cli_printf("Queue depth: avg %lu, max %zu; late: %lu, worst %lu us\n",
+            (unsigned long)(stats.packets ? stats.depthTotal / stats.packets : 0), stats.maxDepth,
+            (unsigned long)stats.late, (unsigned long)stats.maxLateMicros);
+    }
+
+    #endif
+
     void InitNetworkCLI()
     {
         static const DebugCLI::command cmds[] = {
             #if ENABLE_NTP
-            { "clock", "Refresh time from server", "Refreshing Time from Server",
-                [](const DebugCLI::cli_argv &) { NTPTimeClient::UpdateClockFromWeb(&l_Udp); }
+            { "clock", "Refresh time from server and show sync statistics", "Refreshing Time from Server",
+                DoClockCommand
             },
             #endif
             { "stats", "Display system statistics", "Displaying statistics",
                 DoStatsCommand
-            }
+            },
+            #if COLORDATA_SERVER_ENABLED
+            { "preview", "List live preview clients and what they have been sent", nullptr,
+                DoPreviewCommand
+            },
+            #endif
+            #if INCOMING_WIFI_ENABLED && ENABLE_WIRE_CAPTURE
+            { "capture", "Record socket packets: capture start|stop|status|save <file>", nullptr,
+                DoCaptureCommand
+            },
+            { "replay", "Replay a wire capture: replay <file> [fast]", "Replaying capture",
+                DoReplayCommand
+            },
+            #endif
         };
         DebugCLI::RegisterCommands(cmds, std::size(cmds));
     }
@@ -974,7 +1306,7 @@ bool ProcessIncomingData(allocated_unique_ptr<uint8_t[]> &payloadData, size_t pa
     #endif
 }
 
-// SocketServerTaskEntry was migrated into SocketServer::Run() (ITaskService).
+// SocketServer is served by the SocketReactor; see socketserver.cpp.
 
 #if COLORDATA_SERVER_ENABLED
 // ColorStreamerService ITaskService hooks
@@ -985,10 +1317,9 @@ bool ProcessIncomingData(allocated_unique_ptr<uint8_t[]> &payloadData, size_t pa
 ITaskService::TaskConfig ColorStreamerService::GetTaskConfig() const
 {
     // DEFAULT_STACK_SIZE (2560 bytes) is tight for what this task actually
-    // does: lwIP socket ops (accept/send), std::mutex via lock_guard, calls
-    // into EffectManager, per-frame memcpy of the LED buffer, and (when
-    // COLORDATA_WEB_SOCKET_ENABLED) calls into ESPAsyncWebServer. Match the
-    // sibling SocketServer task, which does the same shape of work.
+    // does: std::mutex via lock_guard, calls into EffectManager, per-frame
+    // memcpy of the LED buffer, and (when COLORDATA_WEB_SOCKET_ENABLED)
+    // calls into ESPAsyncWebServer.
     return TaskConfig {
         "ColorData Loop",
         SOCKET_STACK_SIZE,
@@ -998,25 +1329,66 @@ ITaskService::TaskConfig ColorStreamerService::GetTaskConfig() const
     };
 }
 
+ColorStreamerService::ColorStreamerService() = default;
+
+ColorStreamerService::~ColorStreamerService()
+{
+    Stop();
+}
+
+// OnBeforeStart
+//
+// The raw TCP preview viewers are served by the socket reactor rather than
+// by this task, so starting the service hands the viewer port over to it.
+
+bool ColorStreamerService::OnBeforeStart()
+{
+    if (!_viewer)
+        _viewer = std::make_unique<LEDViewer>(NetworkPort::ColorServer);
+
+    if (!_viewer->Attach(g_ptrSystem->GetSocketReactor()))
+        debugE("Unable to start color data server!");
+
+    return true;
+}
+
+void ColorStreamerService::OnAfterStop()
+{
+    if (_viewer)
+        _viewer->Detach();
+}
+
+std::vector<PreviewClientReport> ColorStreamerService::GetPreviewClients() const
+{
+    std::vector<PreviewClientReport> reports;
+
+    if (_viewer)
+        _viewer->AppendPreviewClients(reports);
+
+#if COLORDATA_WEB_SOCKET_ENABLED
+    if (g_ptrSystem->HasWebSocketServer())
+        g_ptrSystem->GetWebSocketServer().AppendPreviewClients(reports);
+#endif
+
+    return reports;
+}
+
 void IRAM_ATTR ColorStreamerService::Run()
 {
+#if COLORDATA_WEB_SOCKET_ENABLED
     // Preview cadence is naturally bounded by the render task's frame rate.
     // The frame listener below wakes this task immediately for each rendered
     // frame, so there is no polling sleep or preview-specific fps cap in the
-    // device-side streamer. The transports handle backpressure: SendColorData
-    // skips when availableForWriteAll() is false, and the raw TCP path returns
-    // Failed when the socket buffer is full.
+    // device-side streamer. SendColorData handles backpressure per client,
+    // skipping any client that still has frames queued, and applies the
+    // frame rate caps clients have asked for.
 
-    LEDViewer _viewer(NetworkPort::ColorServer);
-    int       socket = -1;
-    bool      wsListenersPresent = false;
-    auto previewPacket = make_unique_psram<ColorDataPacket>();
+    auto previewColors = make_unique_psram<CRGB[]>(NUM_LEDS);
+    auto previewFrame = make_unique_psram<CRGB[]>(NUM_LEDS);
 
     auto &effectManager = g_ptrSystem->GetEffectManager();
-#if COLORDATA_WEB_SOCKET_ENABLED
     auto *webSocketServer =
         (g_ptrSystem && g_ptrSystem->HasWebSocketServer()) ? &g_ptrSystem->GetWebSocketServer() : nullptr;
-#endif
 
     struct NotifyingFrameEventListener : public IFrameEventListener
     {
@@ -1063,88 +1435,29 @@ void IRAM_ATTR ColorStreamerService::Run()
 
     while (!ShouldShutdown())
     {
-        while (!nd_network::IsWiFiConnected() && !ShouldShutdown())
-            delay(250);
-
-        if (ShouldShutdown())
-            return;
-
-        if (!_viewer.begin())
-        {
-            debugE("Unable to start color data server!");
-            delay(1000);
-            continue;
-        }
-        else
-        {
-            debugW("Started color data server!");
-            break;
-        }
-    }
-
-    while (!ShouldShutdown())
-    {
-        if (socket < 0)
-            socket = _viewer.CheckForConnection();
-
         auto& graphics = effectManager.g();
         auto leds = graphics.leds;
         const auto activeLEDCount = graphics.GetLEDCount();
 
-#if COLORDATA_WEB_SOCKET_ENABLED
-        wsListenersPresent = webSocketServer && webSocketServer->HaveColorDataClients();
-#else
-        wsListenersPresent = false;
-#endif
-        const auto previewActive = (socket >= 0) || wsListenersPresent;
-        frameEventListener.SetWakeEnabled(previewActive);
+        const bool wsListenersPresent = webSocketServer && webSocketServer->HaveColorDataClients();
+        frameEventListener.SetWakeEnabled(wsListenersPresent);
 
-        if (frameEventListener.CheckAndClearNewFrameAvailable() && leds != nullptr)
+        if (frameEventListener.CheckAndClearNewFrameAvailable() && leds != nullptr && wsListenersPresent)
         {
-            if (previewActive)
-            {
-                previewPacket->header = COLOR_DATA_PACKET_HEADER;
-                previewPacket->width  = graphics.GetMatrixWidth();
-                previewPacket->height = graphics.GetMatrixHeight();
-                memcpy(previewPacket->colors, leds, sizeof(CRGB) * activeLEDCount);
-
-                // Prefer the websocket preview transport used by the local UI. The legacy raw TCP
-                // preview socket remains available for external tools, but we do not drive both
-                // transports simultaneously for the same frame.
-#if COLORDATA_WEB_SOCKET_ENABLED
-                if (wsListenersPresent)
-                {
-                    webSocketServer->SendColorData(previewPacket->colors, activeLEDCount);
-                }
-                else
-#endif
-                if (socket >= 0)
-                {
-                    debugV("Sending color data packet");
-                    const auto packetSize =
-                        sizeof(previewPacket->header) +
-                        sizeof(previewPacket->width) +
-                        sizeof(previewPacket->height) +
-                        sizeof(CRGB) * activeLEDCount;
-                    const auto sendResult = _viewer.SendPacket(socket, previewPacket.get(), packetSize);
-                    if (sendResult == LEDViewer::SendResult::Failed)
-                    {
-                        debugW("Error on color data socket, so closing");
-                        close(socket);
-                        socket = -1;
-                    }
-                }
-            }
+            memcpy(previewColors.get(), leds, sizeof(CRGB) * activeLEDCount);
+            LEDViewer::CopyRowMajor(graphics, previewColors.get(), activeLEDCount, previewFrame.get());
+            webSocketServer->SendColorData(previewColors.get(), activeLEDCount, previewFrame.get(),
+                                           graphics.GetMatrixWidth(), graphics.GetMatrixHeight());
         }
 
-        if (socket >= 0 || wsListenersPresent)
-            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
-        else
-            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wsListenersPresent ? 100 : 1000));
     }
-
-    if (socket >= 0)
-        close(socket);
+#else
+    // Without the websocket channel there is nothing for this task to do;
+    // the TCP viewers are served entirely by the socket reactor.
+    while (!ShouldShutdown())
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+#endif
 }
 #endif // COLORDATA_SERVER_ENABLED
 #endif // ENABLE_WIFI
@@ -22,22 +22,25 @@
 //
 // Description:
 //
-//    Sets the system clock from the specified NTP Server
+//    Keeps the system clock in step with the configured NTP server
 //
 // History:     Jul-12-2018         Davepl      Created for BigBlueLCD
 //              Oct-09-2018         Davepl      Copied to LEDWifi project
 //---------------------------------------------------------------------------
 
 #include "globals.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
 #include <ctime>
-#include <mutex>
+#include <sys/socket.h>
 #include <sys/time.h>
-#include <WiFiUdp.h>
 #include "nd_network.h"
 
 #include "deviceconfig.h"
-#include "ledbuffer.h"
 #include "ntptimeclient.h"
+#include "socketreactor.h"
 #include "systemcontainer.h"
 #include "values.h"
 
@@ -45,181 +48,161 @@
 
 // NTPTimeClient
 //
-// Basically, I took some really ancient NTP code that I had on hand that I knew
-// worked and wrapped it in a class.  As expected, it works, but it could likely
-// benefit from cleanup or even wholesale replacement.
+// The SNTP exchange itself lives in SntpClient; what's here supplies it with a socket the SocketReactor
+// watches, decides when a round is due, and applies its verdicts to the system clock.
 
 // File-static variables to replace class static members
-static DRAM_ATTR bool l_bClockSet = false;
-static DRAM_ATTR std::mutex l_clockMutex;
+static DRAM_ATTR std::atomic<bool> l_bClockSet{false};
+static DRAM_ATTR std::atomic<bool> l_bSyncRequested{false};
+static uint32_t l_lastRoundMs = 0;
+static bool l_bRoundStarted = false;
 
-bool NTPTimeClient::HasClockBeenSet()
+static int64_t WallClockMicros()
 {
-    return l_bClockSet;
+    timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (int64_t)tv.tv_sec * MICROS_PER_SECOND + tv.tv_usec;
+}
+
+static void StepClock(int64_t offsetMicros)
+{
+    const int64_t now = WallClockMicros() + offsetMicros;
+
+    timeval tv;
+    tv.tv_sec  = now / MICROS_PER_SECOND;
+    tv.tv_usec = now % MICROS_PER_SECOND;
+    settimeofday(&tv, nullptr);
 }
 
-// UpdateClockFromWeb
+// CorrectClock
 //
-// Obtains the time from the specified NTP Server and sets the ESP32 RTC to the result
+// adjtime() bends the clock rate until the offset has been worked off, so time never jumps or runs backwards
+// while it does.  A slew the system refuses is stepped instead.
 
-bool NTPTimeClient::UpdateClockFromWeb(WiFiUDP * pUDP)
+static void CorrectClock(int64_t offsetMicros, bool step)
 {
-    if (g_Values.UpdateStarted)
+    if (!step)
     {
-        debugW("Update already in progress, skipping time check, as it seems to disturb the update process.");
-        return false;
+        timeval delta;
+        delta.tv_sec  = offsetMicros / MICROS_PER_SECOND;
+        delta.tv_usec = offsetMicros % MICROS_PER_SECOND;
+        step = adjtime(&delta, nullptr) != 0;
     }
 
-    debugV("Updating Clock From Web...");
+    if (step)
+        StepClock(offsetMicros);
 
-    std::lock_guard guard(l_clockMutex);
+    debugI("NTP clock: %s by %lld us", step ? "stepped" : "slewing", (long long)offsetMicros);
 
-    char chNtpPacket[NTP_PACKET_LENGTH];
-    memset(chNtpPacket, 0, NTP_PACKET_LENGTH);
+    char chBuffer[64];
+    const time_t now = time(nullptr);
+    strftime(chBuffer, sizeof(chBuffer), "%d %b %Y %H:%M:%S", localtime(&now));
+    debugV("NTP clock: time is now %s", chBuffer);
 
-    // Send ntp time request.
-    // Initialize ntp packet.
+    l_bClockSet = true;  // Clock has been set at least once
+}
 
+static SntpClient l_sntp(WallClockMicros, CorrectClock);
 
-    // Set the ll (leap indicator), vvv (version number) and mmm (mode) bits.
-    //
-    //  These bits are contained in the first byte of chNtpPacker and are in
-    // the following format:  llvvvmmm
-    //
-    // where:
-    //
-    //    ll  (leap indicator) = 0
-    //    vvv (version number) = 3
-    //    mmm (mode)           = 3
+// NTPSocket
+//
+// The reactor's handle on the SNTP socket.  Replies are read the moment they arrive, which is what makes the
+// receive timestamps good for anything.
 
-    chNtpPacket[0] = 0b00011011;
+class NTPSocket : public ISocketProtocol
+{
+  public:
+    const char* ProtocolName() const override { return "NTP"; }
+    bool OnReadable(int) override { return l_sntp.OnReadable(millis()); }
+    void OnDisconnect(int) override { l_sntp.SetSocket(-1); }
+};
 
-    IPAddress ipNtpServer;
-    if (!nd_network::GetWiFiHostByName(g_ptrSystem->GetDeviceConfig().GetNTPServer().c_str(), ipNtpServer))
-        // Use Google Time (time.google.com) as default. The pool.ntp.org
-        // servers (IPs) don't necessarily last very long.
-        ipNtpServer.fromString("216.239.35.12");
+static NTPSocket l_socket;
 
-    // Send the ntp packet.
-    while (pUDP->parsePacket() != 0)
-        #if ESP_ARDUINO_VERSION >= ESP_ARDUINO_VERSION_VAL(3, 0, 0)
-            pUDP->clear();
-        #else
-            pUDP->flush();
-        #endif
+// OpenSocket
+//
+// Hands a fresh UDP socket to the reactor to watch; the reactor closes it again if the network goes down.
 
-    if (!pUDP->beginPacket(ipNtpServer, 123))
-    {
-        debugW("beginPacket failed in time set");
+static bool OpenSocket()
+{
+    if (!g_ptrSystem->HasSocketReactor())
         return false;
-    }
 
-    if (NTP_PACKET_LENGTH != pUDP->write((const uint8_t *)chNtpPacket, NTP_PACKET_LENGTH))
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
     {
-        debugW("Could not write to UDP in time set");
+        debugW("NTP clock: unable to open socket: %s (%d)", strerror(errno), errno);
         return false;
     }
 
-    if (!pUDP->endPacket())
+    l_sntp.SetSocket(fd);
+    if (!g_ptrSystem->GetSocketReactor().Watch(fd, l_socket))
     {
-        debugW("EndPacket failed in time set.");
+        l_sntp.SetSocket(-1);
         return false;
     }
+    return true;
+}
 
-    debugV("NTP clock: ntp packet sent to ntp server.");
-    debugV("NTP clock: awaiting response from ntp server");
-
-    int iPass = 0;
-    while (!pUDP->parsePacket())
-    {
-        #if ESP_ARDUINO_VERSION >= ESP_ARDUINO_VERSION_VAL(3, 0, 0)
-            pUDP->clear();
-        #else
-            pUDP->flush();
-        #endif
-        delay(100);
-        debugV(".");
-        if (iPass++ > 100)
-        {
-            debugW("NTP clock: TIMEOUT after 10 seconds of parsePacket!");
-            return false;
-        }
-    }
-    debugV("NTP clock: Time Received From Server...");
-
-    // Server responded, read the packet.
-
-    if (NTP_PACKET_LENGTH != pUDP->read(chNtpPacket, NTP_PACKET_LENGTH))
-    {
-        debugE("Unexpected number of bytes back from UDP read, so returning early");
-        return false;
-    }
+bool NTPTimeClient::HasClockBeenSet()
+{
+    return l_bClockSet;
+}
 
-    // Obtain the time from the packet, convert to Unix time, and adjust for the time zone.
+void NTPTimeClient::RequestSync()
+{
+    l_bSyncRequested = true;
+}
 
-    struct timeval tvNew;
-    memset(&tvNew, 0, sizeof(tvNew));
+SntpClient::Stats NTPTimeClient::GetStats()
+{
+    return l_sntp.GetStats();
+}
 
-    auto frac  =  (uint32_t) chNtpPacket[44] << 24
-                | (uint32_t) chNtpPacket[45] << 16
-                | (uint32_t) chNtpPacket[46] <<  8
-                | (uint32_t) chNtpPacket[47] <<  0;
-    auto microsecs = ((uint64_t) frac * 1000000) >> 32;
+// Poll
+//
+// Only one NetworkReader worker runs a given reader at a time, so the round bookkeeping here needs no lock.
 
-    // BUGBUG (davepl): I've been getting back odd packets where the clock is year 2036 and micros is 0. I ignore those.
+void NTPTimeClient::Poll()
+{
+    const uint32_t now = millis();
 
-    if (microsecs == 0)
+    if (l_sntp.IsBusy())
     {
-        debugW("Bogus NTP time received, ignoring.");
-        return false;
+        l_sntp.Poll(now);
+        return;
     }
 
-    debugW("NTP clock: Raw values sec=%lu, usec=%llu", (unsigned long)frac, microsecs);
-
-    tvNew.tv_sec = ((unsigned long)chNtpPacket[40] << 24) +       // bits 24 through 31 of ntp time
-        ((unsigned long)chNtpPacket[41] << 16) +                        // bits 16 through 23 of ntp time
-        ((unsigned long)chNtpPacket[42] << 8) +                         // bits  8 through 15 of ntp time
-        ((unsigned long)chNtpPacket[43]) -                              // bits  0 through  7 of ntp time
-        (((70UL * 365UL) + 17UL) * 86400UL);                            // ntp to unix conversion
-    tvNew.tv_usec = microsecs;
-
-    timeval tvOld;
-    gettimeofday(&tvOld, nullptr);
-
-    double dOld = tvOld.tv_sec + ((double) tvOld.tv_usec / MICROS_PER_SECOND);
-    double dNew = tvNew.tv_sec + ((double) tvNew.tv_usec / MICROS_PER_SECOND);
-
-    debugI("Old Time: %lf, New Time: %lf, Delta: %lf", dOld, dNew, abs(dNew - dOld));
-
-    // If the clock is off by more than a quarter second, update it
-
-    constexpr auto kMaxTimeDelta = 0.25;
-
-    auto delta = abs(dNew - dOld);
-    if (delta < kMaxTimeDelta)
-    {
-        debugI("Clock is only off by %lf so not updating the RTC.", delta);
-    }
-    else
+    if (g_Values.UpdateStarted)
     {
-        debugI("Adjusting time by %lf to %lf", delta, dNew);
-        settimeofday(&tvNew, nullptr);                                 // Set the ESP32 rtc.
+        debugV("Update in progress, skipping time check, as it seems to disturb the update process.");
+        return;
     }
 
-    // Time has been received.
-    // Output date and time to serial.
+    const uint32_t intervalMs = (l_bClockSet ? NTP_DELAY_SECONDS : NTP_DELAY_ERROR_SECONDS) * 1000UL;
+    if (!l_bSyncRequested.exchange(false) && l_bRoundStarted && now - l_lastRoundMs < intervalMs)
+        return;
 
-    char chBuffer[128];
-    struct tm * tmPointer = localtime(&tvNew.tv_sec);
-    strftime(chBuffer, sizeof(chBuffer), "%d %b %Y %H:%M:%S", tmPointer);
-    debugI("NTP clock: response received, updated time to: %lld.%lld, DELTA: %lf\n",
-            (long long)tvNew.tv_sec,
-            (long long)tvNew.tv_usec,
-            dNew - dOld );
+    l_bRoundStarted = true;
+    l_lastRoundMs = now;
 
-    l_bClockSet = true;  // Clock has been set at least once
+    if (l_sntp.Socket() < 0 && !OpenSocket())
+        return;
 
-    return true;
+    IPAddress ipNtpServer;
+    if (!nd_network::GetWiFiHostByName(g_ptrSystem->GetDeviceConfig().GetNTPServer().c_str(), ipNtpServer))
+        // Use Google Time (time.google.com) as default. The pool.ntp.org
+        // servers (IPs) don't necessarily last very long.
+        ipNtpServer.fromString("216.239.35.12");
+
+    sockaddr_in server = {};
+    server.sin_family      = AF_INET;
+    server.sin_port        = htons(123);
+    server.sin_addr.s_addr = (uint32_t)ipNtpServer;
+
+    debugV("Updating Clock From Web...");
+    if (!l_sntp.StartRound(server, now))
+        debugW("NTP clock: could not start a sync");
 }
 
 #endif
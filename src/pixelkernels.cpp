@@ -0,0 +1,271 @@
+//+--------------------------------------------------------------------------
+//
+// File:        pixelkernels.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Span kernels for the GFXBase pixel helpers; see pixelkernels.h.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pixelkernels.h"
+
+static_assert(sizeof(CRGB) == 3, "Pixel kernels assume packed 3-byte pixels");
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Pixel kernels assume little-endian words");
+
+// Reference kernels
+//
+// The per-pixel loops the GFXBase helpers have always run
+
+void PixelKernels::Reference::ScaleSpan(CRGB* pixels, size_t count, uint8_t scale)
+{
+    for (size_t i = 0; i < count; ++i)
+        pixels[i].nscale8(scale);
+}
+
+void PixelKernels::Reference::AddSpan(CRGB* dst, const CRGB* src, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        dst[i] += src[i];
+}
+
+void PixelKernels::Reference::AddThenScaleSpan(CRGB* dst, const CRGB* src, size_t count, uint8_t scale)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        dst[i] += src[i];
+        dst[i].nscale8(scale);
+    }
+}
+
+void PixelKernels::Reference::BlurSpan(CRGB* pixels, size_t count, fract8 amount)
+{
+    const uint8_t keep = 255 - amount;
+    const uint8_t seep = amount >> 1;
+    CRGB carryover = CRGB::Black;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        CRGB cur = pixels[i];
+        CRGB part = cur;
+        part.nscale8(seep);
+        cur.nscale8(keep);
+        cur += carryover;
+        if (i)
+            pixels[i - 1] += part;
+        pixels[i] = cur;
+        carryover = part;
+    }
+}
+
+#if USE_SWAR_PIXEL_KERNELS
+
+namespace
+{
+    constexpr uint32_t kEvenBytes = 0x00FF00FF;
+    constexpr uint32_t kHighBits  = 0x80808080;
+    constexpr uint32_t kLowBits   = 0x7F7F7F7F;
+
+    // A span is a run of bytes as far as these kernels care: every operation
+    // treats red, green and blue alike, so pixel boundaries don't matter
+
+    uint8_t* Bytes(CRGB* pixels)
+    {
+        return reinterpret_cast<uint8_t*>(pixels);
+    }
+
+    const uint8_t* Bytes(const CRGB* pixels)
+    {
+        return reinterpret_cast<const uint8_t*>(pixels);
+    }
+
+    uint32_t LoadWord(const uint8_t* bytes)
+    {
+        uint32_t word;
+        memcpy(&word, bytes, sizeof(word));
+        return word;
+    }
+
+    void StoreWord(uint8_t* bytes, uint32_t word)
+    {
+        memcpy(bytes, &word, sizeof(word));
+    }
+
+    // nscale8 of each byte, with scaleFixed = scale + 1. Each 16-bit lane
+    // product is at most 255 * 256, so nothing carries between lanes.
+
+    uint32_t ScaleWord(uint32_t word, uint32_t scaleFixed)
+    {
+        const uint32_t even = (((word & kEvenBytes) * scaleFixed) >> 8) & kEvenBytes;
+        const uint32_t odd  = (((word >> 8) & kEvenBytes) * scaleFixed) & ~kEvenBytes;
+        return even | odd;
+    }
+
+    // qadd8 of each byte: add the low seven bits, fix up the top bit, and
+    // saturate every byte that carried out of it
+
+    uint32_t AddWord(uint32_t a, uint32_t b)
+    {
+        const uint32_t low   = (a & kLowBits) + (b & kLowBits);
+        const uint32_t sum   = low ^ ((a ^ b) & kHighBits);
+        const uint32_t carry = ((a & b) | ((a | b) & ~sum)) & kHighBits;
+        return sum | ((carry >> 7) * 0xFF);
+    }
+
+    uint8_t ScaleByte(uint8_t value, uint32_t scaleFixed)
+    {
+        return static_cast<uint8_t>((value * scaleFixed) >> 8);
+    }
+
+    uint8_t AddByte(uint8_t a, uint8_t b)
+    {
+        return static_cast<uint8_t>(std::min(255, a + b));
+    }
+}
+
+void PixelKernels::ScaleSpan(CRGB* pixels, size_t count, uint8_t scale)
+{
+    if (scale == 255)
+        return;
+
+    const uint32_t scaleFixed = scale + 1;
+    uint8_t* bytes = Bytes(pixels);
+    const size_t total = count * sizeof(CRGB);
+
+    size_t i = 0;
+    for (; i + 4 <= total; i += 4)
+        StoreWord(bytes + i, ScaleWord(LoadWord(bytes + i), scaleFixed));
+    for (; i < total; ++i)
+        bytes[i] = ScaleByte(bytes[i], scaleFixed);
+}
+
+void PixelKernels::AddSpan(CRGB* dst, const CRGB* src, size_t count)
+{
+    uint8_t* out = Bytes(dst);
+    const uint8_t* in = Bytes(src);
+    const size_t total = count * sizeof(CRGB);
+
+    size_t i = 0;
+    for (; i + 4 <= total; i += 4)
+        StoreWord(out + i, AddWord(LoadWord(out + i), LoadWord(in + i)));
+    for (; i < total; ++i)
+        out[i] = AddByte(out[i], in[i]);
+}
+
+void PixelKernels::AddThenScaleSpan(CRGB* dst, const CRGB* src, size_t count, uint8_t scale)
+{
+    const uint32_t scaleFixed = scale + 1;
+    uint8_t* out = Bytes(dst);
+    const uint8_t* in = Bytes(src);
+    const size_t total = count * sizeof(CRGB);
+
+    size_t i = 0;
+    for (; i + 4 <= total; i += 4)
+        StoreWord(out + i, ScaleWord(AddWord(LoadWord(out + i), LoadWord(in + i)), scaleFixed));
+    for (; i < total; ++i)
+        out[i] = ScaleByte(AddByte(out[i], in[i]), scaleFixed);
+}
+
+// BlurSpan
+//
+// Every byte ends up as keep * itself plus seep * the same channel of each
+// neighbor, all from the original values; saturating adds of non-negative
+// terms don't care about order, so that matches the carryover loop. The span
+// is copied a chunk at a time into an aligned window with a word of original
+// bytes either side. Scaling is per byte, so each word is scaled by seep once
+// and both neighbors - three bytes away - come from shifting adjacent scaled
+// words together rather than from unaligned loads.
+
+void PixelKernels::BlurSpan(CRGB* pixels, size_t count, fract8 amount)
+{
+    constexpr size_t kChunkWords = 16;
+    constexpr size_t kChunkBytes = kChunkWords * 4;
+
+    const uint32_t keepFixed = 256 - amount;
+    const uint32_t seepFixed = (amount >> 1) + 1;
+    uint8_t* bytes = Bytes(pixels);
+    const size_t total = count * sizeof(CRGB);
+
+    uint32_t window[kChunkWords + 2];
+    uint32_t result[kChunkWords];
+    uint32_t before = 0;
+
+    for (size_t start = 0; start < total; start += kChunkBytes)
+    {
+        const size_t length = std::min(kChunkBytes, total - start);
+        const size_t words = (length + 3) / 4;
+
+        // Zero the words a short copy leaves partly filled; past the end of the span is black
+        window[0] = before;
+        window[words] = 0;
+        window[words + 1] = 0;
+        memcpy(&window[1], bytes + start, std::min(length + 4, total - start));
+
+        // Only a full chunk can have another after it
+        if (length == kChunkBytes)
+            before = window[kChunkWords];
+
+        uint32_t previous = ScaleWord(window[0], seepFixed);
+        uint32_t current = ScaleWord(window[1], seepFixed);
+
+        for (size_t j = 1; j <= words; ++j)
+        {
+            const uint32_t next  = ScaleWord(window[j + 1], seepFixed);
+            const uint32_t left  = (previous >> 8) | (current << 24);
+            const uint32_t right = (current >> 24) | (next << 8);
+
+            result[j - 1] = AddWord(AddWord(ScaleWord(window[j], keepFixed), left), right);
+            previous = current;
+            current = next;
+        }
+
+        memcpy(bytes + start, result, length);
+    }
+}
+
+#else
+
+void PixelKernels::ScaleSpan(CRGB* pixels, size_t count, uint8_t scale)
+{
+    Reference::ScaleSpan(pixels, count, scale);
+}
+
+void PixelKernels::AddSpan(CRGB* dst, const CRGB* src, size_t count)
+{
+    Reference::AddSpan(dst, src, count);
+}
+
+void PixelKernels::AddThenScaleSpan(CRGB* dst, const CRGB* src, size_t count, uint8_t scale)
+{
+    Reference::AddThenScaleSpan(dst, src, count, scale);
+}
+
+void PixelKernels::BlurSpan(CRGB* pixels, size_t count, fract8 amount)
+{
+    Reference::BlurSpan(pixels, count, amount);
+}
+
+#endif
@@ -0,0 +1,573 @@
+//+--------------------------------------------------------------------------
+//
+// File:        powermodel.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Power model, channel-sum kernel and calibration; see powermodel.h.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+#include "powermodel.h"
+
+static_assert(sizeof(CRGB) == 3, "SumChannels assumes packed 3-byte pixels");
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "SumChannels assumes little-endian words");
+
+namespace
+{
+    // Upper bounds on persisted values, which keep every product in the
+    // estimate comfortably inside 64 bits
+    constexpr uint32_t kMaxBaseMw = 1000000;
+    constexpr uint32_t kMaxLevelUw = 1000000;
+
+    constexpr const char* kBaseMwTag = "baseMw";
+    constexpr const char* kIdleUwPerLedTag = "idleUwPerLed";
+    constexpr const char* kRedTag = "red";
+    constexpr const char* kGreenTag = "green";
+    constexpr const char* kBlueTag = "blue";
+    constexpr const char* kWhiteTag = "white";
+
+    constexpr size_t kMaxCalibrationSamples = 64;
+
+    std::mutex                               g_modelMutex;
+    std::shared_ptr<const PowerModel>        g_currentModel;
+
+    // Calibration state. The active flag is checked without the lock so an
+    // idle calibrator costs the render loop nothing.
+
+    std::atomic<bool>                        g_calibrating{false};
+    std::mutex                               g_calibrationMutex;
+    std::vector<PowerCalibration::Sample>    g_samples;
+    PowerCalibration::Sample                 g_pending = {};
+    uint32_t                                 g_pendingFrames = 0;
+    uint64_t                                 g_pendingPredictedMw = 0;
+
+    void AddPixel(ChannelSums& sums, const CRGB& pixel)
+    {
+        sums.red   += pixel.r;
+        sums.green += pixel.g;
+        sums.blue  += pixel.b;
+    }
+
+    uint32_t LoadWord(const uint8_t* bytes)
+    {
+        uint32_t word;
+        memcpy(&word, __builtin_assume_aligned(bytes, 4), sizeof(word));
+        return word;
+    }
+
+    bool IsLinearCurve(const PowerModelConfig::Curve& curve)
+    {
+        // Within one level's worth of a straight line from zero to the last point
+        const int64_t full = curve.back();
+        const int64_t tolerance = std::max<int64_t>(full, 255);
+
+        for (size_t i = 0; i < PowerModelConfig::kCurvePoints; ++i)
+        {
+            const int64_t expected = full * PowerModelConfig::kCurveLevels[i];
+            if (std::llabs(static_cast<int64_t>(curve[i]) * 255 - expected) > tolerance)
+                return false;
+        }
+        return true;
+    }
+
+    // Interpolate the curve, with an implicit (0, 0) point, at every level
+    void FillLevelTable(const PowerModelConfig::Curve& curve, std::array<uint32_t, 256>& table)
+    {
+        int64_t x0 = 0;
+        int64_t y0 = 0;
+        size_t level = 0;
+
+        for (size_t i = 0; i < PowerModelConfig::kCurvePoints; ++i)
+        {
+            const int64_t x1 = PowerModelConfig::kCurveLevels[i];
+            const int64_t y1 = curve[i];
+
+            for (; static_cast<int64_t>(level) <= x1; ++level)
+                table[level] = static_cast<uint32_t>(std::max<int64_t>(0, y0 + (y1 - y0) * (static_cast<int64_t>(level) - x0) / (x1 - x0)));
+
+            x0 = x1;
+            y0 = y1;
+        }
+    }
+
+    bool ReadCurve(JsonObjectConst object, const char* tag, PowerModelConfig::Curve& curve)
+    {
+        if (object[tag].isNull())
+            return true;
+
+        auto points = object[tag].as<JsonArrayConst>();
+        if (points.isNull() || points.size() != PowerModelConfig::kCurvePoints)
+            return false;
+
+        for (size_t i = 0; i < PowerModelConfig::kCurvePoints; ++i)
+        {
+            if (!points[i].is<uint32_t>() || points[i].as<uint32_t>() > kMaxLevelUw)
+                return false;
+            curve[i] = points[i].as<uint32_t>();
+        }
+        return true;
+    }
+
+    void WriteCurve(JsonObject object, const char* tag, const PowerModelConfig::Curve& curve)
+    {
+        auto points = object[tag].to<JsonArray>();
+        for (auto point : curve)
+            points.add(point);
+    }
+
+    // SolveLinearSystem
+    //
+    // Gaussian elimination with partial pivoting on an n x n system held
+    // row-major in a, with right-hand side b. Returns false if singular.
+
+    bool SolveLinearSystem(std::vector<double>& a, std::vector<double>& b, size_t n)
+    {
+        for (size_t col = 0; col < n; ++col)
+        {
+            size_t pivot = col;
+            for (size_t row = col + 1; row < n; ++row)
+                if (std::fabs(a[row * n + col]) > std::fabs(a[pivot * n + col]))
+                    pivot = row;
+
+            if (std::fabs(a[pivot * n + col]) < 1e-9)
+                return false;
+
+            if (pivot != col)
+            {
+                for (size_t k = 0; k < n; ++k)
+                    std::swap(a[col * n + k], a[pivot * n + k]);
+                std::swap(b[col], b[pivot]);
+            }
+
+            for (size_t row = col + 1; row < n; ++row)
+            {
+                const double factor = a[row * n + col] / a[col * n + col];
+                for (size_t k = col; k < n; ++k)
+                    a[row * n + k] -= factor * a[col * n + k];
+                b[row] -= factor * b[col];
+            }
+        }
+
+        for (size_t col = n; col-- > 0;)
+        {
+            double value = b[col];
+            for (size_t k = col + 1; k < n; ++k)
+                value -= a[col * n + k] * b[k];
+            b[col] = value / a[col * n + col];
+        }
+        return true;
+    }
+}
+
+// SumChannels
+//
+// Three consecutive 32-bit words hold exactly four pixels. Masking each
+// word with 0x00FF00FF, before and after shifting it down a byte, splits
+// it into two 16-bit lanes that each hold one channel value:
+//
+//      word 0:  r0 g0 b0 r1   ->  (r0, b0) and (g0, r1)
+//      word 1:  g1 b1 r2 g2   ->  (g1, r2) and (b1, g2)
+//      word 2:  b2 r3 g3 b3   ->  (b2, g3) and (r3, b3)
+//
+// The six lane pairs fall into three layouts - (r, b), (g, r) and (b, g) -
+// so three accumulators take two adds each per group. A lane gains at
+// most 510 per group, so they are folded into the totals every 128 groups
+// before they can overflow.
+
+ChannelSums SumChannels(const CRGB* leds, size_t count)
+{
+    ChannelSums sums;
+    sums.count = count;
+
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(leds);
+    size_t i = 0;
+
+    // Step single pixels until the words line up; three bytes a pixel gets
+    // there in at most three steps
+    for (; i < count && (reinterpret_cast<uintptr_t>(bytes + i * 3) & 3) != 0; ++i)
+        AddPixel(sums, leds[i]);
+
+    constexpr uint32_t kLanes = 0x00FF00FF;
+    constexpr size_t kGroupsPerFold = 128;
+
+    while (count - i >= 4)
+    {
+        const size_t groups = std::min((count - i) / 4, kGroupsPerFold);
+        const uint8_t* words = bytes + i * 3;
+
+        uint32_t rb = 0;
+        uint32_t gr = 0;
+        uint32_t bg = 0;
+
+        for (size_t g = 0; g < groups; ++g, words += 12)
+        {
+            const uint32_t w0 = LoadWord(words);
+            const uint32_t w1 = LoadWord(words + 4);
+            const uint32_t w2 = LoadWord(words + 8);
+
+            rb += (w0 & kLanes) + ((w2 >> 8) & kLanes);
+            gr += ((w0 >> 8) & kLanes) + (w1 & kLanes);
+            bg += ((w1 >> 8) & kLanes) + (w2 & kLanes);
+        }
+
+        sums.red   += (rb & 0xFFFF) + (gr >> 16);
+        sums.green += (gr & 0xFFFF) + (bg >> 16);
+        sums.blue  += (bg & 0xFFFF) + (rb >> 16);
+
+        i += groups * 4;
+    }
+
+    for (; i < count; ++i)
+        AddPixel(sums, leds[i]);
+
+    return sums;
+}
+
+// PowerModelConfig::Defaults
+//
+// HUB75 numbers were measured on a Mesmerizer with a 64x32 panel; strip
+// numbers are FastLED's per-channel WS2812 currents at 5 V.
+
+PowerModelConfig PowerModelConfig::Defaults()
+{
+    PowerModelConfig config;
+
+    #if USE_HUB75
+        config.baseMw       = 1500;
+        config.idleUwPerLed = 0;
+        config.red          = Linear(4100);
+        config.green        = Linear(820);
+        config.blue         = Linear(1750);
+    #else
+        config.baseMw       = 0;
+        config.idleUwPerLed = 1 * 5 * 1000;
+        config.red          = Linear(16 * 5 * 1000);
+        config.green        = Linear(11 * 5 * 1000);
+        config.blue         = Linear(15 * 5 * 1000);
+        config.white        = Linear(SK6812_WHITE_MW * 1000);
+    #endif
+
+    return config;
+}
+
+PowerModelConfig::Curve PowerModelConfig::Linear(uint32_t fullScaleUw)
+{
+    Curve curve;
+    for (size_t i = 0; i < kCurvePoints; ++i)
+        curve[i] = static_cast<uint32_t>((static_cast<uint64_t>(fullScaleUw) * kCurveLevels[i] + 127) / 255);
+    return curve;
+}
+
+bool PowerModelConfig::operator==(const PowerModelConfig& other) const
+{
+    return baseMw == other.baseMw
+        && idleUwPerLed == other.idleUwPerLed
+        && red == other.red
+        && green == other.green
+        && blue == other.blue
+        && white == other.white;
+}
+
+void PowerModelConfig::SerializeToJSON(JsonObject object) const
+{
+    object[kBaseMwTag] = baseMw;
+    object[kIdleUwPerLedTag] = idleUwPerLed;
+    WriteCurve(object, kRedTag, red);
+    WriteCurve(object, kGreenTag, green);
+    WriteCurve(object, kBlueTag, blue);
+    WriteCurve(object, kWhiteTag, white);
+}
+
+// PowerModelConfig::FromJSON
+//
+// Members that are missing keep their defaults; any that are present but
+// malformed or out of range reject the whole object.
+
+std::optional<PowerModelConfig> PowerModelConfig::FromJSON(JsonObjectConst object)
+{
+    auto config = Defaults();
+
+    if (!object[kBaseMwTag].isNull())
+    {
+        if (!object[kBaseMwTag].is<uint32_t>() || object[kBaseMwTag].as<uint32_t>() > kMaxBaseMw)
+            return std::nullopt;
+        config.baseMw = object[kBaseMwTag].as<uint32_t>();
+    }
+
+    if (!object[kIdleUwPerLedTag].isNull())
+    {
+        if (!object[kIdleUwPerLedTag].is<uint32_t>() || object[kIdleUwPerLedTag].as<uint32_t>() > kMaxLevelUw)
+            return std::nullopt;
+        config.idleUwPerLed = object[kIdleUwPerLedTag].as<uint32_t>();
+    }
+
+    if (!ReadCurve(object, kRedTag, config.red)
+        || !ReadCurve(object, kGreenTag, config.green)
+        || !ReadCurve(object, kBlueTag, config.blue)
+        || !ReadCurve(object, kWhiteTag, config.white))
+        return std::nullopt;
+
+    return config;
+}
+
+// PowerModel
+
+PowerModel::PowerModel(const PowerModelConfig& config) : _config(config)
+{
+    const std::array<const PowerModelConfig::Curve*, ChannelCount> curves = { &config.red, &config.green, &config.blue, &config.white };
+
+    for (size_t channel = 0; channel < ChannelCount; ++channel)
+    {
+        const auto& curve = *curves[channel];
+        FillLevelTable(curve, _lut[channel]);
+        _slopeQ16[channel] = static_cast<uint32_t>((static_cast<uint64_t>(curve.back()) << 16) / 255);
+        _linear = _linear && IsLinearCurve(curve);
+    }
+}
+
+std::shared_ptr<const PowerModel> PowerModel::Current()
+{
+    std::lock_guard<std::mutex> lock(g_modelMutex);
+    if (!g_currentModel)
+        g_currentModel = std::make_shared<const PowerModel>(PowerModelConfig::Defaults());
+    return g_currentModel;
+}
+
+void PowerModel::Publish(const PowerModelConfig& config)
+{
+    auto model = std::make_shared<const PowerModel>(config);
+
+    std::lock_guard<std::mutex> lock(g_modelMutex);
+    g_currentModel = std::move(model);
+}
+
+uint32_t PowerModel::SumsMw(const ChannelSums& sums) const
+{
+    const uint64_t levelUwQ16 = static_cast<uint64_t>(sums.red)   * _slopeQ16[Red]
+                              + static_cast<uint64_t>(sums.green) * _slopeQ16[Green]
+                              + static_cast<uint64_t>(sums.blue)  * _slopeQ16[Blue]
+                              + static_cast<uint64_t>(sums.white) * _slopeQ16[White];
+
+    const uint64_t totalUw = (levelUwQ16 >> 16) + static_cast<uint64_t>(sums.count) * _config.idleUwPerLed;
+    return static_cast<uint32_t>(totalUw / 1000);
+}
+
+// PowerModel::EstimateMw
+//
+// A linear model only needs channel totals, which either came with the
+// frame or cost one SumChannels() pass. Anything else is looked up level
+// by level.
+
+uint32_t PowerModel::EstimateMw(const CRGB* leds, size_t count, const ChannelSums* known, ChannelSums& sumsOut) const
+{
+    if (_linear)
+    {
+        sumsOut = known ? *known : SumChannels(leds, count);
+        return SumsMw(sumsOut);
+    }
+
+    ChannelSums sums;
+    sums.count = count;
+    uint64_t totalUw = static_cast<uint64_t>(count) * _config.idleUwPerLed;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const CRGB pixel = leds[i];
+        AddPixel(sums, pixel);
+        totalUw += _lut[Red][pixel.r] + _lut[Green][pixel.g] + _lut[Blue][pixel.b];
+    }
+
+    sumsOut = sums;
+    return static_cast<uint32_t>(totalUw / 1000);
+}
+
+// PowerCalibration
+
+void PowerCalibration::Start()
+{
+    std::lock_guard<std::mutex> lock(g_calibrationMutex);
+    g_pending = {};
+    g_pendingFrames = 0;
+    g_pendingPredictedMw = 0;
+    g_calibrating = true;
+}
+
+void PowerCalibration::Stop()
+{
+    g_calibrating = false;
+}
+
+void PowerCalibration::Clear()
+{
+    std::lock_guard<std::mutex> lock(g_calibrationMutex);
+    g_samples.clear();
+    g_pending = {};
+    g_pendingFrames = 0;
+    g_pendingPredictedMw = 0;
+}
+
+bool PowerCalibration::IsActive()
+{
+    return g_calibrating;
+}
+
+void PowerCalibration::NoteFrame(const ChannelSums& scaledSums, uint32_t predictedMw)
+{
+    if (!g_calibrating)
+        return;
+
+    std::lock_guard<std::mutex> lock(g_calibrationMutex);
+    g_pending.red   += scaledSums.red;
+    g_pending.green += scaledSums.green;
+    g_pending.blue  += scaledSums.blue;
+    g_pending.white += scaledSums.white;
+    g_pending.count += scaledSums.count;
+    g_pendingPredictedMw += predictedMw;
+    g_pendingFrames++;
+}
+
+bool PowerCalibration::AddMeasurement(uint32_t measuredMw)
+{
+    std::lock_guard<std::mutex> lock(g_calibrationMutex);
+    if (g_pendingFrames == 0)
+        return false;
+
+    const double frames = g_pendingFrames;
+    Sample sample = {
+        g_pending.red / frames,
+        g_pending.green / frames,
+        g_pending.blue / frames,
+        g_pending.white / frames,
+        g_pending.count / frames,
+        static_cast<uint32_t>(g_pendingPredictedMw / g_pendingFrames),
+        measuredMw
+    };
+
+    // Keep the most recent samples once the buffer is full
+    if (g_samples.size() >= kMaxCalibrationSamples)
+        g_samples.erase(g_samples.begin());
+    g_samples.push_back(sample);
+
+    g_pending = {};
+    g_pendingFrames = 0;
+    g_pendingPredictedMw = 0;
+    return true;
+}
+
+std::vector<PowerCalibration::Sample> PowerCalibration::Samples()
+{
+    std::lock_guard<std::mutex> lock(g_calibrationMutex);
+    return g_samples;
+}
+
+// PowerCalibration::Fit
+//
+// Solves the normal equations for measured = c + kr*R + kg*G + kb*B (+ kw*W
+// when any sample lit the whites), with the columns scaled to unit range
+// first so the constant and the channel sums condition alike. The samples
+// need at least as many distinct colors as there are unknowns - a run of
+// greys can't tell the channels apart and is reported as no fit.
+
+std::optional<PowerModelConfig> PowerCalibration::Fit(const PowerModelConfig& current, double& rmsErrorMw)
+{
+    const auto samples = Samples();
+
+    const bool fitWhite = std::any_of(samples.begin(), samples.end(), [](const Sample& s) { return s.white > 0; });
+    const size_t n = fitWhite ? 5 : 4;
+    if (samples.size() < n)
+        return std::nullopt;
+
+    auto row = [&](const Sample& s, size_t k) -> double
+    {
+        switch (k)
+        {
+            case 0:  return 1.0;
+            case 1:  return s.red;
+            case 2:  return s.green;
+            case 3:  return s.blue;
+            default: return s.white;
+        }
+    };
+
+    std::vector<double> scale(n, 1.0);
+    for (const auto& s : samples)
+        for (size_t k = 0; k < n; ++k)
+            scale[k] = std::max(scale[k], std::fabs(row(s, k)));
+
+    std::vector<double> a(n * n, 0.0);
+    std::vector<double> b(n, 0.0);
+    for (const auto& s : samples)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            const double xj = row(s, j) / scale[j];
+            for (size_t k = 0; k < n; ++k)
+                a[j * n + k] += xj * row(s, k) / scale[k];
+            b[j] += xj * s.measuredMw;
+        }
+    }
+
+    if (!SolveLinearSystem(a, b, n))
+        return std::nullopt;
+
+    for (size_t k = 0; k < n; ++k)
+        b[k] /= scale[k];
+
+    double squaredError = 0;
+    double meanCount = 0;
+    for (const auto& s : samples)
+    {
+        double predicted = 0;
+        for (size_t k = 0; k < n; ++k)
+            predicted += b[k] * row(s, k);
+        squaredError += (predicted - s.measuredMw) * (predicted - s.measuredMw);
+        meanCount += s.count;
+    }
+    rmsErrorMw = std::sqrt(squaredError / samples.size());
+    meanCount /= samples.size();
+
+    // Coefficients are mW per unit of channel sum; a curve wants the uW one
+    // LED draws at full level
+    auto fullScaleUw = [](double mwPerLevel)
+    {
+        return static_cast<uint32_t>(std::clamp(mwPerLevel * 255.0 * 1000.0, 0.0, static_cast<double>(kMaxLevelUw)));
+    };
+
+    PowerModelConfig fitted = current;
+    const double idleMw = meanCount * current.idleUwPerLed / 1000.0;
+    fitted.baseMw = static_cast<uint32_t>(std::clamp(b[0] - idleMw, 0.0, static_cast<double>(kMaxBaseMw)));
+    fitted.red    = PowerModelConfig::Linear(fullScaleUw(b[1]));
+    fitted.green  = PowerModelConfig::Linear(fullScaleUw(b[2]));
+    fitted.blue   = PowerModelConfig::Linear(fullScaleUw(b[3]));
+    if (fitWhite)
+        fitted.white = PowerModelConfig::Linear(fullScaleUw(b[4]));
+
+    return fitted;
+}
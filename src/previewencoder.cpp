@@ -0,0 +1,297 @@
+//+--------------------------------------------------------------------------
+//
+// File:        previewencoder.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Preview frame downsampling and encoding; see previewencoder.h.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "byte_utils.h"
+#include "previewencoder.h"
+
+namespace
+{
+    void AppendWORD(std::vector<uint8_t>& out, uint16_t value)
+    {
+        out.push_back((uint8_t)value);
+        out.push_back((uint8_t)(value >> 8));
+    }
+
+    void AppendDWORD(std::vector<uint8_t>& out, uint32_t value)
+    {
+        AppendWORD(out, (uint16_t)value);
+        AppendWORD(out, (uint16_t)(value >> 16));
+    }
+
+    void AppendPixel(std::vector<uint8_t>& out, const CRGB& pixel)
+    {
+        out.push_back(pixel.r);
+        out.push_back(pixel.g);
+        out.push_back(pixel.b);
+    }
+
+    bool SamePixel(const CRGB& a, const CRGB& b)
+    {
+        return a.r == b.r && a.g == b.g && a.b == b.b;
+    }
+}
+
+PreviewOptions PreviewOptions::Normalized() const
+{
+    PreviewOptions normalized = *this;
+    normalized.scale = std::clamp<uint8_t>(scale, 1, kMaxScale);
+    if (normalized.encoding > Delta)
+        normalized.encoding = Delta;
+    return normalized;
+}
+
+bool PreviewOptions::FromRequest(const uint8_t* request, PreviewOptions& options)
+{
+    if (memcmp(request, kRequestMagic, sizeof(kRequestMagic)))
+        return false;
+
+    options.scale    = request[4];
+    options.encoding = (Encoding)request[5];
+    options.maxFps   = WORDFromMemory(&request[6]);
+    options = options.Normalized();
+    return true;
+}
+
+bool PreviewOptions::ParseEncoding(const char* name, Encoding& encoding)
+{
+    for (auto candidate : { Raw, RunLength, Delta })
+    {
+        if (!strcmp(name, EncodingName(candidate)))
+        {
+            encoding = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* PreviewOptions::EncodingName(Encoding encoding)
+{
+    switch (encoding)
+    {
+        case RunLength: return "rle";
+        case Delta:     return "delta";
+        default:        return "raw";
+    }
+}
+
+PreviewEncoder::PreviewEncoder(const PreviewOptions& options)
+    : _options(options.Normalized())
+{
+}
+
+void PreviewEncoder::SetOptions(const PreviewOptions& options)
+{
+    _options = options.Normalized();
+    _havePrevious = false;
+}
+
+bool PreviewEncoder::IsDue(uint32_t nowMillis) const
+{
+    return _options.maxFps == 0 || !_haveSent || nowMillis - _lastSentMillis >= 1000u / _options.maxFps;
+}
+
+// Downsample
+//
+// Each output pixel is the average of the scale x scale block it covers; blocks on the right and bottom
+// edges are cut short rather than dropped, so no part of the frame ever disappears from the preview.
+
+void PreviewEncoder::Downsample(const CRGB* pixels, uint16_t width, uint16_t height)
+{
+    const uint16_t scale = _options.scale;
+
+    _width  = (width + scale - 1) / scale;
+    _height = (height + scale - 1) / scale;
+    _current.resize((size_t)_width * _height);
+
+    if (scale == 1)
+    {
+        std::copy(pixels, pixels + _current.size(), _current.begin());
+        return;
+    }
+
+    for (uint16_t y = 0; y < _height; y++)
+    {
+        const uint16_t top    = y * scale;
+        const uint16_t bottom = std::min<uint16_t>(top + scale, height);
+
+        for (uint16_t x = 0; x < _width; x++)
+        {
+            const uint16_t left  = x * scale;
+            const uint16_t right = std::min<uint16_t>(left + scale, width);
+
+            uint32_t r = 0, g = 0, b = 0;
+            for (uint16_t sourceY = top; sourceY < bottom; sourceY++)
+            {
+                const CRGB* row = pixels + (size_t)sourceY * width;
+                for (uint16_t sourceX = left; sourceX < right; sourceX++)
+                {
+                    r += row[sourceX].r;
+                    g += row[sourceX].g;
+                    b += row[sourceX].b;
+                }
+            }
+
+            const uint32_t count = (uint32_t)(bottom - top) * (right - left);
+            _current[(size_t)y * _width + x] = CRGB(r / count, g / count, b / count);
+        }
+    }
+}
+
+void PreviewEncoder::EncodeRunLength(std::vector<uint8_t>& out) const
+{
+    out.clear();
+
+    for (size_t i = 0; i < _current.size(); )
+    {
+        size_t run = 1;
+        while (run < 256 && i + run < _current.size() && SamePixel(_current[i + run], _current[i]))
+            run++;
+
+        out.push_back((uint8_t)(run - 1));
+        AppendPixel(out, _current[i]);
+        i += run;
+    }
+}
+
+// EncodeDelta
+//
+// Alternates runs of unchanged pixels with runs of replacement ones, each up to 255 long.  A skip that runs
+// out of room is closed off with an empty literal run; the unchanged tail of the frame isn't sent at all.
+
+void PreviewEncoder::EncodeDelta(std::vector<uint8_t>& out) const
+{
+    out.clear();
+
+    const size_t count = _current.size();
+    size_t i = 0;
+
+    while (i < count)
+    {
+        size_t skip = 0;
+        while (skip < 255 && i < count && SamePixel(_current[i], _previous[i]))
+        {
+            skip++;
+            i++;
+        }
+
+        if (i == count)
+            break;
+
+        size_t literals = 0;
+        while (literals < 255 && i + literals < count && !SamePixel(_current[i + literals], _previous[i + literals]))
+            literals++;
+
+        out.push_back((uint8_t)skip);
+        out.push_back((uint8_t)literals);
+        for (size_t n = 0; n < literals; n++)
+            AppendPixel(out, _current[i + n]);
+        i += literals;
+    }
+}
+
+void PreviewEncoder::Encode(const CRGB* pixels, uint16_t width, uint16_t height, std::vector<uint8_t>& packet)
+{
+    Downsample(pixels, width, height);
+
+    const size_t rawBytes = _current.size() * 3;
+    PreviewOptions::Encoding encoding = PreviewOptions::Raw;
+    size_t payloadBytes = rawBytes;
+
+    if (_options.encoding >= PreviewOptions::RunLength)
+    {
+        EncodeRunLength(_runLength);
+        if (_runLength.size() < payloadBytes)
+        {
+            encoding = PreviewOptions::RunLength;
+            payloadBytes = _runLength.size();
+        }
+    }
+
+    if (_options.encoding >= PreviewOptions::Delta && _havePrevious && _previousWidth == _width && _previousHeight == _height)
+    {
+        EncodeDelta(_delta);
+        if (_delta.size() < payloadBytes)
+        {
+            encoding = PreviewOptions::Delta;
+            payloadBytes = _delta.size();
+        }
+    }
+
+    packet.clear();
+    packet.reserve(kHeaderSize + payloadBytes);
+    packet.insert(packet.end(), std::begin(kMagic), std::end(kMagic));
+    AppendWORD(packet, _width);
+    AppendWORD(packet, _height);
+    packet.push_back(encoding);
+    packet.push_back(_options.scale);
+    AppendWORD(packet, 0);
+    AppendDWORD(packet, _sequence);
+    AppendDWORD(packet, (uint32_t)payloadBytes);
+
+    switch (encoding)
+    {
+        case PreviewOptions::RunLength:
+            packet.insert(packet.end(), _runLength.begin(), _runLength.end());
+            break;
+
+        case PreviewOptions::Delta:
+            packet.insert(packet.end(), _delta.begin(), _delta.end());
+            break;
+
+        default:
+            for (const auto& pixel : _current)
+                AppendPixel(packet, pixel);
+            break;
+    }
+
+    _encoded = true;
+}
+
+void PreviewEncoder::Commit(uint32_t nowMillis, size_t bytes)
+{
+    if (_encoded)
+    {
+        std::swap(_current, _previous);
+        _previousWidth  = _width;
+        _previousHeight = _height;
+        _havePrevious   = true;
+        _encoded        = false;
+        _sequence++;
+    }
+
+    _haveSent = true;
+    _lastSentMillis = nowMillis;
+    _stats.framesSent++;
+    _stats.bytesSent += bytes;
+}
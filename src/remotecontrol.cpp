@@ -1001,7 +1001,7 @@ void RemoteControl::handle()
                 #if FULL_COLOR_REMOTE_FILL
                     auto effect = make_shared_psram<ColorFillEffect>("Remote Color", RemoteColorCode.color, 1, true);
                     std::scoped_lock guard(g_render_mutex, g_effect_manager_mutex);
-                    if (effect->Init(g_ptrSystem->GetEffectManager().GetBaseGraphics()))
+                    if (effect->InitTimed(g_ptrSystem->GetEffectManager().GetBaseGraphics()))
                         g_ptrSystem->GetEffectManager().SetTempEffect(effect);
                     else
                         debugE("Could not initialize new color fill effect");
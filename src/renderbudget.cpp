@@ -0,0 +1,110 @@
+//+--------------------------------------------------------------------------
+//
+// File:        renderbudget.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Per-effect draw time budgeting; see renderbudget.h.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include "renderbudget.h"
+
+RenderBudget::RenderBudget(MicrosClock clock)
+    : _clock(clock)
+{
+}
+
+uint32_t RenderBudget::DefaultClock()
+{
+    return micros();
+}
+
+void RenderBudget::BeginDraw()
+{
+    _drawStart = _clock();
+}
+
+uint8_t RenderBudget::EndDraw(uint32_t budgetMicros, uint8_t levels)
+{
+    return NoteFrame(_clock() - _drawStart, budgetMicros, levels);
+}
+
+// NoteFrame
+//
+// The first frame seeds the average outright, so a fresh or restarted loop isn't steered by a ramp up from zero
+
+uint8_t RenderBudget::NoteFrame(uint32_t drawMicros, uint32_t budgetMicros, uint8_t levels)
+{
+    if (levels != _levels)
+    {
+        _levels = levels;
+        _level = levels ? levels - 1 : 0;
+        _averageMicros = drawMicros;
+        _overStreak = _underStreak = 0;
+        _settleFrames = kSettleFrames;
+    }
+    else
+    {
+        _averageMicros = _averageMicros - (_averageMicros >> kSmoothingShift) + (drawMicros >> kSmoothingShift);
+    }
+
+    if (budgetMicros == 0)
+        return _level;
+
+    if (drawMicros > budgetMicros)
+        _misses++;
+
+    if (_settleFrames)
+    {
+        _settleFrames--;
+        return _level;
+    }
+
+    if (_averageMicros > budgetMicros)
+    {
+        _underStreak = 0;
+        if (++_overStreak >= kFramesBeforeDrop && _level > 0)
+        {
+            _level--;
+            _overStreak = 0;
+            _settleFrames = kSettleFrames;
+        }
+    }
+    else if (_averageMicros < (uint64_t)budgetMicros * kHeadroomPercent / 100)
+    {
+        _overStreak = 0;
+        if (++_underStreak >= kFramesBeforeRaise && _level + 1 < _levels)
+        {
+            _level++;
+            _underStreak = 0;
+            _settleFrames = kSettleFrames;
+        }
+    }
+    else
+    {
+        _overStreak = _underStreak = 0;
+    }
+
+    return _level;
+}
@@ -39,6 +39,7 @@
 // showing the IP address, buffer depth, clock, etc.
 
 #include <algorithm>
+#include <cstring>
 #include <ctime>
 #include <map>
 #include <memory>
@@ -452,6 +453,7 @@ class EffectSimulatorPage final : public TitlePage
     BaseFrameEventListener frameEventListener;
     bool bClearCompleted = false;
     uint32_t _lastEffectDrawMs = 0;
+    std::vector<uint16_t> _rowPixels;
 
 public:
     EffectSimulatorPage()
@@ -477,6 +479,7 @@ public:
         if (!bClearCompleted || bRedraw)
         {
             display.fillScreen(BLACK16);
+            display.InvalidateMirrorFrame();
             bClearCompleted = true;
         }
 
@@ -550,6 +553,11 @@ public:
             }
         }
         _lastEffectDrawMs = nowMs;
+
+        // Convert a row at a time and let the screen push only what changed
+        _rowPixels.resize(mw);
+        display.BeginMirrorFrame(mw, mh, xOffset, yOffset, scale);
+
         int ledIndex = 0;
         for (int y = 0; y < mh; ++y)
         {
@@ -570,16 +578,13 @@ public:
                     c = gfx.leds[XY(x, y)];
                 }
 
-                uint16_t c16 = display.to16bit(c);
-                int px = xOffset + x * scale;
-                int py = yOffset + y * scale;
-                // Draw filled rect; subtract 1 to create a fine 1px grid line when scale > 1
-                if (scale > 1)
-                    display.fillRect(px, py, scale - 1, scale - 1, c16);
-                else
-                    display.drawPixel(px, py, c16);
+                _rowPixels[x] = display.to16bit(c);
             }
+
+            display.DrawMirrorRow(y, _rowPixels.data());
         }
+
+        display.EndMirrorFrame();
     }
 };
 
@@ -627,6 +632,93 @@ void Screen::EndFrame()
 {
 }
 
+// BeginMirrorFrame
+//
+// Starts a mirror frame. The pushed frame is only trusted if it was drawn
+// with the same geometry and the display keeps its contents between frames.
+
+void Screen::BeginMirrorFrame(int cols, int rows, int xOffset, int yOffset, int scale)
+{
+    if (cols != _mirrorCols || rows != _mirrorRows || xOffset != _mirrorX || yOffset != _mirrorY || scale != _mirrorScale)
+    {
+        _mirrorCols  = cols;
+        _mirrorRows  = rows;
+        _mirrorX     = xOffset;
+        _mirrorY     = yOffset;
+        _mirrorScale = scale;
+        _mirrorValid = false;
+        _mirrorShadow.assign((size_t)cols * rows, 0);
+    }
+
+    if (!KeepsPreviousFrame())
+        _mirrorValid = false;
+}
+
+// DrawMirrorRow
+//
+// Pushes the cells of one row that differ from the shadow frame, then
+// records them as pushed.
+
+void Screen::DrawMirrorRow(int row, const uint16_t* pixels)
+{
+    if (row < 0 || row >= _mirrorRows)
+        return;
+
+    uint16_t* shadow = &_mirrorShadow[(size_t)row * _mirrorCols];
+
+    int changed = _mirrorCols;
+    if (_mirrorValid)
+    {
+        changed = 0;
+        for (int x = 0; x < _mirrorCols; ++x)
+            changed += pixels[x] != shadow[x];
+
+        if (changed == 0)
+            return;
+    }
+
+    const bool wholeRow = changed * 100 >= _mirrorCols * kMirrorFullRowPercent;
+    const int py = _mirrorY + row * _mirrorScale;
+
+    for (int x = 0; x < _mirrorCols; )
+    {
+        if (!wholeRow && pixels[x] == shadow[x])
+        {
+            ++x;
+            continue;
+        }
+
+        const uint16_t color = pixels[x];
+        const int px = _mirrorX + x * _mirrorScale;
+
+        if (_mirrorScale > 1)
+        {
+            // Subtract 1 to leave a fine 1px grid line between cells
+            fillRect(px, py, _mirrorScale - 1, _mirrorScale - 1, color);
+            ++x;
+            continue;
+        }
+
+        // Without grid lines, neighbouring cells of the same color are one span
+        int end = x + 1;
+        while (end < _mirrorCols && pixels[end] == color)
+            ++end;
+
+        if (end - x == 1)
+            drawPixel(px, py, color);
+        else
+            fillRect(px, py, end - x, 1, color);
+        x = end;
+    }
+
+    memcpy(shadow, pixels, _mirrorCols * sizeof(uint16_t));
+}
+
+void Screen::EndMirrorFrame()
+{
+    _mirrorValid = true;
+}
+
 void Screen::ScreenStatus(const String &strStatus)
 {
     fillScreen(GetBkgndColor());
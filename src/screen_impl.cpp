@@ -40,6 +40,7 @@
             oled.clear();
         }
         void StartFrame() override { oled.clearBuffer(); }
+        bool KeepsPreviousFrame() const override { return false; }
         void EndFrame() override { oled.sendBuffer(); }
         void drawPixel(int16_t x, int16_t y, uint16_t color) override {
             oled.setDrawColor(color == BLACK16 ? 0 : 1);
@@ -0,0 +1,295 @@
+//+--------------------------------------------------------------------------
+//
+// File:        sntpclient.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    SNTP sampling and clock offset estimation; see sntpclient.h.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sys/socket.h>
+
+#include "sntpclient.h"
+
+namespace
+{
+    constexpr uint64_t kUnixToNtpSeconds = 2208988800ULL;  // 1900 to 1970
+
+    constexpr uint8_t  kModeClient = 3;
+    constexpr uint8_t  kModeServer = 4;
+    constexpr uint8_t  kVersion    = 4;
+    constexpr uint8_t  kLeapUnsynchronized = 3;
+
+    constexpr size_t   kOriginOffset   = 24;
+    constexpr size_t   kReceiveOffset  = 32;
+    constexpr size_t   kTransmitOffset = 40;
+
+    uint64_t ReadTimestamp(const uint8_t* data)
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < 8; i++)
+            value = (value << 8) | data[i];
+        return value;
+    }
+
+    void WriteTimestamp(uint8_t* data, uint64_t value)
+    {
+        for (size_t i = 8; i-- > 0; value >>= 8)
+            data[i] = (uint8_t)value;
+    }
+
+    // The seconds field wraps in 2036, which the shift below does for free
+    uint64_t ToNtp(int64_t unixMicros)
+    {
+        const uint64_t seconds = (uint64_t)(unixMicros / 1000000) + kUnixToNtpSeconds;
+        const uint64_t micros  = (uint64_t)(unixMicros % 1000000);
+        return (seconds << 32) | ((micros << 32) / 1000000);
+    }
+
+    // A seconds field with the top bit clear is taken to be past the 2036 wrap, as RFC 4330 suggests
+    int64_t FromNtp(uint64_t timestamp)
+    {
+        uint64_t seconds = timestamp >> 32;
+        if (!(seconds & 0x80000000))
+            seconds += 1ULL << 32;
+
+        const uint64_t micros = ((timestamp & 0xFFFFFFFF) * 1000000) >> 32;
+        return (int64_t)(seconds - kUnixToNtpSeconds) * 1000000 + (int64_t)micros;
+    }
+}
+
+SntpClient::SntpClient(WallClock clock, Correction correct)
+    : _clock(std::move(clock)),
+      _correct(std::move(correct))
+{
+}
+
+void SntpClient::SetSocket(int fd)
+{
+    std::lock_guard guard(_mutex);
+
+    _fd = fd;
+    if (fd < 0 && _busy)
+    {
+        _busy = false;
+        _awaitingReply = false;
+        _stats.failedRounds++;
+    }
+}
+
+int SntpClient::Socket() const
+{
+    std::lock_guard guard(_mutex);
+    return _fd;
+}
+
+bool SntpClient::StartRound(const sockaddr_in& server, uint32_t nowMs)
+{
+    std::lock_guard guard(_mutex);
+
+    if (_busy || _fd < 0)
+        return false;
+
+    _server = server;
+    _busy = true;
+    _attempts = 0;
+    _sampleCount = 0;
+
+    if (!SendRequest(nowMs))
+    {
+        _busy = false;
+        _stats.failedRounds++;
+        return false;
+    }
+    return true;
+}
+
+// SendRequest
+//
+// The transmit timestamp is our send time; the server hands it back as the origin timestamp, which is how a
+// reply is matched to the request it answers.
+
+bool SntpClient::SendRequest(uint32_t nowMs)
+{
+    uint8_t packet[kPacketSize] = {};
+    packet[0] = (kVersion << 3) | kModeClient;
+
+    _sentMicros = _clock();
+    _sentTimestamp = ToNtp(_sentMicros);
+    WriteTimestamp(&packet[kTransmitOffset], _sentTimestamp);
+
+    _attempts++;
+    if (sendto(_fd, packet, sizeof(packet), MSG_DONTWAIT, reinterpret_cast<const sockaddr *>(&_server), sizeof(_server)) != sizeof(packet))
+    {
+        debugW("NTP request could not be sent: %s (%d)", strerror(errno), errno);
+        _awaitingReply = false;
+        return false;
+    }
+
+    _sentMs = nowMs;
+    _awaitingReply = true;
+    return true;
+}
+
+bool SntpClient::OnReadable(uint32_t nowMs)
+{
+    std::lock_guard guard(_mutex);
+
+    uint8_t packet[kPacketSize + 16];
+    while (_fd >= 0)
+    {
+        const auto length = recv(_fd, packet, sizeof(packet), MSG_DONTWAIT);
+        const int64_t receivedMicros = _clock();
+
+        if (length < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+
+        if (!_busy || !_awaitingReply || !AcceptReply(packet, length, receivedMicros))
+        {
+            _stats.rejected++;
+            continue;
+        }
+
+        NextSample(nowMs);
+    }
+    return true;
+}
+
+bool SntpClient::AcceptReply(const uint8_t* packet, size_t length, int64_t receivedMicros)
+{
+    if (length < kPacketSize)
+        return false;
+
+    const uint8_t leap    = packet[0] >> 6;
+    const uint8_t mode    = packet[0] & 0x07;
+    const uint8_t stratum = packet[1];
+
+    // Stratum 0 is a kiss-o'-death; the server is telling us to go away or slow down
+    if (mode != kModeServer || leap == kLeapUnsynchronized || stratum == 0 || stratum > 15)
+        return false;
+
+    if (ReadTimestamp(&packet[kOriginOffset]) != _sentTimestamp)
+        return false;
+
+    const uint64_t received    = ReadTimestamp(&packet[kReceiveOffset]);
+    const uint64_t transmitted = ReadTimestamp(&packet[kTransmitOffset]);
+    if (received == 0 || transmitted == 0)
+        return false;
+
+    const int64_t t1 = _sentMicros;
+    const int64_t t2 = FromNtp(received);
+    const int64_t t3 = FromNtp(transmitted);
+    const int64_t t4 = receivedMicros;
+
+    Sample& sample = _samples[_sampleCount++];
+    sample.offsetMicros = ((t2 - t1) + (t3 - t4)) / 2;
+    sample.delayMicros  = std::max<int64_t>(0, (t4 - t1) - (t3 - t2));
+
+    _awaitingReply = false;
+    _stats.samples++;
+    return true;
+}
+
+void SntpClient::Poll(uint32_t nowMs)
+{
+    std::lock_guard guard(_mutex);
+
+    if (!_busy || !_awaitingReply || nowMs - _sentMs < kReplyTimeoutMs)
+        return;
+
+    _awaitingReply = false;
+    _stats.timeouts++;
+    NextSample(nowMs);
+}
+
+void SntpClient::NextSample(uint32_t nowMs)
+{
+    if (_attempts < kSamplesPerRound && SendRequest(nowMs))
+        return;
+
+    FinishRound(nowMs);
+}
+
+// FinishRound
+//
+// The first sync always steps: the clock starts out at 1970, and there's nothing worth slewing through.
+
+void SntpClient::FinishRound(uint32_t nowMs)
+{
+    _busy = false;
+
+    if (_sampleCount == 0)
+    {
+        _stats.failedRounds++;
+        return;
+    }
+
+    const Sample* best = &_samples[0];
+    for (size_t i = 1; i < _sampleCount; i++)
+        if (_samples[i].delayMicros < best->delayMicros)
+            best = &_samples[i];
+
+    double spread = 0;
+    for (size_t i = 0; i < _sampleCount; i++)
+    {
+        const double difference = (double)(_samples[i].offsetMicros - best->offsetMicros);
+        spread += difference * difference;
+    }
+
+    const bool step = !_stats.synced || std::abs(best->offsetMicros) > kStepMicros;
+
+    _stats.offsetMicros = best->offsetMicros;
+    _stats.delayMicros  = (uint32_t)std::min<int64_t>(best->delayMicros, UINT32_MAX);
+    _stats.jitterMicros = _sampleCount > 1 ? (uint32_t)std::sqrt(spread / (_sampleCount - 1)) : 0;
+    _stats.lastSyncMs   = nowMs;
+    _stats.synced       = true;
+    _stats.rounds++;
+    if (step)
+        _stats.steps++;
+    else
+        _stats.slews++;
+
+    _correct(best->offsetMicros, step);
+}
+
+bool SntpClient::IsBusy() const
+{
+    std::lock_guard guard(_mutex);
+    return _busy;
+}
+
+SntpClient::Stats SntpClient::GetStats() const
+{
+    std::lock_guard guard(_mutex);
+    return _stats;
+}
@@ -0,0 +1,560 @@
+//+--------------------------------------------------------------------------
+//
+// File:        socketreactor.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    select()-based event loop for the device's raw TCP servers; see
+//    socketreactor.h.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#if ENABLE_WIFI
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "nd_network.h"
+#include "socketreactor.h"
+#include "taskmgr.h"   // SOCKET_REACTOR_STACK_SIZE
+
+namespace
+{
+    constexpr uint32_t kListenRetryMs   = 5000;     // After a failed socket/bind/listen
+    constexpr uint32_t kNetworkPollMs   = 500;      // How often to look for WiFi while it's down
+
+    // Deadlines are millis() values, so compare them wrap-safely
+
+    bool IsDue(uint32_t now, uint32_t deadline)
+    {
+        return static_cast<int32_t>(now - deadline) >= 0;
+    }
+
+    uint32_t TimeUntil(uint32_t now, uint32_t deadline)
+    {
+        return IsDue(now, deadline) ? 0 : deadline - now;
+    }
+
+    // fd_set is a fixed-size bitmap; FD_SET() past FD_SETSIZE writes off the
+    // end of it, so a socket numbered that high cannot be waited on at all
+
+    bool FitsInFdSet(int fd)
+    {
+        return fd >= 0 && fd < FD_SETSIZE;
+    }
+}
+
+ITaskService::TaskConfig SocketReactor::GetTaskConfig() const
+{
+    return TaskConfig {
+        "Socket Reactor",
+        SOCKET_REACTOR_STACK_SIZE,
+        SOCKET_PRIORITY,
+        SOCKET_CORE,
+        1500    // Stop timeout: a protocol callback may be mid-send when Stop() is called
+    };
+}
+
+bool SocketReactor::Listen(uint16_t port, ISocketProtocol& protocol, int backlog)
+{
+    {
+        std::lock_guard guard(_mutex);
+
+        for (const auto& listener : _listeners)
+        {
+            if (listener.port != port)
+                continue;
+
+            if (listener.protocol == &protocol)
+                return true;
+
+            debugE("Port %u is already owned by %s", (unsigned)port, listener.protocol->ProtocolName());
+            return false;
+        }
+
+        _listeners.push_back(Listener{ port, backlog, &protocol });
+    }
+
+    Wake();
+    return true;
+}
+
+void SocketReactor::Unlisten(ISocketProtocol& protocol)
+{
+    {
+        std::lock_guard guard(_mutex);
+
+        for (size_t i = _clients.size(); i-- > 0;)
+        {
+            if (i < _clients.size() && _clients[i].protocol == &protocol)
+                CloseClient(i);
+        }
+
+        for (auto it = _listeners.begin(); it != _listeners.end();)
+        {
+            if (it->protocol != &protocol)
+            {
+                ++it;
+                continue;
+            }
+
+            if (it->fd >= 0)
+                close(it->fd);
+            it = _listeners.erase(it);
+        }
+    }
+
+    // The reactor may be sleeping on a descriptor we just closed
+    Wake();
+}
+
+bool SocketReactor::Watch(int fd, ISocketProtocol& protocol)
+{
+    if (!FitsInFdSet(fd) || !nd_network::SetSocketBlockingEnabled(fd, false))
+    {
+        debugE("%s: unable to watch socket %d", protocol.ProtocolName(), fd);
+        close(fd);
+        return false;
+    }
+
+    {
+        std::lock_guard guard(_mutex);
+        _clients.push_back(Client{ fd, &protocol, millis() });
+    }
+
+    Wake();
+    return true;
+}
+
+void SocketReactor::Wake()
+{
+    if (_wakePending.exchange(true))
+        return;
+
+    const int fd = _wakeFd.load();
+    if (fd < 0)
+        return;
+
+    const uint8_t token = 0;
+    if (sendto(fd, &token, sizeof(token), MSG_DONTWAIT, reinterpret_cast<const sockaddr *>(&_wakeAddress), sizeof(_wakeAddress)) < 0)
+        _wakePending.store(false);      // Let the next caller try again
+}
+
+size_t SocketReactor::ClientCount(const ISocketProtocol& protocol) const
+{
+    std::lock_guard guard(_mutex);
+
+    return std::count_if(_clients.begin(), _clients.end(), [&protocol](const Client& client)
+    {
+        return client.protocol == &protocol;
+    });
+}
+
+// OpenWakeSocket
+//
+// A UDP socket bound to loopback that Wake() sends single bytes to. Being an
+// ordinary socket it sits in the same select() set as everything else, which
+// is what lets another task cut a wait short.
+
+bool SocketReactor::OpenWakeSocket()
+{
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+        return false;
+
+    sockaddr_in address = {};
+    address.sin_family      = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port        = 0;                        // Any free port; read back below
+
+    socklen_t length = sizeof(address);
+    if (!FitsInFdSet(fd) ||
+        bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr *>(&address), &length) < 0 ||
+        !nd_network::SetSocketBlockingEnabled(fd, false))
+    {
+        close(fd);
+        return false;
+    }
+
+    _wakeAddress = address;
+    _wakePending.store(false);
+    _wakeFd.store(fd);
+    return true;
+}
+
+void SocketReactor::DrainWakeSocket()
+{
+    // Clear the flag before draining so a Wake() that lands mid-drain still
+    // sends a fresh token rather than being swallowed
+
+    _wakePending.store(false);
+
+    uint8_t tokens[16];
+    while (recv(_wakeFd.load(), tokens, sizeof(tokens), MSG_DONTWAIT) > 0)
+        ;
+}
+
+// OpenListeners
+//
+// (Re)open every listening socket that isn't currently open, unless it
+// failed recently and is still backing off.
+
+void SocketReactor::OpenListeners(uint32_t now)
+{
+    for (auto& listener : _listeners)
+    {
+        if (listener.fd >= 0 || (listener.retryAtMs != 0 && !IsDue(now, listener.retryAtMs)))
+            continue;
+
+        const int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0)
+        {
+            debugE("%s: socket error: %s (%d)", listener.protocol->ProtocolName(), strerror(errno), errno);
+            listener.retryAtMs = now + kListenRetryMs;
+            continue;
+        }
+
+        // When an error occurs, and we close and reopen the port, we need to specify reuse flags
+        // or it might be too soon to use the port again, since close doesn't actually close it
+        // until the socket is no longer in use.
+
+        int opt = 1;
+        sockaddr_in address = {};
+        address.sin_family      = AF_INET;
+        address.sin_addr.s_addr = INADDR_ANY;
+        address.sin_port        = htons(listener.port);
+
+        if (!FitsInFdSet(fd) ||
+            !nd_network::SetSocketBlockingEnabled(fd, false) ||
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0 ||
+            bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+            listen(fd, listener.backlog) < 0)
+        {
+            debugE("%s: unable to listen on port %u, socket %d: %s (%d)",
+                   listener.protocol->ProtocolName(), (unsigned)listener.port, fd, strerror(errno), errno);
+            close(fd);
+            listener.retryAtMs = now + kListenRetryMs;
+            continue;
+        }
+
+        listener.fd = fd;
+        listener.retryAtMs = 0;
+        debugI("%s listening on port %u", listener.protocol->ProtocolName(), (unsigned)listener.port);
+    }
+}
+
+// AcceptClients
+//
+// Take connections off the listener's backlog until it's empty or the
+// protocol is full.
+
+void SocketReactor::AcceptClients(size_t listenerIndex, uint32_t now)
+{
+    const uint16_t   port     = _listeners[listenerIndex].port;
+    ISocketProtocol* protocol = _listeners[listenerIndex].protocol;
+
+    // OnConnect may unregister the protocol, taking its listener with it, so
+    // look the listener up again on every pass rather than holding on to it
+
+    auto findListener = [this, port, protocol]() -> Listener*
+    {
+        for (auto& listener : _listeners)
+            if (listener.port == port && listener.protocol == protocol && listener.fd >= 0)
+                return &listener;
+        return nullptr;
+    };
+
+    for (Listener* pListener = findListener();
+         pListener != nullptr && ClientCount(*protocol) < protocol->MaxClients();
+         pListener = findListener())
+    {
+        sockaddr_in peer = {};
+        socklen_t peerLength = sizeof(peer);
+
+        const int fd = accept(pListener->fd, reinterpret_cast<sockaddr *>(&peer), &peerLength);
+        if (fd < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                // Drop the listener and let OpenListeners bring it back
+                debugW("%s: accept failed: %s (%d)", protocol->ProtocolName(), strerror(errno), errno);
+                close(pListener->fd);
+                pListener->fd = -1;
+                pListener->retryAtMs = now + kListenRetryMs;
+            }
+            return;
+        }
+
+        if (!FitsInFdSet(fd) || !nd_network::SetSocketBlockingEnabled(fd, false))
+        {
+            debugE("%s: unable to service client socket %d", protocol->ProtocolName(), fd);
+            close(fd);
+            continue;
+        }
+
+        debugI("%s client connected from %s", protocol->ProtocolName(), inet_ntoa(peer.sin_addr));
+
+        _clients.push_back(Client{ fd, protocol, now });
+        if (!protocol->OnConnect(fd, peer))
+        {
+            auto it = std::find_if(_clients.begin(), _clients.end(), [fd](const Client& client) { return client.fd == fd; });
+            if (it != _clients.end())
+                CloseClient(it - _clients.begin());
+        }
+    }
+}
+
+void SocketReactor::CloseClient(size_t index)
+{
+    // Remove the entry first so the protocol sees the updated client count
+    const Client client = _clients[index];
+    _clients.erase(_clients.begin() + index);
+
+    client.protocol->OnDisconnect(client.fd);
+    close(client.fd);
+
+    debugI("%s client disconnected", client.protocol->ProtocolName());
+}
+
+void SocketReactor::CloseAll()
+{
+    std::lock_guard guard(_mutex);
+
+    while (!_clients.empty())
+        CloseClient(_clients.size() - 1);
+
+    for (auto& listener : _listeners)
+    {
+        if (listener.fd >= 0)
+            close(listener.fd);
+        listener.fd = -1;
+        listener.retryAtMs = 0;
+    }
+
+    _networkUp = false;
+}
+
+// SocketReactor::Run
+//
+// Each pass builds the descriptor sets from the current listeners and
+// clients, sleeps in select() until something is ready, a deadline (idle
+// timeout, listen retry) comes due or Wake() is called, and then dispatches
+// whatever is ready. Callbacks can add and remove clients and listeners, so
+// dispatch re-finds each client by fd rather than holding on to iterators.
+
+void SocketReactor::Run()
+{
+    if (!OpenWakeSocket())
+        debugW("Socket reactor could not open its wake socket; polling every %dms instead", SOCKET_REACTOR_POLL_MS);
+
+    struct ReadyClient
+    {
+        int              fd;
+        ISocketProtocol* protocol;
+        bool             readable;
+        bool             writable;
+    };
+    std::vector<ReadyClient> ready;
+
+    while (!ShouldShutdown())
+    {
+        fd_set readSet;
+        fd_set writeSet;
+        FD_ZERO(&readSet);
+        FD_ZERO(&writeSet);
+        int maxFd = -1;
+        uint32_t timeoutMs = SOCKET_REACTOR_IDLE_MS;
+
+        auto watch = [&maxFd](int fd, fd_set& set)
+        {
+            FD_SET(fd, &set);
+            maxFd = std::max(maxFd, fd);
+        };
+
+        {
+            std::lock_guard guard(_mutex);
+            const uint32_t now = millis();
+
+            const bool networkUp = nd_network::IsWiFiConnected();
+            if (networkUp != _networkUp)
+            {
+                if (!networkUp)
+                    CloseAll();
+                _networkUp = networkUp;
+            }
+
+            if (_networkUp)
+            {
+                OpenListeners(now);
+
+                for (const auto& listener : _listeners)
+                {
+                    if (listener.fd >= 0 && ClientCount(*listener.protocol) < listener.protocol->MaxClients())
+                        watch(listener.fd, readSet);
+                    else if (listener.fd < 0 && listener.retryAtMs != 0)
+                        timeoutMs = std::min(timeoutMs, TimeUntil(now, listener.retryAtMs));
+                }
+
+                for (const auto& client : _clients)
+                {
+                    watch(client.fd, readSet);
+                    if (client.protocol->WantsWrite(client.fd))
+                        watch(client.fd, writeSet);
+
+                    const uint32_t idleTimeoutMs = client.protocol->IdleTimeoutMs();
+                    if (idleTimeoutMs != 0)
+                        timeoutMs = std::min(timeoutMs, TimeUntil(now, client.lastActivityMs + idleTimeoutMs));
+                }
+            }
+            else
+            {
+                timeoutMs = std::min(timeoutMs, kNetworkPollMs);
+            }
+        }
+
+        const int wakeFd = _wakeFd.load();
+        if (wakeFd >= 0)
+            watch(wakeFd, readSet);
+        else
+            timeoutMs = std::min<uint32_t>(timeoutMs, SOCKET_REACTOR_POLL_MS);
+
+        if (ShouldShutdown())
+            break;
+
+        timeval timeout;
+        timeout.tv_sec  = timeoutMs / 1000;
+        timeout.tv_usec = (timeoutMs % 1000) * 1000;
+
+        const int result = select(maxFd + 1, &readSet, &writeSet, nullptr, &timeout);
+        if (result < 0)
+        {
+            // EBADF means Unlisten() closed a socket we were waiting on; the
+            // next pass rebuilds the sets without it
+            if (errno != EINTR && errno != EBADF)
+            {
+                debugW("Socket reactor select failed: %s (%d)", strerror(errno), errno);
+                delay(10);
+            }
+            continue;
+        }
+
+        std::lock_guard guard(_mutex);
+        const uint32_t now = millis();
+
+        if (wakeFd >= 0 && FD_ISSET(wakeFd, &readSet))
+            DrainWakeSocket();
+
+        if (result > 0)
+        {
+            // Snapshot which clients are ready before any callback can reshuffle _clients
+
+            ready.clear();
+            for (const auto& client : _clients)
+            {
+                const bool readable = FD_ISSET(client.fd, &readSet);
+                const bool writable = FD_ISSET(client.fd, &writeSet);
+                if (readable || writable)
+                    ready.push_back(ReadyClient{ client.fd, client.protocol, readable, writable });
+            }
+
+            for (size_t i = 0; i < _listeners.size(); i++)
+            {
+                if (_listeners[i].fd >= 0 && FD_ISSET(_listeners[i].fd, &readSet))
+                    AcceptClients(i, now);
+            }
+
+            auto findClient = [this](const ReadyClient& event) -> int
+            {
+                for (size_t i = 0; i < _clients.size(); i++)
+                    if (_clients[i].fd == event.fd && _clients[i].protocol == event.protocol)
+                        return (int)i;
+                return -1;
+            };
+
+            for (const auto& event : ready)
+            {
+                int index = findClient(event);
+                if (index >= 0 && event.readable)
+                {
+                    _clients[index].lastActivityMs = now;
+                    if (!event.protocol->OnReadable(event.fd))
+                    {
+                        index = findClient(event);
+                        if (index >= 0)
+                            CloseClient(index);
+                        continue;
+                    }
+                    index = findClient(event);
+                }
+
+                if (index >= 0 && event.writable && !event.protocol->OnWritable(event.fd))
+                {
+                    index = findClient(event);
+                    if (index >= 0)
+                        CloseClient(index);
+                }
+            }
+        }
+
+        for (size_t i = _clients.size(); i-- > 0;)
+        {
+            if (i >= _clients.size())
+                continue;
+
+            const uint32_t idleTimeoutMs = _clients[i].protocol->IdleTimeoutMs();
+            if (idleTimeoutMs != 0 && IsDue(now, _clients[i].lastActivityMs + idleTimeoutMs))
+            {
+                debugW("%s client idle for %lums, closing", _clients[i].protocol->ProtocolName(), (unsigned long)idleTimeoutMs);
+                CloseClient(i);
+            }
+        }
+    }
+
+    CloseAll();
+
+    const int wakeFd = _wakeFd.exchange(-1);
+    if (wakeFd >= 0)
+        close(wakeFd);
+}
+
+void SocketReactor::OnAfterStop()
+{
+    // Normally Run() has already done this; covers the force-delete path
+
+    CloseAll();
+
+    const int wakeFd = _wakeFd.exchange(-1);
+    if (wakeFd >= 0)
+        close(wakeFd);
+}
+
+#endif // ENABLE_WIFI
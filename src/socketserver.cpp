@@ -35,9 +35,9 @@
 #include "socketserver.h"
 #include "soundanalyzer.h"
 #include "systemcontainer.h"
-#include "taskmgr.h"   // SOCKET_STACK_SIZE / SOCKET_PRIORITY / SOCKET_CORE
 #include "values.h"
 
+#include <algorithm>
 #include <arpa/inet.h>
 #include <cerrno>
 #include <cstdio>
@@ -47,7 +47,6 @@
 #include <mutex>
 #include <netinet/in.h>
 #include <sys/socket.h>
-#include <sys/time.h>
 #include <unistd.h>
 
 extern "C"
@@ -75,192 +74,160 @@ namespace
 
 SocketServer::SocketServer(int port, int numLeds) :
     _port(port),
-    _numLeds(numLeds),
-    _cbReceived(0)
+    _numLeds(numLeds)
 {
     _abOutputBuffer = make_unique_psram<uint8_t[]>(MAXIMUM_PACKET_SIZE + 1);                    // +1 for uzlib one byte overreach bug
-    memset(&_address, 0, sizeof(_address));
 }
 
-// ITaskService hooks
+// SocketServer::Start
 //
-// Start/Stop/IsRunning are inherited final from ITaskService; this class only
-// supplies the task config, the accept loop body, and the listening-socket
-// shutdown nudge that breaks accept() out of its blocking call.
+// Hands our port to the socket reactor, which opens it once WiFi is up and
+// calls back into the ISocketProtocol methods below as senders connect and
+// data arrives.
 
-ITaskService::TaskConfig SocketServer::GetTaskConfig() const
+bool SocketServer::Start()
 {
-    return TaskConfig {
-        "Socket Server Loop",
-        SOCKET_STACK_SIZE,
-        SOCKET_PRIORITY,
-        SOCKET_CORE,
-        1500   // Stop timeout: accept() can block for ~1s before returning EBADF.
-    };
-}
+    if (_running.load())
+        return true;
 
-void SocketServer::OnBeforeWaitForStop()
-{
-    // Closing the listening socket from this thread breaks the task out of
-    // any blocking accept/read call so it can see ShouldShutdown() promptly.
-    release();
+    _pReactor = &g_ptrSystem->GetSocketReactor();
+    if (!_pReactor->Listen(_port, *this, 6))
+        return false;
+
+    _running.store(true);
+    return true;
 }
 
-// SocketServer::Run
-//
-// Repeatedly opens the socket and processes incoming connections. Runs until
-// ShouldShutdown() is true; ITaskService::TaskEntryThunk handles the actual
-// vTaskDelete and the running-state bookkeeping when this returns.
-void SocketServer::Run()
+void SocketServer::Stop()
 {
-    while (!ShouldShutdown())
-    {
-        if (nd_network::IsWiFiConnected())
-        {
-            release();
-            if (ShouldShutdown())
-                break;
-
-            if (begin())
-            {
-                ProcessIncomingConnectionsLoop();
-                debugV("Socket connection closed.  Retrying...");
-            }
-            else
-            {
-                debugE("Failed to start socket server, retrying in 5 seconds...");
-                delay(5000);
-            }
-        }
-        delay(500);
-    }
+    if (!_running.exchange(false))
+        return;
 
-    // Drop the listening socket if Stop() didn't already, so we leave the
-    // service in a clean state regardless of which path we exited through.
-    release();
+    // Closes every sender, so OnDisconnect releases their buffers
+    _pReactor->Unlisten(*this);
 }
 
-void SocketServer::release()
+SocketServer::Connection* SocketServer::FindConnection(int fd)
 {
-    _pBuffer.reset();
-    // Atomic exchange: only the caller that observed a non-negative fd does
-    // the close(). The other (Run loop vs. OnBeforeWaitForStop) sees -1 and
-    // becomes a no-op, eliminating a double-close race.
-    int fd = _server_fd.exchange(-1);
-    if (fd >= 0)
-        close(fd);
+    auto it = std::find_if(_connections.begin(), _connections.end(), [fd](const Connection& connection) { return connection.fd == fd; });
+    return it == _connections.end() ? nullptr : &(*it);
 }
 
-bool SocketServer::begin()
+void SocketServer::ResetConnection(Connection& connection)
 {
-    _pBuffer = make_unique_psram<uint8_t[]>(MAXIMUM_PACKET_SIZE);
-    _cbReceived = 0;
-
-    // Build the socket on a local fd and only publish it into the atomic
-    // _server_fd member after listen() succeeds. That keeps release() (which
-    // can run on a different thread via OnBeforeWaitForStop) from closing a
-    // half-configured descriptor or racing with bind/listen.
-
-    int fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (fd < 0)
-    {
-        debugE("socket error\n");
-        _pBuffer.reset();
-        return false;
-    }
-
-    nd_network::SetSocketBlockingEnabled(fd, false);
-
-    // When an error occurs, and we close and reopen the port, we need to specify reuse flags
-    // or it might be too soon to use the port again, since close doesn't actually close it
-    // until the socket is no longer in use.
-
-    int opt = 1;
-    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)))
-    {
-        debugE("setsockopt SO_REUSEADDR failed on socket %d: %s (%d)", fd, strerror(errno), errno);
-        close(fd);
-        _pBuffer.reset();
-        return false;
-    }
+    _cbReceived -= connection.cbReceived;
+    connection.cbReceived   = 0;
+    connection.cbNeeded     = STANDARD_DATA_HEADER_SIZE;
+    connection.headerParsed = false;
+}
 
-    memset(&_address, 0, sizeof(_address));
-    _address.sin_family = AF_INET;
-    _address.sin_addr.s_addr = INADDR_ANY;
-    _address.sin_port = htons( _port );
+bool SocketServer::OnConnect(int fd, const sockaddr_in& peer)
+{
+    debugV("Incoming connection from: %s", inet_ntoa(peer.sin_addr));
 
-    if (bind(fd, (struct sockaddr *)&_address, sizeof(_address)) < 0)       // Bind socket to port
-    {
-        debugE("bind failed on port %d, socket %d: %s (%d)", _port, fd, strerror(errno), errno);
-        close(fd);
-        _pBuffer.reset();
-        return false;
-    }
-    if (listen(fd, 6) < 0)                                                  // Start listening for connections
+    auto pBuffer = make_unique_psram<uint8_t[]>(MAXIMUM_PACKET_SIZE);
+    if (pBuffer == nullptr || _abOutputBuffer == nullptr)
     {
-        debugE("listen failed on port %d, socket %d: %s (%d)", _port, fd, strerror(errno), errno);
-        close(fd);
-        _pBuffer.reset();
+        debugE("Buffer not allocated!");
         return false;
     }
 
-    _server_fd.store(fd);
-    debugI("Socket server %d listening on port %d", fd, _port);
+    _connections.push_back(Connection{ fd, std::move(pBuffer) });
     return true;
 }
 
-void SocketServer::ResetReadBuffer()
+void SocketServer::OnDisconnect(int fd)
 {
-    _cbReceived = 0;
-    memset(_pBuffer.get(), 0, MAXIMUM_PACKET_SIZE);
+    auto it = std::find_if(_connections.begin(), _connections.end(), [fd](const Connection& connection) { return connection.fd == fd; });
+    if (it == _connections.end())
+        return;
+
+    ResetConnection(*it);
+    _connections.erase(it);
 }
 
-// ReadUntilNBytesReceived
+// OnReadable
 //
-// Read from the socket until the buffer contains at least cbNeeded bytes
+// Reads whatever the sender has delivered into its buffer, never past the end
+// of the packet in progress. The header is read first; once it has been
+// validated we know how much more to wait for. At most one packet is handled
+// per call so a sender streaming flat out can't starve the other sockets -
+// select() reports the socket again straight away if more is waiting.
 
-bool SocketServer::ReadUntilNBytesReceived(size_t socket, size_t cbNeeded)
+bool SocketServer::OnReadable(int fd)
 {
-    if (cbNeeded <= _cbReceived)                            // If we already have that many bytes, we're already done
-    {
-        debugV("Already had enough data to satisfy read: requested %d, had %d", cbNeeded, _cbReceived);
-        return true;
-    }
-
-    // This test caps maximum packet size as a full buffer read of LED data.  If other packets wind up being longer,
-    // the buffer itself and this test might need to change
-
-    if (cbNeeded > MAXIMUM_PACKET_SIZE)
-    {
-        debugE("Unexpected request for %d bytes in ReadUntilNBytesReceived\n", cbNeeded);
+    Connection* pConnection = FindConnection(fd);
+    if (pConnection == nullptr)
         return false;
-    }
 
-    do
+    Connection& connection = *pConnection;
+
+    while (true)
     {
-        // If we're reading at a point in the buffer more than just the header, we're actually transferring data, so light up the LED
+        int cbRead = recv(fd, connection.pBuffer.get() + connection.cbReceived, connection.cbNeeded - connection.cbReceived, MSG_DONTWAIT);
 
-        // Read data from the socket until we have _bcNeeded bytes in the buffer
+        if (cbRead == 0)
+        {
+            debugV("Socket connection closed by sender");
+            return false;
+        }
 
-        int cbRead = 0;
-        do
+        if (cbRead < 0)
         {
-            cbRead = read(socket, (uint8_t *) _pBuffer.get() + _cbReceived, cbNeeded - _cbReceived);
-        } while (cbRead < 0 && errno == EINTR);
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return true;
+
+            debugE("ERROR: read failed with %zu of %zu bytes received: %s", connection.cbReceived, connection.cbNeeded, strerror(errno));
+            return false;
+        }
 
-        // Restore the old state
+        connection.cbReceived += cbRead;
+        _cbReceived += cbRead;
 
-        if (cbRead > 0)
+        if (connection.cbReceived < connection.cbNeeded)
+            continue;
+
+        // Now that we have the header we can see how much more data is expected to follow
+
+        if (!connection.headerParsed)
         {
-            _cbReceived += cbRead;
+            const size_t packetSize = PacketSizeFromHeader(connection.pBuffer.get());
+            if (packetSize == 0)
+                return false;
+
+            connection.headerParsed = true;
+            connection.cbNeeded = std::max(packetSize, (size_t)STANDARD_DATA_HEADER_SIZE);
+            debugV("Expecting %zu total bytes", connection.cbNeeded);
+
+            if (connection.cbReceived < connection.cbNeeded)
+                continue;
         }
-        else
+
+        #if ENABLE_WIRE_CAPTURE
+            if (_capturing.load())
+                _pCapture->Record(connection.pBuffer.get(), connection.cbReceived, micros());
+        #endif
+
+        bool bSendResponsePacket = false;
+        bool processed;
         {
-            debugE("ERROR: %d bytes read in ReadUntilNBytesReceived trying to read %d\n", cbRead, cbNeeded-_cbReceived);
-            return false;
+            std::lock_guard guard(_ingestMutex);
+            processed = ProcessPacket(connection.pBuffer, connection.cbReceived, bSendResponsePacket);
         }
-    } while (_cbReceived < cbNeeded);
-    return true;
+
+        // Whether or not it worked, the packet has been consumed
+        ResetConnection(connection);
+
+        if (!processed)
+            return false;
+
+        if (bSendResponsePacket)
+            SendResponsePacket(fd);
+
+        return true;
+    }
 }
 
 // DecompressBuffer
@@ -314,305 +281,244 @@ bool SocketServer::DecompressBuffer(const uint8_t * pBuffer, size_t cBuffer, uin
     return true;
 }
 
-// ProcessIncomingConnectionsLoop
-//
-// Socket server main ProcessIncomingConnectionsLoop - accepts new connections and reads from them, dispatching
-// data packets into our buffer and closing the socket if anything goes weird.
-
-bool SocketServer::ProcessIncomingConnectionsLoop()
+size_t SocketServer::PacketSizeFromHeader(const uint8_t * pHeader) const
 {
-    int listen_fd = _server_fd.load();
-    if (0 >= listen_fd)
+    const uint32_t header = DWORDFromMemory(&pHeader[0]);
+    if (header == COMPRESSED_HEADER)
     {
-        debugE("No _server_fd, returning.");
-        return false;
+        uint32_t compressedSize = DWORDFromMemory(&pHeader[4]);
+        uint32_t expandedSize   = DWORDFromMemory(&pHeader[8]);
+        uint32_t reserved       = DWORDFromMemory(&pHeader[12]);
+        debugV("Compressed Header: compressedSize: %lu, expandedSize: %lu, reserved: %lu", (unsigned long)compressedSize, (unsigned long)expandedSize, (unsigned long)reserved);
+
+        // Check the addition before trusting it; an overflowed header+payload
+        // size can wrap back below MAXIMUM_PACKET_SIZE and make us under-read
+        // a malformed packet.
+
+        size_t compressedPacketSize = 0;
+        if (!CheckedAdd(COMPRESSED_HEADER_SIZE, compressedSize, compressedPacketSize) ||
+            compressedPacketSize > MAXIMUM_PACKET_SIZE ||
+            expandedSize > MAXIMUM_PACKET_SIZE)
+        {
+            debugE("Compressed packet sizes are invalid: compressed=%lu expanded=%lu max=%lu",
+                   (unsigned long)compressedSize, (unsigned long)expandedSize, (unsigned long)MAXIMUM_PACKET_SIZE);
+            return 0;
+        }
+        return compressedPacketSize;
     }
 
-    int new_socket = -1;
+    const uint16_t command16 = WORDFromMemory(&pHeader[0]);
+    size_t totalExpected = 0;
 
-    // Accept loop: wait for an incoming connection, sleeping between polls to avoid busy-spinning
-    socklen_t addrlen = sizeof(_address);
-    while (new_socket < 0)
+    if (command16 == WIFI_COMMAND_PEAKDATA)
     {
-        // Re-read each iteration so a release() from another thread (Stop)
-        // is observed as -1 and we exit promptly via EBADF/-1 fall-through.
-        listen_fd = _server_fd.load();
-        if (listen_fd < 0)
-            return false;
-        new_socket = accept(listen_fd, (struct sockaddr *)&_address, &addrlen);
-        if (new_socket < 0)
+        uint16_t numbands  = WORDFromMemory(&pHeader[2]);
+        uint32_t length32  = DWORDFromMemory(&pHeader[4]);
+        uint64_t seconds   = ULONGFromMemory(&pHeader[8]);
+        uint64_t micros    = ULONGFromMemory(&pHeader[16]);
+
+        debugV("PeakData Header: numbands=%u, length=%lu, seconds=%llu, micro=%llu", numbands, (unsigned long)length32, seconds, micros);
+
+        if (!CheckedStandardPacketSize(length32, sizeof(uint8_t), totalExpected) ||
+            totalExpected > MAXIMUM_PACKET_SIZE)
         {
-            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            debugE("Invalid peak data packet: bands=%u length=%lu total=%zu",
+                   (unsigned int)numbands, (unsigned long)length32, totalExpected);
+            return 0;
+        }
+
+        #if ENABLE_AUDIO
+            if (numbands != NUM_BANDS)
             {
-                delay(100); // No connection yet, yield and retry
-                continue;
+                debugE("Invalid peak data packet: bands=%u, expected %d", (unsigned int)numbands, (int)NUM_BANDS);
+                return 0;
             }
-            debugE("Socket server %d failed to accept connection: %s (%d)", listen_fd, strerror(errno), errno);
-            return false;
-        }
-    }
 
-    // Report where this connection is coming from
+            if (length32 != numbands * sizeof(float))
+            {
+                debugE("Expecting %zu bytes for %d audio bands, but received %lu.  Ensure float size and endianness matches between sender and receiver systems.",
+                       (size_t)(numbands * sizeof(float)), (int)NUM_BANDS, (unsigned long)length32);
+                return 0;
+            }
+        #endif
 
-    struct sockaddr_in addr;
-    socklen_t addr_size = sizeof(struct sockaddr_in);
-    if (0 != getpeername(new_socket, (struct sockaddr *)&addr, &addr_size))
-    {
-        close(new_socket);
-        ResetReadBuffer();
-        return false;
+        return totalExpected;
     }
 
-    debugV("Incoming connection from: %s", inet_ntoa(addr.sin_addr));
+    if (command16 == WIFI_COMMAND_PIXELDATA64)
+    {
+        // We know it's pixel data, so we do some validation before accepting it
 
-    // Set a timeout of 3 seconds on the socket so we don't permanently hang on a corrupt or partial packet
+        uint16_t channel16 = WORDFromMemory(&pHeader[2]);
+        uint32_t length32  = DWORDFromMemory(&pHeader[4]);
+        uint64_t seconds   = ULONGFromMemory(&pHeader[8]);
+        uint64_t micros    = ULONGFromMemory(&pHeader[16]);
 
-    struct timeval to;
-    to.tv_sec = 3;
-    to.tv_usec = 0;
-    if (setsockopt(new_socket,SOL_SOCKET,SO_RCVTIMEO,&to,sizeof(to)) < 0)
-    {
-        debugE("Unable to set read timeout on socket!");
-        close(new_socket);
-        ResetReadBuffer();
-        return false;
-    }
+        debugV("Uncompressed Header: channel16=%u, length=%lu, seconds=%llu, micro=%llu", channel16, (unsigned long)length32, seconds, micros);
 
-    if (_pBuffer == nullptr)
-    {
-        debugE("Buffer not allocated!");
-        close(new_socket);
-        ResetReadBuffer();
-        return false;
+        if (!CheckedStandardPacketSize(length32, LED_DATA_SIZE, totalExpected) ||
+            totalExpected > MAXIMUM_PACKET_SIZE)
+        {
+            debugE("Too many bytes promised (%zu) - more than we can use for our LEDs at max packet (%lu)\n", (size_t)totalExpected, (unsigned long)MAXIMUM_PACKET_SIZE);
+            return 0;
+        }
+        return totalExpected;
     }
 
-    // Ensure the new_socket is valid
-    if (new_socket < 0) {
-        debugE("Invalid socket!");
-        ResetReadBuffer();
-        return false;
-    }
+    debugE("Unknown command in packet received: %u\n", command16);
+    return 0;
+}
 
-    do
-    {
-        bool bSendResponsePacket = false;
+// ProcessPacket
+//
+// Dispatches one complete packet sitting in a MAXIMUM_PACKET_SIZE buffer.  Called with _ingestMutex held.
 
-            // Read until we have at least enough for the data header
+bool SocketServer::ProcessPacket(allocated_unique_ptr<uint8_t []>& pBuffer, size_t cbPacket, bool& bSendResponsePacket)
+{
+    const uint32_t header = DWORDFromMemory(&pBuffer[0]);
 
-        if (false == ReadUntilNBytesReceived(new_socket, STANDARD_DATA_HEADER_SIZE))
+    if (header == COMPRESSED_HEADER)
+    {
+        uint32_t compressedSize = DWORDFromMemory(&pBuffer[4]);
+        uint32_t expandedSize   = DWORDFromMemory(&pBuffer[8]);
+
+        // If our buffer is in PSRAM it would be expensive to decompress in place, as the SPIRAM doesn't like
+        // non-linear access from what I can tell.  I bet it must send addr+len to request each unique read, so
+        // one big read one time would work best, and we use that to copy it to a regular RAM buffer.
+
+        #if USE_PSRAM
+            auto _abTempBuffer = make_unique_internal<uint8_t[]>(MAXIMUM_PACKET_SIZE + 1);    // Plus one for uzlib buffer overreach bug
+            memcpy(_abTempBuffer.get(), pBuffer.get(), MAXIMUM_PACKET_SIZE);
+            auto pSourceBuffer = &_abTempBuffer[COMPRESSED_HEADER_SIZE];
+        #else
+            auto pSourceBuffer = &pBuffer[COMPRESSED_HEADER_SIZE];
+        #endif
+
+        if (!DecompressBuffer(pSourceBuffer, compressedSize, _abOutputBuffer.get(), expandedSize))
         {
-            debugE("Read error in getting header.\n");
-            break;
+            debugE("Error decompressing data\n");
+            return false;
         }
 
-        // Now that we have the header we can see how much more data is expected to follow
-
-        const uint32_t header  = _pBuffer[3] << 24  | _pBuffer[2] << 16  | _pBuffer[1] << 8  | _pBuffer[0];
-        if (header == COMPRESSED_HEADER)
+        if (false == ProcessIncomingData(_abOutputBuffer, expandedSize))
         {
-            uint32_t compressedSize = _pBuffer[7] << 24  | _pBuffer[6] << 16  | _pBuffer[5] << 8  | _pBuffer[4];
-            uint32_t expandedSize   = _pBuffer[11] << 24 | _pBuffer[10] << 16 | _pBuffer[9] << 8  | _pBuffer[8];
-            uint32_t reserved       = _pBuffer[15] << 24 | _pBuffer[14] << 16 | _pBuffer[13] << 8 | _pBuffer[12];
-            debugV("Compressed Header: compressedSize: %lu, expandedSize: %lu, reserved: %lu", (unsigned long)compressedSize, (unsigned long)expandedSize, (unsigned long)reserved);
-
-            size_t compressedPacketSize = 0;
-            if (!CheckedAdd(COMPRESSED_HEADER_SIZE, compressedSize, compressedPacketSize) ||
-                compressedPacketSize > MAXIMUM_PACKET_SIZE ||
-                expandedSize > MAXIMUM_PACKET_SIZE)
-            {
-                debugE("Compressed packet sizes are invalid: compressed=%lu expanded=%lu max=%lu",
-                       (unsigned long)compressedSize, (unsigned long)expandedSize, (unsigned long)MAXIMUM_PACKET_SIZE);
-                break;
-            }
+            debugE("Error processing data\n");
+            return false;
+        }
 
-            // Check addition before ReadUntilNBytesReceived; an overflowed
-            // header+payload size can wrap back below MAXIMUM_PACKET_SIZE and
-            // make the socket reader under-read a malformed packet.
-            if (false == ReadUntilNBytesReceived(new_socket, compressedPacketSize))
-            {
-                debugE("Could not read compressed data from stream\n");
-                break;
-            }
-            debugV("Successfully read %zu bytes", compressedPacketSize);
+        bSendResponsePacket = true;
+        return true;
+    }
 
-            // If our buffer is in PSRAM it would be expensive to decompress in place, as the SPIRAM doesn't like
-            // non-linear access from what I can tell.  I bet it must send addr+len to request each unique read, so
-            // one big read one time would work best, and we use that to copy it to a regular RAM buffer.
+    const uint16_t command16 = WORDFromMemory(&pBuffer[0]);
 
-            #if USE_PSRAM
-                auto _abTempBuffer = make_unique_internal<uint8_t[]>(MAXIMUM_PACKET_SIZE + 1);    // Plus one for uzlib buffer overreach bug
-                memcpy(_abTempBuffer.get(), _pBuffer.get(), MAXIMUM_PACKET_SIZE);
-                auto pSourceBuffer = &_abTempBuffer[COMPRESSED_HEADER_SIZE];
-            #else
-                auto pSourceBuffer = &_pBuffer[COMPRESSED_HEADER_SIZE];
-            #endif
+    if (command16 == WIFI_COMMAND_PEAKDATA)
+    {
+        #if ENABLE_AUDIO
+            return ProcessIncomingData(pBuffer, cbPacket);
+        #else
+            // Audio disabled: the payload has been read to keep the stream in sync; ignore it
+            debugV("Audio disabled; skipped PEAKDATA payload (%zu bytes)", cbPacket);
+            return true;
+        #endif
+    }
 
-            if (!DecompressBuffer(pSourceBuffer, compressedSize, _abOutputBuffer.get(), expandedSize))
-            {
-                debugE("Error decompressing data\n");
-                break;
-            }
+    // PacketSizeFromHeader only lets pixel data through otherwise; add it to the buffer ring
 
-            if (false == ProcessIncomingData(_abOutputBuffer, expandedSize))
-            {
-                debugE("Error processing data\n");
-                break;
+    if (false == ProcessIncomingData(pBuffer, cbPacket))
+    {
+        debugE("Error in processing pixel data from wifi\n");
+        return false;
+    }
 
-            }
-            ResetReadBuffer();
-            bSendResponsePacket = true;
-        }
-        else
-        {
-            // Read the rest of the data
-            uint16_t command16   = WORDFromMemory(&_pBuffer.get()[0]);
+    bSendResponsePacket = true;
+    return true;
+}
 
-            if (command16 == WIFI_COMMAND_PEAKDATA)
-            {
-                #if ENABLE_AUDIO
-                {
-                    uint16_t numbands  = WORDFromMemory(&_pBuffer.get()[2]);
-                    uint32_t length32  = DWORDFromMemory(&_pBuffer.get()[4]);
-                    uint64_t seconds   = ULONGFromMemory(&_pBuffer.get()[8]);
-                    uint64_t micros    = ULONGFromMemory(&_pBuffer.get()[16]);
-
-                    size_t totalExpected = 0;
-
-                    debugV("PeakData Header: numbands=%u, length=%lu, seconds=%llu, micro=%llu", numbands, (unsigned long)length32, seconds, micros);
-
-                    if (!CheckedStandardPacketSize(length32, sizeof(uint8_t), totalExpected) ||
-                        totalExpected > MAXIMUM_PACKET_SIZE ||
-                        numbands != NUM_BANDS)
-                    {
-                        debugE("Invalid peak data packet: bands=%u length=%lu total=%zu",
-                               (unsigned int)numbands, (unsigned long)length32, totalExpected);
-                        break;
-                    }
-
-                    if (length32 != numbands * sizeof(float))
-                    {
-                        debugE("Expecting %zu bytes for %d audio bands, but received %zu.  Ensure float size and endianness matches between sender and receiver systems.", (size_t)totalExpected, (int)NUM_BANDS, (size_t)_cbReceived);
-                        break;
-                    }
-
-                    if (false == ReadUntilNBytesReceived(new_socket, totalExpected))
-                    {
-                        debugE("Error in getting peak data from wifi, could not read the %zu bytes", (size_t)totalExpected);
-                        break;
-                    }
-
-                    if (false == ProcessIncomingData(_pBuffer, totalExpected))
-                        break;
-
-                    // Consume the data by resetting the buffer
-                    debugV("Consuming the data as WIFI_COMMAND_PEAKDATA by setting _cbReceived to from %zu down 0.", (size_t)_cbReceived);
-                }
-                #else
-                    // Audio disabled: consume any declared payload to keep stream in sync, then ignore it
-                    uint32_t length32  = DWORDFromMemory(&_pBuffer.get()[4]);
-                    size_t totalExpected = 0;
-                    if (!CheckedStandardPacketSize(length32, sizeof(uint8_t), totalExpected) ||
-                        totalExpected > MAXIMUM_PACKET_SIZE)
-                    {
-                        debugE("Audio disabled, invalid PEAKDATA payload length %lu", (unsigned long)length32);
-                        break;
-                    }
-                    if (!ReadUntilNBytesReceived(new_socket, totalExpected))
-                    {
-                        debugE("Audio disabled, failed to skip PEAKDATA payload of %zu bytes", (size_t)totalExpected);
-                        break;
-                    }
-                    debugV("Audio disabled; skipped PEAKDATA payload (%zu bytes)", (size_t)totalExpected);
-                #endif
-                ResetReadBuffer();
+bool SocketServer::ReplayPacket(const uint8_t* pPacket, size_t cbPacket)
+{
+    if (pPacket == nullptr || cbPacket < STANDARD_DATA_HEADER_SIZE || cbPacket > MAXIMUM_PACKET_SIZE)
+        return false;
 
-            }
-            else if (command16 == WIFI_COMMAND_PIXELDATA64)
-            {
-                // We know it's pixel data, so we do some validation before calling Process.
-
-                uint16_t channel16 = WORDFromMemory(&_pBuffer.get()[2]);
-                uint32_t length32  = DWORDFromMemory(&_pBuffer.get()[4]);
-                uint64_t seconds   = ULONGFromMemory(&_pBuffer.get()[8]);
-                uint64_t micros    = ULONGFromMemory(&_pBuffer.get()[16]);
-
-                debugV("Uncompressed Header: channel16=%u, length=%lu, seconds=%llu, micro=%llu", channel16, (unsigned long)length32, seconds, micros);
-
-                size_t totalExpected = 0;
-                if (!CheckedStandardPacketSize(length32, LED_DATA_SIZE, totalExpected) ||
-                    totalExpected > MAXIMUM_PACKET_SIZE)
-                {
-                    debugE("Too many bytes promised (%zu) - more than we can use for our LEDs at max packet (%lu)\n", (size_t)totalExpected, (unsigned long)MAXIMUM_PACKET_SIZE);
-                    break;
-                }
-
-                debugV("Expecting %zu total bytes", (size_t)totalExpected);
-                if (false == ReadUntilNBytesReceived(new_socket, totalExpected))
-                {
-                    debugE("Error in getting pixel data from wifi\n");
-                    break;
-                }
-
-                // Add it to the buffer ring
-
-                if (false == ProcessIncomingData(_pBuffer, totalExpected))
-                {
-                    debugE("Error in processing pixel data from wifi\n");
-                    break;
-                }
-
-                // Consume the data by resetting the buffer
-                debugV("Consuming the data as WIFI_COMMAND_PIXELDATA64 by setting _cbReceived to from %zu down 0.", (size_t)_cbReceived);
-                ResetReadBuffer();
-
-                bSendResponsePacket = true;
-            }
-            else
-            {
-                debugE("Unknown command in packet received: %u\n", command16);
-                break;
-            }
-        }
+    // The header has to announce exactly the bytes that are there, as it would for a sender
+    const size_t packetSize = PacketSizeFromHeader(pPacket);
+    if (packetSize == 0 || std::max(packetSize, (size_t)STANDARD_DATA_HEADER_SIZE) != cbPacket)
+        return false;
+
+    std::lock_guard guard(_ingestMutex);
 
-        // If we make it to this point, it should be success, so we consume
+    if (!_abReplayBuffer)
+        _abReplayBuffer = make_unique_psram<uint8_t[]>(MAXIMUM_PACKET_SIZE);
+    if (!_abReplayBuffer)
+        return false;
 
-        ResetReadBuffer();
+    memcpy(_abReplayBuffer.get(), pPacket, cbPacket);
 
-        if (bSendResponsePacket)
-        {
-            static uint64_t sequence = 0;
+    bool bSendResponsePacket = false;
+    return ProcessPacket(_abReplayBuffer, cbPacket, bSendResponsePacket);
+}
 
-            debugV("Sending Response Packet from Socket Server");
-            auto& bufferManager = g_ptrSystem->GetBufferManagers()[0];
+WireReplay::Stats SocketServer::ReplayCapture(WireCaptureReader& capture, WireReplay::Timing timing)
+{
+    auto& bufferManager = g_ptrSystem->GetBufferManagers()[0];
 
+    return WireReplay().Run(capture, timing,
+        [this](const uint8_t* pPacket, size_t cbPacket) { return ReplayPacket(pPacket, cbPacket); },
+        [&bufferManager]
+        {
             std::lock_guard guard(g_buffer_mutex);
-            SocketResponse response = {
-                                        .size = sizeof(SocketResponse),
-                                        .sequence     = sequence++,
-                                        .flashVersion = FLASH_VERSION,
-                                        .currentClock = g_Values.AppTime.CurrentTime(),
-                                        .oldestPacket = bufferManager.AgeOfOldestBuffer(),
-                                        .newestPacket = bufferManager.AgeOfNewestBuffer(),
-                                        .brightness   = g_Values.Brite,
-                                        .wifiSignal   = (float) nd_network::GetWiFiRSSI(),
-                                        .bufferSize   = bufferManager.BufferCount(),
-                                        .bufferPos    = bufferManager.Depth(),
-                                        .fpsDrawing   = g_Values.FPS,
-                                        .watts        = g_Values.Watts
-                                    };
-
-            // I dont think this is fatal, and doesn't affect the read buffer, so content to ignore for now if it happens
-            if (sizeof(response) != write(new_socket, &response, sizeof(response)))
-                debugE("Unable to send response back to server.");
-        }
+            return (size_t)bufferManager.Depth();
+        });
+}
+
+#if ENABLE_WIRE_CAPTURE
+
+bool SocketServer::StartCapture(size_t capacityBytes)
+{
+    std::lock_guard guard(_ingestMutex);
+
+    if (!_pCapture)
+        _pCapture = std::make_unique<WireCapture>(capacityBytes);
+
+    if (_pCapture->Capacity() == 0)
+    {
+        debugE("Could not allocate %zu bytes for a wire capture", capacityBytes);
+        _pCapture.reset();
+        return false;
+    }
 
-        delay(1);
+    _pCapture->Clear();
+    _capturing.store(true);
+    return true;
+}
 
-    } while (true);
+#endif
 
-    close(new_socket);
-    ResetReadBuffer();
-    return false;
+void SocketServer::SendResponsePacket(int fd)
+{
+    debugV("Sending Response Packet from Socket Server");
+    auto& bufferManager = g_ptrSystem->GetBufferManagers()[0];
+
+    std::lock_guard guard(g_buffer_mutex);
+    SocketResponse response = {
+                                .size = sizeof(SocketResponse),
+                                .sequence     = _responseSequence++,
+                                .flashVersion = FLASH_VERSION,
+                                .currentClock = g_Values.AppTime.CurrentTime(),
+                                .oldestPacket = bufferManager.AgeOfOldestBuffer(),
+                                .newestPacket = bufferManager.AgeOfNewestBuffer(),
+                                .brightness   = g_Values.Brite,
+                                .wifiSignal   = (float) nd_network::GetWiFiRSSI(),
+                                .bufferSize   = bufferManager.BufferCount(),
+                                .bufferPos    = bufferManager.Depth(),
+                                .fpsDrawing   = g_Values.FPS,
+                                .watts        = g_Values.Watts
+                            };
+
+    // I dont think this is fatal, and doesn't affect the read buffer, so content to ignore for now if it happens.
+    // The response is tiny, so a full send buffer is the only way this comes up short.
+    if (sizeof(response) != send(fd, &response, sizeof(response), MSG_DONTWAIT))
+        debugE("Unable to send response back to server.");
 }
 
 #endif
@@ -43,10 +43,6 @@
 
 #include <arduinoFFT.h>
 
-#if USE_M5
-    #include <M5Unified.h>
-#endif
-
 namespace
 {
     int GetConfiguredAudioInputPin()
@@ -89,13 +85,20 @@ namespace
 // Construct analyzer, allocate buffers, set initial state.
 // Throws std::runtime_error on allocation failure. Computes band layout once.
 SoundAnalyzerBase::SoundAnalyzerBase()
-    : _FFT(_vReal.data(), _vImaginary.data(), MAX_SAMPLES, SAMPLING_FREQUENCY, true)
+    : _FFT(_vReal.data(), _vImaginary.data(), MAX_SAMPLES, SAMPLING_FREQUENCY)
 {
     ptrSampleBuffer = make_unique_internal<int16_t[]>(MAX_SAMPLES);
     if (!ptrSampleBuffer)
     {
         throw std::runtime_error("Failed to allocate sample buffer");
     }
+
+    // Let the FFT library window a block of ones once so _window holds exactly
+    // the weights it would have applied; SampleAudio multiplies them in as it
+    // converts each block instead of making a second pass over _vReal.
+    _vReal.fill(1.0f);
+    _FFT.windowing(FFTWindow::Hann, FFTDirection::Forward);
+    _window = _vReal;
     _oldVU = _oldPeakVU = _oldMinVU = 0.0f;
     ComputeBandLayout();
     Reset();
@@ -118,40 +121,11 @@ void SoundAnalyzerBase::TeardownAudioInput()
 
     debugI("Audio: tearing down audio input driver");
 
-#if IS_IDF5
-    // Stop the hardware first to kill any active DMA transfers
-    if (_rx_handle)
+    if (_input)
     {
-        const esp_err_t disableErr = i2s_channel_disable(_rx_handle);
-        if (disableErr != ESP_OK)
-            debugW("Audio: i2s_channel_disable returned %d", (int)disableErr);
-        const esp_err_t delErr = i2s_del_channel(_rx_handle);
-        if (delErr != ESP_OK)
-            debugW("Audio: i2s_del_channel returned %d", (int)delErr);
-        _rx_handle = nullptr;
+        _input->End();
+        _input.reset();
     }
-    if (_adc_handle)
-    {
-        const esp_err_t stopErr = adc_continuous_stop(_adc_handle);
-        if (stopErr != ESP_OK)
-            debugW("Audio: adc_continuous_stop returned %d", (int)stopErr);
-        const esp_err_t deinitErr = adc_continuous_deinit(_adc_handle);
-        if (deinitErr != ESP_OK)
-            debugW("Audio: adc_continuous_deinit returned %d", (int)deinitErr);
-        _adc_handle = nullptr;
-    }
-#else
-    #if !USE_M5
-        // Legacy cleanup - i2s_stop terminates DMA. M5Unified manages its own
-        // mic teardown in M5.Mic.end() so we don't double-stop the I2S peripheral.
-        i2s_stop(I2S_NUM_0);
-        i2s_driver_uninstall(I2S_NUM_0);
-    #endif
-#endif
-
-#if USE_M5
-    M5.Mic.end();
-#endif
 
     _hardwareInstalled = false;
 }
@@ -229,39 +203,29 @@ void SoundAnalyzerBase::ResetBeatDetection()
 void SoundAnalyzerBase::FFT()
 {
     // _FFT is now a member variable to avoid ctor/dtor overhead per frame.
-    // Windowing and computation use either the Hann window or others as configured.
-    _FFT.windowing(FFTWindow::Hann, FFTDirection::Forward);
+    // The Hann window was already applied by SampleAudio.
     _FFT.compute(FFTDirection::Forward);
     _FFT.complexToMagnitude();
 }
 
 // SampleAudio
 //
-// Sample the audio
+// Sleep until the input delivers the next block, then convert it to float
+// and apply the Hann window in the same pass. Samples the input did not
+// deliver stay at the zero ResetFrameState left behind.
 void SoundAnalyzerBase::SampleAudio()
 {
-    size_t bytesRead = 0;
-    const auto audioInputPin = GetConfiguredAudioInputPin();
+    constexpr uint32_t kInputTimeoutMs = 100;
 
-    if (audioInputPin < 0)
+    if (!_input)
         return;
 
-#if USE_M5
-    bytesRead = SampleM5();
-#else
-    // Attempt to sample from all supported backends.
-    // Those not active in the current configuration will return 0 immediately.
-    if (bytesRead == 0) bytesRead = SampleI2S_Modern();
-    if (bytesRead == 0) bytesRead = SampleI2S_Legacy();
-    if (bytesRead == 0) bytesRead = SampleADC_Modern();
-    if (bytesRead == 0) bytesRead = SampleADC_Legacy();
-#endif
+    const size_t samples = _input->Read(ptrSampleBuffer.get(), MAX_SAMPLES, kInputTimeoutMs);
+    _lastPassWaitedOnInput = samples > 0;
 
-    if (bytesRead == 0) return;
-
-    // Use std::transform for better code gen (SIMD) when copying/casting samples to FFT input
-    std::transform(ptrSampleBuffer.get(), ptrSampleBuffer.get() + MAX_SAMPLES, _vReal.begin(),
-                   [](int16_t s) { return static_cast<float>(s); });
+    const int16_t *src = ptrSampleBuffer.get();
+    for (size_t i = 0; i < samples; i++)
+        _vReal[i] = static_cast<float>(src[i]) * _window[i];
 }
 
 // UpdateVU
@@ -350,7 +314,7 @@ void SoundAnalyzerBase::InitAudioInput()
 
     const auto audioInputPin = GetConfiguredAudioInputPin();
 
-    if (audioInputPin < 0)
+    if (audioInputPin < 0 && !AUDIO_INPUT_SYNTHETIC)
     {
         debugI("Audio: input pin < 0, skipping hardware initialization. SimBeat only.");
         return;
@@ -358,17 +322,21 @@ void SoundAnalyzerBase::InitAudioInput()
 
     debugV("Begin InitAudioInput...");
 
-#if USE_M5
-    InitM5();
-#else
-    // Digital Microphones
-    InitI2S_Modern();
-    InitI2S_Legacy();
+    _input = CreateAudioInput();
+    if (!_input)
+    {
+        debugW("Audio: no audio input available on this target. SimBeat only.");
+        return;
+    }
 
-    // Analog Microphones
-    InitADC_Modern();
-    InitADC_Legacy();
-#endif
+    if (!_input->Begin(audioInputPin))
+    {
+        debugE("Audio: %s input failed to start", _input->Name());
+        _input.reset();
+        return;
+    }
+
+    debugI("Audio: sampling from %s input", _input->Name());
     _hardwareInstalled = true;
     debugV("InitAudioInput Complete\n");
 }
@@ -467,6 +435,30 @@ void SoundAnalyzerBase::SetPeakDataFromRemote(const PeakData &peaks)
     UpdateVU(sum / (float)NUM_BANDS);
 }
 
+// SetBeatFromRemote
+//
+// Accept a beat event from a remote publisher. The band split is recomputed
+// from the remote peaks already applied so the BeatInfo fields stay populated,
+// and the publisher's tempo estimate replaces our own smoothed interval.
+void SoundAnalyzerBase::SetBeatFromRemote(uint32_t timestampMs, float msPerBeat, float confidence, float strength)
+{
+    const size_t bassBands = std::max<size_t>(1, std::min<size_t>(NUM_BANDS, 3));
+    const float bass = std::accumulate(_Peaks.begin(), _Peaks.begin() + bassBands, 0.0f) / (float)bassBands;
+    const float rest = (NUM_BANDS > bassBands)
+        ? std::accumulate(_Peaks.begin() + bassBands, _Peaks.end(), 0.0f) / (float)(NUM_BANDS - bassBands)
+        : 0.0f;
+
+    RecordBeat(timestampMs, confidence, strength, bass, rest, rest, 0.0f, false);
+
+    if (msPerBeat > 1.0f)
+    {
+        std::lock_guard guard(_beatInfoMutex);
+        _previousBeatIntervalMs = msPerBeat;
+        _lastBeatInfo.msPerBeat = msPerBeat;
+        _lastBeatInfo.bpm = 60000.0f / msPerBeat;
+    }
+}
+
 void SoundAnalyzerBase::RecordBeat(uint32_t now, float confidence, float strength, float bass, float mid, float treble, float flux, bool simulated)
 {
     std::lock_guard guard(_beatInfoMutex);
@@ -713,6 +705,8 @@ void SoundAnalyzerBase::SimulateBeatPass()
 // Uses local mic if no recent remote peaks; otherwise trusts remote and only updates VU.
 void SoundAnalyzerBase::RunSamplerPass()
 {
+    _lastPassWaitedOnInput = false;
+
     if (_simulateBeat)
     {
         SimulateBeatPass();
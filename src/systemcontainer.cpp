@@ -41,9 +41,11 @@
 #include "remotecontrol.h"
 #include "renderservice.h"
 #include "screen.h"
+#include "socketreactor.h"
 #include "socketserver.h"
 #include "systemcontainer.h"
 #include "taskmgr.h"
+#include "values.h"
 #include "webserver.h"
 #include "websocketserver.h"
 #if USE_STRIP
@@ -142,6 +144,12 @@ NetworkReader& SystemContainer::GetNetworkReader() const
     CheckPointer(!!_ptrNetworkReader, "NetworkReader");
     return *_ptrNetworkReader;
 }
+
+SocketReactor& SystemContainer::GetSocketReactor() const
+{
+    CheckPointer(!!_ptrSocketReactor, "SocketReactor");
+    return *_ptrSocketReactor;
+}
 #endif
 
 #if ENABLE_WIFI && ENABLE_WEBSERVER
@@ -316,6 +324,16 @@ SuccessResultWithMessage SystemContainer::ApplyRuntimeConfiguration()
     // topology.
     std::scoped_lock guard(g_render_mutex, g_effect_manager_mutex, g_buffer_mutex);
 
+    // Nothing is drawn for as long as the locks are held, so that's what is measured
+    const uint32_t start = micros();
+    auto result = ApplyRuntimeConfigurationLocked();
+    g_Values.ReconfigureBlackoutMicros = micros() - start;
+
+    return result;
+}
+
+SuccessResultWithMessage SystemContainer::ApplyRuntimeConfigurationLocked()
+{
     auto& config = GetDeviceConfig();
 
     if (config.RequiresRecompileForCurrentRuntimeConfig())
@@ -400,6 +418,13 @@ NetworkReader& SystemContainer::SetupNetworkReader()
         _ptrNetworkReader = make_unique_internal<NetworkReader>();
     return *_ptrNetworkReader;
 }
+
+SocketReactor& SystemContainer::SetupSocketReactor()
+{
+    if (!_ptrSocketReactor)
+        _ptrSocketReactor = make_unique_internal<SocketReactor>();
+    return *_ptrSocketReactor;
+}
 #endif
 
 #if ENABLE_WIFI && ENABLE_WEBSERVER
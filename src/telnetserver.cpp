@@ -22,7 +22,9 @@
 //
 // Description:
 //
-//    BSD-socket based Telnet server for remote console access.
+//    BSD-socket based Telnet server for remote console access. The
+//    sockets are owned by the SocketReactor, which calls DebugConsole
+//    whenever the client has sent something.
 //
 //    Telnet protocol handling (RFC 854):
 //      - Negotiates WILL ECHO so the client suppresses its local echo
@@ -31,20 +33,29 @@
 //        (suppress go-ahead, disabling Telnet's line-buffered default).
 //      - Filters IAC command sequences out of the data stream.
 //      - Translates RFC 854 CR-NUL (bare CR) and CR-LF to a single '\r'
-//        for ProcessCLIByte, which then handles command dispatch.
+//        for ProcessCLIByte, which edits and echoes the line.
 //        The state machine survives across recv() boundaries so a split
 //        \r\0 pair arriving in two separate packets is handled correctly.
 //
+//    Only line editing happens on the reactor task. Completed lines are
+//    queued on the ConsoleManager and run from the main loop, and output
+//    goes through a buffered sink that never blocks, so neither a slow
+//    command nor a slow client holds up the reactor's other sockets.
+//
 //---------------------------------------------------------------------------
 
 #include "globals.h"
 #include <Arduino.h>
+#include <algorithm>
 #include <arpa/inet.h>
 #include <cassert>
 #include <cerrno>
 #include <cstddef>
 #include <cstring>
+#include <memory>
+#include <mutex>
 #include <netinet/in.h>
+#include <string>
 #include <sys/socket.h>
 #include <unistd.h>
 
@@ -52,7 +63,7 @@
 #include "debugconsole.h"
 #include "logger.h"
 #include "nd_network.h"
-#include "taskmgr.h"   // DEBUG_STACK_SIZE / DEBUG_PRIORITY / DEBUG_CORE
+#include "systemcontainer.h"
 
 
 #if ENABLE_WIFI
@@ -68,45 +79,116 @@ static constexpr uint8_t TELNET_SE   = 240;  // Subnegotiation end
 static constexpr uint8_t OPT_ECHO    =   1;  // Echo option
 static constexpr uint8_t OPT_SGA     =   3;  // Suppress Go Ahead
 
+// TelnetSink
+//
+// Console output for the telnet client. Write() can be called from any task -
+// the logger, the main loop running a command, the reactor echoing a keystroke -
+// and never waits: it sends what the socket will take right away and keeps the
+// rest in a bounded buffer that the reactor drains through OnWritable(). When
+// the client falls too far behind, further output is dropped and counted, and
+// a note saying how much went missing follows once the buffer has emptied.
+
 class TelnetSink : public IConsoleSink
 {
 public:
-    TelnetSink(int fd) : _fd(fd) {}
-    void Write(const char* data, size_t len) override {
-        size_t total_sent = 0;
-        int retries = 0;
-        while (total_sent < len) {
+    TelnetSink(int fd, SocketReactor& reactor) : _fd(fd), _reactor(reactor) {}
+
+    void Write(const char* data, size_t len) override
+    {
+        bool wake;
+        {
+            std::lock_guard guard(_mutex);
+            if (_fd < 0)
+                return;
+
+            size_t room = kMaxPending - std::min(_pending.size(), kMaxPending);
+            if (len > room)
+            {
+                _dropped += len - room;
+                len = room;
+            }
+            _pending.append(data, len);
+            SendPendingLocked();
+            wake = !_pending.empty();
+        }
+
+        // Have the reactor start watching for writability if the socket
+        // didn't take it all
+        if (wake)
+            _reactor.Wake();
+    }
+
+    LineEndingPolicy LinePolicy() const override { return LineEndingPolicy::CRLF; }
+
+    bool HasPending() const
+    {
+        std::lock_guard guard(_mutex);
+        return _fd >= 0 && !_pending.empty();
+    }
+
+    // Called by the reactor when the socket can take more. Returns false if
+    // the connection has failed.
+
+    bool Drain()
+    {
+        std::lock_guard guard(_mutex);
+        return SendPendingLocked();
+    }
+
+    // The reactor is about to close the socket; anything written from here on
+    // (a command still running on the main loop, say) goes nowhere
+
+    void Close()
+    {
+        std::lock_guard guard(_mutex);
+        _fd = -1;
+        _pending.clear();
+    }
+
+private:
+    static constexpr size_t kMaxPending = 4096;
+
+    bool SendPendingLocked()
+    {
+        while (_fd >= 0 && !_pending.empty())
+        {
             // Write directly with MSG_DONTWAIT. This avoids the use of select() and FD_SET(),
             // which can corrupt the stack in ESP-IDF if _fd >= FD_SETSIZE (default 64) due to
             // numerous open file/socket handles.
-            int sent = send(_fd, data + total_sent, len - total_sent, MSG_DONTWAIT);
-
-            if (sent > 0) {
-                total_sent += sent;
-                retries = 0; // Reset retries on successful progress
-            } else if (sent < 0) {
-                if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                    retries++;
-                    if (retries > 50) {
-                        // Timeout after ~500ms of spinning to avoid stalling the logger thread
-                        return;
-                    }
-                    vTaskDelay(pdMS_TO_TICKS(10));
-                } else if (errno == EINTR) {
-                    continue; // Interrupted, try again immediately
-                } else {
-                    // Fatal socket error (broken pipe, reset, etc.). Stop writing.
-                    // The main read loop will detect this on its next recv().
-                    return;
+            int sent = send(_fd, _pending.data(), _pending.size(), MSG_DONTWAIT);
+            if (sent > 0)
+            {
+                _pending.erase(0, sent);
+                if (_pending.empty() && _dropped)
+                {
+                    _pending = str_sprintf("\r\n[%zu bytes of output dropped]\r\n", _dropped).c_str();
+                    _dropped = 0;
                 }
-            } else {
-                return; // sent == 0, peer closed
+            }
+            else if (sent < 0 && errno == EINTR)
+            {
+                continue;       // Interrupted, try again immediately
+            }
+            else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                return true;    // Full; the reactor calls Drain() when there's room
+            }
+            else
+            {
+                // Fatal socket error (broken pipe, reset, etc.) or peer closed.
+                // Stop writing; the reactor will see it on the socket and close it.
+                _pending.clear();
+                return false;
             }
         }
+        return true;
     }
-    LineEndingPolicy LinePolicy() const override { return LineEndingPolicy::CRLF; }
-private:
-    int _fd;
+
+    mutable std::mutex _mutex;
+    int                _fd;
+    SocketReactor&     _reactor;
+    std::string        _pending;
+    size_t             _dropped = 0;
 };
 
 // SendTelnetOption
@@ -133,248 +215,185 @@ static void NegotiateTelnetOptions(int fd)
     SendTelnetOption(fd, TELNET_DO,   OPT_SGA);
 }
 
-// DebugConsole ITaskService hooks
+// DebugConsole IService
 //
-// Start/Stop/IsRunning are inherited final from ITaskService; this class
-// only supplies the task config and the telnet accept/process loop body.
+// The telnet port is served by the socket reactor; starting the console just
+// registers it there, and stopping it closes the listener and any client.
 
-ITaskService::TaskConfig DebugConsole::GetTaskConfig() const
+DebugConsole::~DebugConsole()
 {
-    return TaskConfig {
-        "Debug Loop",
-        DEBUG_STACK_SIZE,
-        DEBUG_PRIORITY,
-        DEBUG_CORE,
-        2000   // Stop timeout: outer accept() polls non-blocking with delay(100).
-    };
+    Stop();
 }
 
-void DebugConsole::Run()
+bool DebugConsole::Start()
 {
-    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (listen_fd < 0) {
-        debugE("Failed to create telnet socket");
-        return;
-    }
-    _listenFd.store(listen_fd);
-
-    struct sockaddr_in serv_addr;
-    memset(&serv_addr, 0, sizeof(serv_addr));
-    serv_addr.sin_family = AF_INET;
-    serv_addr.sin_addr.s_addr = INADDR_ANY;
-    serv_addr.sin_port = htons(NetworkPort::Telnet);
-
-    if (bind(listen_fd, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) < 0) {
-        debugE("Failed to bind telnet socket");
-        const int fd = _listenFd.exchange(-1);
-        if (fd >= 0) close(fd);
-        return;
-    }
+    if (_running.load())
+        return true;
 
-    nd_network::SetSocketBlockingEnabled(listen_fd, false);
-    if (listen(listen_fd, 1) < 0)
-    {
-        debugE("Failed to listen on telnet socket");
-        const int fd = _listenFd.exchange(-1);
-        if (fd >= 0) close(fd);
-        return;
-    }
+    _pReactor = &g_ptrSystem->GetSocketReactor();
+    if (!_pReactor->Listen(NetworkPort::Telnet, *this, 1))
+        return false;
 
-    while (!ShouldShutdown())
-    {
-        struct sockaddr_in cli_addr;
-        socklen_t cli_len = sizeof(cli_addr);
-        int client_fd = accept(listen_fd, (struct sockaddr *)&cli_addr, &cli_len);
-
-        if (client_fd < 0) {
-            if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                delay(100);
-                continue;
-            }
-            // If our listening fd was closed under us by OnBeforeWaitForStop,
-            // accept() will return EBADF — fall through to the shutdown check.
-            if (ShouldShutdown())
-                break;
-            delay(100);
-            continue;
-        }
+    _running.store(true);
+    return true;
+}
+
+void DebugConsole::Stop()
+{
+    if (_running.exchange(false))
+        _pReactor->Unlisten(*this);
+}
 
-        debugI("Telnet client connected from %s", inet_ntoa(cli_addr.sin_addr));
+bool DebugConsole::OnConnect(int fd, const sockaddr_in& peer)
+{
+    debugI("Telnet client connected from %s", inet_ntoa(peer.sin_addr));
 
-        // Non-blocking client so recv() can also observe ShouldShutdown()
-        // without sitting in a blocking syscall that only OnBeforeWaitForStop
-        // could rescue. We poll with a short delay between empty reads.
-        nd_network::SetSocketBlockingEnabled(client_fd, false);
-        _clientFd.store(client_fd);
+    // Negotiate character-at-a-time mode and server-side echo before
+    // registering the sink, so the client is in the right mode before
+    // we start sending any output.
+    NegotiateTelnetOptions(fd);
 
-        // Negotiate character-at-a-time mode and server-side echo before
-        // registering the sink, so the client is in the right mode before
-        // we start sending any output.
-        NegotiateTelnetOptions(client_fd);
+    _state = RecvState::Normal;
+    _sink = std::make_shared<TelnetSink>(fd, *_pReactor);
+    ConsoleManager::Instance().SetTelnetSink(_sink);
+    return true;
+}
 
-        TelnetSink sink(client_fd);
-        ConsoleManager::Instance().SetTelnetSink(&sink);
+bool DebugConsole::WantsWrite(int fd) const
+{
+    return _sink && _sink->HasPending();
+}
 
-        // State machine for Telnet protocol and CR handling.
-        // Survives across recv() boundaries.
-        enum class RecvState : uint8_t
-        {
-            Normal,     // Normal data byte
-            IAC,        // Saw 0xFF, waiting for verb
-            IACVerb,    // Saw IAC + verb, waiting for option byte
-            IACsb,      // Inside subnegotiation, waiting for IAC SE
-            IACInSB,    // Saw IAC inside subnegotiation
-            AfterCR,    // Saw \r, waiting to see if next is \0 or \n (RFC 854)
-        };
-        RecvState state = RecvState::Normal;
-
-        uint8_t buf[128];
-        while (!ShouldShutdown())
-        {
-            int n = recv(client_fd, buf, sizeof(buf), 0);
-            if (n == 0)
-            {
-                // Clean shutdown from client side
-                break;
-            }
-            if (n < 0)
-            {
-                if (errno == EAGAIN || errno == EWOULDBLOCK)
-                {
-                    // No data available right now; sleep briefly and re-check
-                    // ShouldShutdown() at the top of the loop.
-                    delay(50);
-                    continue;
-                }
-                if (errno == EINTR)
-                    continue;   // Signal interrupted syscall, retry
-                if (errno == EBADF)
-                    break;      // OnBeforeWaitForStop closed us; exit cleanly
-                // Use Serial directly to avoid any risk of recursion through
-                // the Telnet sink that may itself be in a broken state.
-                Serial.printf("[TelnetServer] recv error: %s\n", strerror(errno));
-                break;
-            }
+bool DebugConsole::OnWritable(int fd)
+{
+    return !_sink || _sink->Drain();
+}
 
-            for (int i = 0; i < n; ++i)
-            {
-                const uint8_t byte = buf[i];
+void DebugConsole::OnDisconnect(int fd)
+{
+    // Detach the sink before the reactor closes the socket, so console
+    // output can't be written to a descriptor that's about to be reused.
+    // A command still running on the main loop may hold the session (and so
+    // the sink) a little longer, which is why the sink is closed too.
+    ConsoleManager::Instance().ClearTelnetSink();
+    if (_sink)
+        _sink->Close();
+    _sink.reset();
+    debugI("Telnet client disconnected");
+}
 
-                switch (state)
-                {
-                case RecvState::Normal:
-                    if (byte == TELNET_IAC)
-                    {
-                        state = RecvState::IAC;
-                    }
-                    else if (byte == '\r')
-                    {
-                        // RFC 854: bare CR must be followed by \0 or \n.
-                        // Defer until we see the next byte.
-                        state = RecvState::AfterCR;
-                    }
-                    else
-                    {
-                        ConsoleManager::Instance().FeedTelnetByte(byte);
-                    }
-                    break;
-
-                case RecvState::AfterCR:
-                    // RFC 854: CR-NUL means a bare CR; CR-LF means end-of-line.
-                    // Either way we deliver a single '\r' to the CLI handler.
-                    // Any other byte after CR is non-standard; deliver both.
-                    state = RecvState::Normal;
-                    if (byte == '\0' || byte == '\n')
-                    {
-                        // Canonical end-of-line: deliver the CR
-                        ConsoleManager::Instance().FeedTelnetByte('\r');
-                    }
-                    else
-                    {
-                        // Non-standard: deliver CR then the unexpected byte
-                        ConsoleManager::Instance().FeedTelnetByte('\r');
-                        ConsoleManager::Instance().FeedTelnetByte(byte);
-                    }
-                    break;
-
-                case RecvState::IAC:
-                    if (byte == TELNET_IAC)
-                    {
-                        // Escaped 0xFF in data stream — deliver it literally
-                        ConsoleManager::Instance().FeedTelnetByte(0xFF);
-                        state = RecvState::Normal;
-                    }
-                    else if (byte == TELNET_SB)
-                    {
-                        state = RecvState::IACsb;
-                    }
-                    else if (byte == TELNET_WILL || byte == TELNET_WONT ||
-                             byte == TELNET_DO   || byte == TELNET_DONT)
-                    {
-                        state = RecvState::IACVerb;
-                    }
-                    else
-                    {
-                        // Single-byte IAC command (NOP, DM, GA, etc.) — ignore
-                        state = RecvState::Normal;
-                    }
-                    break;
-
-                case RecvState::IACVerb:
-                    // Option byte following the verb — silently absorb.
-                    // We don't need to respond to client DO/DONT for options
-                    // we haven't offered; our WILL ECHO / WILL SGA / DO SGA
-                    // were already sent on connect.
-                    state = RecvState::Normal;
-                    break;
-
-                case RecvState::IACsb:
-                    // Inside subnegotiation — absorb until IAC SE
-                    if (byte == TELNET_IAC)
-                        state = RecvState::IACInSB;
-                    break;
-
-                case RecvState::IACInSB:
-                    state = (byte == TELNET_SE) ? RecvState::Normal : RecvState::IACsb;
-                    break;
-                }
-            }
+bool DebugConsole::OnReadable(int fd)
+{
+    uint8_t buf[128];
+    while (true)
+    {
+        int n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n == 0)
+        {
+            // Clean shutdown from client side
+            return false;
         }
-
-        ConsoleManager::Instance().ClearTelnetSink();
+        if (n < 0)
         {
-            const int fd = _clientFd.exchange(-1);
-            if (fd >= 0)
-                close(fd);
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return true;    // Drained; the reactor calls again when more arrives
+            if (errno == EINTR)
+                continue;       // Signal interrupted syscall, retry
+            // Use Serial directly to avoid any risk of recursion through
+            // the Telnet sink that may itself be in a broken state.
+            Serial.printf("[TelnetServer] recv error: %s\n", strerror(errno));
+            return false;
         }
-        debugI("Telnet client disconnected");
-    }
 
-    {
-        const int fd = _listenFd.exchange(-1);
-        if (fd >= 0)
-            close(fd);
+        for (int i = 0; i < n; ++i)
+            ProcessByte(buf[i]);
     }
 }
 
-void DebugConsole::OnBeforeWaitForStop()
-{
-    // Close the listening socket and any active client connection from the
-    // Stop() thread so the task's accept()/recv() return promptly with EBADF
-    // and the loop can observe ShouldShutdown(). Both fds are atomic<int>
-    // so the exchange is the only point at which they're consumed.
+// ProcessByte
+//
+// Runs one received byte through the telnet state machine, passing data
+// bytes on to the console.
 
-    const int listen_fd = _listenFd.exchange(-1);
-    if (listen_fd >= 0)
-    {
-        shutdown(listen_fd, SHUT_RDWR);
-        close(listen_fd);
-    }
-    const int client_fd = _clientFd.exchange(-1);
-    if (client_fd >= 0)
+void DebugConsole::ProcessByte(uint8_t byte)
+{
+    switch (_state)
     {
-        shutdown(client_fd, SHUT_RDWR);
-        close(client_fd);
+    case RecvState::Normal:
+        if (byte == TELNET_IAC)
+        {
+            _state = RecvState::IAC;
+        }
+        else if (byte == '\r')
+        {
+            // RFC 854: bare CR must be followed by \0 or \n.
+            // Defer until we see the next byte.
+            _state = RecvState::AfterCR;
+        }
+        else
+        {
+            ConsoleManager::Instance().FeedTelnetByte(byte);
+        }
+        break;
+
+    case RecvState::AfterCR:
+        // RFC 854: CR-NUL means a bare CR; CR-LF means end-of-line.
+        // Either way we deliver a single '\r' to the CLI handler.
+        // Any other byte after CR is non-standard; deliver both.
+        _state = RecvState::Normal;
+        if (byte == '\0' || byte == '\n')
+        {
+            // Canonical end-of-line: deliver the CR
+            ConsoleManager::Instance().FeedTelnetByte('\r');
+        }
+        else
+        {
+            // Non-standard: deliver CR then the unexpected byte
+            ConsoleManager::Instance().FeedTelnetByte('\r');
+            ConsoleManager::Instance().FeedTelnetByte(byte);
+        }
+        break;
+
+    case RecvState::IAC:
+        if (byte == TELNET_IAC)
+        {
+            // Escaped 0xFF in data stream — deliver it literally
+            ConsoleManager::Instance().FeedTelnetByte(0xFF);
+            _state = RecvState::Normal;
+        }
+        else if (byte == TELNET_SB)
+        {
+            _state = RecvState::IACsb;
+        }
+        else if (byte == TELNET_WILL || byte == TELNET_WONT ||
+                 byte == TELNET_DO   || byte == TELNET_DONT)
+        {
+            _state = RecvState::IACVerb;
+        }
+        else
+        {
+            // Single-byte IAC command (NOP, DM, GA, etc.) — ignore
+            _state = RecvState::Normal;
+        }
+        break;
+
+    case RecvState::IACVerb:
+        // Option byte following the verb — silently absorb.
+        // We don't need to respond to client DO/DONT for options
+        // we haven't offered; our WILL ECHO / WILL SGA / DO SGA
+        // were already sent on connect.
+        _state = RecvState::Normal;
+        break;
+
+    case RecvState::IACsb:
+        // Inside subnegotiation — absorb until IAC SE
+        if (byte == TELNET_IAC)
+            _state = RecvState::IACInSB;
+        break;
+
+    case RecvState::IACInSB:
+        _state = (byte == TELNET_SE) ? RecvState::Normal : RecvState::IACsb;
+        break;
     }
 }
 
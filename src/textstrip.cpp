@@ -0,0 +1,233 @@
+//+--------------------------------------------------------------------------
+//
+// File:        textstrip.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Rasterized text strips and their cache; see textstrip.h.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <mutex>
+
+#include "gfxbase.h"
+#include "textstrip.h"
+
+namespace
+{
+    struct CachedStrip
+    {
+        String                           text;
+        const GFXfont*                   font;
+        uint8_t                          sizeX;
+        uint8_t                          sizeY;
+        TextStrip::Style                 style;
+        int                              maxWidth;
+        std::shared_ptr<const TextStrip> strip;
+    };
+
+    // Most recently used first
+    std::list<CachedStrip> g_StripCache;
+    std::mutex g_StripCacheMutex;
+
+    void SetUpCanvas(GFXcanvas8& canvas, const GFXfont* font, uint8_t sizeX, uint8_t sizeY)
+    {
+        canvas.setFont(font);
+        canvas.setTextSize(sizeX, sizeY);
+        canvas.setTextWrap(false);
+    }
+}
+
+TextStrip::TextStrip(uint16_t width, uint16_t height, int16_t originX, int16_t originY)
+    : _width(width),
+      _height(height),
+      _originX(originX),
+      _originY(originY),
+      _pixels(size_t(width) * height, kClear)
+{
+}
+
+void TextStrip::Set(int x, int y, uint8_t value)
+{
+    if (x >= 0 && y >= 0 && x < _width && y < _height)
+        _pixels[size_t(y) * _width + x] = value;
+}
+
+void TextStrip::SetInkBounds(int16_t x, int16_t y, uint16_t width, uint16_t height)
+{
+    _inkX = x;
+    _inkY = y;
+    _inkWidth = width;
+    _inkHeight = height;
+}
+
+// Rasterize
+//
+// Measures and fits the text on a 1x1 canvas, then prints it onto one just big enough for the ink plus
+// whatever the style adds around it: edge passes first, then the ink over the top of them.
+
+std::shared_ptr<const TextStrip> TextStrip::Rasterize(const String& text, const GFXfont* font, uint8_t sizeX, uint8_t sizeY, Style style, int maxWidth)
+{
+    GFXcanvas8 measure(1, 1);
+    SetUpCanvas(measure, font, sizeX, sizeY);
+
+    String fitted = maxWidth == 0 ? String() : text;
+    int16_t x1 = 0, y1 = 0;
+    uint16_t textWidth = 0, textHeight = 0;
+
+    while (!fitted.isEmpty())
+    {
+        measure.getTextBounds(fitted, 0, 0, &x1, &y1, &textWidth, &textHeight);
+        if (maxWidth < 0 || textWidth <= maxWidth)
+            break;
+
+        fitted.remove(fitted.length() - 1);
+    }
+
+    if (fitted.isEmpty() || textWidth == 0 || textHeight == 0)
+        return std::make_shared<TextStrip>(0, 0);
+
+    const int padBefore = style == Style::Outline ? 1 : 0;
+    const int padAfter  = style == Style::Plain ? 0 : 1;
+
+    const uint16_t width  = textWidth + padBefore + padAfter;
+    const uint16_t height = textHeight + padBefore + padAfter;
+
+    GFXcanvas8 canvas(width, height);
+    if (!canvas.getBuffer())
+        return std::make_shared<TextStrip>(0, 0);
+
+    SetUpCanvas(canvas, font, sizeX, sizeY);
+    canvas.fillScreen(kClear);
+
+    const int16_t cursorX = padBefore - x1;
+    const int16_t cursorY = padBefore - y1;
+
+    auto printAt = [&](int16_t dx, int16_t dy, uint8_t value)
+    {
+        canvas.setTextColor(value);
+        canvas.setCursor(cursorX + dx, cursorY + dy);
+        canvas.print(fitted);
+    };
+
+    if (style == Style::Outline)
+    {
+        printAt(-1, 0, kEdge);
+        printAt( 1, 0, kEdge);
+        printAt( 0,-1, kEdge);
+        printAt( 0, 1, kEdge);
+    }
+    else if (style == Style::DropShadow)
+    {
+        printAt(1, 1, kEdge);
+    }
+    printAt(0, 0, kInk);
+
+    auto strip = std::make_shared<TextStrip>(width, height, x1 - padBefore, y1 - padBefore);
+    memcpy(strip->_pixels.data(), canvas.getBuffer(), strip->_pixels.size());
+    strip->SetInkBounds(x1, y1, textWidth, textHeight);
+
+    return strip;
+}
+
+// Cached
+//
+// A short list searched front to back is plenty for the handful of strings any one effect shows
+
+std::shared_ptr<const TextStrip> TextStrip::Cached(const String& text, const GFXfont* font, uint8_t sizeX, uint8_t sizeY, Style style, int maxWidth)
+{
+    std::lock_guard<std::mutex> guard(g_StripCacheMutex);
+
+    for (auto entry = g_StripCache.begin(); entry != g_StripCache.end(); ++entry)
+    {
+        if (entry->font == font && entry->sizeX == sizeX && entry->sizeY == sizeY && entry->style == style
+            && entry->maxWidth == maxWidth && entry->text == text)
+        {
+            g_StripCache.splice(g_StripCache.begin(), g_StripCache, entry);
+            return g_StripCache.front().strip;
+        }
+    }
+
+    auto strip = Rasterize(text, font, sizeX, sizeY, style, maxWidth);
+    g_StripCache.push_front({ text, font, sizeX, sizeY, style, maxWidth, strip });
+
+    while (g_StripCache.size() > TEXT_STRIP_CACHE_ENTRIES)
+        g_StripCache.pop_back();
+
+    return strip;
+}
+
+void TextStrip::Draw(GFXBase& g, int x, int y, const CRGB& ink, const CRGB& edge, uint8_t alpha) const
+{
+    const int left = x + _originX;
+    const int top  = y + _originY;
+
+    const int firstRow = std::max(0, -top);
+    const int lastRow  = std::min<int>(_height, int(g.GetMatrixHeight()) - top);
+    const int firstCol = std::max(0, -left);
+    const int lastCol  = std::min<int>(_width, int(g.GetMatrixWidth()) - left);
+
+    for (int sy = firstRow; sy < lastRow; ++sy)
+    {
+        const uint8_t* row = &_pixels[size_t(sy) * _width];
+        for (int sx = firstCol; sx < lastCol; ++sx)
+        {
+            if (row[sx] == kClear)
+                continue;
+
+            const CRGB& color = row[sx] == kInk ? ink : edge;
+            if (alpha == 255)
+            {
+                g.drawPixel(left + sx, top + sy, color);
+            }
+            else if (g.isValidPixel(left + sx, top + sy))
+            {
+                CRGB& pixel = g.leds[XY(left + sx, top + sy)];
+                pixel = blend(pixel, color, alpha);
+            }
+        }
+    }
+}
+
+void TextStrip::DrawRow(int stripY, CRGB* row, int rowWidth, int left, const CRGB& ink, const CRGB& edge, uint8_t alpha) const
+{
+    if (stripY < 0 || stripY >= _height)
+        return;
+
+    const uint8_t* pixels = &_pixels[size_t(stripY) * _width];
+    const int firstCol = std::max(0, -left);
+    const int lastCol  = std::min<int>(_width, rowWidth - left);
+
+    for (int sx = firstCol; sx < lastCol; ++sx)
+    {
+        if (pixels[sx] == kClear)
+            continue;
+
+        const CRGB& color = pixels[sx] == kInk ? ink : edge;
+        CRGB& pixel = row[left + sx];
+        pixel = alpha == 255 ? color : blend(pixel, color, alpha);
+    }
+}
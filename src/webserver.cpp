@@ -41,16 +41,22 @@
 #include <limits>
 #include <utility>
 
+#include "audioservice.h"
+#include "colorstreamerservice.h"
 #include "deviceconfig.h"
 #include "effectmanager.h"
 #include "effects.h"
 #include "gfxbase.h"
 #include "improvserial.h"
+#include "ntptimeclient.h"
 #include "soundanalyzer.h"
 #include "systemcontainer.h"
 #include "taskmgr.h"
 #include "values.h"
 #include "websocketserver.h"   // Stop() tears down our websocket clients first
+#if USE_WS281X
+#include "ws281xoutputmanager.h"
+#endif
 
 // Member function template specializations
 
@@ -200,7 +206,7 @@ void CWebServer::begin()
 
     // SPIFFS file requests
 
-    _server.on("/effectsConfig",         HTTP_GET,  [](AsyncWebServerRequest* pRequest) { pRequest->send(SPIFFS, EFFECTS_CONFIG_FILE,   "text/json"); });
+    _server.on("/effectsConfig",         HTTP_GET,  [this](AsyncWebServerRequest* pRequest) { this->GetEffectsConfig(pRequest); });
     #if ENABLE_IMPROV_LOGGING
         _server.on(IMPROV_LOG_FILE,      HTTP_GET,  [](AsyncWebServerRequest* pRequest) { pRequest->send(SPIFFS, IMPROV_LOG_FILE,       "text/plain"); });
     #endif
@@ -362,8 +368,81 @@ void CWebServer::GetStatistics(AsyncWebServerRequest * pRequest, StatisticsType
     if ((statsType & StatisticsType::Dynamic) != StatisticsType::None)
     {
         j["LED_FPS"]               = g_Values.FPS;
+        #if USE_HUB75
+            j["MATRIX_SWAP_WAIT_US"]   = g_Values.MatrixSwapWaitMicros;
+            j["MATRIX_SWAP_COPY_US"]   = g_Values.MatrixSwapCopyMicros;
+        #endif
+        #if ENABLE_RENDER_BUDGET
+            j["EFFECT_DRAW_US"]        = g_Values.EffectDrawMicros;
+            j["EFFECT_QUALITY_LEVEL"]  = g_Values.EffectQualityLevel;
+            j["EFFECT_BUDGET_MISSES"]  = g_Values.EffectBudgetMisses;
+        #endif
+        #if USE_WS281X
+            const auto rmtStats = WS281xOutputManager::GetTranslatorStats();
+            j["RMT_REFILLS"]           = rmtStats.refills;
+            j["RMT_REFILL_CYCLES"]     = rmtStats.averageCycles;
+            j["RMT_REFILL_MAX_CYCLES"] = rmtStats.maxCycles;
+            j["RMT_REFILL_MAX_US"]     = rmtStats.maxCycles / ESP.getCpuFreqMHz();
+        #endif
         j["SERIAL_FPS"]            = g_Analyzer.SerialFPS();
         j["AUDIO_FPS"]             = g_Analyzer.AudioFPS();
+
+        if (const auto* syncStats = g_ptrSystem->HasAudioService() ? g_ptrSystem->GetAudioService().SyncStats() : nullptr)
+        {
+            j["AUDIO_SYNC_PACKETS"]    = syncStats->packets;
+            j["AUDIO_SYNC_LOST"]       = syncStats->lost;
+            j["AUDIO_SYNC_LATE"]       = syncStats->late;
+            j["AUDIO_SYNC_CONCEALED"]  = syncStats->concealed;
+            j["AUDIO_SYNC_OFFSET_MS"]  = syncStats->offsetMs;
+            j["AUDIO_SYNC_JITTER_MS"]  = syncStats->jitterMs;
+            j["AUDIO_SYNC_AGE_MS"]     = syncStats->lastPacketMs ? millis() - syncStats->lastPacketMs : 0;
+        }
+
+        #if COLORDATA_SERVER_ENABLED
+            if (g_ptrSystem->HasColorStreamerService())
+            {
+                auto clients = j["PREVIEW_CLIENTS"].to<JsonArray>();
+                for (const auto& report : g_ptrSystem->GetColorStreamerService().GetPreviewClients())
+                {
+                    auto client = clients.add<JsonObject>();
+                    client["transport"] = report.transport;
+                    client["id"]        = report.id;
+                    client["encoding"]  = report.negotiated ? PreviewOptions::EncodingName(report.options.encoding) : "legacy";
+                    client["scale"]     = report.options.scale;
+                    client["maxFps"]    = report.options.maxFps;
+                    client["frames"]    = report.stats.framesSent;
+                    client["bytes"]     = report.stats.bytesSent;
+                    client["dropped"]   = report.stats.framesDropped;
+                }
+            }
+        #endif
+
+        const auto journalStats = GetEffectsJournalStats();
+        j["EFFECTS_JOURNAL_BYTES"]       = journalStats.journalBytes;
+        j["EFFECTS_JOURNAL_LAST_CHANGE"] = journalStats.lastChangeBytes;
+        j["EFFECTS_JOURNAL_CHANGES"]     = journalStats.changesWritten;
+        j["EFFECTS_JOURNAL_REPLAYED"]    = journalStats.replayedChanges;
+        j["EFFECTS_JOURNAL_REPLAY_MS"]   = journalStats.replayMs;
+        j["EFFECTS_SNAPSHOT_BYTES"]      = journalStats.snapshotBytes;
+        j["EFFECTS_SNAPSHOTS"]           = journalStats.snapshots;
+        j["RECONFIG_BLACKOUT_US"]        = g_Values.ReconfigureBlackoutMicros;
+        if (g_ptrSystem->HasEffectManager())
+        {
+            j["EFFECTS_INIT_PENDING"]    = g_ptrSystem->GetEffectManager().PendingInitCount();
+            j["EFFECTS_INIT_FAILED"]     = g_ptrSystem->GetEffectManager().FailedInitCount();
+        }
+        j["LOG_DROPPED"]           = Logger::DroppedRecords();
+        #if ENABLE_NTP
+            const auto ntpStats = NTPTimeClient::GetStats();
+            j["NTP_SYNCED"]        = ntpStats.synced;
+            j["NTP_OFFSET_US"]     = ntpStats.offsetMicros;
+            j["NTP_DELAY_US"]      = ntpStats.delayMicros;
+            j["NTP_JITTER_US"]     = ntpStats.jitterMicros;
+            j["NTP_SYNC_AGE_S"]    = ntpStats.synced ? (int32_t)((millis() - ntpStats.lastSyncMs) / 1000) : -1;
+            j["NTP_STEPS"]         = ntpStats.steps;
+            j["NTP_SLEWS"]         = ntpStats.slews;
+            j["NTP_TIMEOUTS"]      = ntpStats.timeouts;
+        #endif
         j["HEAP_FREE"]             = ESP.getFreeHeap();
         j["HEAP_MIN"]              = ESP.getMinFreeHeap();
         j["DMA_FREE"]              = heap_caps_get_free_size(MALLOC_CAP_DMA);
@@ -18,53 +18,128 @@
 
 #include <AsyncJson.h>
 #include <memory>
+#include <SPIFFS.h>
+#include <utility>
+#include <vector>
 
 #include "effectmanager.h"
+#include "effects.h"
+#include "jsonchunkstream.h"
 #include "ledstripeffect.h"
 #include "systemcontainer.h"
 
+// GetEffectListText
+//
+// Copies the effect list into a snapshot while holding the render and effect
+// manager locks, then streams it out one effect per fragment after the locks
+// are released, so a long catalog neither stalls the render loop nor needs a
+// document big enough to hold all of it.
+
 void CWebServer::GetEffectListText(AsyncWebServerRequest * pRequest)
 {
     debugV("GetEffectListText");
 
-    auto response = std::make_unique<AsyncJsonResponse>();
-    auto& j = response->getRoot();
+    struct EffectEntry
+    {
+        String   name;
+        bool     enabled;
+        bool     core;
+        uint8_t  qualityLevel;
+        uint8_t  qualityLevels;
+        uint32_t drawMicros;
+        uint32_t budgetMisses;
+        uint32_t initMicros;
+        bool     initPending;
+        bool     initFailed;
+    };
+
+    struct EffectListSnapshot
+    {
+        size_t currentEffect;
+        uint   millisecondsRemaining;
+        bool   eternalInterval;
+        uint   effectInterval;
+        std::vector<EffectEntry> effects;
+    };
+
+    auto snapshot = std::make_shared<EffectListSnapshot>();
     auto& effectManager = g_ptrSystem->GetEffectManager();
-    bool overflow = false;
 
     {
         std::scoped_lock guard(g_render_mutex, g_effect_manager_mutex);
 
-        j["currentEffect"]         = effectManager.GetCurrentEffectIndex();
-        j["millisecondsRemaining"] = effectManager.GetTimeRemainingForCurrentEffect();
-        j["eternalInterval"]       = effectManager.IsIntervalEternal();
-        j["effectInterval"]        = effectManager.GetInterval();
+        snapshot->currentEffect         = effectManager.GetCurrentEffectIndex();
+        snapshot->millisecondsRemaining = effectManager.GetTimeRemainingForCurrentEffect();
+        snapshot->eternalInterval       = effectManager.IsIntervalEternal();
+        snapshot->effectInterval        = effectManager.GetInterval();
 
-        for (const auto& effect : effectManager.EffectsList())
+        const auto effects = effectManager.EffectsList();
+        snapshot->effects.reserve(effects.size());
+        for (const auto& effect : effects)
         {
-            auto effectDoc = CreateJsonDocument();
-
-            effectDoc["name"]    = effect->FriendlyName();
-            effectDoc["enabled"] = effect->IsEnabled();
-            effectDoc["core"]    = effect->IsCoreEffect();
-
-            if (!j["Effects"].add(effectDoc))
-            {
-                debugV("JSON response buffer overflow!");
-                overflow = true;
-                break;
-            }
+            const auto& budget = effect->GetRenderBudget();
+            snapshot->effects.push_back({ effect->FriendlyName(), effect->IsEnabled(), effect->IsCoreEffect(),
+                                          effect->QualityLevel(), effect->QualityLevels(),
+                                          budget.AverageMicros(), budget.Misses(),
+                                          effect->LastInitMicros(), effect->IsInitPending(), effect->InitFailed() });
         }
     }
 
-    if (overflow)
+    // Fragment 0 is the header through the opening '[', then one per effect, then the closing "]}"
+    auto response = JsonChunkStream::BeginResponse(pRequest, [snapshot, first = true](size_t index, String& out) mutable
     {
-        response.reset();
-        SendBufferOverflowResponse(pRequest);
-        return;
-    }
+        const size_t effectCount = snapshot->effects.size();
+
+        if (index == 0)
+        {
+            out += '{';
+            JsonChunkStream::AppendKey(out, "currentEffect");
+            out += snapshot->currentEffect;
+            out += ',';
+            JsonChunkStream::AppendKey(out, "millisecondsRemaining");
+            out += snapshot->millisecondsRemaining;
+            out += ',';
+            JsonChunkStream::AppendKey(out, "eternalInterval");
+            out += snapshot->eternalInterval ? "true" : "false";
+            out += ',';
+            JsonChunkStream::AppendKey(out, "effectInterval");
+            out += snapshot->effectInterval;
+            out += ',';
+            JsonChunkStream::AppendKey(out, "Effects");
+            out += '[';
+            return true;
+        }
+
+        if (index <= effectCount)
+        {
+            const auto& entry = snapshot->effects[index - 1];
+            auto effectDoc = CreateJsonDocument();
+            effectDoc["name"]    = entry.name;
+            effectDoc["enabled"] = entry.enabled;
+            effectDoc["core"]    = entry.core;
+            effectDoc["qualityLevel"]  = entry.qualityLevel;
+            effectDoc["qualityLevels"] = entry.qualityLevels;
+            effectDoc["drawMicros"]    = entry.drawMicros;
+            effectDoc["budgetMisses"]  = entry.budgetMisses;
+            effectDoc["initMicros"]    = entry.initMicros;
+            effectDoc["initPending"]   = entry.initPending;
+            effectDoc["initFailed"]    = entry.initFailed;
+
+            if (!JsonChunkStream::AppendElement(out, first, effectDoc))
+                debugW("Effect %s overflowed its JSON document; left out of the response.", entry.name.c_str());
+            return true;
+        }
+
+        if (index == effectCount + 1)
+        {
+            out += "]}";
+            return true;
+        }
 
-    AddCORSHeaderAndSendResponse(pRequest, response.release());
+        return false;
+    });
+
+    AddCORSHeaderAndSendResponse(pRequest, response);
 }
 
 void CWebServer::SetCurrentEffectIndex(AsyncWebServerRequest * pRequest)
@@ -150,6 +225,53 @@ void CWebServer::DeleteEffect(AsyncWebServerRequest * pRequest)
     AddCORSHeaderAndSendOKResponse(pRequest);
 }
 
+// GetEffectsConfig
+//
+// Sends the persisted effects config. A text JSON file goes out as is; only a
+// file that really is MessagePack is decoded and re-serialized as JSON. While
+// changes are still in the journal the file is out of date, so the effects
+// are serialized as they stand instead.
+
+void CWebServer::GetEffectsConfig(AsyncWebServerRequest * pRequest)
+{
+    debugV("GetEffectsConfig");
+
+    if (!IsEffectsConfigFileCurrent())
+    {
+        auto jsonDoc = CreateJsonDocument();
+        auto root = jsonDoc.to<JsonObject>();
+        if (!g_ptrSystem->GetEffectManager().SerializeToJSON(root) || jsonDoc.overflowed())
+        {
+            AddCORSHeaderAndSendResponse(pRequest, pRequest->beginResponse(HttpInternalServerError));
+            return;
+        }
+
+        auto response = pRequest->beginResponseStream("text/json");
+        serializeJson(jsonDoc, *response);
+        AddCORSHeaderAndSendResponse(pRequest, response);
+        return;
+    }
+
+    #if JSON_STORAGE_MSGPACK
+        if (IsBinaryJSONFile(EFFECTS_CONFIG_FILE))
+        {
+            auto jsonDoc = CreateJsonDocument();
+            if (!LoadJSONFile(EFFECTS_CONFIG_FILE, jsonDoc))
+            {
+                AddCORSHeaderAndSendResponse(pRequest, pRequest->beginResponse(HttpNotFound));
+                return;
+            }
+
+            auto response = pRequest->beginResponseStream("text/json");
+            serializeJson(jsonDoc, *response);
+            AddCORSHeaderAndSendResponse(pRequest, response);
+            return;
+        }
+    #endif
+
+    pRequest->send(SPIFFS, EFFECTS_CONFIG_FILE, "text/json");
+}
+
 void CWebServer::NextEffect(AsyncWebServerRequest * pRequest)
 {
     debugV("NextEffect");
@@ -198,7 +320,7 @@ void CWebServer::GetEffectSettingSpecs(AsyncWebServerRequest * pRequest)
         settingSpecs = effect->GetSettingSpecs();
     }
 
-    SendSettingSpecsResponse(pRequest, settingSpecs);
+    SendSettingSpecsResponse(pRequest, std::move(settingSpecs), effect);
 }
 
 void CWebServer::SendEffectSettingsResponse(AsyncWebServerRequest * pRequest, std::shared_ptr<LEDStripEffect> & effect)
@@ -234,7 +356,7 @@ void CWebServer::GetEffectSettings(AsyncWebServerRequest * pRequest)
     SendEffectSettingsResponse(pRequest, effect);
 }
 
-bool CWebServer::ApplyEffectSettings(AsyncWebServerRequest * pRequest, std::shared_ptr<LEDStripEffect> & effect)
+bool CWebServer::ApplyEffectSettings(AsyncWebServerRequest * pRequest, std::shared_ptr<LEDStripEffect> & effect, std::vector<std::pair<String, String>> * pApplied)
 {
     bool settingChanged = false;
 
@@ -245,8 +367,14 @@ bool CWebServer::ApplyEffectSettings(AsyncWebServerRequest * pRequest, std::shar
         if (spec.ApiPath)
             continue;
         const String& settingName = spec.Name;
-        settingChanged = PushPostParamIfPresent<String>(pRequest, settingName, [&](auto value) { return effect->SetSetting(settingName, value); })
-            || settingChanged;
+        settingChanged = PushPostParamIfPresent<String>(pRequest, settingName, [&](auto value)
+        {
+            if (!effect->SetSetting(settingName, value))
+                return false;
+            if (pApplied)
+                pApplied->emplace_back(settingName, value);
+            return true;
+        }) || settingChanged;
     }
 
     return settingChanged;
@@ -261,8 +389,10 @@ void CWebServer::SetEffectSettings(AsyncWebServerRequest * pRequest)
     if (!CheckAndGetSettingsEffect(pRequest, effect, true))
         return;
 
-    if (ApplyEffectSettings(pRequest, effect))
-        SaveEffectManagerConfig();
+    // Only the settings that were actually applied go to the journal
+    std::vector<std::pair<String, String>> applied;
+    if (ApplyEffectSettings(pRequest, effect, &applied))
+        JournalEffectSettings(GetEffectIndexFromParam(pRequest, true), applied);
 
     SendEffectSettingsResponse(pRequest, effect);
 }
@@ -25,6 +25,7 @@
 #include "audioservice.h"
 #include "deviceconfig.h"
 #include "effectmanager.h"
+#include "jsonchunkstream.h"
 #include "ledstripeffect.h"
 #include "systemcontainer.h"
 
@@ -60,34 +61,15 @@ bool CWebServer::ApplyAudioInputPinChange(int oldPin)
     return true;
 }
 
-void CWebServer::SendSettingSpecsResponse(AsyncWebServerRequest * pRequest, const std::vector<std::reference_wrapper<SettingSpec>> & settingSpecs)
-{
-    String json;
-    if (!BuildSettingSpecsJson(json, settingSpecs))
-    {
-        debugW("Unable to build setting specs JSON response.");
-        SendBufferOverflowResponse(pRequest);
-        return;
-    }
-
-    AddCORSHeaderAndSendResponse(pRequest, pRequest->beginResponse(HttpOk, "application/json", json));
-}
-
-bool CWebServer::BuildSettingSpecsJson(String& json, const std::vector<std::reference_wrapper<SettingSpec>> & settingSpecs)
+namespace
 {
-    auto jsonDoc = CreateJsonDocument();
-    auto jsonArray = jsonDoc.to<JsonArray>();
+    // SerializeSettingSpec
+    //
+    // Shared by the cached device specs document and the streamed per-effect
+    // spec list, so both describe a setting identically.
 
-    for (const auto& specWrapper : settingSpecs)
+    void SerializeSettingSpec(JsonObject specObject, const SettingSpec& spec)
     {
-        const auto& spec = specWrapper.get();
-        auto specObject = jsonArray.add<JsonObject>();
-        if (specObject.isNull())
-        {
-            debugW("Setting specs JSON object allocation failed.");
-            return false;
-        }
-
         specObject["name"] = spec.Name;
         specObject["friendlyName"] = spec.FriendlyName;
         if (spec.Description)
@@ -183,6 +165,67 @@ bool CWebServer::BuildSettingSpecsJson(String& json, const std::vector<std::refe
             }
         }
     }
+}
+
+// SendSettingSpecsResponse
+//
+// Streams the specs as a JSON array, one spec per fragment. The caller takes
+// the list under its lock; owner keeps whatever holds the specs (usually the
+// effect) alive until the response has been sent. A spec too big to serialize
+// is left out, so the array stays valid JSON.
+
+void CWebServer::SendSettingSpecsResponse(AsyncWebServerRequest * pRequest, std::vector<std::reference_wrapper<SettingSpec>> settingSpecs, std::shared_ptr<const void> owner)
+{
+    auto specs = std::make_shared<std::vector<std::reference_wrapper<SettingSpec>>>(std::move(settingSpecs));
+
+    auto response = JsonChunkStream::BeginResponse(pRequest, [specs, owner, first = true](size_t index, String& out) mutable
+    {
+        const size_t specCount = specs->size();
+
+        if (index == 0)
+        {
+            out += '[';
+            return true;
+        }
+
+        if (index <= specCount)
+        {
+            auto specDoc = CreateJsonDocument();
+            SerializeSettingSpec(specDoc.to<JsonObject>(), (*specs)[index - 1].get());
+
+            if (!JsonChunkStream::AppendElement(out, first, specDoc))
+                debugW("Setting spec %s overflowed its JSON document; left out of the response.", (*specs)[index - 1].get().Name);
+            return true;
+        }
+
+        if (index == specCount + 1)
+        {
+            out += ']';
+            return true;
+        }
+
+        return false;
+    });
+
+    AddCORSHeaderAndSendResponse(pRequest, response);
+}
+
+bool CWebServer::BuildSettingSpecsJson(String& json, const std::vector<std::reference_wrapper<SettingSpec>> & settingSpecs)
+{
+    auto jsonDoc = CreateJsonDocument();
+    auto jsonArray = jsonDoc.to<JsonArray>();
+
+    for (const auto& specWrapper : settingSpecs)
+    {
+        auto specObject = jsonArray.add<JsonObject>();
+        if (specObject.isNull())
+        {
+            debugW("Setting specs JSON object allocation failed.");
+            return false;
+        }
+
+        SerializeSettingSpec(specObject, specWrapper.get());
+    }
 
     if (jsonDoc.overflowed())
     {
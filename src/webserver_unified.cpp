@@ -20,6 +20,7 @@
 
 #include "deviceconfig.h"
 #include "effectmanager.h"
+#include "jsonchunkstream.h"
 #include "systemcontainer.h"
 
 void CWebServer::GetUnifiedSettings(AsyncWebServerRequest * pRequest)
@@ -32,11 +33,39 @@ void CWebServer::GetUnifiedSettings(AsyncWebServerRequest * pRequest)
     AddCORSHeaderAndSendResponse(pRequest, response);
 }
 
+// GetUnifiedSettingsSchema
+//
+// Streams the schema one top-level member at a time. The schema describes
+// compiled-in limits and DeviceConfig, which outlives the web server, so
+// there is nothing to snapshot. A part too big to serialize is left out, so
+// the object stays valid JSON.
+
 void CWebServer::GetUnifiedSettingsSchema(AsyncWebServerRequest * pRequest)
 {
-    auto response = new AsyncJsonResponse();
-    auto root = response->getRoot().to<JsonObject>();
-    g_ptrSystem->GetDeviceConfig().SerializeUnifiedSettingsSchema(root);
+    auto response = JsonChunkStream::BeginResponse(pRequest, [first = true](size_t index, String& out) mutable
+    {
+        if (index < DeviceConfig::kUnifiedSettingsSchemaPartCount)
+        {
+            auto partDoc = CreateJsonDocument();
+            g_ptrSystem->GetDeviceConfig().SerializeUnifiedSettingsSchemaPart(index, partDoc.to<JsonVariant>());
+
+            if (index == 0)
+                out += '{';
+            const char* partName = DeviceConfig::UnifiedSettingsSchemaPartName(index);
+            if (!JsonChunkStream::AppendMember(out, first, partName, partDoc))
+                debugW("Settings schema part %s overflowed its JSON document; left out of the response.", partName);
+            return true;
+        }
+
+        if (index == DeviceConfig::kUnifiedSettingsSchemaPartCount)
+        {
+            out += '}';
+            return true;
+        }
+
+        return false;
+    });
+
     AddCORSHeaderAndSendResponse(pRequest, response);
 }
 
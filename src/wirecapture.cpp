@@ -0,0 +1,192 @@
+//+--------------------------------------------------------------------------
+//
+// File:        wirecapture.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Wire capture ring and capture file reader; see wirecapture.h.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "byte_utils.h"
+#include "wirecapture.h"
+
+namespace
+{
+    void StoreDWORD(uint8_t* destination, uint32_t value)
+    {
+        destination[0] = (uint8_t)value;
+        destination[1] = (uint8_t)(value >> 8);
+        destination[2] = (uint8_t)(value >> 16);
+        destination[3] = (uint8_t)(value >> 24);
+    }
+}
+
+WireCapture::WireCapture(size_t capacityBytes)
+    : _ring(make_unique_psram<uint8_t[]>(capacityBytes)),
+      _capacity(_ring ? capacityBytes : 0)
+{
+}
+
+// Record
+//
+// The oldest records are dropped until the new one fits.  A record never straddles the tail, so the ring is
+// always a whole number of records and Save() can walk it from the tail.
+
+bool WireCapture::Record(const uint8_t* packet, size_t length, uint32_t timestampMicros)
+{
+    std::lock_guard guard(_mutex);
+
+    const size_t needed = kRecordHeader + length;
+    if (needed > _capacity)
+    {
+        _dropped++;
+        return false;
+    }
+
+    while (_capacity - _used < needed)
+        DropOldest();
+
+    uint8_t header[kRecordHeader];
+    StoreDWORD(&header[0], _records ? timestampMicros - _lastTimestamp : 0);
+    StoreDWORD(&header[4], (uint32_t)length);
+
+    Put(header, sizeof(header));
+    Put(packet, length);
+
+    _lastTimestamp = timestampMicros;
+    _records++;
+    return true;
+}
+
+void WireCapture::Clear()
+{
+    std::lock_guard guard(_mutex);
+
+    _head = _tail = _used = _records = 0;
+    _dropped = 0;
+}
+
+size_t WireCapture::Save(const Writer& write) const
+{
+    std::lock_guard guard(_mutex);
+
+    uint8_t fileHeader[kFileHeader] = { kMagic[0], kMagic[1], kMagic[2], kMagic[3],
+                                        (uint8_t)kVersion, (uint8_t)(kVersion >> 8), 0, 0 };
+    if (!write(fileHeader, sizeof(fileHeader)))
+        return 0;
+
+    size_t written = sizeof(fileHeader);
+
+    // The ring is at most two runs of bytes, either side of the wrap
+    const size_t firstRun = std::min(_used, _capacity - _tail);
+    if (firstRun && !write(&_ring[_tail], firstRun))
+        return written;
+    written += firstRun;
+
+    if (_used > firstRun && !write(&_ring[0], _used - firstRun))
+        return written;
+
+    return written + _used - firstRun;
+}
+
+size_t WireCapture::Records() const
+{
+    std::lock_guard guard(_mutex);
+    return _records;
+}
+
+size_t WireCapture::Bytes() const
+{
+    std::lock_guard guard(_mutex);
+    return kFileHeader + _used;
+}
+
+uint32_t WireCapture::Dropped() const
+{
+    std::lock_guard guard(_mutex);
+    return _dropped;
+}
+
+void WireCapture::Put(const uint8_t* data, size_t length)
+{
+    if (length == 0)
+        return;
+
+    const size_t firstRun = std::min(length, _capacity - _head);
+    memcpy(&_ring[_head], data, firstRun);
+    memcpy(&_ring[0], data + firstRun, length - firstRun);
+
+    _head = (_head + length) % _capacity;
+    _used += length;
+}
+
+void WireCapture::Get(size_t position, uint8_t* data, size_t length) const
+{
+    const size_t firstRun = std::min(length, _capacity - position);
+    memcpy(data, &_ring[position], firstRun);
+    memcpy(data + firstRun, &_ring[0], length - firstRun);
+}
+
+void WireCapture::DropOldest()
+{
+    uint8_t header[kRecordHeader];
+    Get(_tail, header, sizeof(header));
+
+    const size_t size = kRecordHeader + DWORDFromMemory(&header[4]);
+    _tail = (_tail + size) % _capacity;
+    _used -= size;
+    _records--;
+    _dropped++;
+}
+
+WireCaptureReader::WireCaptureReader(const uint8_t* capture, size_t length)
+    : _capture(capture),
+      _length(length),
+      _position(WireCapture::kFileHeader),
+      _valid(capture && length >= WireCapture::kFileHeader
+             && !memcmp(capture, WireCapture::kMagic, sizeof(WireCapture::kMagic))
+             && WORDFromMemory(&capture[4]) == WireCapture::kVersion)
+{
+}
+
+bool WireCaptureReader::Next(WireCaptureRecord& record)
+{
+    if (!_valid || _length - _position < WireCapture::kRecordHeader)
+        return false;
+
+    const uint8_t* header = &_capture[_position];
+    const uint32_t length = DWORDFromMemory(&header[4]);
+    if (_length - _position - WireCapture::kRecordHeader < length)
+        return false;
+
+    record.deltaMicros = DWORDFromMemory(&header[0]);
+    record.data        = header + WireCapture::kRecordHeader;
+    record.length      = length;
+
+    _position += WireCapture::kRecordHeader + length;
+    return true;
+}
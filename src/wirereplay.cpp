@@ -0,0 +1,134 @@
+//+--------------------------------------------------------------------------
+//
+// File:        wirereplay.cpp
+//
+// NightDriverStrip - (c) 2026 Plummer's Software LLC.  All Rights Reserved.
+//
+// This file is part of the NightDriver software project.
+//
+//    NightDriver is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    NightDriver is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with Nightdriver.  It is normally found in copying.txt
+//    If not, see <https://www.gnu.org/licenses/>.
+//
+// Description:
+//
+//    Wire capture playback and ingest measurements; see wirereplay.h.
+//
+//---------------------------------------------------------------------------
+
+#include "globals.h"
+
+#include <algorithm>
+
+#include "byte_utils.h"
+#include "socketserver.h"
+#include "wirereplay.h"
+
+uint32_t WireReplay::Stats::PacketsPerSecond() const
+{
+    return elapsedMicros ? (uint32_t)((uint64_t)packets * 1000000 / elapsedMicros) : 0;
+}
+
+uint32_t WireReplay::Stats::AverageIngestMicros() const
+{
+    return packets ? (uint32_t)(ingestMicros / packets) : 0;
+}
+
+uint32_t WireReplay::Stats::AverageCompressedMicros() const
+{
+    return compressed ? (uint32_t)(compressedMicros / compressed) : 0;
+}
+
+WireReplay::WireReplay(MicrosClock clock, MicrosWait wait)
+    : _clock(clock),
+      _wait(wait)
+{
+}
+
+uint32_t WireReplay::DefaultClock()
+{
+    return micros();
+}
+
+// DefaultWait
+//
+// Long waits give the CPU away; short ones spin, as a tick would be far longer than the wait itself
+
+void WireReplay::DefaultWait(uint32_t micros)
+{
+    if (micros >= 2000)
+        delay(micros / 1000);
+    else
+        delayMicroseconds(micros);
+}
+
+// Run
+//
+// Due times are kept relative to the start of the replay rather than to the previous packet, so time lost on
+// one packet isn't quietly made up by shifting all the ones after it.
+
+WireReplay::Stats WireReplay::Run(WireCaptureReader& capture, Timing timing, const Ingest& ingest, const DepthProbe& depth)
+{
+    Stats stats;
+    WireCaptureRecord record;
+
+    const uint32_t start = _clock();
+    uint32_t due = 0;
+
+    while (capture.Next(record))
+    {
+        if (timing == Timing::Original)
+        {
+            if (stats.packets)
+                due += record.deltaMicros;
+
+            uint32_t elapsed;
+            while ((elapsed = _clock() - start) < due)
+                _wait(due - elapsed);
+
+            const uint32_t lateness = elapsed - due;
+            stats.maxLateMicros = std::max(stats.maxLateMicros, lateness);
+            if (lateness > kLateMicros)
+                stats.late++;
+        }
+
+        const bool compressed = record.length >= sizeof(uint32_t) && DWORDFromMemory(record.data) == COMPRESSED_HEADER;
+
+        const uint32_t ingestStart = _clock();
+        const bool accepted = ingest(record.data, record.length);
+        const uint32_t ingestMicros = _clock() - ingestStart;
+
+        stats.packets++;
+        stats.bytes += record.length;
+        stats.ingestMicros += ingestMicros;
+        stats.maxIngestMicros = std::max(stats.maxIngestMicros, ingestMicros);
+        if (!accepted)
+            stats.failed++;
+
+        if (compressed)
+        {
+            stats.compressed++;
+            stats.compressedMicros += ingestMicros;
+        }
+
+        if (depth)
+        {
+            const size_t queued = depth();
+            stats.maxDepth = std::max(stats.maxDepth, queued);
+            stats.depthTotal += queued;
+        }
+    }
+
+    stats.elapsedMicros = _clock() - start;
+    return stats;
+}
@@ -37,6 +37,7 @@
 #include "deviceconfig.h"
 #include "effectmanager.h"
 #include "pixelformat.h"
+#include "powermodel.h"
 #include "systemcontainer.h"
 #include "values.h"
 #include "ws281xgfx.h"
@@ -54,14 +55,6 @@ namespace
 {
     DRAM_ATTR std::mutex g_ws281xTransportMutex;
 
-    constexpr uint8_t kPowerRedMw = 16 * 5;      // FastLED default: 16 mA at 5 V
-    constexpr uint8_t kPowerGreenMw = 11 * 5;    // FastLED default: 11 mA at 5 V
-    constexpr uint8_t kPowerBlueMw = 15 * 5;     // FastLED default: 15 mA at 5 V
-    constexpr uint8_t kPowerDarkMw = 1 * 5;      // FastLED default: 1 mA at 5 V
-
-    #ifndef SK6812_WHITE_MW
-        #define SK6812_WHITE_MW (15 * 5)
-    #endif
     #ifndef NIGHTDRIVER_DEFAULT_AMBIENT_CW
         #define NIGHTDRIVER_DEFAULT_AMBIENT_CW 0
     #endif
@@ -72,37 +65,22 @@ namespace
         #define SK6812_WHITE_EXTRACT_RATIO 128
     #endif
 
-    constexpr uint8_t kPowerWhiteMw = SK6812_WHITE_MW;
     constexpr uint8_t kDefaultAmbientCw = NIGHTDRIVER_DEFAULT_AMBIENT_CW;
     constexpr uint8_t kDefaultAmbientWw = NIGHTDRIVER_DEFAULT_AMBIENT_WW;
     constexpr uint8_t kDefaultWhiteExtractRatio = SK6812_WHITE_EXTRACT_RATIO;
 
-    uint32_t EstimateRGBUnscaledPowerMw(const CRGB* leds, size_t ledCount)
-    {
-        uint32_t red = 0;
-        uint32_t green = 0;
-        uint32_t blue = 0;
+    // EstimateWS281xUnscaledPowerMw
+    //
+    // Draw of the first ledCount pixels at full brightness under the power model. Plain RGB strips
+    // take the channel sums the effect reported when they describe exactly these pixels; SK6812
+    // strips visit every pixel regardless, to work out how much of each moves to the white die.
 
-        for (size_t i = 0; i < ledCount; ++i)
-        {
-            red += leds[i].r;
-            green += leds[i].g;
-            blue += leds[i].b;
-        }
-
-        return ((red * kPowerRedMw) >> 8)
-             + ((green * kPowerGreenMw) >> 8)
-             + ((blue * kPowerBlueMw) >> 8)
-             + (kPowerDarkMw * ledCount);
-    }
-
-    uint32_t EstimateWS281xUnscaledPowerMw(const GFXBase& graphics, size_t ledCount)
+    uint32_t EstimateWS281xUnscaledPowerMw(const PowerModel& model, const GFXBase& graphics, size_t ledCount, bool wholeBufferDrawn, ChannelSums& sums)
     {
         #if defined(USE_SK6812) && USE_SK6812
-            uint32_t red = 0;
-            uint32_t green = 0;
-            uint32_t blue = 0;
-            uint32_t white = 0;
+            sums = ChannelSums{};
+            sums.count = ledCount;
+            uint64_t totalUw = static_cast<uint64_t>(ledCount) * model.Config().idleUwPerLed;
             const uint16_t ratio = static_cast<uint16_t>(kDefaultWhiteExtractRatio);
             const uint8_t ambientWhite = PixelFormatHelpers::SaturatingAdd(kDefaultAmbientCw, kDefaultAmbientWw);
 
@@ -122,20 +100,25 @@ namespace
                     color.g -= pull;
                     color.b -= pull;
                 }
-
-                red += color.r;
-                green += color.g;
-                blue += color.b;
-                white += std::max(PixelFormatHelpers::SaturatingAdd(pull, effectWhite), ambientWhite);
+                const uint8_t white = std::max(PixelFormatHelpers::SaturatingAdd(pull, effectWhite), ambientWhite);
+
+                sums.red += color.r;
+                sums.green += color.g;
+                sums.blue += color.b;
+                sums.white += white;
+                totalUw += model.LevelUw(PowerModel::Red, color.r)
+                         + model.LevelUw(PowerModel::Green, color.g)
+                         + model.LevelUw(PowerModel::Blue, color.b)
+                         + model.LevelUw(PowerModel::White, white);
             }
 
-            return ((red * kPowerRedMw) >> 8)
-                 + ((green * kPowerGreenMw) >> 8)
-                 + ((blue * kPowerBlueMw) >> 8)
-                 + ((white * kPowerWhiteMw) >> 8)
-                 + (kPowerDarkMw * ledCount);
+            return static_cast<uint32_t>(totalUw / 1000);
         #else
-            return EstimateRGBUnscaledPowerMw(graphics.leds, ledCount);
+            const ChannelSums* known = wholeBufferDrawn ? graphics.GetFrameChannelSums() : nullptr;
+            if (known && known->count != ledCount)
+                known = nullptr;
+
+            return model.EstimateMw(graphics.leds, ledCount, known, sums);
         #endif
     }
 
@@ -319,22 +302,38 @@ void WS281xGFX::PostProcessFrame(uint16_t localPixelsDrawn, uint16_t wifiPixelsD
     }
 
     auto& outputManager = g_ptrSystem->GetStripOutputManager();
-    uint32_t unscaledPowerMw = 0;
+    const auto model = PowerModel::Current();
+    uint32_t unscaledPowerMw = model->BaseMw();
+    ChannelSums frameSums;
     const size_t activeChannelCount = std::min<size_t>(outputManager.GetActiveChannelCount(), NUM_CHANNELS);
     const size_t activeLEDCount = outputManager.GetActiveLEDCount();
     for (size_t i = 0; i < activeChannelCount; ++i)
     {
         auto& graphics = effectManager.g(i);
         const size_t ledCount = std::min(activeLEDCount, graphics.GetLEDCount());
-        unscaledPowerMw += EstimateWS281xUnscaledPowerMw(graphics, ledCount);
+        ChannelSums channelSums;
+        unscaledPowerMw += EstimateWS281xUnscaledPowerMw(*model, graphics, ledCount, pixelsDrawn >= ledCount, channelSums);
+        frameSums += channelSums;
     }
 
     uint8_t outputBrightness = deviceConfig.GetBrightness();
     outputBrightness = LimitBrightnessForPower(unscaledPowerMw, outputBrightness, g_Values.Fader, deviceConfig.GetPowerLimit());
     outputManager.Show(g_ptrSystem->GetDevices(), pixelsDrawn, outputBrightness, g_Values.Fader);
 
+    const uint32_t scaledPowerMw = ScalePowerMw(unscaledPowerMw, outputBrightness, g_Values.Fader);
     g_Values.Brite = 100.0 * outputBrightness / 255;
-    g_Values.Watts = ScalePowerMw(unscaledPowerMw, outputBrightness, g_Values.Fader) / 1000; // 1000 for mW->W
+    g_Values.Watts = scaledPowerMw / 1000; // 1000 for mW->W
+
+    if (PowerCalibration::IsActive())
+    {
+        // Report what the strip is actually being driven with, not the full-brightness frame
+        const uint32_t scale = static_cast<uint32_t>(outputBrightness) * g_Values.Fader;
+        frameSums.red   = static_cast<uint32_t>((static_cast<uint64_t>(frameSums.red)   * scale) >> 16);
+        frameSums.green = static_cast<uint32_t>((static_cast<uint64_t>(frameSums.green) * scale) >> 16);
+        frameSums.blue  = static_cast<uint32_t>((static_cast<uint64_t>(frameSums.blue)  * scale) >> 16);
+        frameSums.white = static_cast<uint32_t>((static_cast<uint64_t>(frameSums.white) * scale) >> 16);
+        PowerCalibration::NoteFrame(frameSums, scaledPowerMw);
+    }
     #endif
 }
 
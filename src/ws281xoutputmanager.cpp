@@ -21,6 +21,7 @@
 #include "ws281xoutputmanager.h"
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
 
 #include <esp_err.h>
@@ -42,6 +43,7 @@
 #endif
 #define CONFIG_RMT_SUPPRESS_DEPRECATE_WARN 1
 #include <driver/rmt.h>
+#include <hal/cpu_hal.h>
 #ifndef RMT_DEFAULT_CONFIG_TX
     #error "NightDriverStrip WS281x runtime transport requires the ESP-IDF legacy RMT API on IDF 4.x."
 #endif
@@ -123,30 +125,93 @@ namespace
         return item;
     }
 
-    const DRAM_ATTR rmt_item32_t kBitZero = MakeRmtItem(NsToRmtTicks(kWs2812T0HighNs), NsToRmtTicks(kWs2812T0LowNs));
-    const DRAM_ATTR rmt_item32_t kBitOne  = MakeRmtItem(NsToRmtTicks(kWs2812T1HighNs), NsToRmtTicks(kWs2812T1LowNs));
+    constexpr rmt_item32_t kBitZero = MakeRmtItem(NsToRmtTicks(kWs2812T0HighNs), NsToRmtTicks(kWs2812T0LowNs));
+    constexpr rmt_item32_t kBitOne  = MakeRmtItem(NsToRmtTicks(kWs2812T1HighNs), NsToRmtTicks(kWs2812T1LowNs));
+
+    // The items for each of the 16 nibbles, most significant bit first, so the translator can expand a byte
+    // as two four-item copies instead of testing and branching on every bit. A full 256 x 8 table would
+    // save one lookup per byte at the cost of 8K of DRAM; this one is 256 bytes.
+    using RmtNibbleItems = std::array<rmt_item32_t, 4>;
+
+    constexpr std::array<RmtNibbleItems, 16> MakeNibbleTable()
+    {
+        std::array<RmtNibbleItems, 16> table{};
+        for (uint8_t nibble = 0; nibble < 16; ++nibble)
+            for (uint8_t bit = 0; bit < 4; ++bit)
+                table[nibble][bit] = (nibble & (0x08 >> bit)) ? kBitOne : kBitZero;
+        return table;
+    }
+
+    constexpr auto kNibbleTable = MakeNibbleTable();
+
+    constexpr bool SameRmtItem(const rmt_item32_t& a, const rmt_item32_t& b)
+    {
+        return a.level0 == b.level0 && a.duration0 == b.duration0 && a.level1 == b.level1 && a.duration1 == b.duration1;
+    }
+
+    // Every byte value expands through the table exactly as it would bit by bit
+    constexpr bool NibbleTableMatchesBits()
+    {
+        for (uint16_t value = 0; value < 256; ++value)
+        {
+            for (uint8_t bit = 0; bit < 8; ++bit)
+            {
+                const rmt_item32_t& expected = (value & (0x80 >> bit)) ? kBitOne : kBitZero;
+                const rmt_item32_t& actual = bit < 4 ? kNibbleTable[value >> 4][bit] : kNibbleTable[value & 0x0F][bit - 4];
+                if (!SameRmtItem(expected, actual))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(NibbleTableMatchesBits(), "RMT nibble table does not match the bitwise expansion");
+
+    // The translator runs from the RMT ISR, which may fire while the flash cache is off, so its table and
+    // counters have to live in DRAM
+    const DRAM_ATTR std::array<RmtNibbleItems, 16> kNibbleItems = kNibbleTable;
+
+    constexpr uint8_t kRefillSmoothingShift = 4;
+
+    DRAM_ATTR volatile uint32_t g_rmtRefills = 0;
+    DRAM_ATTR volatile uint32_t g_rmtRefillCycles = 0;           // Smoothed
+    DRAM_ATTR volatile uint32_t g_rmtRefillMaxCycles = 0;
 
     // The translator is called by the legacy RMT driver as it needs more items.
     // It consumes raw GRB/RGB/etc. bytes and expands each bit into one timing
     // item, so the higher layers only need to provide packed color bytes.
     void IRAM_ATTR WS2812ByteTranslator(const void* src, rmt_item32_t* dest, size_t srcSize, size_t wantedNum, size_t* translatedSize, size_t* itemNum)
     {
+        const uint32_t startCycles = cpu_hal_get_cycle_count();
+
         const auto* bytes = static_cast<const uint8_t*>(src);
         const size_t maxBytesByItems = wantedNum / 8;
         const size_t maxBytes = srcSize < maxBytesByItems ? srcSize : maxBytesByItems;
 
-        size_t outputItems = 0;
-        size_t consumedBytes = 0;
-        while (consumedBytes < maxBytes)
+        for (size_t consumedBytes = 0; consumedBytes < maxBytes; ++consumedBytes)
         {
             const uint8_t value = bytes[consumedBytes];
-            for (int bit = 7; bit >= 0; --bit)
-                dest[outputItems++] = (value & (1U << bit)) ? kBitOne : kBitZero;
-            ++consumedBytes;
+            const RmtNibbleItems& high = kNibbleItems[value >> 4];
+            const RmtNibbleItems& low  = kNibbleItems[value & 0x0F];
+
+            for (size_t item = 0; item < 4; ++item)
+            {
+                dest[item]     = high[item];
+                dest[item + 4] = low[item];
+            }
+            dest += 8;
         }
 
-        *translatedSize = consumedBytes;
-        *itemNum = outputItems;
+        *translatedSize = maxBytes;
+        *itemNum = maxBytes * 8;
+
+        // Every counter is a single word, so a reader on the other core never sees half an update
+        const uint32_t cycles = cpu_hal_get_cycle_count() - startCycles;
+        const uint32_t smoothed = g_rmtRefills ? g_rmtRefillCycles : cycles;
+        g_rmtRefillCycles = smoothed - (smoothed >> kRefillSmoothingShift) + (cycles >> kRefillSmoothingShift);
+        if (cycles > g_rmtRefillMaxCycles)
+            g_rmtRefillMaxCycles = cycles;
+        g_rmtRefills = g_rmtRefills + 1;
     }
 #endif // ESP_IDF_VERSION_MAJOR < 5
 
@@ -588,10 +653,24 @@ SuccessResultWithMessage WS281xOutputManager::ApplyConfig(const DeviceConfig& co
     _activeLEDCount = ledCount;
     _colorOrder = config.GetWS281xColorOrder();
 
+    // A new layout changes what a refill costs, so the worst case starts over
+    #if ESP_IDF_VERSION_MAJOR < 5
+        g_rmtRefillMaxCycles = 0;
+    #endif
+
     LogRuntimeWS281xConfiguration(config, devices, "apply");
     return { true, "" };
 }
 
+WS281xOutputManager::TranslatorStats WS281xOutputManager::GetTranslatorStats()
+{
+    #if ESP_IDF_VERSION_MAJOR < 5
+        return { g_rmtRefills, g_rmtRefillCycles, g_rmtRefillMaxCycles };
+    #else
+        return {};
+    #endif
+}
+
 void WS281xOutputManager::Show(const std::vector<std::shared_ptr<GFXBase>>& devices, uint16_t pixelsDrawn, uint8_t brightness, uint8_t fader)
 {
     // The same mutex used by ApplyConfig() keeps live transport mutations from
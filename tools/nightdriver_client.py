@@ -152,13 +152,115 @@ class NightDriver:
         return self._post("/settings/effect", data=data)
 
 
+PREVIEW_MAGIC = b'NDPV'
+PREVIEW_REQUEST_MAGIC = b'NDPR'
+PREVIEW_HEADER_SIZE = 20
+PREVIEW_ENCODINGS = {"raw": 0, "rle": 1, "delta": 2}
+
+
+def preview_request(scale=1, encoding="delta", max_fps=0):
+    """
+    Builds the request a ColorServer client sends to switch to preview packets.
+
+    Args:
+        scale: Divide each side of the frame by this (1-8).
+        encoding: The richest encoding to accept: raw, rle or delta.
+        max_fps: Frame rate cap, or 0 for every frame.
+    """
+    return PREVIEW_REQUEST_MAGIC + struct.pack('<BBH', scale, PREVIEW_ENCODINGS[encoding], max_fps)
+
+
+class PreviewDecoder:
+    """
+    Decodes the preview packets a device sends after a preview request (see
+    include/previewencoder.h). Delta packets patch the frame before them, so
+    one decoder has to see every packet from the same stream, in order.
+    """
+
+    def __init__(self):
+        self.previous = None
+
+    @staticmethod
+    def parse_header(header):
+        """
+        Returns (width, height, encoding, scale, sequence, payload_length) from a 20 byte header.
+        """
+        if header[0:4] != PREVIEW_MAGIC:
+            raise ValueError(f"Bad preview packet magic {header[0:4]!r}")
+        width, height, encoding, scale, _, sequence, payload_length = struct.unpack('<HHBBHII', header[4:PREVIEW_HEADER_SIZE])
+        return width, height, encoding, scale, sequence, payload_length
+
+    def decode(self, packet):
+        """
+        Decodes one whole packet into a frame dictionary with 'width', 'height', 'scale', 'sequence' and
+        'pixels', the pixels row-major as (r, g, b) tuples.
+        """
+        width, height, encoding, scale, sequence, payload_length = self.parse_header(packet)
+        payload = packet[PREVIEW_HEADER_SIZE:PREVIEW_HEADER_SIZE + payload_length]
+        if len(payload) != payload_length:
+            raise ValueError(f"Preview packet cut short: {len(payload)} of {payload_length} payload bytes")
+
+        count = width * height
+        if encoding == PREVIEW_ENCODINGS["raw"]:
+            if payload_length != count * 3:
+                raise ValueError(f"Raw preview payload is {payload_length} bytes for {count} pixels")
+            pixels = [tuple(payload[i:i + 3]) for i in range(0, payload_length, 3)]
+
+        elif encoding == PREVIEW_ENCODINGS["rle"]:
+            pixels = []
+            for i in range(0, payload_length - 3, 4):
+                pixels.extend([tuple(payload[i + 1:i + 4])] * (payload[i] + 1))
+            if len(pixels) != count:
+                raise ValueError(f"Run-length preview payload holds {len(pixels)} pixels, not {count}")
+
+        elif encoding == PREVIEW_ENCODINGS["delta"]:
+            if self.previous is None or (self.previous['width'], self.previous['height']) != (width, height):
+                raise ValueError("Delta preview packet without a matching frame before it")
+            pixels = list(self.previous['pixels'])
+            index = 0
+            position = 0
+            while position + 2 <= payload_length:
+                skip, literals = payload[position], payload[position + 1]
+                position += 2
+                index += skip
+                if index + literals > count or position + literals * 3 > payload_length:
+                    raise ValueError("Delta preview payload runs past the frame")
+                for n in range(literals):
+                    pixels[index + n] = tuple(payload[position + n * 3:position + n * 3 + 3])
+                index += literals
+                position += literals * 3
+
+        else:
+            raise ValueError(f"Unknown preview encoding {encoding}")
+
+        frame = {"width": width, "height": height, "scale": scale, "sequence": sequence, "pixels": pixels}
+        self.previous = frame
+        return frame
+
+
+def decode_preview_stream(data, verbose=False):
+    """
+    Decodes back to back preview packets, such as a saved stream, into a list of frames.
+    """
+    decoder = PreviewDecoder()
+    frames = []
+    position = 0
+    while len(data) - position >= PREVIEW_HEADER_SIZE:
+        payload_length = PreviewDecoder.parse_header(data[position:position + PREVIEW_HEADER_SIZE])[5]
+        end = position + PREVIEW_HEADER_SIZE + payload_length
+        frames.append(decoder.decode(data[position:end]))
+        if verbose: print(f"decode_preview_stream: Frame {frames[-1]['sequence']} from {end - position} bytes")
+        position = end
+    return frames
+
+
 class ColorClient:
     """
     A client for the NightDriver ColorServer.
     """
     MAX_INVALID_HEADER_MESSAGES = 3 # Limit the number of invalid header messages
 
-    def __init__(self, host, port=12000, verbose=False):
+    def __init__(self, host, port=12000, verbose=False, preview=None):
         """
         Initializes the ColorClient.
 
@@ -166,9 +268,12 @@ class ColorClient:
             host: The IP address or hostname of the NightDriver device.
             port: The port of the ColorServer (default 12000).
             verbose: Enable verbose output for debugging.
+            preview: Optional preview_request() arguments (scale, encoding, max_fps) to ask the
+                     device for scaled, encoded frames instead of the raw LED buffer.
         """
         self.host = host
         self.port = port
+        self.preview = preview
         self.sock = None
         self.data_queue = queue.Queue()
         self.stop_event = threading.Event()
@@ -184,6 +289,8 @@ class ColorClient:
         self.sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
         self.sock.settimeout(5.0) # Increased timeout for initial read
         self.sock.connect((self.host, self.port))
+        if self.preview is not None:
+            self.sock.sendall(preview_request(**self.preview))
         self.sock.settimeout(0.1)
 
         self.reader_thread = SocketReader(self.sock, self.data_queue, self.stop_event, verbose=self.verbose)
@@ -296,6 +403,9 @@ class ColorClient:
         Returns:
             A list of frames, where each frame is a dictionary with 'width', 'height', and 'pixels'.
         """
+        if self.preview is not None:
+            return self._capture_preview_frames(duration_seconds)
+
         frames = []
         start_time = time.time()
 
@@ -407,6 +517,51 @@ class ColorClient:
         if self.verbose: print(f"capture_frames: Exiting. Total frames captured: {self.frames_captured}, Total frames in error: {self.frames_in_error}")
         return frames
 
+    def _capture_preview_frames(self, duration_seconds):
+        """
+        capture_frames() for a client that asked for preview packets. The device may keep sending raw
+        packets until it has read the request, so anything before the first preview packet is skipped.
+        """
+        frames = []
+        decoder = PreviewDecoder()
+        start_time = time.time()
+
+        while True:
+            remaining_time = duration_seconds - (time.time() - start_time)
+            if remaining_time <= 0:
+                break
+
+            start = self.internal_buffer.find(PREVIEW_MAGIC)
+            if start < 0 or len(self.internal_buffer) - start < PREVIEW_HEADER_SIZE:
+                if start > 0:
+                    self.internal_buffer = self.internal_buffer[start:]
+                elif start < 0:
+                    self.internal_buffer = self.internal_buffer[-(len(PREVIEW_MAGIC) - 1):]
+                try:
+                    chunk = self.data_queue.get(timeout=min(remaining_time, 0.1))
+                except queue.Empty:
+                    continue
+                if chunk is None:
+                    break
+                self.internal_buffer += chunk
+                continue
+
+            self.internal_buffer = self.internal_buffer[start:]
+            payload_length = PreviewDecoder.parse_header(self.internal_buffer[:PREVIEW_HEADER_SIZE])[5]
+            packet = self._get_data_from_queue(PREVIEW_HEADER_SIZE + payload_length, remaining_time)
+            if packet is None:
+                break
+
+            try:
+                frames.append(decoder.decode(packet))
+                self.frames_captured += 1
+            except ValueError as e:
+                if self.verbose: print(f"_capture_preview_frames: {e}")
+                self.frames_in_error += 1
+
+        if self.verbose: print(f"_capture_preview_frames: Exiting. Total frames captured: {self.frames_captured}, Total frames in error: {self.frames_in_error}")
+        return frames
+
 def create_animated_gif(frames, output_filename, frame_duration=100, scale=None, verbose=False):
     """
     Creates an animated GIF from a list of frames.
@@ -970,6 +1125,10 @@ def main():
     parser.add_argument("--restore", metavar="FILENAME", help="Restore the device configuration from a JSON file.")
     parser.add_argument("--generate-gallery", action="store_true", help="Generate an HTML gallery from captured GIFs.")
     parser.add_argument("--mapping", type=str, default="auto", choices=["auto", "row-major", "column-major", "serpentine", "spectrum"], help="Specify pixel mapping (auto, row-major, column-major, serpentine, spectrum). Default: auto.")
+    parser.add_argument("--preview-encoding", type=str, choices=list(PREVIEW_ENCODINGS), help="Ask the device for preview packets using at most this encoding instead of raw frames.")
+    parser.add_argument("--preview-scale", type=int, default=1, metavar="FACTOR", help="With --preview-encoding, divide each side of the frame by this (1-8). Default: 1.")
+    parser.add_argument("--preview-fps", type=int, default=0, metavar="FPS", help="With --preview-encoding, cap the frame rate the device sends. Default: no cap.")
+    parser.add_argument("--decode-preview", metavar="FILENAME", help="Decode a file of back to back preview packets and save the frames like --capture does.")
     parser.add_argument("--verbose", action="store_true", help="Enable verbose output for debugging.")
     parser.add_argument("command", nargs="*", help="Optional command: next, prev, or an effect name/index.")
 
@@ -978,6 +1137,10 @@ def main():
 
     client = NightDriver(args.host, port=args.rest_port)
 
+    preview = None
+    if args.preview_encoding:
+        preview = {"scale": args.preview_scale, "encoding": args.preview_encoding, "max_fps": args.preview_fps}
+
     captured_files = []
 
     if args.effects:
@@ -1052,7 +1215,7 @@ def main():
             print(f"Capturing effect {effect_to_capture} for {args.duration} seconds...")
             print(f"Outputs: {', '.join(outputs)}")
             client.set_current_effect(effect_to_capture, width=16, height=16)
-            with ColorClient(args.host, verbose=args.verbose) as color_client:
+            with ColorClient(args.host, verbose=args.verbose, preview=preview) as color_client:
                 frames = color_client.capture_frames(args.duration)
 
             if frames:
@@ -1084,7 +1247,7 @@ def main():
                 print(f"Outputs: {', '.join(outputs)}")
                 client.set_current_effect(i, width=16, height=16)
 
-                with ColorClient(args.host, verbose=args.verbose) as color_client:
+                with ColorClient(args.host, verbose=args.verbose, preview=preview) as color_client:
                     frames = color_client.capture_frames(args.duration)
 
                 if frames:
@@ -1097,6 +1260,14 @@ def main():
                         create_contact_sheet(frames, output_filename, scale=args.scale, verbose=args.verbose)
                     captured_files.append(output_filename)
 
+    if args.decode_preview:
+        with open(args.decode_preview, 'rb') as f:
+            frames = decode_preview_stream(f.read(), verbose=args.verbose)
+        print(f"Decoded {len(frames)} preview frames from {args.decode_preview}")
+        if frames:
+            create_animated_gif(frames, args.output, scale=args.scale, verbose=args.verbose)
+            save_raw_frames(frames, args.output.replace('.gif', '.raw'), verbose=args.verbose)
+
     if args.live_view:
         live_view(args.host, args.hex_layout, verbose=args.verbose, gain=args.preview_gain, scale=args.scale, mapping=args.mapping)
 